@@ -1,37 +1,24 @@
 #! /usr/bin/python
 
 import os
-import re
+
+import xiosim_stat as xs
 
 RUN1 = '/group/brooks/skanev/data_test/ref'
 RUN2 = '/group/brooks/skanev/data_test/ref_bkp'
 STAT = 'total_IPC'
 
 
-def GetZestoStat(file, stat):
-    try:
-        f = open(file)
-        val = float("NaN")
-        rx = re.compile(stat)
-
-        for line in f:
-            m = rx.match(line)
-            if m:
-                val = float(line.split()[1])
-                break
-    except IOError:
-        val = float("NaN")
-    return val
-
 def GetRunStats(run, stat):
     stats = {}
 
     res = os.listdir(run)
     for f in res:
-        if not "slice" in f:
+        if not "slice" in f or f.endswith(".json") or f.endswith(".stats"):
             continue
 
-        stats[f] = GetZestoStat("%s/%s" % (run, f), stat)
+        # Picks up the structured stats next to each slice output, if present.
+        stats[f] = xs.GetStat("%s/%s" % (run, f), xs.PerfStatRE(stat))
 
     return stats
 
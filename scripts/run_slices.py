@@ -0,0 +1,169 @@
+#!/usr/bin/env python
+''' Simulate the PinPoints slices of a run as independent, parallel XIOSim runs.
+
+A single XIOSim run simulates the slices of a pinpoints file one after another.
+Here, every slice gets its own harness (feeder + timing_sim) with a pinpoints
+file of just that slice, so it fast-forwards to its own region. The runs go in
+parallel, and the slices' stats are merged with their weights into the same
+averaged output a single run would produce (see xiosim_stat.MergeStats).
+
+Usage as a script:
+  run_slices.py -benchmark_cfg <bmk_cfg> -config <cfg> -ppfile <pp> -run_dir <dir> [-jobs N]
+'''
+import argparse
+import multiprocessing
+import multiprocessing.pool
+import os
+import re
+import shutil
+
+import xiosim_driver as xd
+import xiosim_stat as xs
+
+
+class PinPoints(object):
+    ''' A parsed pinpoints file, which we can split into per-slice files. '''
+    def __init__(self, ppfile):
+        self.header = []   # Everything before the first region.
+        self.regions = []  # (region id, weight in %, lines), in file order.
+        self.footer = []   # markedInstrs and everything after.
+
+        with open(ppfile) as f:
+            lines = f.readlines()
+
+        curr = self.header
+        pending_region = False  # Started a block at its comment, no region line yet.
+        for line in lines:
+            tokens = line.split()
+            keyword = tokens[0] if tokens else ""
+            if curr is not self.footer:
+                if keyword == "markedInstrs":
+                    curr = self.footer
+                elif line.startswith("#Pinpoint=") or (keyword == "region" and not pending_region):
+                    # The comment above a region belongs to it.
+                    curr = []
+                    self.regions.append([None, 0.0, curr])
+                    pending_region = True
+                if keyword == "region":
+                    self.regions[-1][0] = int(tokens[1])
+                    self.regions[-1][1] = float(tokens[2])
+                    pending_region = False
+            curr.append(line)
+        self.regions = [tuple(region) for region in self.regions if region[0] is not None]
+
+    def WriteSlice(self, index, fname):
+        ''' Write a pinpoints file with only region @index. '''
+        region_id, weight, region_lines = self.regions[index]
+        with open(fname, "w") as f:
+            f.writelines(self.header)
+            f.writelines(region_lines)
+            for line in self.footer:
+                if re.match(r"^pinpoints\s+\d+", line):
+                    line = "pinpoints 1\n"
+                f.write(line)
+
+
+def DefaultJobs():
+    ''' Every slice keeps a feeder and a timing_sim busy. '''
+    return max(1, multiprocessing.cpu_count() // 2)
+
+
+def RunSlices(create_driver, ppfile, config, run_dir, changes=None, jobs=None):
+    ''' Simulate every slice in @ppfile in parallel and merge the results.
+
+    Args:
+        create_driver: callable(slice_dir) that prepares @slice_dir for the
+            benchmark and returns a XIOSimDriver with benchmarks added.
+        ppfile: pinpoints file.
+        config: starting config file.
+        run_dir: directory for the slice runs; merged results go to
+            <run_dir>/sim.out and <run_dir>/sim.out.json.
+        changes: dict of config changes, as for GenerateConfigFile().
+        jobs: number of slices to simulate at a time (DefaultJobs() if None).
+
+    Returns:
+        The merged stats (see xiosim_stat.MergeStats).
+    '''
+    pp = PinPoints(ppfile)
+    if not pp.regions:
+        raise Exception("No regions in %s" % ppfile)
+    if not os.path.exists(run_dir):
+        os.makedirs(run_dir)
+
+    def RunSlice(index):
+        region_id = pp.regions[index][0]
+        slice_dir = os.path.join(run_dir, "slice.%d" % region_id)
+        xio = create_driver(slice_dir)
+
+        slice_pp = os.path.join(slice_dir, "slice.%d.pp" % region_id)
+        pp.WriteSlice(index, slice_pp)
+
+        slice_changes = dict(changes or {})
+        slice_changes["system_cfg.output_redir"] = "\"%s\"" % os.path.join(slice_dir, "sim.out")
+        slice_changes["system_cfg.structured_stats"] = "\"json\""
+        slice_cfg = os.path.join(slice_dir, os.path.basename(config))
+        with open(slice_cfg, "w") as f:
+            f.writelines(xio.GenerateConfigFile(config, slice_changes))
+        xio.AddConfigFile(slice_cfg)
+        xio.AddPinOptions()
+        xio.AddPinPointFile(slice_pp)
+
+        out_file = os.path.join(slice_dir, "harness.out")
+        err_file = os.path.join(slice_dir, "harness.err")
+        ret = xio.Exec(stdout_file=out_file, stderr_file=err_file, cwd=slice_dir)
+        return (region_id, ret, os.path.join(slice_dir, "sim.out.json"))
+
+    if jobs is None:
+        jobs = DefaultJobs()
+    pool = multiprocessing.pool.ThreadPool(min(jobs, len(pp.regions)))
+    try:
+        results = pool.map(RunSlice, range(len(pp.regions)))
+    finally:
+        pool.close()
+        pool.join()
+
+    runs = []
+    for region_id, ret, stats_file in results:
+        if ret != 0:
+            raise Exception("Slice %d failed (errcode %d)" % (region_id, ret))
+        stats = xs.LoadStats(stats_file)
+        if stats is None:
+            raise Exception("Slice %d has no stats in %s" % (region_id, stats_file))
+        runs.append(stats)
+
+    # Same normalization as the simulator (see end_slice()).
+    weights = [weight / 100.0 for _, weight, _ in pp.regions]
+    merged = xs.MergeStats(runs, weights)
+    xs.WriteStats(os.path.join(run_dir, "sim.out.json"), merged)
+    xs.WriteTextStats(os.path.join(run_dir, "sim.out"), merged)
+    return merged
+
+
+def CreateDriver():
+    XIOSIM_INSTALL = os.environ["XIOSIM_INSTALL"]
+    XIOSIM_TREE = os.environ["XIOSIM_TREE"]
+    ARCH = os.environ["TARGET_ARCH"]
+    return xd.XIOSimDriver(XIOSIM_INSTALL, XIOSIM_TREE, ARCH)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Simulate pinpoints slices in parallel.")
+    parser.add_argument("-benchmark_cfg", required=True)
+    parser.add_argument("-config", required=True)
+    parser.add_argument("-ppfile", required=True)
+    parser.add_argument("-run_dir", required=True)
+    parser.add_argument("-jobs", type=int, default=None)
+    args = parser.parse_args()
+
+    bmk_cfg = os.path.abspath(args.benchmark_cfg)
+
+    def CreateSliceDriver(slice_dir):
+        if os.path.exists(slice_dir):
+            shutil.rmtree(slice_dir)
+        os.makedirs(slice_dir)
+        xio = CreateDriver()
+        xio.AddBmks(bmk_cfg)
+        return xio
+
+    RunSlices(CreateSliceDriver, os.path.abspath(args.ppfile), os.path.abspath(args.config),
+              os.path.abspath(args.run_dir), jobs=args.jobs)
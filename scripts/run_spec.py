@@ -1,6 +1,8 @@
 #!/usr/bin/env python
 import os.path
+import shutil
 
+import run_slices
 import xiosim_driver as xd
 import spec
 
@@ -79,5 +81,31 @@ def RunSPECBenchmark(name):
     if ret != 0:
         raise Exception("XIOSim run failed (errcode %d)" % ret)
 
+
+def RunSPECBenchmarkSlices(name, jobs=None):
+    ''' Same as RunSPECBenchmark, but simulate every pinpoints slice as a
+    separate run, in parallel. '''
+    run = spec.GetRun(name)
+    if run == None:
+        raise Exception("Wrong benchmark!")
+
+    def CreateSliceDriver(slice_dir):
+        run.CreateRunDir(slice_dir)
+        xio = CreateDriver()
+        xio.AddBmks(WriteBmkConfig(xio, run, slice_dir))
+        return xio
+
+    run_dir = os.path.join(RUN_DIR_ROOT, name)
+    orig_cfg = os.path.join(os.environ["XIOSIM_TREE"], CONFIG_FILE)
+    ppfile = os.path.join(run.directory, "%s.pintool.1.pp" % name)
+    run_slices.RunSlices(CreateSliceDriver, ppfile, orig_cfg, run_dir, jobs=jobs)
+
+    # Merged results next to the single-run ones.
+    shutil.copy(os.path.join(run_dir, "sim.out"),
+                os.path.join(RESULT_DIR, "%s.sim.out" % name))
+    shutil.copy(os.path.join(run_dir, "sim.out.json"),
+                os.path.join(RESULT_DIR, "%s.sim.out.json" % name))
+
+
 if __name__ == "__main__":
     RunSPECBenchmark("401.bzip2.chicken")
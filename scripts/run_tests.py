@@ -9,6 +9,7 @@ import sys
 import tempfile
 import unittest
 
+import run_slices
 import xiosim_driver as xd
 import xiosim_stat as xs
 
@@ -259,6 +260,44 @@ class Fib1PinPointsTest(XIOSimTest):
     def runTest(self):
         self.runAndValidate()
 
+class Fib1ParallelPinPointsTest(XIOSimTest):
+    ''' Same as Fib1PinPointsTest, with every pinpoint simulated in a
+    separate, parallel run and the results merged. '''
+    def setDriverParams(self):
+        pass
+
+    def setUp(self):
+        super(Fib1ParallelPinPointsTest, self).setUp()
+        if self.xio.TARGET_ARCH == "k8":
+            self.expected_vals.append((xs.PerfStatRE("all_insn"), 10000.0))
+        else:
+            self.expected_vals.append((xs.PerfStatRE("all_insn"), 9430.0))
+
+    def runTest(self):
+        bazel_env = ("TEST_SRCDIR" in os.environ)
+
+        def CreateSliceDriver(slice_dir):
+            os.makedirs(slice_dir)
+            xio = CreateDriver(bazel_env)
+            cfg_file = xio.GenerateTestBmkConfig("fib", 1)
+            bmk_cfg = os.path.join(slice_dir, "fib.cfg")
+            with open(bmk_cfg, "w") as f:
+                f.writelines(cfg_file)
+            xio.AddBmks(bmk_cfg)
+            return xio
+
+        config = os.path.join(self.xio.GetTreeDir(), "xiosim/config", "N.cfg")
+        ppfile = os.path.join(self.xio.GetTreeDir(), "tests",
+                              self.xio.TARGET_ARCH, "fib..pintool.2.pp")
+        run_slices.RunSlices(CreateSliceDriver, ppfile, config, self.run_dir, jobs=2)
+
+        sim_out = os.path.join(self.run_dir, "sim.out")
+        for re, golden_val in self.expected_vals:
+            val = xs.GetStat(sim_out, re)
+            res = xs.ValidateStat(val, golden_val)
+            self.assertEqual(res, True, "%s: expected %.2f, got %.2f" %
+                                        (re, golden_val, val))
+
 class ROITest(XIOSimTest):
     ''' End-to-end test with a single binary with ROI hooks.'''
     def setDriverParams(self):
@@ -1,14 +1,36 @@
 #!/usr/bin/env python
 
+import collections
+import copy
+import json
+import math
+import os
 import re
+import struct
 
 STAT_THRESHOLD = 0.02
 
 DECIMAL_RE = "-*\d+(\.\d*)?"
 
+class StatRE(str):
+    ''' A stat RE that remembers the stat name, so the structured stats
+    file (see LoadStats) can be used instead of matching the text output.'''
+    def __new__(cls, rx, stat):
+        obj = str.__new__(cls, rx)
+        obj.stat = stat
+        return obj
+
+class DistStatRE(tuple):
+    ''' Same as StatRE, for the REs of a distribution bucket. '''
+    def __new__(cls, rxs, stat, label):
+        obj = tuple.__new__(cls, rxs)
+        obj.stat = stat
+        obj.label = label
+        return obj
+
 def PerfStatRE(stat):
     ''' Return a RE that looks for a XIOSim performance stat.'''
-    return "^%s\s+(%s)" % (stat, DECIMAL_RE)
+    return StatRE("^%s\s+(%s)" % (stat, DECIMAL_RE), stat)
 
 def PowerStatRE(stat):
     ''' Return a RE that looks for a McPAT power stat.'''
@@ -34,10 +56,99 @@ def PerfDistStatRE(stat):
 
     # The start and end labels are either start_hist or start_dist, depending
     # on the type of stat used.
-    return ("^%s.start_[hd]ist" % stat_name,
-            "^\s*%s\s+(%s)" % (label, DECIMAL_RE),
-            "^%s.end_[hd]ist" % stat_name,
-            )
+    return DistStatRE(("^%s.start_[hd]ist" % stat_name,
+                       "^\s*%s\s+(%s)" % (label, DECIMAL_RE),
+                       "^%s.end_[hd]ist" % stat_name,
+                       ), stat_name, label)
+
+STAT_TYPES = ["int", "float", "string", "distribution", "histogram", "formula"]
+
+def _ReadBinaryStats(f):
+    ''' Parse the binary stats format (see xiosim/stat_format.h). '''
+    def read(fmt):
+        size = struct.calcsize(fmt)
+        buf = f.read(size)
+        if len(buf) != size:
+            raise ValueError("truncated stats file")
+        return struct.unpack(fmt, buf)
+
+    def read_string():
+        length, = read("<I")
+        return f.read(length).decode("utf-8", "replace")
+
+    if f.read(8) != b"XIOSTAT1":
+        raise ValueError("not a binary stats file")
+    weight, num_stats = read("<dI")
+    stats = []
+    for _ in range(num_stats):
+        type_id, = read("<B")
+        stat = {"type" : STAT_TYPES[type_id],
+                "name" : read_string(),
+                "desc" : read_string()}
+        if stat["type"] == "int":
+            stat["value"], = read("<q")
+        elif stat["type"] in ("float", "formula"):
+            stat["value"], = read("<d")
+        elif stat["type"] == "string":
+            stat["value"] = read_string()
+        elif stat["type"] == "distribution":
+            n, stat["overflows"] = read("<II")
+            stat["counts"] = list(read("<%dQ" % n))
+            has_labels, = read("<B")
+            if has_labels:
+                stat["labels"] = [read_string() for _ in range(n)]
+        elif stat["type"] == "histogram":
+            n, = read("<I")
+            flat = read("<%dQ" % (2 * n))
+            stat["counts"] = [[flat[2 * i], flat[2 * i + 1]] for i in range(n)]
+        stats.append(stat)
+    return {"version" : 1, "weight" : weight, "stats" : stats}
+
+_stats_cache = {}
+
+def LoadStats(fname):
+    ''' Load a structured stats file (.json or binary .stats), as written with
+    system_cfg.structured_stats.
+
+    Returns:
+        An ordered dict of stat name -> stat dict (with "type", "desc" and
+        "value" or "counts" etc.), or None if the file can't be read.
+    '''
+    try:
+        mtime = os.path.getmtime(fname)
+    except OSError:
+        return None
+    cached = _stats_cache.get(fname)
+    if cached and cached[0] == mtime:
+        return cached[1]
+
+    try:
+        with open(fname, "rb") as f:
+            if f.read(8) == b"XIOSTAT1":
+                f.seek(0)
+                data = _ReadBinaryStats(f)
+            else:
+                f.seek(0)
+                data = json.loads(f.read().decode("utf-8"))
+    except (IOError, ValueError):
+        return None
+
+    stats = collections.OrderedDict((stat["name"], stat) for stat in data["stats"])
+    _stats_cache[fname] = (mtime, stats)
+    return stats
+
+def _StructuredStats(fname):
+    ''' Find the structured stats written next to a text output file. '''
+    for ext in (".json", ".stats"):
+        if os.path.exists(fname + ext):
+            return LoadStats(fname + ext)
+    return None
+
+def _StatValue(val):
+    # NaN/inf are written as null.
+    if val is None:
+        return float("NaN")
+    return float(val)
 
 def GetStat(fname, stat):
     ''' Find a stat value in a xiosim output file. '''
@@ -54,6 +165,15 @@ def GetScalarStat(fname, stat):
     Returns:
         Stat value, or NaN if not found.
     '''
+    # Stats missing from the structured file (e.g. printed by a component
+    # that doesn't register them) are still looked up in the text output.
+    stats = _StructuredStats(fname) if hasattr(stat, "stat") else None
+    if stats is not None and stat.stat in stats and "value" in stats[stat.stat]:
+        try:
+            return _StatValue(stats[stat.stat]["value"])
+        except ValueError:
+            pass
+
     try:
         f = open(fname)
         val = float("NaN")
@@ -81,6 +201,10 @@ def GetDistStat(fname, dist_stat_rxs):
     Returns:
         Stat value, or NaN if not found.
     '''
+    stats = _StructuredStats(fname) if hasattr(dist_stat_rxs, "stat") else None
+    if stats is not None and dist_stat_rxs.stat in stats:
+        return _DistBucket(stats[dist_stat_rxs.stat], dist_stat_rxs.label)
+
     try:
         f = open(fname)
         val = float("NaN")
@@ -115,6 +239,22 @@ def GetDistStat(fname, dist_stat_rxs):
         val = float("NaN")
     return val
 
+def _DistBucket(stat, label):
+    ''' Count of bucket @label (an index, a label or a histogram key). '''
+    if stat is None:
+        return float("NaN")
+    if stat["type"] == "histogram":
+        for key, count in stat["counts"]:
+            if str(key) == label:
+                return float(count)
+        return float("NaN")
+    if "labels" in stat and label in stat["labels"]:
+        return float(stat["counts"][stat["labels"].index(label)])
+    try:
+        return float(stat["counts"][int(label)])
+    except (ValueError, IndexError):
+        return float("NaN")
+
 def ValidateStat(val, golden):
     ''' Check whether stat value matches a golden one.
 
@@ -129,3 +269,174 @@ def ValidateStat(val, golden):
 
     abs_err = abs(val - golden) / golden
     return (abs_err <= STAT_THRESHOLD)
+
+
+_EXPR_TOKEN_RE = re.compile(r"\s*(\{[^}]*\}|(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?|[a-z]+|[()+\-*/^])")
+
+def EvalFormula(expr, stats):
+    ''' Evaluate the "expr" of a dumped formula (fully parenthesized infix,
+    with statistics as {name}; see xiosim/stat_format.h) over @stats.
+
+    Returns:
+        The value, or None if some term is missing from @stats.
+    '''
+    tokens = _EXPR_TOKEN_RE.findall(expr)
+    pos = [0]
+
+    def next_token():
+        tok = tokens[pos[0]]
+        pos[0] += 1
+        return tok
+
+    def term():
+        tok = next_token()
+        if tok.startswith("{"):
+            stat = stats.get(tok[1:-1])
+            if stat is None or stat.get("value") is None:
+                raise KeyError(tok)
+            return float(stat["value"])
+        if tok == "-":  # Negative constant.
+            return -term()
+        if tok != "(":
+            return float(tok)
+        if tokens[pos[0]] == "-":
+            next_token()
+            val = -term()
+        else:
+            lhs = term()
+            op = next_token()
+            rhs = term()
+            val = _ApplyOp(op, lhs, rhs)
+        if next_token() != ")":
+            raise ValueError("bad formula: %s" % expr)
+        return val
+
+    try:
+        return term()
+    except (KeyError, IndexError):
+        return None
+
+def _ApplyOp(op, lhs, rhs):
+    try:
+        if op == "+":
+            return lhs + rhs
+        if op == "-":
+            return lhs - rhs
+        if op == "*":
+            return lhs * rhs
+        if op == "/":
+            return lhs / rhs
+        if op == "^":
+            return math.pow(lhs, rhs)
+    except (ZeroDivisionError, ValueError, OverflowError):
+        return float("NaN")
+    raise ValueError("unknown operator %s" % op)
+
+def MergeStats(runs, weights):
+    ''' Merge the stats of independent slice runs, the way the simulator
+    accumulates the slices it runs back to back. Each run's top-level output
+    is already scaled by its slice weight.
+
+    Args:
+        runs: list of stats dicts, as returned by LoadStats().
+        weights: list of slice weights for the runs.
+
+    Returns:
+        An ordered dict of merged stats. Counters and distributions are
+        summed, formulas are re-evaluated over the sums. Formulas whose terms
+        weren't all dumped fall back to the weighted mean of the slice values.
+    '''
+    merged = collections.OrderedDict()
+    for stats in runs:
+        for name, stat in stats.items():
+            if name not in merged:
+                merged[name] = copy.deepcopy(stat)
+                continue
+            acc = merged[name]
+            if stat["type"] == "int":
+                acc["value"] += stat["value"]
+            elif stat["type"] == "float":
+                acc["value"] = _StatValue(acc["value"]) + _StatValue(stat["value"])
+            elif stat["type"] == "distribution":
+                acc["counts"] = [a + b for a, b in zip(acc["counts"], stat["counts"])]
+                acc["overflows"] += stat["overflows"]
+            elif stat["type"] == "histogram":
+                counts = dict((k, v) for k, v in acc["counts"])
+                for key, count in stat["counts"]:
+                    counts[key] = counts.get(key, 0) + count
+                acc["counts"] = [[k, counts[k]] for k in sorted(counts)]
+
+    total_weight = sum(weights)
+    for name, acc in merged.items():
+        if acc["type"] != "formula":
+            continue
+        val = EvalFormula(acc["expr"], merged) if "expr" in acc else None
+        if val is None and total_weight > 0:
+            val = 0.0
+            for stats, weight in zip(runs, weights):
+                if name in stats:
+                    val += weight * _StatValue(stats[name]["value"])
+            val /= total_weight
+        acc["value"] = val
+    return merged
+
+def _JSONValue(val):
+    # Same as the simulator: NaN/inf are written as null.
+    if isinstance(val, float) and (math.isnan(val) or math.isinf(val)):
+        return None
+    return val
+
+def WriteStats(fname, stats, weight=1.0):
+    ''' Write @stats in the JSON format of xiosim/stat_format.h. '''
+    lines = []
+    for stat in stats.values():
+        stat = dict(stat)
+        if "value" in stat:
+            stat["value"] = _JSONValue(stat["value"])
+        lines.append(json.dumps(stat, sort_keys=True))
+    with open(fname, "w") as f:
+        f.write('{"version": 1, "weight": %s, "stats": [\n' % json.dumps(weight))
+        f.write(",\n".join(lines))
+        f.write("\n]}\n")
+
+def WriteTextStats(fname, stats):
+    ''' Write @stats in (roughly) the simulator's text format, so the stat
+    REs above work on merged results too. '''
+    with open(fname, "w") as f:
+        for name, stat in stats.items():
+            if stat["type"] == "distribution":
+                counts = stat["counts"]
+                labels = stat.get("labels") or [str(i) for i in range(len(counts))]
+                total = sum(counts)
+                f.write("%-28s # %s\n" % (name, stat["desc"]))
+                f.write("%s.count = %d\n" % (name, total))
+                f.write("%s.overflows = %d\n" % (name, stat["overflows"]))
+                f.write("%s.start_dist\n" % name)
+                cdf = 0
+                for label, count in zip(labels, counts):
+                    cdf += count
+                    f.write("%-16s %10d %6.2f %6.2f \n" % (label, count,
+                            100.0 * count / max(total, 1), 100.0 * cdf / max(total, 1)))
+                f.write("%s.end_dist\n" % name)
+            elif stat["type"] == "histogram":
+                total = sum(count for _, count in stat["counts"])
+                f.write("%-28s # %s\n" % (name, stat["desc"]))
+                f.write("%s.total = %d\n" % (name, total))
+                f.write("%s.start_hist\n" % name)
+                cdf = 0
+                for key, count in stat["counts"]:
+                    cdf += count
+                    f.write("%18d %10d %6.2f %6.2f\n" % (key, count,
+                            100.0 * count / max(total, 1), 100.0 * cdf / max(total, 1)))
+                f.write("%s.end_hist\n" % name)
+            else:
+                if stat["type"] == "int":
+                    val = "%12d" % stat["value"]
+                elif stat["type"] in ("float", "formula"):
+                    val = "%12.4f" % _StatValue(stat["value"])
+                else:
+                    val = "%12s" % stat["value"]
+                f.write("%-28s%s" % (name, val))
+                if stat["desc"]:
+                    f.write(" # %s" % stat["desc"])
+                f.write("\n")
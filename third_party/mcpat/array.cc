@@ -34,6 +34,7 @@
 #include "decoder.h"
 #include "parameter.h"
 #include "array.h"
+#include "array_cache.h"
 #include <iostream>
 #include <math.h>
 #include <assert.h>
@@ -58,7 +59,10 @@ ArrayST::ArrayST(const InputParameter *configure_interface,
 	if (l_ip.cache_sz<64) l_ip.cache_sz=64;
 	if (l_ip.power_gating && (l_ip.assoc==0)) {l_ip.power_gating = false;}
 	l_ip.error_checking();//not only do the error checking but also fill some missing parameters
-	optimize_array();
+	if (!array_cache::replay(this)) {
+		optimize_array();
+		array_cache::record(this);
+	}
 
 }
 
@@ -0,0 +1,724 @@
+/* array_cache.cc - On-disk cache of ArrayST optimization results. */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "array.h"
+#include "array_cache.h"
+#include "Ucache.h"
+#include "XML_Parse.h"
+#include "wire.h"
+
+/* Compiler the optimizer was built with; it can change results. */
+#define BUILD_STAMP "mcpat array cache, " __VERSION__
+
+namespace array_cache {
+
+/* The parts of a CACTI mem_array that McPAT reads. */
+struct mem_array_record_t {
+	double area_efficiency;
+	powerDef power;
+};
+
+/* Everything ArrayST::optimize_array() leaves behind that the rest of McPAT
+ * reads. Saved field by field (see visit()), never as raw bytes. */
+struct record_t {
+	/* Identifies the array, to catch a cache that went stale anyway. */
+	uint64_t name_hash;
+	unsigned int cache_sz, line_sz, assoc, nbanks;
+
+	/* Optimizer knobs, as adjusted in l_ip. */
+	int ed;
+	int delay_wt, dynamic_power_wt, leakage_power_wt, cycle_time_wt, area_wt;
+	int delay_dev, dynamic_power_dev, leakage_power_dev, cycle_time_dev, area_dev;
+
+	/* local_result. */
+	double access_time, cycle_time, area, area_efficiency;
+	powerDef power;
+	double leak_power_with_sleep_transistors_in_mats;
+	double cache_ht, cache_len;
+	double vdd_periph_global;
+	bool valid;
+	bool has_data, has_tag;
+	mem_array_record_t data_array2, tag_array2;
+};
+
+template <typename F>
+static void visit(powerComponents& p, F& f)
+{
+	f(p.dynamic);
+	f(p.leakage);
+	f(p.gate_leakage);
+	f(p.short_circuit);
+	f(p.longer_channel_leakage);
+	f(p.power_gated_leakage);
+	f(p.power_gated_with_long_channel_leakage);
+}
+
+template <typename F>
+static void visit(powerDef& p, F& f)
+{
+	visit(p.readOp, f);
+	visit(p.writeOp, f);
+	visit(p.searchOp, f);
+}
+
+template <typename F>
+static void visit(mem_array_record_t& arr, F& f)
+{
+	f(arr.area_efficiency);
+	visit(arr.power, f);
+}
+
+/* Call @f on every scalar field of @rec, in file order. */
+template <typename F>
+static void visit(record_t& rec, F& f)
+{
+	f(rec.name_hash);
+	f(rec.cache_sz);
+	f(rec.line_sz);
+	f(rec.assoc);
+	f(rec.nbanks);
+	f(rec.ed);
+	f(rec.delay_wt);
+	f(rec.dynamic_power_wt);
+	f(rec.leakage_power_wt);
+	f(rec.cycle_time_wt);
+	f(rec.area_wt);
+	f(rec.delay_dev);
+	f(rec.dynamic_power_dev);
+	f(rec.leakage_power_dev);
+	f(rec.cycle_time_dev);
+	f(rec.area_dev);
+	f(rec.access_time);
+	f(rec.cycle_time);
+	f(rec.area);
+	f(rec.area_efficiency);
+	visit(rec.power, f);
+	f(rec.leak_power_with_sleep_transistors_in_mats);
+	f(rec.cache_ht);
+	f(rec.cache_len);
+	f(rec.vdd_periph_global);
+	f(rec.valid);
+	f(rec.has_data);
+	f(rec.has_tag);
+	visit(rec.data_array2, f);
+	visit(rec.tag_array2, f);
+}
+
+struct field_reader_t {
+	FILE* fd;
+	bool ok;
+	template <typename T>
+	void operator()(T& field) { ok = ok && fread(&field, sizeof(field), 1, fd) == 1; }
+};
+
+struct field_writer_t {
+	FILE* fd;
+	bool ok;
+	template <typename T>
+	void operator()(T& field) { ok = ok && fwrite(&field, sizeof(field), 1, fd) == 1; }
+};
+
+static const char MAGIC[8] = { 'M', 'C', 'P', 'A', 'T', 'A', 'C', 'H' };
+
+static bool active = false;
+static std::string path;
+static uint64_t cache_key;
+static std::vector<record_t> records;
+static size_t next_record;
+static bool dirty;
+
+uint64_t hash(const void* data, size_t size, uint64_t seed)
+{
+	const unsigned char* bytes = (const unsigned char*) data;
+	uint64_t h = seed;
+	for (size_t i = 0; i < size; i++) {
+		h ^= bytes[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+/* Hashing of configuration fields, by name. Strings only up to their NUL. */
+template <typename T>
+static typename std::enable_if<std::is_arithmetic<T>::value, uint64_t>::type
+mix(uint64_t h, T value)
+{
+	return hash(&value, sizeof(value), h);
+}
+
+template <size_t N>
+static uint64_t mix(uint64_t h, const char (&str)[N])
+{
+	return hash(str, strnlen(str, N), h);
+}
+
+template <typename T, size_t N>
+static uint64_t mix(uint64_t h, const T (&arr)[N])
+{
+	for (size_t i = 0; i < N; i++)
+		h = mix(h, arr[i]);
+	return h;
+}
+
+/* The input parameters of each part of the system. Statistics are left out,
+ * the optimizer doesn't look at them. */
+static uint64_t mix(uint64_t h, const predictor_systemcore& p)
+{
+	h = mix(h, p.prediction_width);
+	h = mix(h, p.prediction_scheme);
+	h = mix(h, p.predictor_size);
+	h = mix(h, p.predictor_entries);
+	h = mix(h, p.local_predictor_size);
+	h = mix(h, p.local_predictor_entries);
+	h = mix(h, p.global_predictor_entries);
+	h = mix(h, p.global_predictor_bits);
+	h = mix(h, p.chooser_predictor_entries);
+	h = mix(h, p.chooser_predictor_bits);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const itlb_systemcore& p)
+{
+	h = mix(h, p.number_entries);
+	h = mix(h, p.cache_policy);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const icache_systemcore& p)
+{
+	h = mix(h, p.icache_config);
+	h = mix(h, p.buffer_sizes);
+	h = mix(h, p.cache_policy);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const dtlb_systemcore& p)
+{
+	h = mix(h, p.number_entries);
+	h = mix(h, p.cache_policy);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const dcache_systemcore& p)
+{
+	h = mix(h, p.dcache_config);
+	h = mix(h, p.buffer_sizes);
+	h = mix(h, p.cache_policy);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const BTB_systemcore& p)
+{
+	h = mix(h, p.BTB_config);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_core& p)
+{
+	h = mix(h, p.clock_rate);
+	h = mix(h, p.opt_local);
+	h = mix(h, p.x86);
+	h = mix(h, p.machine_bits);
+	h = mix(h, p.virtual_address_width);
+	h = mix(h, p.physical_address_width);
+	h = mix(h, p.opcode_width);
+	h = mix(h, p.micro_opcode_width);
+	h = mix(h, p.instruction_length);
+	h = mix(h, p.machine_type);
+	h = mix(h, p.internal_datapath_width);
+	h = mix(h, p.number_hardware_threads);
+	h = mix(h, p.fetch_width);
+	h = mix(h, p.number_instruction_fetch_ports);
+	h = mix(h, p.decode_width);
+	h = mix(h, p.issue_width);
+	h = mix(h, p.peak_issue_width);
+	h = mix(h, p.commit_width);
+	h = mix(h, p.pipelines_per_core);
+	h = mix(h, p.pipeline_depth);
+	h = mix(h, p.FPU);
+	h = mix(h, p.divider_multiplier);
+	h = mix(h, p.ALU_per_core);
+	h = mix(h, p.FPU_per_core);
+	h = mix(h, p.MUL_per_core);
+	h = mix(h, p.instruction_buffer_size);
+	h = mix(h, p.decoded_stream_buffer_size);
+	h = mix(h, p.instruction_window_scheme);
+	h = mix(h, p.instruction_window_size);
+	h = mix(h, p.fp_instruction_window_size);
+	h = mix(h, p.ROB_size);
+	h = mix(h, p.archi_Regs_IRF_size);
+	h = mix(h, p.archi_Regs_FRF_size);
+	h = mix(h, p.phy_Regs_IRF_size);
+	h = mix(h, p.phy_Regs_FRF_size);
+	h = mix(h, p.rename_scheme);
+	h = mix(h, p.register_windows_size);
+	h = mix(h, p.LSU_order);
+	h = mix(h, p.store_buffer_size);
+	h = mix(h, p.load_buffer_size);
+	h = mix(h, p.memory_ports);
+	h = mix(h, p.Dcache_dual_pump);
+	h = mix(h, p.RAS_size);
+	h = mix(h, p.fp_issue_width);
+	h = mix(h, p.prediction_width);
+	h = mix(h, p.number_of_BTB);
+	h = mix(h, p.number_of_BPT);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	h = mix(h, p.predictor);
+	h = mix(h, p.itlb);
+	h = mix(h, p.icache);
+	h = mix(h, p.dtlb);
+	h = mix(h, p.dcache);
+	h = mix(h, p.BTB);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_L1Directory& p)
+{
+	h = mix(h, p.Directory_type);
+	h = mix(h, p.Dir_config);
+	h = mix(h, p.buffer_sizes);
+	h = mix(h, p.clockrate);
+	h = mix(h, p.ports);
+	h = mix(h, p.device_type);
+	h = mix(h, p.cache_policy);
+	h = mix(h, p.threeD_stack);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_L2Directory& p)
+{
+	h = mix(h, p.Directory_type);
+	h = mix(h, p.Dir_config);
+	h = mix(h, p.buffer_sizes);
+	h = mix(h, p.clockrate);
+	h = mix(h, p.ports);
+	h = mix(h, p.device_type);
+	h = mix(h, p.cache_policy);
+	h = mix(h, p.threeD_stack);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_L2& p)
+{
+	h = mix(h, p.L2_config);
+	h = mix(h, p.clockrate);
+	h = mix(h, p.ports);
+	h = mix(h, p.device_type);
+	h = mix(h, p.cache_policy);
+	h = mix(h, p.threeD_stack);
+	h = mix(h, p.buffer_sizes);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	h = mix(h, p.merged_dir);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_L3& p)
+{
+	h = mix(h, p.L3_config);
+	h = mix(h, p.clockrate);
+	h = mix(h, p.ports);
+	h = mix(h, p.device_type);
+	h = mix(h, p.cache_policy);
+	h = mix(h, p.threeD_stack);
+	h = mix(h, p.buffer_sizes);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	h = mix(h, p.merged_dir);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const xbar0_systemNoC& p)
+{
+	h = mix(h, p.number_of_inputs_of_crossbars);
+	h = mix(h, p.number_of_outputs_of_crossbars);
+	h = mix(h, p.flit_bits);
+	h = mix(h, p.input_buffer_entries_per_port);
+	h = mix(h, p.ports_of_input_buffer);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_NoC& p)
+{
+	h = mix(h, p.clockrate);
+	h = mix(h, p.type);
+	h = mix(h, p.has_global_link);
+	h = mix(h, p.topology);
+	h = mix(h, p.horizontal_nodes);
+	h = mix(h, p.vertical_nodes);
+	h = mix(h, p.link_throughput);
+	h = mix(h, p.link_latency);
+	h = mix(h, p.input_ports);
+	h = mix(h, p.output_ports);
+	h = mix(h, p.virtual_channel_per_port);
+	h = mix(h, p.flit_bits);
+	h = mix(h, p.input_buffer_entries_per_vc);
+	h = mix(h, p.ports_of_input_buffer);
+	h = mix(h, p.dual_pump);
+	h = mix(h, p.number_of_crossbars);
+	h = mix(h, p.crossbar_type);
+	h = mix(h, p.crosspoint_type);
+	h = mix(h, p.xbar0);
+	h = mix(h, p.arbiter_type);
+	h = mix(h, p.chip_coverage);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	h = mix(h, p.route_over_perc);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_mem& p)
+{
+	h = mix(h, p.mem_tech_node);
+	h = mix(h, p.device_clock);
+	h = mix(h, p.peak_transfer_rate);
+	h = mix(h, p.internal_prefetch_of_DRAM_chip);
+	h = mix(h, p.capacity_per_channel);
+	h = mix(h, p.number_ranks);
+	h = mix(h, p.num_banks_of_DRAM_chip);
+	h = mix(h, p.Block_width_of_DRAM_chip);
+	h = mix(h, p.output_width_of_DRAM_chip);
+	h = mix(h, p.page_size_of_DRAM_chip);
+	h = mix(h, p.burstlength_of_DRAM_chip);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_mc& p)
+{
+	h = mix(h, p.peak_transfer_rate);
+	h = mix(h, p.number_mcs);
+	h = mix(h, p.withPHY);
+	h = mix(h, p.type);
+	h = mix(h, p.mc_clock);
+	h = mix(h, p.llc_line_length);
+	h = mix(h, p.memory_channels_per_mc);
+	h = mix(h, p.number_ranks);
+	h = mix(h, p.req_window_size_per_channel);
+	h = mix(h, p.IO_buffer_size_per_channel);
+	h = mix(h, p.databus_width);
+	h = mix(h, p.addressbus_width);
+	h = mix(h, p.LVDS);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_niu& p)
+{
+	h = mix(h, p.clockrate);
+	h = mix(h, p.number_units);
+	h = mix(h, p.type);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const system_pcie& p)
+{
+	h = mix(h, p.clockrate);
+	h = mix(h, p.number_units);
+	h = mix(h, p.num_channels);
+	h = mix(h, p.type);
+	h = mix(h, p.withPHY);
+	h = mix(h, p.vdd);
+	h = mix(h, p.power_gating_vcc);
+	return h;
+}
+
+static uint64_t mix(uint64_t h, const root_system& sys)
+{
+	h = mix(h, sys.number_of_cores);
+	h = mix(h, sys.number_of_L1Directories);
+	h = mix(h, sys.number_of_L2Directories);
+	h = mix(h, sys.number_of_L2s);
+	h = mix(h, sys.Private_L2);
+	h = mix(h, sys.number_of_L3s);
+	h = mix(h, sys.number_of_NoCs);
+	h = mix(h, sys.number_of_dir_levels);
+	h = mix(h, sys.domain_size);
+	h = mix(h, sys.first_level_dir);
+	h = mix(h, sys.homogeneous_cores);
+	h = mix(h, sys.homogeneous_L1Directories);
+	h = mix(h, sys.homogeneous_L2Directories);
+	h = mix(h, sys.core_tech_node);
+	h = mix(h, sys.target_core_clockrate);
+	h = mix(h, sys.target_chip_area);
+	h = mix(h, sys.temperature);
+	h = mix(h, sys.number_cache_levels);
+	h = mix(h, sys.L1_property);
+	h = mix(h, sys.L2_property);
+	h = mix(h, sys.homogeneous_L2s);
+	h = mix(h, sys.L3_property);
+	h = mix(h, sys.homogeneous_L3s);
+	h = mix(h, sys.homogeneous_NoCs);
+	h = mix(h, sys.homogeneous_ccs);
+	h = mix(h, sys.Max_area_deviation);
+	h = mix(h, sys.Max_power_deviation);
+	h = mix(h, sys.device_type);
+	h = mix(h, sys.longer_channel_device);
+	h = mix(h, sys.power_gating);
+	h = mix(h, sys.Embedded);
+	h = mix(h, sys.opt_dynamic_power);
+	h = mix(h, sys.opt_lakage_power);
+	h = mix(h, sys.opt_clockrate);
+	h = mix(h, sys.opt_area);
+	h = mix(h, sys.interconnect_projection_type);
+	h = mix(h, sys.machine_bits);
+	h = mix(h, sys.virtual_address_width);
+	h = mix(h, sys.physical_address_width);
+	h = mix(h, sys.virtual_memory_page_size);
+	h = mix(h, sys.vdd);
+	h = mix(h, sys.power_gating_vcc);
+	for (int i = 0; i < 64; i++)
+		h = mix(h, sys.core[i]);
+	for (int i = 0; i < 64; i++)
+		h = mix(h, sys.L1Directory[i]);
+	for (int i = 0; i < 64; i++)
+		h = mix(h, sys.L2Directory[i]);
+	for (int i = 0; i < 64; i++)
+		h = mix(h, sys.L2[i]);
+	for (int i = 0; i < 64; i++)
+		h = mix(h, sys.L3[i]);
+	for (int i = 0; i < 64; i++)
+		h = mix(h, sys.NoC[i]);
+	h = mix(h, sys.mem);
+	h = mix(h, sys.mc);
+	h = mix(h, sys.flashc);
+	h = mix(h, sys.niu);
+	h = mix(h, sys.pcie);
+	return h;
+}
+
+uint64_t config_key(const ParseXML* xml)
+{
+	/* Results also depend on the optimizer code and how it was compiled. */
+	uint64_t h = hash(BUILD_STAMP, strlen(BUILD_STAMP));
+	h = mix(h, VERSION);
+	return mix(h, xml->sys);
+}
+
+static uint64_t hash_name(const std::string& name)
+{
+	return hash(name.data(), name.size());
+}
+
+/* Arrays whose results depend on more than local_result (DVS and power-gating
+ * update wire and tech state on the side) always go through the optimizer. */
+static bool cacheable(const ArrayST* array)
+{
+	return !array->l_ip.power_gating && array->l_ip.dvs_voltage.empty();
+}
+
+static bool load()
+{
+	FILE* fd = fopen(path.c_str(), "rb");
+	if (!fd)
+		return false;
+
+	char magic[sizeof(MAGIC)];
+	uint32_t version, num_records;
+	uint64_t key;
+	bool ok = fread(magic, sizeof(magic), 1, fd) == 1 &&
+	          fread(&version, sizeof(version), 1, fd) == 1 &&
+	          fread(&key, sizeof(key), 1, fd) == 1 &&
+	          fread(&num_records, sizeof(num_records), 1, fd) == 1;
+	ok = ok && !memcmp(magic, MAGIC, sizeof(MAGIC)) && version == VERSION && key == cache_key;
+	if (ok) {
+		field_reader_t reader = { fd, true };
+		records.resize(num_records);
+		for (size_t i = 0; i < records.size() && reader.ok; i++)
+			visit(records[i], reader);
+		ok = reader.ok;
+	}
+	fclose(fd);
+
+	if (!ok)
+		records.clear();
+	return ok;
+}
+
+static void save()
+{
+	/* Write to the side and rename, so concurrent runs never see half a file. */
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), ".%d.tmp", (int) getpid());
+	std::string tmp_path = path + suffix;
+	FILE* fd = fopen(tmp_path.c_str(), "wb");
+	if (!fd) {
+		fprintf(stderr, "McPAT: can't write array cache %s\n", tmp_path.c_str());
+		return;
+	}
+
+	uint32_t version = VERSION;
+	uint32_t num_records = records.size();
+	bool ok = fwrite(MAGIC, sizeof(MAGIC), 1, fd) == 1 &&
+	          fwrite(&version, sizeof(version), 1, fd) == 1 &&
+	          fwrite(&cache_key, sizeof(cache_key), 1, fd) == 1 &&
+	          fwrite(&num_records, sizeof(num_records), 1, fd) == 1;
+	field_writer_t writer = { fd, ok };
+	for (size_t i = 0; i < records.size() && writer.ok; i++)
+		visit(records[i], writer);
+	ok = (fclose(fd) == 0) && writer.ok;
+
+	if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+		fprintf(stderr, "McPAT: can't write array cache %s\n", path.c_str());
+		remove(tmp_path.c_str());
+	}
+}
+
+void open(const char* dir, uint64_t key)
+{
+	active = (dir != NULL && dir[0] != '\0');
+	records.clear();
+	next_record = 0;
+	dirty = false;
+	if (!active)
+		return;
+
+	char fname[64];
+	snprintf(fname, sizeof(fname), "/mcpat-%016llx.cache", (unsigned long long) key);
+	path = std::string(dir) + fname;
+	cache_key = key;
+	load();
+}
+
+static bool matches(const record_t& rec, const ArrayST* array)
+{
+	const InputParameter& ip = array->l_ip;
+	return rec.name_hash == hash_name(array->name) && rec.cache_sz == ip.cache_sz &&
+	       rec.line_sz == ip.line_sz && rec.assoc == ip.assoc && rec.nbanks == ip.nbanks;
+}
+
+static mem_array* replay_mem_array(const mem_array_record_t& from)
+{
+	mem_array* res = new mem_array();
+	res->area_efficiency = from.area_efficiency;
+	res->power = from.power;
+	return res;
+}
+
+static void record_mem_array(const mem_array* from, mem_array_record_t* to)
+{
+	to->area_efficiency = from->area_efficiency;
+	to->power = from->power;
+}
+
+bool replay(ArrayST* array)
+{
+	if (!active || !cacheable(array))
+		return false;
+
+	if (next_record >= records.size() || !matches(records[next_record], array)) {
+		/* The configuration changed under the same key (or the cache was
+		 * cut short). Everything from here on gets recomputed. */
+		records.resize(next_record);
+		return false;
+	}
+
+	const record_t& rec = records[next_record++];
+	InputParameter& ip = array->l_ip;
+	ip.ed = rec.ed;
+	ip.delay_wt = rec.delay_wt;
+	ip.dynamic_power_wt = rec.dynamic_power_wt;
+	ip.leakage_power_wt = rec.leakage_power_wt;
+	ip.cycle_time_wt = rec.cycle_time_wt;
+	ip.area_wt = rec.area_wt;
+	ip.delay_dev = rec.delay_dev;
+	ip.dynamic_power_dev = rec.dynamic_power_dev;
+	ip.leakage_power_dev = rec.leakage_power_dev;
+	ip.cycle_time_dev = rec.cycle_time_dev;
+	ip.area_dev = rec.area_dev;
+
+	uca_org_t& res = array->local_result;
+	res.access_time = rec.access_time;
+	res.cycle_time = rec.cycle_time;
+	res.area = rec.area;
+	res.area_efficiency = rec.area_efficiency;
+	res.power = rec.power;
+	res.leak_power_with_sleep_transistors_in_mats = rec.leak_power_with_sleep_transistors_in_mats;
+	res.cache_ht = rec.cache_ht;
+	res.cache_len = rec.cache_len;
+	res.vdd_periph_global = rec.vdd_periph_global;
+	res.valid = rec.valid;
+	res.data_array2 = rec.has_data ? replay_mem_array(rec.data_array2) : NULL;
+	res.tag_array2 = rec.has_tag ? replay_mem_array(rec.tag_array2) : NULL;
+
+	/* cacti_interface() leaves the globals pointing at the last array's
+	 * parameters and technology; later components rely on that. */
+	g_ip = &array->l_ip;
+	init_tech_params(g_ip->F_sz_um, false);
+	Wire winit;
+	return true;
+}
+
+void record(const ArrayST* array)
+{
+	if (!active || !cacheable(array))
+		return;
+
+	record_t rec = record_t();
+	const InputParameter& ip = array->l_ip;
+	rec.name_hash = hash_name(array->name);
+	rec.cache_sz = ip.cache_sz;
+	rec.line_sz = ip.line_sz;
+	rec.assoc = ip.assoc;
+	rec.nbanks = ip.nbanks;
+	rec.ed = ip.ed;
+	rec.delay_wt = ip.delay_wt;
+	rec.dynamic_power_wt = ip.dynamic_power_wt;
+	rec.leakage_power_wt = ip.leakage_power_wt;
+	rec.cycle_time_wt = ip.cycle_time_wt;
+	rec.area_wt = ip.area_wt;
+	rec.delay_dev = ip.delay_dev;
+	rec.dynamic_power_dev = ip.dynamic_power_dev;
+	rec.leakage_power_dev = ip.leakage_power_dev;
+	rec.cycle_time_dev = ip.cycle_time_dev;
+	rec.area_dev = ip.area_dev;
+
+	const uca_org_t& res = array->local_result;
+	rec.access_time = res.access_time;
+	rec.cycle_time = res.cycle_time;
+	rec.area = res.area;
+	rec.area_efficiency = res.area_efficiency;
+	rec.power = res.power;
+	rec.leak_power_with_sleep_transistors_in_mats = res.leak_power_with_sleep_transistors_in_mats;
+	rec.cache_ht = res.cache_ht;
+	rec.cache_len = res.cache_len;
+	rec.vdd_periph_global = res.vdd_periph_global;
+	rec.valid = res.valid;
+	rec.has_data = (res.data_array2 != NULL);
+	if (rec.has_data)
+		record_mem_array(res.data_array2, &rec.data_array2);
+	rec.has_tag = (res.tag_array2 != NULL);
+	if (rec.has_tag)
+		record_mem_array(res.tag_array2, &rec.tag_array2);
+
+	/* Misses truncate the cache, so we are always appending. */
+	records.resize(next_record);
+	records.push_back(rec);
+	next_record++;
+	dirty = true;
+}
+
+void close()
+{
+	if (active && (dirty || next_record != records.size())) {
+		records.resize(next_record);
+		save();
+	}
+	active = false;
+	records.clear();
+}
+
+}  // namespace array_cache
@@ -0,0 +1,45 @@
+/* array_cache.h - On-disk cache of ArrayST optimization results.
+ *
+ * Building a Processor runs CACTI's array optimizer for every array structure
+ * in the chip, which dominates McPAT start-up time. The results only depend on
+ * the configuration, so the first run with a given configuration records them
+ * (in construction order) and later runs replay them instead of optimizing.
+ */
+
+#ifndef ARRAY_CACHE_H_
+#define ARRAY_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+class ArrayST;
+class ParseXML;
+
+namespace array_cache {
+
+/* Bumped whenever the record layout or the optimizer changes. */
+const uint32_t VERSION = 2;
+
+/* FNV-1a. */
+uint64_t hash(const void* data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+/* Cache key for the configuration in @xml: its input parameters, field by
+ * field, and a stamp of this build. */
+uint64_t config_key(const ParseXML* xml);
+
+/* Start caching arrays for configuration @key in directory @dir.
+ * A NULL or empty @dir keeps the cache off. */
+void open(const char* dir, uint64_t key);
+
+/* Fill in @array's results from the cache. Returns false on a miss, in which
+ * case the caller optimizes the array and record()s it. */
+bool replay(ArrayST* array);
+
+void record(const ArrayST* array);
+
+/* Write back the cache file if anything was (re)computed. */
+void close();
+
+}  // namespace array_cache
+
+#endif /* ARRAY_CACHE_H_ */
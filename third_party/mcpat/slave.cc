@@ -49,6 +49,7 @@
 #include "XML_Parse.h"
 #include "processor.h"
 #include "globalvar.h"
+#include "array_cache.h"
 
 #include "mcpat.h"
 
@@ -57,13 +58,18 @@ static int print_level;
 
 using namespace std;
 
-void mcpat_initialize(ParseXML* p1, ostream *_out_file, double * cores_leakage, double * uncore_leakage, int _print_level) {
+void mcpat_initialize(ParseXML* p1, ostream *_out_file, double * cores_leakage, double * uncore_leakage, int _print_level, const char * cache_dir) {
    print_level = _print_level;
 
    opt_for_clk = true;
    out_file = _out_file;
 
+   /* Array results only depend on the configuration parameters, so that is
+      what the cache is keyed by. */
+   uint64_t cache_key = array_cache::config_key(p1);
+   array_cache::open(cache_dir, cache_key);
    proc = new Processor(p1);
+   array_cache::close();
    proc->compute();
 
    bool longer_channel = proc->XML->sys.longer_channel_device;
@@ -6,14 +6,17 @@
 #include <iostream>
 #include <fstream>
 #include <list>
+#include <queue>
 #include <stdint.h>
-#include <../DRAMSim2/DRAMSim.h>
+#include <string>
+#include <unordered_map>
+#include "DRAMSim.h"
 
 #ifdef MC_PARSE_ARGS
 if(!strcasecmp("dramsim",type))
 {
-  string config_path;
-  string part_name;
+  std::string config_path;
+  std::string part_name;
 
   char buf_config[100];
   char buf_part[100];
@@ -34,8 +37,17 @@ using namespace DRAMSim;
 class MC_dramsim_t:public MC_t
 {
   private:
+    typedef std::list<MC_action_t>::iterator req_iter_t;
+
     MultiChannelMemorySystem* mem;
+    /* Requests handed to DRAMSim and not yet returned to the caches. */
     std::list<MC_action_t> outstanding_reqs;
+    /* Requests still in DRAMSim, per address, oldest first. DRAMSim only
+       reports back the address, so this is how we find a request on a callback. */
+    std::unordered_map<md_paddr_t, std::queue<req_iter_t>> in_flight;
+    /* Requests that DRAMSim finished, in completion order, waiting for the
+       bus to go back up to the caches. */
+    std::queue<req_iter_t> completed;
 
     bool finished_init;
 
@@ -44,32 +56,34 @@ class MC_dramsim_t:public MC_t
     double accumulatedNs;
     double nextMemUpdate;
 
-    string config_path;
-    string part_name;
-
-    int mem_cycle;
+    std::string config_path;
+    std::string part_name;
 
   public:
 
-  /* Callback from DRAMSim, we use the addr to check the outstanding request list
-   */
+  /* Callback from DRAMSim, the oldest in-flight request to @addr is done. */
   void mem_complete(unsigned id, uint64_t addr, uint64_t cycle)
   {
-    // Find first outstanding request for that addr
-    std::list<MC_action_t>::iterator it;
-    bool found = false;
-    for(it = outstanding_reqs.begin(); it != outstanding_reqs.end(); it++) {
-      if((*it).addr == addr && (*it).when_finished == TICK_T_MAX) {
-        (*it).when_finished = uncore->sim_cycle;
-        total_dram_cycles += (*it).when_finished - (*it).when_started;
-        found = true;
-        break;
-      }
+    auto bucket = in_flight.find(addr);
+    assert(bucket != in_flight.end());
+    req_iter_t it = bucket->second.front();
+    bucket->second.pop();
+    if(bucket->second.empty())
+      in_flight.erase(bucket);
+
+    it->when_finished = uncore->sim_cycle;
+    total_dram_cycles += it->when_finished - it->when_started;
+
+    if(it->prev_cp)
+      completed.push(it);
+    else { /* nothing to fill (a write to dram), we're done with it */
+      it->when_returned = uncore->sim_cycle;
+      total_service_cycles += uncore->sim_cycle - it->when_enqueued;
+      outstanding_reqs.erase(it);
     }
-    assert(found);
   }
 
-  MC_dramsim_t(string dramsim_root_path, string dramsim_part_name)
+  MC_dramsim_t(std::string dramsim_root_path, std::string dramsim_part_name)
     : finished_init(false)
   {
     init();
@@ -80,13 +94,13 @@ class MC_dramsim_t:public MC_t
     // Parse memory clock period from system file
     // It is stored as ns
     std::ifstream fin;
-    string part_file_name = config_path + "/" + part_name;
-    string line;
+    std::string part_file_name = config_path + "/" + part_name;
+    std::string line;
     bool foundMemClock = false;
     fin.open(part_file_name.c_str());
     assert(fin.is_open());
     while(getline(fin, line)) {
-      if(line.find("tCK=") != string::npos) {
+      if(line.find("tCK=") != std::string::npos) {
         sscanf(line.c_str(), "%*[^=]=%lf", &memPeriodNs);
         foundMemClock = true;
         break;
@@ -164,6 +178,7 @@ class MC_dramsim_t:public MC_t
 
     assert(req->addr == (uint64_t)req->addr);
 
+    in_flight[req->addr].push(std::prev(outstanding_reqs.end()));
     mem->addTransaction(req->cmd == CACHE_WRITE, req->addr);
 
     total_accesses++;
@@ -190,48 +205,38 @@ class MC_dramsim_t:public MC_t
     // Tick the memory
     mem->update();
 
-    /* walk request queue and process requests that have completed. */
-    std::list<MC_action_t>::iterator it;
-    for(it = outstanding_reqs.begin(); it != outstanding_reqs.end(); ) {
-
+    /* return the oldest completed request, if the bus lets us
+       (only one request can go back per cycle) */
+    if(!completed.empty() && bus_free(uncore->fsb.get())) {
+      req_iter_t it = completed.front();
+      completed.pop();
       MC_action_t* req = &(*it);
 
-      if((req->when_finished <= uncore->sim_cycle) && (req->when_returned == TICK_T_MAX) && (!req->prev_cp || bus_free(uncore->fsb.get()))) {
-
-        req->when_returned = uncore->sim_cycle;
-        total_service_cycles += uncore->sim_cycle - req->when_enqueued;
-
-        /* fill previous level as appropriate */
-        if(req->prev_cp) {
-          fill_arrived(req->prev_cp,req->MSHR_bank,req->MSHR_index);
-          bus_use(uncore->fsb.get(),req->linesize>>uncore->fsb_DDR,req->cmd==CACHE_PREFETCH);
-          it = outstanding_reqs.erase(it);
-          break; /* might as well break, since only one request can writeback per cycle */
-        }
-        else { // is a write to dram (I think)
-          it = outstanding_reqs.erase(it);
-        }
-      }
-      else {
-        it++;
-      }
-    }
+      req->when_returned = uncore->sim_cycle;
+      total_service_cycles += uncore->sim_cycle - req->when_enqueued;
 
+      fill_arrived(req->prev_cp,req->MSHR_bank,req->MSHR_index);
+      bus_use(uncore->fsb.get(),req->linesize>>uncore->fsb_DDR,req->cmd==CACHE_PREFETCH);
+      outstanding_reqs.erase(it);
+    }
   }
 
   MC_PRINT_HEADER
   {
     fprintf(stderr,"<<<<< MC >>>>>\n");
-    std::list<MC_action_t>::iterator it;
+    req_iter_t it;
     int i = 0;
     for(it = outstanding_reqs.begin(); it != outstanding_reqs.end(); it++, i++) {
       fprintf(stderr,"MC[%d]: ",i);
       if((*it).op)
-        fprintf(stderr,"%p(%lld)",(*it).op,((struct uop_t*)((*it).op))->decode.uop_seq);
-      fprintf(stderr," --> %s",(*it).prev_cp->name);
+        fprintf(stderr,"%p(%" PRId64")",(*it).op,((struct uop_t*)((*it).op))->decode.uop_seq);
+      if((*it).prev_cp)
+        fprintf(stderr," --> %s",(*it).prev_cp->name);
       fprintf(stderr," MSHR[%d][%d]",(*it).MSHR_bank,(*it).MSHR_index);
+      if((*it).when_finished != TICK_T_MAX)
+        fprintf(stderr," (done)");
+      fprintf(stderr,"\n");
     }
-    fprintf(stderr,"\n");
   }
 
 };
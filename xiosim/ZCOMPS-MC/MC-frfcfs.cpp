@@ -0,0 +1,186 @@
+/* MC-frfcfs.cpp: Bank- and row-aware FR-FCFS memory controller */
+/*
+ * __COPYRIGHT__ SK
+ */
+
+#include <memory>
+#include <queue>
+#include <vector>
+
+#ifdef MC_PARSE_ARGS
+if(!strcasecmp("frfcfs",type))
+{
+  int channels;
+  int banks;
+  int interleave;
+  int RQ_size;
+  int WQ_size;
+  int WQ_high;
+  int WQ_low;
+  int starvation_cap;
+
+  if(sscanf(opt_string,"%*[^:]:%d:%d:%d:%d:%d:%d:%d:%d",&channels,&banks,&interleave,&RQ_size,&WQ_size,&WQ_high,&WQ_low,&starvation_cap) != 8)
+    fatal("bad memory controller options string %s (should be \"frfcfs:channels:banks:interleave:RQ-size:WQ-size:WQ-high:WQ-low:starvation-cap\")",opt_string);
+  return std::make_unique<MC_frfcfs_t>(channels,banks,interleave,RQ_size,WQ_size,WQ_high,WQ_low,starvation_cap);
+}
+#else
+
+/* First-ready, first-come-first-served scheduling over per-channel,
+   per-bank request queues (see frfcfs_scheduler.h).
+
+   Access latency still comes from the DRAM model, this only decides the
+   order. A channel with nothing queued costs one check per cycle, and a
+   request at the head of its bank queue that hits the open row is found
+   without scanning. */
+class MC_frfcfs_t:public MC_t
+{
+  protected:
+  std::unique_ptr<xiosim::frfcfs_scheduler_t> scheduler;
+
+  /* Indexed by scheduler slot */
+  std::vector<struct MC_action_t> requests;
+
+  /* Requests in DRAM, soonest to complete on top */
+  typedef std::pair<tick_t, int> completion_t;
+  std::priority_queue<completion_t, std::vector<completion_t>, std::greater<completion_t>> in_flight;
+
+  public:
+
+  MC_frfcfs_t(const int arg_channels,
+              const int arg_banks,
+              const int arg_interleave,
+              const int arg_RQ_size,
+              const int arg_WQ_size,
+              const int arg_WQ_high,
+              const int arg_WQ_low,
+              const int arg_starvation_cap)
+  {
+    init();
+
+    if((arg_channels <= 0) || (arg_channels & (arg_channels-1)))
+      fatal("MC channels must be a power of two");
+    if((arg_banks <= 0) || (arg_banks & (arg_banks-1)) || (arg_banks > 64))
+      fatal("MC banks must be a power of two, at most 64");
+    if((arg_interleave < 64) || (arg_interleave & (arg_interleave-1)))
+      fatal("MC channel interleaving must be a power of two, at least 64 bytes");
+    if((arg_RQ_size <= 0) || (arg_WQ_size <= 0))
+      fatal("MC read and write queues can't be empty");
+    if((arg_WQ_low < 0) || (arg_WQ_low >= arg_WQ_high) || (arg_WQ_high > arg_WQ_size))
+      fatal("MC write watermarks should be 0 <= WQ-low < WQ-high <= WQ-size");
+    if(arg_starvation_cap <= 0)
+      fatal("MC starvation cap must be positive");
+
+    scheduler = std::make_unique<xiosim::frfcfs_scheduler_t>(arg_channels, arg_banks,
+        arg_interleave, arg_RQ_size, arg_WQ_size, arg_WQ_high, arg_WQ_low, arg_starvation_cap);
+    requests.resize(arg_channels * (arg_RQ_size + arg_WQ_size));
+  }
+
+  MC_ENQUEUABLE_HEADER
+  {
+    return scheduler->enqueuable(addr);
+  }
+
+  /* Enqueue a memory command (read/write) to the memory controller. */
+  MC_ENQUEUE_HEADER
+  {
+    MC_assert(enqueuable(addr),(void)0);
+
+    int idx = scheduler->enqueue(addr, cmd == CACHE_WRITE, uncore->sim_cycle);
+    struct MC_action_t& req = requests[idx];
+
+    req.valid = true;
+    req.prev_cp = prev_cp;
+    req.cmd = cmd;
+    req.addr = addr;
+    req.linesize = linesize;
+    req.op = op;
+    req.action_id = action_id;
+    req.MSHR_bank = MSHR_bank;
+    req.MSHR_index = MSHR_index;
+    req.cb = cb;
+    req.get_action_id = get_action_id;
+    req.when_enqueued = uncore->sim_cycle;
+    req.when_started = TICK_T_MAX;
+    req.when_finished = TICK_T_MAX;
+    req.when_returned = TICK_T_MAX;
+
+    total_accesses++;
+  }
+
+  /* This is called each cycle to process the requests in the memory controller queue. */
+  MC_STEP_HEADER
+  {
+    /* Return the earliest finished request, if the bus lets us
+       (only one request can go back per cycle). */
+    if(!in_flight.empty() && (in_flight.top().first <= uncore->sim_cycle) && bus_free(uncore->fsb.get()))
+    {
+      int idx = in_flight.top().second;
+      in_flight.pop();
+      struct MC_action_t* req = &requests[idx];
+
+      req->when_returned = uncore->sim_cycle;
+      total_service_cycles += uncore->sim_cycle - req->when_enqueued;
+
+      if(req->prev_cp)
+      {
+        fill_arrived(req->prev_cp, req->MSHR_bank, req->MSHR_index);
+        bus_use(uncore->fsb.get(), req->linesize >> uncore->fsb_DDR, req->cmd == CACHE_PREFETCH);
+      }
+      req->valid = false;
+      scheduler->release(idx);
+    }
+
+    /* Send new requests to DRAM */
+    scheduler->step(uncore->sim_cycle, [this](int idx) {
+      struct MC_action_t& req = requests[idx];
+      req.when_started = uncore->sim_cycle;
+      req.when_finished = uncore->sim_cycle + dram->access(req.cmd, req.addr, req.linesize);
+      total_dram_cycles += req.when_finished - req.when_started;
+      in_flight.push(std::make_pair(req.when_finished, idx));
+      return req.when_finished;
+    });
+  }
+
+  MC_REG_STATS_HEADER
+  {
+    using namespace xiosim::stats;
+    MC_t::reg_stats(sdb);
+
+    auto& row_hits_st = stat_reg_counter(sdb, true, "MC.row_hits",
+                                         "requests sent to an open row",
+                                         &scheduler->row_hits, 0, TRUE, NULL);
+    stat_reg_counter(sdb, true, "MC.row_conflicts",
+                     "requests that closed another open row",
+                     &scheduler->row_conflicts, 0, TRUE, NULL);
+    stat_reg_counter(sdb, true, "MC.starved_issues",
+                     "requests sent in order after waiting past the starvation cap",
+                     &scheduler->starved_issues, 0, TRUE, NULL);
+    stat_reg_counter(sdb, true, "MC.write_drains",
+                     "times the write queue went over its high watermark",
+                     &scheduler->write_drains, 0, TRUE, NULL);
+    auto total_accesses_st = stat_find_stat<counter_t>(sdb, "MC.total_accesses");
+    assert(total_accesses_st != nullptr);
+    stat_reg_formula(sdb, true, "MC.row_hit_rate",
+                     "fraction of requests that hit an open row",
+                     row_hits_st / *total_accesses_st, NULL);
+  }
+
+  MC_RESET_STATS_HEADER
+  {
+    MC_t::reset_stats();
+    scheduler->row_hits = 0;
+    scheduler->row_conflicts = 0;
+    scheduler->starved_issues = 0;
+    scheduler->write_drains = 0;
+  }
+
+  MC_PRINT_HEADER
+  {
+    fprintf(stderr,"<<<<< MC >>>>>\n");
+    scheduler->print(stderr);
+    fprintf(stderr,"in DRAM: %zu\n",in_flight.size());
+  }
+
+};
+
+#endif /* MC_PARSE_ARGS */
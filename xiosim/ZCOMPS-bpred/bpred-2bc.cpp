@@ -86,13 +86,22 @@ class bpred_2bC_t:public bpred_dir_t
     MY2BC_UPDATE(*sc->current_ctr,outcome);
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(table,num_entries);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(table,num_entries);
+  }
+
   /* GET_CACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_2bC_sc_t)
   {
-    class bpred_2bC_sc_t * sc = new bpred_2bC_sc_t();
-    if(!sc)
-      fatal("couldn't malloc 2bC State Cache");
-    return sc;
+    return new (mem) bpred_2bC_sc_t();
   }
 
 };
@@ -165,13 +165,24 @@ class bpred_2lev_t:public bpred_dir_t
         bht[0] = sc->lookup_bhr;
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(bht,bht_size);
+    ckpt.put_array(pht,pht_size);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(bht,bht_size);
+    ckpt.get_array(pht,pht_size);
+  }
+
   /* GETCACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_2lev_sc_t)
   {
-    class bpred_2lev_sc_t * sc = new bpred_2lev_sc_t();
-    if(!sc)
-      fatal("couldn't malloc 2lev State Cache");
-    return sc;
+    return new (mem) bpred_2lev_sc_t();
   }
 
 
@@ -24,7 +24,6 @@ if(!strcasecmp(COMPONENT_NAME,type))
 class bpred_alloyedperceptron_t:public bpred_dir_t
 {
 #define BIPOLAR(x) (((x)<<1)-1)
-//#define BIPOLAR(x) (2*(x)-1)
 
   class bpred_alloyedperceptron_sc_t:public bpred_sc_t
   {
@@ -46,9 +45,11 @@ class bpred_alloyedperceptron_t:public bpred_dir_t
   int bhr_size;
   uint64_t bhr;
 
+  /* Table of perceptrons, one contiguous block. Each row holds the global
+     history weights, then the local history weights, then the bias. */
   int top_size;
-  short **top;  /* table of perceptrons */
-  short **ltop; /* table of perceptrons */
+  short *top;
+  int row_size;
   int weight_width;
   int weight_max;
   int weight_min;
@@ -77,6 +78,8 @@ class bpred_alloyedperceptron_t:public bpred_dir_t
     CHECK_NNEG(arg_ghistory_length);
     CHECK_NNEG(arg_lhistory_length);
     CHECK_NNEG(arg_top_size);
+    if(arg_ghistory_length > 64 || arg_lhistory_length > 64)
+      fatal("alloyedperceptron history lengths are limited to 64 bits");
 
     name = arg_name;
     type = COMPONENT_NAME;
@@ -106,19 +109,10 @@ class bpred_alloyedperceptron_t:public bpred_dir_t
     bht = (uint64_t*) calloc(bht_size,sizeof(*bht));
     if(!bht)
       fatal("couldn't malloc alloyedperceptron BHT");
-    top = (short**) calloc(top_size,sizeof(*top));
-    ltop = (short**) calloc(top_size,sizeof(*ltop));
-    if(!top || !ltop)
+    row_size = ghistory_length+lhistory_length+1;
+    top = (short*) calloc((size_t)top_size*row_size,sizeof(*top));
+    if(!top)
       fatal("couldn't malloc alloyedperceptron ToP");
-    for(int i=0;i<top_size;i++)
-    {
-      top[i] = (short*) calloc(ghistory_length,sizeof(*top[i]));
-      if(!top[i])
-        fatal("couldn't malloc alloyedperceptron ToP entry");
-      ltop[i] = (short*) calloc(lhistory_length+1,sizeof(*ltop[i]));
-      if(!ltop[i])
-        fatal("couldn't malloc alloyedperceptron ToP entry");
-    }
 
     bits = ghistory_length + bht_size*(lhistory_length)
          + top_size*(ghistory_length+lhistory_length+1)*weight_width;
@@ -127,59 +121,27 @@ class bpred_alloyedperceptron_t:public bpred_dir_t
   /* DESTROY */
   ~bpred_alloyedperceptron_t()
   {
-    for(int i=0;i<top_size;i++)
-    {
-      free(top[i]); top[i] = NULL;
-      free(ltop[i]); ltop[i] = NULL;
-    }
-    free(ltop); ltop = NULL;
     free(top); top = NULL;
     free(bht); bht = NULL;
   }
 
-  /* LOOKUP - loops unrolled by factor of 2.  This code takes a fair amount of
-     time, and so we'll do what we can to speed it up. */
+  /* LOOKUP - this code takes a fair amount of time, so the dot products go
+     through the vectorized perceptron kernels. */
   BPRED_LOOKUP_HEADER
   {
     class bpred_alloyedperceptron_sc_t * sc = (class bpred_alloyedperceptron_sc_t*) scvp;
     int l1index = PC&bht_mask;
     bool pred;
     int top_index = PC%top_size;
-    int x1; /* temporary */
-    int y1; /* temporary */
 
     sc->lbhr = &bht[l1index];
-    sc->top_entry = top[top_index];
-    sc->ltop_entry = ltop[top_index];
-    sc->sum = 0;
+    sc->top_entry = &top[top_index*row_size];
+    sc->ltop_entry = sc->top_entry + ghistory_length;
     sc->updated = false;
 
-    for(int i=0;i<ghistory_length;i++)
-    {
-      /* add top_entry[i] if bit i in bhr is a one, subtract if zero */
-      /* This is what one iteration used to do:
-         if((*sc->bhr>>i)&1)
-           sc->sum += sc->top_entry[i];
-         else
-           sc->sum -= sc->top_entry[i];
-       */
-      x1 = ((bhr>>i)&1);
-      y1 = ((x1-1)^sc->top_entry[i])+(1-x1);  /* cond. negative: gives 2's complement if x1==0 */
-      sc->sum += y1;
-    }
-    for(int i=0;i<lhistory_length;i++)
-    {
-      /* add top_entry[i] if bit i in bhr is a one, subtract if zero */
-      /* This is what one iteration used to do:
-         if((*sc->bhr>>i)&1)
-           sc->sum += sc->top_entry[i];
-         else
-           sc->sum -= sc->top_entry[i];
-       */
-      x1 = ((*sc->lbhr>>i)&1);
-      y1 = ((x1-1)^sc->ltop_entry[i])+(1-x1);  /* cond. negative: gives 2's complement if x1==0 */
-      sc->sum += y1;
-    }
+    /* add top_entry[i] if bit i in bhr is a one, subtract if zero */
+    sc->sum = xiosim::bpred::perceptron_dot(sc->top_entry,&bhr,ghistory_length)
+            + xiosim::bpred::perceptron_dot(sc->ltop_entry,sc->lbhr,lhistory_length);
     sc->sum += sc->ltop_entry[lhistory_length]; /* last entry corresponds to w_0, i.e. the bias */
 
     pred = sc->sum >= 0;
@@ -197,8 +159,6 @@ class bpred_alloyedperceptron_t:public bpred_dir_t
     class bpred_alloyedperceptron_sc_t * sc = (class bpred_alloyedperceptron_sc_t*) scvp;
     int y_out;
     int t = BIPOLAR(outcome); /* make bipolar */
-    int x; /* temporary */
-    int diff;
 
     if(!sc->updated)
     {
@@ -222,42 +182,14 @@ class bpred_alloyedperceptron_t:public bpred_dir_t
        training */
     if(y_out != t)
     {
-      for(int i=0;i<ghistory_length;i++)
-      {
-        //diff = t*BIPOLAR((*sc->bhr>>i)&1);
-        x = ((sc->lookup_bhr>>i)&1);
-        diff = ((x-1)^t)+(1-x);
-        if(diff > 0)
-        {
-          if(sc->top_entry[i] < weight_max)
-            sc->top_entry[i] ++;
-        }
-        else
-        {
-          if(sc->top_entry[i] > weight_min)
-            sc->top_entry[i] --;
-        }
-      }
-      for(int i=0;i<lhistory_length+1;i++)
-      {
-        if(i < lhistory_length)
-        {
-          //diff = t*BIPOLAR((*sc->bhr>>i)&1);
-          x = ((*sc->lbhr>>i)&1);
-          diff = ((x-1)^t)+(1-x);
-        }
-        else /* w_0 */
-          diff = t;
-        if(diff > 0)
-        {
-          if(sc->ltop_entry[i] < weight_max)
-            sc->ltop_entry[i] ++;
-        }
-        else
-        {
-          if(sc->ltop_entry[i] > weight_min)
-            sc->ltop_entry[i] --;
-        }
+      xiosim::bpred::perceptron_train(sc->top_entry,&sc->lookup_bhr,ghistory_length,outcome,weight_min,weight_max);
+      xiosim::bpred::perceptron_train(sc->ltop_entry,sc->lbhr,lhistory_length,outcome,weight_min,weight_max);
+      /* w_0 */
+      short * bias = &sc->ltop_entry[lhistory_length];
+      if(outcome) {
+        if(*bias < weight_max) (*bias)++;
+      } else {
+        if(*bias > weight_min) (*bias)--;
       }
     }
 
@@ -303,13 +235,26 @@ class bpred_alloyedperceptron_t:public bpred_dir_t
     stat_reg_int(sdb, true, buf, buf2, &weight_width, weight_width, FALSE, NULL);
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(bht,bht_size);
+    ckpt.put(bhr);
+    ckpt.put_array(top,(size_t)top_size*row_size);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(bht,bht_size);
+    ckpt.get_array(&bhr,1);
+    ckpt.get_array(top,(size_t)top_size*row_size);
+  }
+
   /* GETCACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_alloyedperceptron_sc_t)
   {
-    class bpred_alloyedperceptron_sc_t * sc = new bpred_alloyedperceptron_sc_t();
-    if(!sc)
-      fatal("couldn't malloc alloyedperceptron State Cache");
-    return sc;
+    return new (mem) bpred_alloyedperceptron_sc_t();
   }
 
 };
@@ -199,13 +199,28 @@ class bpred_bimode_t:public bpred_dir_t
       bht[0] = sc->lookup_bhr;
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(bht,bht_size);
+    ckpt.put_array(pht[0],pht_size);
+    ckpt.put_array(pht[1],pht_size);
+    ckpt.put_array(pht_meta,pht_size);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(bht,bht_size);
+    ckpt.get_array(pht[0],pht_size);
+    ckpt.get_array(pht[1],pht_size);
+    ckpt.get_array(pht_meta,pht_size);
+  }
+
   /* GET_CACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_bimode_sc_t)
   {
-    class bpred_bimode_sc_t * sc = new bpred_bimode_sc_t();
-    if(!sc)
-      fatal("couldn't malloc bimode State Cache");
-    return sc;
+    return new (mem) bpred_bimode_sc_t();
   }
 
 };
@@ -400,13 +400,34 @@ class bpred_blg_t:public bpred_dir_t
       L_hist[sc->L_hist_index] = sc->lookup_L_hist;
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(B,B_size);
+    ckpt.put_array(L_hist,L_hist_size);
+    ckpt.put_array(L_tag,L_hist_size);
+    ckpt.put_array(L,L_size);
+    ckpt.put_array(G,G_size);
+    ckpt.put_array(G_tag,G_size);
+    ckpt.put(stew);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(B,B_size);
+    ckpt.get_array(L_hist,L_hist_size);
+    ckpt.get_array(L_tag,L_hist_size);
+    ckpt.get_array(L,L_size);
+    ckpt.get_array(G,G_size);
+    ckpt.get_array(G_tag,G_size);
+    ckpt.get_array(&stew,1);
+  }
+
   /* GET_CACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_blg_sc_t)
   {
-    class bpred_blg_sc_t * sc = new bpred_blg_sc_t();
-    if(!sc)
-      fatal("couldn't malloc blg State Cache");
-    return sc;
+    return new (mem) bpred_blg_sc_t();
   }
 
 };
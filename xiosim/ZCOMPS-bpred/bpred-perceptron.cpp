@@ -17,9 +17,6 @@ if(!strcasecmp(COMPONENT_NAME,type))
 }
 #else
 
-#define BIPOLAR(x) (((x)<<1)-1)
-//#define BIPOLAR(x) (2*(x)-1)
-
 class bpred_perceptron_t:public bpred_dir_t
 {
 
@@ -40,7 +37,8 @@ class bpred_perceptron_t:public bpred_dir_t
 
   int top_size;
   int top_mask;
-  short **top; /* table of perceptrons */
+  short *top; /* table of perceptrons, top_size rows of [bias, weights...] */
+  int row_size;
   int weight_width;
   int weight_max;
   int weight_min;
@@ -63,6 +61,8 @@ class bpred_perceptron_t:public bpred_dir_t
     /* verify arguments are valid */
     CHECK_NNEG(arg_history_length);
     CHECK_PPOW2(arg_top_size);
+    if(arg_history_length > 128)
+      fatal("perceptron history length is limited to 128 bits");
 
     name = arg_name;
     type = COMPONENT_NAME;
@@ -87,15 +87,11 @@ class bpred_perceptron_t:public bpred_dir_t
 
     bhr = 0;
     bhr_old = 0;
-    top = (short**) calloc(top_size,sizeof(*top));
+    /* one contiguous block, so the dot product streams through a row */
+    row_size = 1+history_length;
+    top = (short*) calloc((size_t)top_size*row_size,sizeof(*top));
     if(!top)
       fatal("couldn't malloc perceptron ToP");
-    for(int i=0;i<top_size;i++)
-    {
-      top[i] = (short*) calloc(1+history_length,sizeof(*top[i]));
-      if(!top[i])
-        fatal("couldn't malloc perceptron ToP entry");
-    }
 
     bits =  history_length
          + top_size*(history_length+1)*weight_width;
@@ -104,11 +100,6 @@ class bpred_perceptron_t:public bpred_dir_t
   /* DESTROY */
   ~bpred_perceptron_t()
   {
-    for(int i=0;i<top_size;i++)
-    {
-      free(top[i]);
-      top[i] = NULL;
-    }
     free(top); top = NULL;
   }
 
@@ -119,16 +110,9 @@ class bpred_perceptron_t:public bpred_dir_t
     bool pred;
     int top_index = PC&top_mask;
 
-    sc->top_entry = top[top_index];
-    sc->sum = sc->top_entry[0];
-
-    for(int i=0;i<history_length;i++)
-    {
-      int hist_dir;
-      if(i<64) hist_dir = BIPOLAR((bhr>>i)&1);
-      else     hist_dir = BIPOLAR((bhr_old>>(i-64))&1);
-      sc->sum += sc->top_entry[i+1]*hist_dir;
-    }
+    const uint64_t hist[2] = {bhr, bhr_old};
+    sc->top_entry = &top[top_index*row_size];
+    sc->sum = sc->top_entry[0] + xiosim::bpred::perceptron_dot(sc->top_entry+1,hist,history_length);
 
     pred = sc->sum >= 0;
     sc->lookup_bhr_old = bhr_old;
@@ -153,17 +137,8 @@ class bpred_perceptron_t:public bpred_dir_t
       } else {
           if(sc->top_entry[0] > weight_min) sc->top_entry[0]--;
       }
-      for(int i=0;i<history_length;i++)
-      {
-        int hist_bit;
-        if(i<64) hist_bit = (sc->lookup_bhr>>i)&1;
-        else     hist_bit = (sc->lookup_bhr_old>>(i-64))&1;
-        if(hist_bit == outcome) {
-          if(sc->top_entry[i+1] < weight_max) sc->top_entry[i+1]++;
-        } else {
-          if(sc->top_entry[i+1] > weight_min) sc->top_entry[i+1]--;
-        }
-      }
+      const uint64_t hist[2] = {sc->lookup_bhr, sc->lookup_bhr_old};
+      xiosim::bpred::perceptron_train(sc->top_entry+1,hist,history_length,outcome,weight_min,weight_max);
     }
 
     if(!sc->updated)
@@ -216,17 +191,29 @@ class bpred_perceptron_t:public bpred_dir_t
     stat_reg_int(sdb, true, buf, buf2, &weight_width, weight_width, FALSE, NULL);
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put(bhr);
+    ckpt.put(bhr_old);
+    ckpt.put_array(top,(size_t)top_size*row_size);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(&bhr,1);
+    ckpt.get_array(&bhr_old,1);
+    ckpt.get_array(top,(size_t)top_size*row_size);
+  }
+
   /* GET_CACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_perceptron_sc_t)
   {
-    class bpred_perceptron_sc_t * sc = new bpred_perceptron_sc_t();
-    if(!sc)
-      fatal("couldn't malloc perceptron State Cache");
-    return sc;
+    return new (mem) bpred_perceptron_sc_t();
   }
 
 };
 
-#undef BIPOLAR
 #endif /* BPRED_PARSE_ARGS */
 #undef COMPONENT_NAME
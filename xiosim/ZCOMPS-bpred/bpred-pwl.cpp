@@ -22,9 +22,6 @@ if(!strcasecmp(COMPONENT_NAME,type))
 
 class bpred_pwl_t:public bpred_dir_t
 {
-#define BIPOLAR(x) (((x)<<1)-1)
-//#define BIPOLAR(x) (2*(x)-1)
-
 #define MAX_PATHNEURAL_PATH 128
 
   class bpred_pwl_sc_t:public bpred_sc_t
@@ -47,7 +44,8 @@ class bpred_pwl_t:public bpred_dir_t
   uint64_t * bht;
   int top_size;
   int top_mask;
-  short **top; /* table of pwls */
+  short *top; /* table of pwls, top_size rows of [bias, weights...] */
+  int row_size;
   int weight_width;
   int weight_max;
   int weight_min;
@@ -75,6 +73,8 @@ class bpred_pwl_t:public bpred_dir_t
     /* verify arguments are valid */
     CHECK_PPOW2(arg_bht_size);
     CHECK_NNEG(arg_history_length);
+    if(arg_history_length > 64)
+      fatal("pwl history length is limited to 64 bits");
 
     name = arg_name;
     type = COMPONENT_NAME;
@@ -107,15 +107,10 @@ class bpred_pwl_t:public bpred_dir_t
     bht = (uint64_t*) calloc(bht_size,sizeof(*bht));
     if(!bht)
       fatal("couldn't malloc pwl BHT");
-    top = (short**) calloc(top_size,sizeof(*top));
+    row_size = 1+history_length;
+    top = (short*) calloc((size_t)top_size*row_size,sizeof(*top));
     if(!top)
       fatal("couldn't malloc pwl ToP");
-    for(int i=0;i<top_size;i++)
-    {
-      top[i] = (short*) calloc(1+history_length,sizeof(*top[i]));
-      if(!top[i])
-        fatal("couldn't malloc pwl ToP entry");
-    }
 
     memset(path,0,sizeof(*path)*MAX_PATHNEURAL_PATH);
     path_head = 0;
@@ -128,37 +123,45 @@ class bpred_pwl_t:public bpred_dir_t
   /* DESTROY */
   ~bpred_pwl_t()
   {
-    for(int i=0;i<top_size;i++)
-    {
-      free(top[i]); top[i] = NULL;
-    }
     free(top); top = NULL;
     free(bht); bht = NULL;
   }
 
+  /* Weight i comes from the row picked by the i-th most recent branch on the
+     path and this branch's PC. Collect them (and where they live) into one
+     vector for the perceptron kernels. */
+  void gather_weights(const md_addr_t PC, const md_addr_t * lookup_path, short ** slots, short * weights)
+  {
+    for(int i=0;i<history_length;i++)
+    {
+      md_addr_t addr = lookup_path[history_length-1-i];
+      slots[i] = &top[((((addr&top_mask)<<pc_bits)^(PC&pc_mask))%top_size)*row_size + i+1];
+      weights[i] = *slots[i];
+    }
+  }
+
   BPRED_LOOKUP_HEADER
   {
     class bpred_pwl_sc_t * sc = (class bpred_pwl_sc_t*) scvp;
     int l1index = PC&bht_mask;
     bool pred;
     int i;
+    short * slots[MAX_PATHNEURAL_PATH];
+    short weights[MAX_PATHNEURAL_PATH];
 
     sc->bhr = &bht[l1index];
-    sc->sum = top[(PC&top_mask)%top_size][0];
     for(i=0;i<history_length;i++)
     {
-        int hist_dir = ((*sc->bhr >> i) & 1) ? 1:-1;
-        md_addr_t addr = path[(path_head - i + MAX_PATHNEURAL_PATH) % MAX_PATHNEURAL_PATH];
-        sc->sum += hist_dir * top[(((addr&top_mask)<<pc_bits)^(PC&pc_mask))%top_size][i+1];
+        sc->lookup_path[history_length-i-1] = path[(path_head - i + MAX_PATHNEURAL_PATH)%MAX_PATHNEURAL_PATH];
     }
 
+    gather_weights(PC,sc->lookup_path,slots,weights);
+    sc->sum = top[((PC&top_mask)%top_size)*row_size]
+            + xiosim::bpred::perceptron_dot(weights,sc->bhr,history_length);
+
     pred = (sc->sum >= 0);
     sc->lookup_PC = PC;
     sc->lookup_bhr = *sc->bhr;
-    for(i=0;i<history_length;i++)
-    {
-        sc->lookup_path[history_length-i-1] = path[(path_head - i + MAX_PATHNEURAL_PATH)%MAX_PATHNEURAL_PATH];
-    }
 
     BPRED_STAT(lookups++;)
     sc->updated = false;
@@ -170,7 +173,6 @@ class bpred_pwl_t:public bpred_dir_t
   BPRED_UPDATE_HEADER
   {
     class bpred_pwl_sc_t * sc = (class bpred_pwl_sc_t*) scvp;
-    int i;
 
     if(!sc->updated)
     {
@@ -182,23 +184,20 @@ class bpred_pwl_t:public bpred_dir_t
     if(((sc->sum >= 0) != outcome) || ((sc->sum > -theta) && (sc->sum <theta)))
     {
         short * weight;
-        weight = &top[(PC&top_mask)%top_size][0];
+        weight = &top[((PC&top_mask)%top_size)*row_size];
         if(outcome) {
             if(*weight < weight_max) ++*weight;
         } else {
             if(*weight > weight_min) --*weight;
         }
 
-        for(i=0;i<history_length;i++)
-        {
-          md_addr_t addr = sc->lookup_path[history_length-1-i];
-          weight = &top[(((addr&top_mask)<<pc_bits)^(PC&pc_mask))%top_size][i+1];
-          if( ((sc->lookup_bhr>>i)&1) == (unsigned)outcome ) {
-              if(*weight < weight_max) ++*weight;
-          } else {
-              if(*weight > weight_min) --*weight;
-          }
-        }
+        short * slots[MAX_PATHNEURAL_PATH];
+        short weights[MAX_PATHNEURAL_PATH];
+        gather_weights(PC,sc->lookup_path,slots,weights);
+        xiosim::bpred::perceptron_train(weights,&sc->lookup_bhr,history_length,outcome,weight_min,weight_max);
+        /* each position is its own column, so slots never repeat */
+        for(int i=0;i<history_length;i++)
+          *slots[i] = weights[i];
     }
 
   }
@@ -256,17 +255,31 @@ class bpred_pwl_t:public bpred_dir_t
     stat_reg_int(sdb, true, buf, buf2, &weight_width, weight_width, FALSE, NULL);
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(bht,bht_size);
+    ckpt.put_array(top,(size_t)top_size*row_size);
+    ckpt.put_array(path,MAX_PATHNEURAL_PATH);
+    ckpt.put(path_head);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(bht,bht_size);
+    ckpt.get_array(top,(size_t)top_size*row_size);
+    ckpt.get_array(path,MAX_PATHNEURAL_PATH);
+    ckpt.get_array(&path_head,1);
+  }
+
   /* GET_CACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_pwl_sc_t)
   {
-    class bpred_pwl_sc_t * sc = new bpred_pwl_sc_t();
-    if(!sc)
-      fatal("couldn't malloc pwl State Cache");
-    return sc;
+    return new (mem) bpred_pwl_sc_t();
   }
 
 };
 
-#undef BIPOLAR
 #endif /* BPRED_PARSE_ARGS */
 #undef COMPONENT_NAME
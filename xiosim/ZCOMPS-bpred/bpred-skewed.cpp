@@ -241,13 +241,28 @@ class bpred_skewed_t:public bpred_dir_t
       bht[0] = sc->lookup_bhr;
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(bht,bht_size);
+    ckpt.put_array(pht[0],double_bim ? 2*pht_size : pht_size);
+    ckpt.put_array(pht[1],pht_size);
+    ckpt.put_array(pht[2],pht_size);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(bht,bht_size);
+    ckpt.get_array(pht[0],double_bim ? 2*pht_size : pht_size);
+    ckpt.get_array(pht[1],pht_size);
+    ckpt.get_array(pht[2],pht_size);
+  }
+
   /* GET_CACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_skewed_sc_t)
   {
-    class bpred_skewed_sc_t * sc = new bpred_skewed_sc_t();
-    if(!sc)
-      fatal("couldn't malloc skewed State Cache");
-    return sc;
+    return new (mem) bpred_skewed_sc_t();
   }
 
 };
@@ -27,8 +27,9 @@ class bpred_tage_t:public bpred_dir_t
 {
 #define TAGE_MAX_HIST 512
 #define TAGE_MAX_TABLES 16
-
-  typedef uint64_t bpred_tage_hist_t[8]; /* Max length: 8 * 64 = 512 */
+/* Global history ring, in bits. Needs to cover TAGE_MAX_HIST plus however
+   many wrong-path branches can be spec-updated before a recovery. */
+#define TAGE_GHIST_SIZE 4096
 
   struct bpred_tage_ent_t
   {
@@ -37,12 +38,24 @@ class bpred_tage_t:public bpred_dir_t
     char u;
   };
 
+  /* Global history folded down to index width and to the two tag widths
+     (circular shift registers, one per tagged table) [Michaud, JILP 2005] */
+  struct bpred_tage_folds_t
+  {
+    uint32_t idx[TAGE_MAX_TABLES];
+    uint32_t tag0[TAGE_MAX_TABLES];
+    uint32_t tag1[TAGE_MAX_TABLES];
+  };
+
   class bpred_tage_sc_t:public bpred_sc_t
   {
     public:
     my2bc_t * current_ctr;
-    bpred_tage_hist_t lookup_bhr;
+    /* history state at lookup (used for recovery) */
+    bpred_tage_folds_t lookup_folds;
+    uint64_t lookup_ghead;
     int index[TAGE_MAX_TABLES];
+    int tag[TAGE_MAX_TABLES];
     int provider;
     int provpred;
     int alt;
@@ -53,57 +66,58 @@ class bpred_tage_t:public bpred_dir_t
 
   private:
 
-  inline void bpred_tage_hist_update(bpred_tage_hist_t H, int outcome)
+  /* Shift @in into a @clen-bit fold of the last Hlen history bits; @out is
+     the bit that just fell off the end, which was folded in at @outpoint. */
+  static inline uint32_t bpred_tage_fold(uint32_t comp, uint32_t in, uint32_t out, int outpoint, int clen)
   {
-    H[7] <<= 1; H[7] |= (H[6]>>63)&1;
-    H[6] <<= 1; H[6] |= (H[5]>>63)&1;
-    H[5] <<= 1; H[5] |= (H[4]>>63)&1;
-    H[4] <<= 1; H[4] |= (H[3]>>63)&1;
-    H[3] <<= 1; H[3] |= (H[2]>>63)&1;
-    H[2] <<= 1; H[2] |= (H[1]>>63)&1;
-    H[1] <<= 1; H[1] |= (H[0]>>63)&1;
-    H[0] <<= 1; H[0] |= outcome&1;
+    comp = (comp<<1) | in;
+    comp ^= out << outpoint;
+    comp ^= comp >> clen;
+    return comp & ((1u<<clen)-1);
   }
 
-  inline void bpred_tage_hist_copy(bpred_tage_hist_t D /*dest*/, bpred_tage_hist_t S /*src*/)
+  /* Bit @age of the global history (0 is the most recent branch) */
+  inline int bpred_tage_ghist(int age) const
   {
-    D[0] = S[0];
-    D[1] = S[1];
-    D[2] = S[2];
-    D[3] = S[3];
-    D[4] = S[4];
-    D[5] = S[5];
-    D[6] = S[6];
-    D[7] = S[7];
+    return ghist[(ghead - age) & (TAGE_GHIST_SIZE-1)];
   }
 
-  int bpred_tage_hist_hash(bpred_tage_hist_t H, int hist_length, int hash_length)
+  /* Shift @outcome into the global history. O(1) per table, independent of
+     history lengths. */
+  void bpred_tage_hist_update(int outcome)
   {
-    int result = 0;
-    int i;
-    int mask = (1<<hash_length)-1;
-    int row=0;
-    int pos=0;
-    for(i=0;i<hist_length/hash_length;i++)
+    uint32_t out[TAGE_MAX_TABLES];
+
+    ghead++;
+    ghist[ghead & (TAGE_GHIST_SIZE-1)] = outcome & 1;
+
+    for(int i=1;i<num_tables;i++)
+      out[i] = bpred_tage_ghist(Hlen[i]);
+    for(int i=1;i<num_tables;i++)
     {
-      result ^= (H[row]>>pos) & mask;
-      if(pos+hash_length > 64) /* wrap past end of current uint64_t */
-      {
-        row++;
-        pos = (pos+hash_length)&63;
-        result ^= (H[row]<<(hash_length-pos))&mask;
-      }
-      else /* includes when pos+HL is exactly 64 */
-      {
-        pos = pos+hash_length;
-        if(pos > 63)
-        {
-          pos &=63;
-          row++;
-        }
-      }
+      folds.idx[i] = bpred_tage_fold(folds.idx[i],outcome&1,out[i],idx_outpoint[i],log_size);
+      folds.tag0[i] = bpred_tage_fold(folds.tag0[i],outcome&1,out[i],tag0_outpoint[i],tag_width);
+      folds.tag1[i] = bpred_tage_fold(folds.tag1[i],outcome&1,out[i],tag1_outpoint[i],tag1_width);
     }
-    return result;
+  }
+
+  /* Recompute the ring and all folds from a flat copy of the history
+     (bit i of word i/64 is history bit i), as stored in checkpoints. */
+  void bpred_tage_hist_load(const uint64_t * H)
+  {
+    memset(ghist,0,sizeof(ghist));
+    memset(&folds,0,sizeof(folds));
+    ghead = 0;
+    for(int i=TAGE_MAX_HIST-1;i>=0;i--)
+      bpred_tage_hist_update((H[i/64]>>(i%64))&1);
+  }
+
+  void bpred_tage_hist_store(uint64_t * H) const
+  {
+    for(int i=0;i<TAGE_MAX_HIST/64;i++)
+      H[i] = 0;
+    for(int i=0;i<TAGE_MAX_HIST;i++)
+      H[i/64] |= ((uint64_t)bpred_tage_ghist(i))<<(i%64);
   }
 
   protected:
@@ -113,6 +127,7 @@ class bpred_tage_t:public bpred_dir_t
   int log_size;
   int table_mask;
   int tag_width;
+  int tag1_width;
   int tag_mask;
 
   int bim_size;
@@ -125,7 +140,13 @@ class bpred_tage_t:public bpred_dir_t
 
   counter_t * Tuses;
 
-  bpred_tage_hist_t bhr;
+  uint8_t ghist[TAGE_GHIST_SIZE]; /* one history bit per byte, newest at ghead */
+  uint64_t ghead; /* branches shifted in so far; not wrapped, so we can tell how far
+                     the wrong path got past a lookup */
+  bpred_tage_folds_t folds;
+  int idx_outpoint[TAGE_MAX_TABLES];
+  int tag0_outpoint[TAGE_MAX_TABLES];
+  int tag1_outpoint[TAGE_MAX_TABLES];
 
   /* For generating random numbers without touching any global state */
   std::random_device random_device;
@@ -160,8 +181,9 @@ class bpred_tage_t:public bpred_dir_t
     CHECK_POS_LT(arg_num_tables,TAGE_MAX_TABLES);
     CHECK_POS_LEQ(arg_last_length,TAGE_MAX_HIST);
 
-    for(i=0;i<8;i++)
-      bhr[i] = 0;
+    memset(ghist,0,sizeof(ghist));
+    ghead = 0;
+    memset(&folds,0,sizeof(folds));
 
     name = arg_name;
     type = COMPONENT_NAME;
@@ -191,8 +213,16 @@ class bpred_tage_t:public bpred_dir_t
       fatal("couldn't calloc tage T array");
 
     tag_width = arg_tag_width;
+    tag1_width = (arg_tag_width > 1) ? arg_tag_width-1 : 1;
     tag_mask = (1<<arg_tag_width)-1;
 
+    for(i=1;i<num_tables;i++)
+    {
+      idx_outpoint[i] = Hlen[i] % log_size;
+      tag0_outpoint[i] = Hlen[i] % tag_width;
+      tag1_outpoint[i] = Hlen[i] % tag1_width;
+    }
+
     for(i=0;i<num_tables;i++)
     {
       if(i>0)
@@ -241,13 +271,14 @@ class bpred_tage_t:public bpred_dir_t
   BPRED_LOOKUP_HEADER
   {
     class bpred_tage_sc_t * sc = (class bpred_tage_sc_t*) scvp;
+    const uint32_t pc = (uint32_t)PC;
 
-    for(int i=0;i<num_tables;i++)
+    /* no dependencies between tables, so this vectorizes */
+    sc->index[0] = PC;
+    for(int i=1;i<num_tables;i++)
     {
-      if(i==0)
-        sc->index[i] = PC;
-      else
-        sc->index[i] = PC^bpred_tage_hist_hash(bhr,Hlen[i],log_size);
+      sc->index[i] = (pc ^ folds.idx[i]) & table_mask;
+      sc->tag[i] = (pc ^ folds.tag0[i] ^ (folds.tag1[i]<<1)) & tag_mask;
     }
     sc->provider = 0;
     sc->provpred = 0;
@@ -259,7 +290,7 @@ class bpred_tage_t:public bpred_dir_t
     for(int i=num_tables-1;i>0;i--)
     {
       struct bpred_tage_ent_t * ent = &T[i][sc->index[i]&table_mask];
-      if(((unsigned)ent->tag) == (PC&tag_mask))
+      if(ent->tag == sc->tag[i])
       {
         sc->provnew = !ent->u && ((ent->ctr==4) || (ent->ctr==3));
         if((pwin < 8) || !sc->provnew)
@@ -277,7 +308,7 @@ class bpred_tage_t:public bpred_dir_t
       for(int i=sc->provider-1;i>0;i--)
       {
         struct bpred_tage_ent_t * ent = &T[i][sc->index[i]&table_mask];
-        if((unsigned)ent->tag == (PC&tag_mask))
+        if(ent->tag == sc->tag[i])
         {
           sc->altpred = (ent->ctr >= 4);
           sc->alt = i;
@@ -295,7 +326,8 @@ class bpred_tage_t:public bpred_dir_t
     sc->updated = false;
 
     BPRED_STAT(lookups++;)
-    bpred_tage_hist_copy(sc->lookup_bhr,bhr);
+    sc->lookup_folds = folds;
+    sc->lookup_ghead = ghead;
 
     if(!pwin_hit)
     {
@@ -376,7 +408,7 @@ class bpred_tage_t:public bpred_dir_t
             struct bpred_tage_ent_t * ent = &T[allocated][sc->index[allocated]&table_mask];
             ent->u = 0;
             ent->ctr = 3+outcome;
-            ent->tag = PC & tag_mask;
+            ent->tag = sc->tag[allocated];
           }
           else
           {
@@ -440,22 +472,35 @@ class bpred_tage_t:public bpred_dir_t
   BPRED_SPEC_UPDATE_HEADER
   {
     BPRED_STAT(spec_updates++;)
-    bpred_tage_hist_update(bhr,our_pred);
+    bpred_tage_hist_update(our_pred);
+  }
+
+  /* Ring entries up to lookup_ghead are still intact (wrong-path branches
+     only wrote past it), so restoring the head and the folds is enough --
+     as long as the wrong path didn't wrap around the ring onto the last
+     Hlen bits before the lookup, which the next update reads back. */
+  inline void bpred_tage_check_spec_depth(const bpred_tage_sc_t * sc) const
+  {
+    assert(ghead - sc->lookup_ghead <= (uint64_t)(TAGE_GHIST_SIZE - Hlen[num_tables-1]));
   }
 
   BPRED_RECOVER_HEADER
   {
     class bpred_tage_sc_t * sc = (class bpred_tage_sc_t*) scvp;
 
-    bpred_tage_hist_copy(bhr,sc->lookup_bhr);
-    bpred_tage_hist_update(bhr,outcome);
+    bpred_tage_check_spec_depth(sc);
+    folds = sc->lookup_folds;
+    ghead = sc->lookup_ghead;
+    bpred_tage_hist_update(outcome);
   }
 
   BPRED_FLUSH_HEADER
   {
     class bpred_tage_sc_t * sc = (class bpred_tage_sc_t*) scvp;
 
-    bpred_tage_hist_copy(bhr,sc->lookup_bhr);
+    bpred_tage_check_spec_depth(sc);
+    folds = sc->lookup_folds;
+    ghead = sc->lookup_ghead;
   }
 
   /* REG_STATS */
@@ -474,13 +519,34 @@ class bpred_tage_t:public bpred_dir_t
     }
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(T[0],bim_size);
+    for(int i=1;i<num_tables;i++)
+      ckpt.put_array(T[i],table_size);
+    uint64_t bhr[TAGE_MAX_HIST/64];
+    bpred_tage_hist_store(bhr);
+    ckpt.put_array(bhr,TAGE_MAX_HIST/64);
+    ckpt.put(pwin);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(T[0],bim_size);
+    for(int i=1;i<num_tables;i++)
+      ckpt.get_array(T[i],table_size);
+    uint64_t bhr[TAGE_MAX_HIST/64];
+    ckpt.get_array(bhr,TAGE_MAX_HIST/64);
+    bpred_tage_hist_load(bhr);
+    ckpt.get_array(&pwin,1);
+  }
+
   /* GETCACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_tage_sc_t)
   {
-    class bpred_tage_sc_t * sc = new bpred_tage_sc_t();
-    if(!sc)
-      fatal("couldn't malloc tage State Cache");
-    return sc;
+    return new (mem) bpred_tage_sc_t();
   }
 
   int get_local_size(void) { return (num_tables-1)*table_size; }
@@ -231,13 +231,28 @@ class bpred_yags_t:public bpred_dir_t
       bht[0] = sc->lookup_bhr;
   }
 
+  /* SAVE */
+  BPRED_SAVE_HEADER
+  {
+    ckpt.put_array(bht,bht_size);
+    ckpt.put_array(pht,pht_size);
+    ckpt.put_array(T_cache,cache_size);
+    ckpt.put_array(NT_cache,cache_size);
+  }
+
+  /* RESTORE */
+  BPRED_RESTORE_HEADER
+  {
+    ckpt.get_array(bht,bht_size);
+    ckpt.get_array(pht,pht_size);
+    ckpt.get_array(T_cache,cache_size);
+    ckpt.get_array(NT_cache,cache_size);
+  }
+
   /* GET_CACHE */
-  BPRED_GET_CACHE_HEADER
+  BPRED_GET_CACHE_HEADER(bpred_yags_sc_t)
   {
-    class bpred_yags_sc_t * sc = new bpred_yags_sc_t();
-    if(!sc)
-      fatal("couldn't malloc yags State Cache");
-    return sc;
+    return new (mem) bpred_yags_sc_t();
   }
 
 };
@@ -343,13 +343,34 @@ class BTB_2levbtac_t:public BTB_t
       bht[0] = sc->lookup_bhr;
   }
 
+  /* SAVE */
+  BTB_SAVE_HEADER
+  {
+    ckpt.put_array(bht,bht_size);
+    for(int i=0;i<num_entries;i++)
+      for(struct BTB_2levbtac_Entry_t * p = set[i]; p; p = p->next)
+      {
+        ckpt.put(p->PC);
+        ckpt.put(p->target);
+      }
+  }
+
+  /* RESTORE */
+  BTB_RESTORE_HEADER
+  {
+    ckpt.get_array(bht,bht_size);
+    for(int i=0;i<num_entries;i++)
+      for(struct BTB_2levbtac_Entry_t * p = set[i]; p; p = p->next)
+      {
+        ckpt.get_array(&p->PC,1);
+        ckpt.get_array(&p->target,1);
+      }
+  }
+
   /* GET_CACHE */
-  BTB_GET_CACHE_HEADER
+  BTB_GET_CACHE_HEADER(BTB_2levbtac_sc_t)
   {
-    class BTB_2levbtac_sc_t * sc = new BTB_2levbtac_sc_t();
-    if(!sc)
-      fatal("couldn't malloc 2levbtac state cache");
-    return sc;
+    return new (mem) BTB_2levbtac_sc_t();
   }
 
   int get_num_entries(void) { return num_entries; }
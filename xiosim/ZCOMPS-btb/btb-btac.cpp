@@ -243,13 +243,34 @@ class BTB_btac_t:public BTB_t
     }
   }
 
+  /* SAVE */
+  /* Entries in recency order; the entries are interchangeable, so
+     that's all it takes to rebuild the lists. */
+  BTB_SAVE_HEADER
+  {
+    for(int i=0;i<num_entries;i++)
+      for(struct BTB_btac_Entry_t * p = set[i]; p; p = p->next)
+      {
+        ckpt.put(p->PC);
+        ckpt.put(p->target);
+      }
+  }
+
+  /* RESTORE */
+  BTB_RESTORE_HEADER
+  {
+    for(int i=0;i<num_entries;i++)
+      for(struct BTB_btac_Entry_t * p = set[i]; p; p = p->next)
+      {
+        ckpt.get_array(&p->PC,1);
+        ckpt.get_array(&p->target,1);
+      }
+  }
+
   /* GET_CACHE */
-  BTB_GET_CACHE_HEADER
+  BTB_GET_CACHE_HEADER(BTB_btac_sc_t)
   {
-    class BTB_btac_sc_t * sc = new BTB_btac_sc_t();
-    if(!sc)
-      fatal("couldn't malloc btac state cache");
-    return sc;
+    return new (mem) BTB_btac_sc_t();
   }
 
 
@@ -0,0 +1,326 @@
+/* mesi.cpp - Directory-based MESI coherence between private caches
+ *
+ * The LLC's controller ("mesi:<dir-entries>:<dir-assoc>:<forward-lat>:<invalidate-lat>")
+ * owns a sparse directory (coherence_directory.h), sharded by LLC bank. Every
+ * request from a private cache updates it when the LLC responds: reads
+ * downgrade a previous owner, writes invalidate all other sharers, and the
+ * response is delayed by the forward / invalidation round trip.
+ *
+ * Private caches ("mesi") keep their MESI state in the line's coherence data.
+ * Invalidations and downgrades are posted to the affected caches, which apply
+ * them on their next access, so one core never touches another's arrays. A
+ * line whose state is unknown (just filled, or named in a message) gets it
+ * from the directory. Writes to lines in S miss, and upgrade through the
+ * regular miss path.
+ */
+
+#ifdef ZESTO_PARSE_ARGS
+  if(!strncasecmp(controller_opt_string,"mesi", 4))
+    return std::make_unique<cache_controller_mesi_t>(core, cache, controller_opt_string);
+#else
+
+class cache_controller_mesi_t : public cache_controller_t {
+  public:
+  cache_controller_mesi_t(struct core_t * const core, struct cache_t * const cache, const char * opt_string);
+  virtual ~cache_controller_mesi_t();
+
+  virtual controller_array_response_t check_array(struct cache_line_t * line, const enum cache_command cmd);
+  virtual controller_response_t check_MSHR(struct cache_action_t * MSHR_item);
+
+  virtual bool can_schedule_upstream();
+  virtual bool can_schedule_downstream(struct cache_t * const prev_cache);
+  virtual bool send_request_upstream(int bank, int MSHR_index, struct cache_action_t * MSHR);
+  virtual void send_response_downstream(struct cache_action_t * const MSHR);
+
+  virtual void reg_stats(xiosim::stats::StatsDatabase* sdb);
+
+  protected:
+  /* line->coh.v; UNKNOWN has to be 0, what a fresh fill gets */
+  enum mesi_state_t { MESI_UNKNOWN = 0, MESI_INVALID, MESI_SHARED, MESI_EXCLUSIVE, MESI_MODIFIED };
+
+  /* Get @line's state from the directory, for an access that @is_write. */
+  mesi_state_t refresh(struct cache_line_t * line, bool is_write);
+  /* Apply invalidations and downgrades other cores have posted. */
+  void drain_inbox();
+  /* Tell every private cache of the cores in @core_mask to re-check @paddr. */
+  static void notify(uint64_t core_mask, md_paddr_t paddr);
+
+  /* Messages from other cores' requests; addresses of lines to re-check. */
+  XIOSIM_LOCK lk_inbox;
+  std::vector<md_paddr_t> inbox;
+  std::atomic<int> inbox_num;
+
+  /* set up by the LLC's controller */
+  static std::unique_ptr<xiosim::coherence::directory_t> directory;
+  static unsigned int forward_latency;
+  static unsigned int invalidate_latency;
+  /* private-cache controllers, by core id */
+  static std::vector<cache_controller_mesi_t*> core_controllers[xiosim::coherence::MAX_CORES];
+
+  struct {
+    counter_t upgrades;          /* write to a line in S */
+    counter_t coherence_misses;  /* lost the line to another core */
+    counter_t messages;          /* invalidations/downgrades received */
+    counter_t forwards;          /* LLC: data supplied by another core's cache */
+    counter_t invalidations;     /* LLC: copies invalidated by writes */
+    counter_t recalls;           /* LLC: directory entries evicted */
+  } stat;
+};
+
+std::unique_ptr<xiosim::coherence::directory_t> cache_controller_mesi_t::directory;
+unsigned int cache_controller_mesi_t::forward_latency;
+unsigned int cache_controller_mesi_t::invalidate_latency;
+std::vector<cache_controller_mesi_t*> cache_controller_mesi_t::core_controllers[xiosim::coherence::MAX_CORES];
+
+cache_controller_mesi_t::cache_controller_mesi_t(struct core_t * const core, struct cache_t * const cache, const char * opt_string) :
+  cache_controller_t(core, cache), inbox_num(0)
+{
+  memset(&stat, 0, sizeof(stat));
+
+  if (!core) {
+    char name[256];
+    int dir_entries, dir_assoc;
+    if(sscanf(opt_string, "%[^:]:%d:%d:%u:%u", name, &dir_entries, &dir_assoc, &forward_latency, &invalidate_latency) != 5)
+      fatal("couldn't parse mesi LLC controller options <name:dir-entries:dir-assoc:forward-latency:invalidate-latency>");
+    if(directory)
+      fatal("only one cache can hold the mesi directory");
+    if(dir_assoc <= 0 || dir_entries % (cache->banks * dir_assoc))
+      fatal("mesi directory entries must be a multiple of LLC banks * directory associativity");
+    const int sets_per_shard = dir_entries / (cache->banks * dir_assoc);
+    if(sets_per_shard & (sets_per_shard - 1))
+      fatal("mesi directory sets per LLC bank must be a power of two");
+
+    directory = std::make_unique<xiosim::coherence::directory_t>(cache->banks, cache->bank_shift,
+                                                                 cache->addr_shift, sets_per_shard, dir_assoc);
+  }
+  else {
+    /* the LLC (and its controller) gets created before the cores */
+    if(!directory)
+      fatal("mesi controllers on private caches need a mesi LLC controller");
+    if(core->id >= xiosim::coherence::MAX_CORES)
+      fatal("mesi directory tracks up to %d cores", xiosim::coherence::MAX_CORES);
+    if(cache->linesize != uncore->LLC->linesize)
+      fatal("mesi controller on %s: line size has to match the LLC's", cache->name);
+    core_controllers[core->id].push_back(this);
+  }
+}
+
+cache_controller_mesi_t::~cache_controller_mesi_t()
+{
+  if (core) {
+    auto& ctrls = core_controllers[core->id];
+    ctrls.erase(std::remove(ctrls.begin(), ctrls.end(), this), ctrls.end());
+  }
+  else
+    directory.reset();
+}
+
+void cache_controller_mesi_t::reg_stats(xiosim::stats::StatsDatabase* sdb)
+{
+  char buf[1024];
+  if (!core) {
+    sprintf(buf, "LLC.controller.forwards");
+    stat_reg_counter(sdb, true, buf, "requests served by another core's cache", &stat.forwards, 0, true, NULL);
+
+    sprintf(buf, "LLC.controller.invalidations");
+    stat_reg_counter(sdb, true, buf, "private copies invalidated by writes", &stat.invalidations, 0, true, NULL);
+
+    sprintf(buf, "LLC.controller.recalls");
+    stat_reg_counter(sdb, true, buf, "directory entries evicted (sharers invalidated)", &stat.recalls, 0, true, NULL);
+  }
+  else {
+    sprintf(buf, "c%d.%s.controller.upgrades", core->id, cache->name);
+    stat_reg_counter(sdb, true, buf, "writes to shared lines", &stat.upgrades, 0, true, NULL);
+
+    sprintf(buf, "c%d.%s.controller.coherence_misses", core->id, cache->name);
+    stat_reg_counter(sdb, true, buf, "misses on lines taken away by other cores", &stat.coherence_misses, 0, true, NULL);
+
+    sprintf(buf, "c%d.%s.controller.messages", core->id, cache->name);
+    stat_reg_counter(sdb, true, buf, "invalidations/downgrades received", &stat.messages, 0, true, NULL);
+  }
+}
+
+void cache_controller_mesi_t::notify(uint64_t core_mask, md_paddr_t paddr)
+{
+  while (core_mask) {
+    const int id = __builtin_ctzll(core_mask);
+    core_mask &= core_mask - 1;
+    for (auto ctrl : core_controllers[id]) {
+      lk_lock(&ctrl->lk_inbox, 1);
+      ctrl->inbox.push_back(paddr);
+      ctrl->inbox_num.store(ctrl->inbox.size(), std::memory_order_release);
+      lk_unlock(&ctrl->lk_inbox);
+    }
+  }
+}
+
+void cache_controller_mesi_t::drain_inbox()
+{
+  if (inbox_num.load(std::memory_order_acquire) == 0)
+    return;
+
+  lk_lock(&lk_inbox, 1);
+  for (md_paddr_t paddr : inbox) {
+    struct cache_line_t * line = cache_peek(cache, paddr);
+    if (line)
+      line->coh.v = MESI_UNKNOWN;
+  }
+  stat.messages += inbox.size();
+  inbox.clear();
+  inbox_num.store(0, std::memory_order_release);
+  lk_unlock(&lk_inbox);
+}
+
+cache_controller_mesi_t::mesi_state_t cache_controller_mesi_t::refresh(struct cache_line_t * line, bool is_write)
+{
+  const md_paddr_t paddr = line->tag << cache->addr_shift;
+  switch (directory->probe(paddr, core->id)) {
+    case xiosim::coherence::dir_state_t::EXCLUSIVE:
+      line->coh.v = line->dirty ? MESI_MODIFIED : MESI_EXCLUSIVE;
+      break;
+    case xiosim::coherence::dir_state_t::SHARED:
+      /* A downgrade from M wrote the data back. Unless this is a write --
+         then dirty is the new store's, and has to survive the upgrade. */
+      if (!is_write)
+        line->dirty = false;
+      line->coh.v = MESI_SHARED;
+      break;
+    case xiosim::coherence::dir_state_t::INVALID:
+      line->valid = line->dirty = false;
+      line->coh.v = MESI_INVALID;
+      break;
+  }
+  return (mesi_state_t)line->coh.v;
+}
+
+controller_array_response_t cache_controller_mesi_t::check_array(struct cache_line_t * line, const enum cache_command cmd)
+{
+  if (!core)
+    return line ? ARRAY_HIT : ARRAY_MISS;
+
+  drain_inbox();
+
+  if (line == NULL)
+    return ARRAY_MISS;
+
+  const bool is_write = (cmd == CACHE_WRITE || cmd == CACHE_WRITEBACK);
+  mesi_state_t state = (mesi_state_t)line->coh.v;
+  /* an upgrade may have gone through the other cache level, so S isn't final for writes */
+  if (state == MESI_UNKNOWN || (is_write && state == MESI_SHARED))
+    state = refresh(line, is_write);
+
+  if (state == MESI_INVALID) {
+    stat.coherence_misses++;
+    return ARRAY_MISS;
+  }
+
+  if (is_write) {
+    if (state == MESI_SHARED) {
+      stat.upgrades++;
+      return ARRAY_MISS;
+    }
+    line->coh.v = MESI_MODIFIED;
+  }
+  return ARRAY_HIT;
+}
+
+controller_response_t cache_controller_mesi_t::check_MSHR(struct cache_action_t * MSHR_item)
+{
+  (void) MSHR_item;
+
+  return MSHR_CHECK_ARRAY;
+}
+
+bool cache_controller_mesi_t::can_schedule_upstream()
+{
+  if (cache->next_level)
+    return (!cache->next_bus || bus_free(cache->next_bus));
+  return bus_free(uncore->fsb.get());
+}
+
+bool cache_controller_mesi_t::can_schedule_downstream(struct cache_t * const prev_cache)
+{
+  return (!prev_cache || bus_free(prev_cache->next_bus));
+}
+
+bool cache_controller_mesi_t::send_request_upstream(int bank, int MSHR_index, struct cache_action_t * MSHR)
+{
+  if(cache->next_level) /* enqueue the request to the next-level cache */
+  {
+    if(!cache_enqueuable(cache->next_level, memory::DO_NOT_TRANSLATE, MSHR->paddr))
+      return false;
+
+    cache_enqueue(MSHR->core, cache->next_level, cache, MSHR->cmd, memory::DO_NOT_TRANSLATE, MSHR->PC, MSHR->paddr, MSHR->action_id, bank, MSHR_index, MSHR->op, MSHR->cb, MSHR->miss_cb, NULL, MSHR->get_action_id);
+
+    bus_use(cache->next_bus, (MSHR->cmd == CACHE_WRITE || MSHR->cmd == CACHE_WRITEBACK) ? cache->linesize : 1, MSHR->cmd == CACHE_PREFETCH);
+  }
+  else /* or if there is no next level, enqueue to the memory controller */
+  {
+    if(!uncore->MC->enqueuable(MSHR->paddr))
+      return false;
+
+    uncore->MC->enqueue(cache, MSHR->cmd, MSHR->paddr, cache->linesize, MSHR->action_id, bank, MSHR_index, MSHR->op, MSHR->cb, MSHR->get_action_id);
+
+    bus_use(uncore->fsb.get(), (MSHR->cmd == CACHE_WRITE || MSHR->cmd == CACHE_WRITEBACK) ? (cache->linesize>>uncore->fsb_DDR) : 1, MSHR->cmd == CACHE_PREFETCH);
+  }
+
+  MSHR->when_started = cache_get_cycle(cache);
+  return true;
+}
+
+void cache_controller_mesi_t::send_response_downstream(struct cache_action_t * const MSHR)
+{
+  if(!MSHR->prev_cp)
+    return;
+
+  tick_t delay = 0;
+  /* the directory sits at the LLC; serialize there against requests from other cores */
+  if(!core && MSHR->core)
+  {
+    const int id = MSHR->core->id;
+    xiosim::coherence::dir_result_t res;
+    switch(MSHR->cmd)
+    {
+      case CACHE_READ:
+      case CACHE_PREFETCH:
+        res = directory->read(MSHR->paddr, id);
+        break;
+      case CACHE_WRITE:
+        res = directory->write(MSHR->paddr, id);
+        break;
+      case CACHE_WRITEBACK:
+        directory->writeback(MSHR->paddr, id);
+        break;
+      default:
+        break;
+    }
+
+    if(res.recalled_sharers)
+    {
+      notify(res.recalled_sharers, res.recalled_addr);
+      stat.recalls++;
+    }
+
+    uint64_t targets = res.invalidate;
+    if(res.forward_from != xiosim::coherence::NO_OWNER)
+    {
+      /* downgrade (read) or invalidate (write, already in the mask) the owner */
+      targets |= 1ULL << res.forward_from;
+      delay = forward_latency;
+      stat.forwards++;
+    }
+    if(res.invalidate)
+    {
+      /* invalidations go out in parallel with a forward */
+      delay = std::max<tick_t>(delay, invalidate_latency);
+      stat.invalidations += __builtin_popcountll(res.invalidate);
+    }
+    notify(targets, MSHR->paddr);
+  }
+
+  /* everyone but the response from a writeback transfers a full cache line */
+  bus_use(MSHR->prev_cp->next_bus, (MSHR->cmd == CACHE_WRITEBACK) ? 1 : MSHR->prev_cp->linesize, MSHR->cmd == CACHE_PREFETCH);
+  fill_arrived(MSHR->prev_cp, MSHR->MSHR_bank, MSHR->MSHR_index, delay);
+}
+
+#endif /* ZESTO_PARSE_ARGS */
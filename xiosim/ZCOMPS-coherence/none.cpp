@@ -10,7 +10,7 @@ class cache_controller_none_t : public cache_controller_t {
   cache_controller_none_t(struct core_t * const core, struct cache_t * const cache, const char * opt_string);
 
 
-  virtual controller_array_response_t check_array(struct cache_line_t * line);
+  virtual controller_array_response_t check_array(struct cache_line_t * line, const enum cache_command cmd);
   virtual controller_response_t check_MSHR(struct cache_action_t * MSHR_item);
 
   virtual bool can_schedule_upstream();
@@ -25,7 +25,7 @@ cache_controller_none_t::cache_controller_none_t(struct core_t * const core, str
   (void) opt_string;
 }
 
-controller_array_response_t cache_controller_none_t::check_array(struct cache_line_t * line)
+controller_array_response_t cache_controller_none_t::check_array(struct cache_line_t * line, const enum cache_command cmd)
 {
   if (line == NULL)
     return ARRAY_MISS;
@@ -302,6 +302,29 @@ class dram_simplesdram_t:public dram_t
                      row_buffer_hits_st / *total_access_st, NULL);
   }
 
+  /* SAVE */
+  /* Open rows and the refresh position; bank timing restarts from idle. */
+  DRAM_SAVE_HEADER
+  {
+    for(int i=0;i<num_ranks;i++)
+      for(int j=0;j<num_banks;j++)
+        ckpt.put(array[i][j].current_row);
+    ckpt.put(refresh_rank);
+    ckpt.put(refresh_bank);
+    ckpt.put(refresh_row);
+  }
+
+  /* RESTORE */
+  DRAM_RESTORE_HEADER
+  {
+    for(int i=0;i<num_ranks;i++)
+      for(int j=0;j<num_banks;j++)
+        ckpt.get_array(&array[i][j].current_row,1);
+    ckpt.get_array(&refresh_rank,1);
+    ckpt.get_array(&refresh_bank,1);
+    ckpt.get_array(&refresh_row,1);
+  }
+
 };
 
 
@@ -42,7 +42,11 @@ void vf_controller_sample_t::change_vf()
     else
         core->cpu_speed = max_freq;
 
-    ZTRACE_PRINT(core->id, "cycles: %" PRId64" instrs: %" PRId64" IPC: %.3f cpu_speed: %.1f\n", delta_cycles, delta_insn, curr_ipc, core->cpu_speed);
+    /* Power is computed asynchronously; this is the latest finished interval,
+     * which can lag behind the current one. */
+    power_estimate_t power = get_power_estimate(core->id);
+
+    ZTRACE_PRINT(core->id, "cycles: %" PRId64" instrs: %" PRId64" IPC: %.3f cpu_speed: %.1f power: %.3f (@%" PRId64")\n", delta_cycles, delta_insn, curr_ipc, core->cpu_speed, power.rt_power + power.leakage_power, power.cycle);
 
     last_cycle = core->sim_cycle;
     last_commit_insn = core->stat.commit_insn;
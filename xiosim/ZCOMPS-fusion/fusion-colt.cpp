@@ -183,13 +183,24 @@ class fusion_colt_t:public fusion_t
       history[0] = sc->lookup_bhr;
   }
 
+  /* SAVE */
+  FUSION_SAVE_HEADER
+  {
+    ckpt.put_array(history,history_size);
+    ckpt.put_array(ftable,meta_size);
+  }
+
+  /* RESTORE */
+  FUSION_RESTORE_HEADER
+  {
+    ckpt.get_array(history,history_size);
+    ckpt.get_array(ftable,meta_size);
+  }
+
   /* GET_CACHE */
-  FUSION_GET_CACHE_HEADER
+  FUSION_GET_CACHE_HEADER(fusion_colt_sc_t)
   {
-    class fusion_colt_sc_t * sc = new fusion_colt_sc_t();
-    if(!sc)
-      fatal("couldn't malloc colt State Cache");
-    return sc;
+    return new (mem) fusion_colt_sc_t();
   }
 
 };
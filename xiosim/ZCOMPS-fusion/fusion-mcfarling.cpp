@@ -89,6 +89,18 @@ class fusion_mcfarling_t:public fusion_t
     }
   }
 
+  /* SAVE */
+  FUSION_SAVE_HEADER
+  {
+    ckpt.put_array(meta,meta_size);
+  }
+
+  /* RESTORE */
+  FUSION_RESTORE_HEADER
+  {
+    ckpt.get_array(meta,meta_size);
+  }
+
 };
 
 #endif /* BPRED_PARSE_ARGS */
@@ -148,6 +148,20 @@ class fusion_multihybrid_t:public fusion_t
       MY2BC_UPDATE(meta[2][index],(preds[3]==outcome));
     }
   }
+
+  /* SAVE */
+  FUSION_SAVE_HEADER
+  {
+    for(int i=0;i<3;i++)
+      ckpt.put_array(meta[i],meta_size);
+  }
+
+  /* RESTORE */
+  FUSION_RESTORE_HEADER
+  {
+    for(int i=0;i<3;i++)
+      ckpt.get_array(meta[i],meta_size);
+  }
 };
 
 #endif /* BPRED_PARSE_ARGS */
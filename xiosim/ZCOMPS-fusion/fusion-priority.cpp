@@ -137,6 +137,20 @@ class fusion_priority_t:public fusion_t
       }
   }
 
+  /* SAVE */
+  FUSION_SAVE_HEADER
+  {
+    for(int i=0;i<meta_size;i++)
+      ckpt.put_array(meta[i],num_pred);
+  }
+
+  /* RESTORE */
+  FUSION_RESTORE_HEADER
+  {
+    for(int i=0;i<meta_size;i++)
+      ckpt.get_array(meta[i],num_pred);
+  }
+
 };
 
 #endif /* BPRED_PARSE_ARGS */
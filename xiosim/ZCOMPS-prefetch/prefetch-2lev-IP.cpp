@@ -158,6 +158,18 @@ class prefetch_2lev_IP_t:public prefetch_t
     int index = PC & mask;
     return table[index].last_stride + paddr;
   }
+
+  /* SAVE */
+  PREFETCH_SAVE_HEADER
+  {
+    ckpt.put_array(table,num_entries);
+  }
+
+  /* RESTORE */
+  PREFETCH_RESTORE_HEADER
+  {
+    ckpt.get_array(table,num_entries);
+  }
 };
 
 
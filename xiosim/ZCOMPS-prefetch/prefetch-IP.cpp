@@ -116,6 +116,18 @@ class prefetch_IP_t:public prefetch_t
 
     return pf_paddr;
   }
+
+  /* SAVE */
+  PREFETCH_SAVE_HEADER
+  {
+    ckpt.put_array(table,num_entries);
+  }
+
+  /* RESTORE */
+  PREFETCH_RESTORE_HEADER
+  {
+    ckpt.get_array(table,num_entries);
+  }
 };
 
 
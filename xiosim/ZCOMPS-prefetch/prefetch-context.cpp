@@ -153,6 +153,20 @@ class prefetch_context_t:public prefetch_t
 
     return pf_paddr;
   }
+
+  /* SAVE */
+  PREFETCH_SAVE_HEADER
+  {
+    ckpt.put_array(table,num_entries);
+    ckpt.put(last_paddr);
+  }
+
+  /* RESTORE */
+  PREFETCH_RESTORE_HEADER
+  {
+    ckpt.get_array(table,num_entries);
+    ckpt.get_array(&last_paddr,1);
+  }
 };
 
 
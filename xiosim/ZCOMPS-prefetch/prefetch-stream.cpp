@@ -23,15 +23,33 @@ class prefetch_stream_t:public prefetch_t
   int num_upstream_entries;
   int num_downstream_entries;
 
+  /* Streams are looked up by page number. Tables up to STREAM_MAX_ASSOC
+     entries are fully associative; bigger ones get split into sets of that
+     many ways. */
+  static const int STREAM_MAX_ASSOC = 16;
   struct prefetch_stream_table_t {
     md_paddr_t last_paddr;
-    struct prefetch_stream_table_t * next;
   };
+  typedef xiosim::assoc_table_t<prefetch_stream_table_t> stream_table_t;
 
-  struct prefetch_stream_table_t * upstream;
-  struct prefetch_stream_table_t * downstream;
-  struct prefetch_stream_table_t * upstream_head;
-  struct prefetch_stream_table_t * downstream_head;
+  std::unique_ptr<stream_table_t> upstream;
+  std::unique_ptr<stream_table_t> downstream;
+
+  std::unique_ptr<stream_table_t> create_table(const char * name, const int num_entries)
+  {
+    if(num_entries <= 0)
+      fatal("%s needs at least one stream table entry", name);
+    int assoc = num_entries;
+    if(num_entries > STREAM_MAX_ASSOC)
+    {
+      assoc = STREAM_MAX_ASSOC;
+      const int sets = num_entries / assoc;
+      if((num_entries % assoc) || (sets & (sets - 1)))
+        fatal("%s: stream tables bigger than %d entries have to be a power-of-two multiple of %d",
+              name, STREAM_MAX_ASSOC, STREAM_MAX_ASSOC);
+    }
+    return std::make_unique<stream_table_t>(num_entries, assoc);
+  }
 
   public:
   /* CREATE */
@@ -54,70 +72,34 @@ class prefetch_stream_t:public prefetch_t
     num_upstream_entries = arg_num_upstream_entries;
     num_downstream_entries = arg_num_downstream_entries;
 
-    upstream = (struct prefetch_stream_t::prefetch_stream_table_t*) calloc(num_upstream_entries,sizeof(*upstream));
-    downstream = (struct prefetch_stream_t::prefetch_stream_table_t*) calloc(num_downstream_entries,sizeof(*downstream));
-    if(!upstream || !downstream)
-      fatal("couldn't calloc stream-prefetch table(s)");
-
-    for(int i=0;i<num_upstream_entries-1;i++)
-      upstream[i].next = &upstream[i+1];
-    for(int i=0;i<num_downstream_entries-1;i++)
-      downstream[i].next = &downstream[i+1];
-    upstream_head = upstream;
-    downstream_head = downstream;
+    upstream = create_table(name, num_upstream_entries);
+    downstream = create_table(name, num_downstream_entries);
 
     bits = (num_upstream_entries+num_downstream_entries) * (40-12); /* assume 40-bit physical addres, 4KB pages */
   }
 
-  /* DESTROY */
-  ~prefetch_stream_t()
-  {
-    free(upstream); upstream = upstream_head = NULL;
-    free(downstream); downstream = downstream_head = NULL;
-  }
-
   /* LOOKUP */
   PREFETCH_LOOKUP_HEADER
   {
     lookups++;
 
-    md_paddr_t page_addr = memory::page_round_down(paddr);
+    const md_paddr_t page = paddr >> memory::PAGE_SHIFT;
+    const md_paddr_t line = paddr >> cp->addr_shift;
 
-    /* see if we can find a matching entry */
-    struct prefetch_stream_table_t * p = upstream_head;
-    struct prefetch_stream_table_t * prev = NULL;
     bool possible_up = false;
     bool possible_down = false;
-    bool up_hit = false; /* page present */
-    bool down_hit = false; /* page present */
 
     /* check upstreams */
-    while(p)
-    {
-      if(page_addr == memory::page_round_down(p->last_paddr)) /* hit */
-      {
-        up_hit = true;
-        break;
-      }
-      prev = p;
-      p = p->next;
-    }
-
-    if(p) /* hit */
+    stream_table_t::entry_t * up = upstream->find(page);
+    if(up) /* hit */
     {
-      if((paddr>>cp->addr_shift) == ((p->last_paddr>>cp->addr_shift)+1))
+      if(line == ((up->data.last_paddr>>cp->addr_shift)+1))
       {
-        p->last_paddr = paddr; /* record this address */
-
-        if(prev) /* entry to MRU position */
-        {
-          prev->next = p->next;
-          p->next = upstream_head;
-          upstream_head = p;
-        }
+        up->data.last_paddr = paddr; /* record this address */
+        upstream->touch(up); /* entry to MRU position */
         return paddr + (1<<cp->addr_shift);
       }
-      else if((paddr>>cp->addr_shift) == ((p->last_paddr>>cp->addr_shift)-1))
+      else if(line == ((up->data.last_paddr>>cp->addr_shift)-1))
       {
         /* possible downward-stream */
         possible_down = true;
@@ -125,83 +107,66 @@ class prefetch_stream_t:public prefetch_t
     }
 
     /* check downstreams */
-    p = downstream_head;
-    prev = NULL;
-    while(p)
-    {
-      if(page_addr == memory::page_round_down(p->last_paddr)) /* hit */
-      {
-        down_hit = true;
-        break;
-      }
-      prev = p;
-      p = p->next;
-    }
-
-    if(p) /* hit */
+    stream_table_t::entry_t * down = downstream->find(page);
+    if(down) /* hit */
     {
-      if((paddr>>cp->addr_shift) == ((p->last_paddr>>cp->addr_shift)-1))
+      if(line == ((down->data.last_paddr>>cp->addr_shift)-1))
       {
-        p->last_paddr = paddr; /* record this address */
-
-        if(prev) /* entry to MRU position */
-        {
-          prev->next = p->next;
-          p->next = downstream_head;
-          downstream_head = p;
-        }
+        down->data.last_paddr = paddr; /* record this address */
+        downstream->touch(down); /* entry to MRU position */
         return paddr - (1<<cp->addr_shift);
       }
-      else if((paddr>>cp->addr_shift) == ((p->last_paddr>>cp->addr_shift)+1))
+      else if(line == ((down->data.last_paddr>>cp->addr_shift)+1))
       {
         /* possible upward-stream */
         possible_up = true;
       }
     }
 
-    if((!up_hit && !down_hit) || (!up_hit && possible_up))
+    if((!up && !down) || (!up && possible_up))
     {
       /* we don't know about this page; just allocate an entry in the upstream
          table */
-      p = upstream_head; prev = NULL;
-      while(p->next)
-      {
-        prev = p;
-        p = p->next;
-      }
-
-      assert(p);
-      p->last_paddr = paddr;
-
-      if(prev) /* entry to MRU position */
-      {
-        prev->next = p->next;
-        p->next = upstream_head;
-        upstream_head = p;
-      }
+      upstream->replace(page)->data.last_paddr = paddr;
     }
-    else if(!down_hit && possible_down)
+    else if(!down && possible_down)
     {
-      p = downstream_head; prev = NULL;
-      while(p->next)
-      {
-        prev = p;
-        p = p->next;
-      }
-
-      assert(p);
-      p->last_paddr = paddr;
-
-      if(prev) /* entry to MRU position */
-      {
-        prev->next = p->next;
-        p->next = downstream_head;
-        downstream_head = p;
-      }
+      downstream->replace(page)->data.last_paddr = paddr;
     }
 
     return 0; /* nothing to prefetch */
   }
+
+  /* SAVE */
+  /* Addresses in recency order (0 for unused entries); the entries
+     themselves are interchangeable. */
+  PREFETCH_SAVE_HEADER
+  {
+    auto put_entry = [&ckpt](const stream_table_t::entry_t& e, bool valid) {
+      ckpt.put<md_paddr_t>(valid ? e.data.last_paddr : 0);
+    };
+    upstream->for_each(put_entry);
+    downstream->for_each(put_entry);
+  }
+
+  /* RESTORE */
+  PREFETCH_RESTORE_HEADER
+  {
+    restore_table(ckpt, upstream.get());
+    restore_table(ckpt, downstream.get());
+  }
+
+  private:
+  /* Re-insert from LRU to MRU, so each set ends up in the saved order. */
+  static void restore_table(xiosim::checkpoint::reader_t& ckpt, stream_table_t * table)
+  {
+    std::vector<md_paddr_t> addrs(table->get_num_entries());
+    ckpt.get_array(addrs.data(), addrs.size());
+    table->clear();
+    for(auto it = addrs.rbegin(); it != addrs.rend(); ++it)
+      if(*it)
+        table->replace(*it >> memory::PAGE_SHIFT)->data.last_paddr = *it;
+  }
 };
 
 
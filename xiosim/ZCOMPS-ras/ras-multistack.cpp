@@ -132,6 +132,24 @@ class RAS_multistack_t:public RAS_t
 
     BPRED_STAT(num_recovers++;)
   }
+
+  /* SAVE */
+  /* Only the committed stack -- the speculative one is rebuilt from it. */
+  RAS_SAVE_HEADER
+  {
+    ckpt.put_array(real_stack,real_size);
+    ckpt.put(real_head);
+  }
+
+  /* RESTORE */
+  RAS_RESTORE_HEADER
+  {
+    ckpt.get_array(real_stack,real_size);
+    ckpt.get_array(&real_head,1);
+    for(int i=0;i<spec_size;i++)
+      spec_stack[i].valid = 0;
+    spec_to_real_head = real_head;
+  }
 };
 
 #endif /* RAS_PARSE_ARGS */
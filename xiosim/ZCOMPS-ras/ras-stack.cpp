@@ -95,18 +95,23 @@ class RAS_stack_t:public RAS_t
   }
 
   /* GET_STATE */
-  RAS_GET_STATE_HEADER
+  RAS_GET_STATE_HEADER(RAS_stack_chkpt_t)
   {
-    class RAS_stack_chkpt_t * cp = new RAS_stack_chkpt_t();
-    if(!cp)
-      fatal("couldn't malloc stack recovery state");
-    return cp;
+    return new (mem) RAS_stack_chkpt_t();
   }
 
-  /* RET_STATE */
-  RAS_RET_STATE_HEADER
+  /* SAVE */
+  RAS_SAVE_HEADER
   {
-    delete(cpvp);
+    ckpt.put_array(stack,size);
+    ckpt.put(head);
+  }
+
+  /* RESTORE */
+  RAS_RESTORE_HEADER
+  {
+    ckpt.get_array(stack,size);
+    ckpt.get_array(&head,1);
   }
 
 };
@@ -9,7 +9,7 @@
     return std::make_unique<class core_alloc_DPM_t>(core);
 #else
 
-class core_alloc_DPM_t:public core_alloc_t
+class core_alloc_DPM_t final : public core_alloc_t
 {
   enum alloc_stall_t {ASTALL_NONE,   /* no stall */
                       ASTALL_EMPTY,
@@ -64,27 +64,27 @@ core_alloc_DPM_t::core_alloc_DPM_t(struct core_t * const arg_core)
   core = arg_core;
   int i;
 
-  if(knobs->alloc.depth <= 0)
+  if(CORE_KNOB(knobs, alloc, depth) <= 0)
     fatal("allocation pipeline depth must be > 0");
-  if(knobs->alloc.width <= 0)
+  if(CORE_KNOB(knobs, alloc, width) <= 0)
     fatal("allocation pipeline width must be > 0");
 
-  pipe = (struct uop_t***) calloc(knobs->alloc.depth,sizeof(*pipe));
+  pipe = (struct uop_t***) calloc(CORE_KNOB(knobs, alloc, depth),sizeof(*pipe));
   if(!pipe)
     fatal("couldn't calloc alloc pipe");
 
-  for(i=0;i<knobs->alloc.depth;i++)
+  for(i=0;i<CORE_KNOB(knobs, alloc, depth);i++)
   {
-    pipe[i] = (struct uop_t**) calloc(knobs->alloc.width,sizeof(**pipe));
+    pipe[i] = (struct uop_t**) calloc(CORE_KNOB(knobs, alloc, width),sizeof(**pipe));
     if(!pipe[i])
       fatal("couldn't calloc alloc pipe stage");
   }
 
-  occupancy = (int*) calloc(knobs->alloc.depth,sizeof(*occupancy));
+  occupancy = (int*) calloc(CORE_KNOB(knobs, alloc, depth),sizeof(*occupancy));
   if(!occupancy)
     fatal("couldn't calloc alloc occupancy array");
 
-  port_loading = (int*) calloc(knobs->exec.num_exec_ports,sizeof(*port_loading));
+  port_loading = (int*) calloc(CORE_KNOB(knobs, exec, num_exec_ports),sizeof(*port_loading));
   if(!port_loading)
     fatal("couldn't calloc allocation port-loading scoreboard");
 }
@@ -92,7 +92,7 @@ core_alloc_DPM_t::core_alloc_DPM_t(struct core_t * const arg_core)
 core_alloc_DPM_t::~core_alloc_DPM_t() {
     free(port_loading);
     free(occupancy);
-    for (int i = 0; i < core->knobs->alloc.depth; i++)
+    for (int i = 0; i < CORE_KNOB(core->knobs, alloc, depth); i++)
         free(pipe[i]);
     free(pipe);
 }
@@ -143,10 +143,10 @@ void core_alloc_DPM_t::step(void)
 
   /*========================================================================*/
   /*== Dispatch insts if ROB, RS, and LQ/SQ entries available (as needed) ==*/
-  stage = knobs->alloc.depth-1;
+  stage = CORE_KNOB(knobs, alloc, depth)-1;
   if(occupancy[stage]) /* are there uops in the last stage of the alloc pipe? */
   {
-    for(i=0; i < knobs->alloc.width; i++) /* if so, scan all slots (width) of this stage */
+    for(i=0; i < CORE_KNOB(knobs, alloc, width); i++) /* if so, scan all slots (width) of this stage */
     {
       struct uop_t * uop = pipe[stage][i];
       int abort_alloc = false;
@@ -410,12 +410,12 @@ void core_alloc_DPM_t::step(void)
   /*== Shuffle uops down the rename/alloc pipe ==*/
 
   /* walk pipe backwards */
-  for(stage=knobs->alloc.depth-1; stage > 0; stage--)
+  for(stage=CORE_KNOB(knobs, alloc, depth)-1; stage > 0; stage--)
   {
     if(0 == occupancy[stage]) /* implementing non-serpentine pipe (no compressing) - can't advance until stage is empty */
     {
       /* move everyone from previous stage forward */
-      for(i=0;i<knobs->alloc.width;i++)
+      for(i=0;i<CORE_KNOB(knobs, alloc, width);i++)
       {
         pipe[stage][i] = pipe[stage-1][i];
         pipe[stage-1][i] = NULL;
@@ -423,7 +423,7 @@ void core_alloc_DPM_t::step(void)
         {
           occupancy[stage]++;
           occupancy[stage-1]--;
-          zesto_assert(occupancy[stage] <= knobs->alloc.width,(void)0);
+          zesto_assert(occupancy[stage] <= CORE_KNOB(knobs, alloc, width),(void)0);
           zesto_assert(occupancy[stage-1] >= 0,(void)0);
         }
       }
@@ -435,11 +435,11 @@ void core_alloc_DPM_t::step(void)
   if(0 == occupancy[0])
   {
     /* while the uopQ sitll has uops in it, allocate up to alloc.width uops per cycle */
-    for(i=0;(i<knobs->alloc.width) && core->decode->uop_available();i++)
+    for(i=0;(i<CORE_KNOB(knobs, alloc, width)) && core->decode->uop_available();i++)
     {
       pipe[0][i] = core->decode->uop_peek(); core->decode->uop_consume();
       occupancy[0]++;
-      zesto_assert(occupancy[0] <= knobs->alloc.width,(void)0);
+      zesto_assert(occupancy[0] <= CORE_KNOB(knobs, alloc, width),(void)0);
 #ifdef ZTRACE
       ztrace_print(pipe[0][i],"a|alloc-pipe|enqueue");
 #endif
@@ -456,11 +456,11 @@ core_alloc_DPM_t::recover(const struct Mop_t * const Mop)
 {
   struct core_knobs_t * knobs = core->knobs;
   int stage,i;
-  for(stage=0;stage<knobs->alloc.depth;stage++)
+  for(stage=0;stage<CORE_KNOB(knobs, alloc, depth);stage++)
   {
     /* slot N-1 is most speculative, start from there */
     if(occupancy[stage])
-      for(i=knobs->alloc.width-1;i>=0;i--)
+      for(i=CORE_KNOB(knobs, alloc, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -480,11 +480,11 @@ core_alloc_DPM_t::recover(void)
 {
   struct core_knobs_t * knobs = core->knobs;
   int stage,i;
-  for(stage=0;stage<knobs->alloc.depth;stage++)
+  for(stage=0;stage<CORE_KNOB(knobs, alloc, depth);stage++)
   {
     /* slot N-1 is most speculative, start from there */
     if(occupancy[stage])
-      for(i=knobs->alloc.width-1;i>=0;i--)
+      for(i=CORE_KNOB(knobs, alloc, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
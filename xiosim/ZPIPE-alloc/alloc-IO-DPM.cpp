@@ -13,7 +13,7 @@
 #include <list>
 using namespace std;
 
-class core_alloc_IO_DPM_t:public core_alloc_t
+class core_alloc_IO_DPM_t final : public core_alloc_t
 {
   enum alloc_stall_t {ASTALL_NONE,   /* no stall */
                       ASTALL_EMPTY,
@@ -72,31 +72,31 @@ core_alloc_IO_DPM_t::core_alloc_IO_DPM_t(struct core_t * const arg_core)
   core = arg_core;
   int i;
 
-  if(knobs->alloc.depth <= 0)
+  if(CORE_KNOB(knobs, alloc, depth) <= 0)
     fatal("allocation pipeline depth must be > 0");
-  if(knobs->alloc.width <= 0)
+  if(CORE_KNOB(knobs, alloc, width) <= 0)
     fatal("allocation pipeline width must be > 0");
 
-  pipe = (struct uop_t***) calloc(knobs->alloc.depth,sizeof(*pipe));
+  pipe = (struct uop_t***) calloc(CORE_KNOB(knobs, alloc, depth),sizeof(*pipe));
   if(!pipe)
     fatal("couldn't calloc alloc pipe");
 
-  for(i=0;i<knobs->alloc.depth;i++)
+  for(i=0;i<CORE_KNOB(knobs, alloc, depth);i++)
   {
-    pipe[i] = (struct uop_t**) calloc(knobs->alloc.width,sizeof(**pipe));
+    pipe[i] = (struct uop_t**) calloc(CORE_KNOB(knobs, alloc, width),sizeof(**pipe));
     if(!pipe[i])
       fatal("couldn't calloc alloc pipe stage");
   }
 
-  occupancy = (int*) calloc(knobs->alloc.depth,sizeof(*occupancy));
+  occupancy = (int*) calloc(CORE_KNOB(knobs, alloc, depth),sizeof(*occupancy));
   if(!occupancy)
     fatal("couldn't calloc alloc occupancy array");
 
-  port_loading = (int*) calloc(knobs->exec.num_exec_ports,sizeof(*port_loading));
+  port_loading = (int*) calloc(CORE_KNOB(knobs, exec, num_exec_ports),sizeof(*port_loading));
   if(!port_loading)
     fatal("couldn't calloc allocation port-loading scoreboard");
 
-  can_alloc = (bool*) calloc(knobs->exec.num_exec_ports,sizeof(*can_alloc));
+  can_alloc = (bool*) calloc(CORE_KNOB(knobs, exec, num_exec_ports),sizeof(*can_alloc));
   if(!can_alloc)
     fatal("couldn't calloc can_alloc array");
 }
@@ -105,7 +105,7 @@ core_alloc_IO_DPM_t::~core_alloc_IO_DPM_t() {
     free(can_alloc);
     free(port_loading);
     free(occupancy);
-    for (int i = 0; i < core->knobs->alloc.depth; i++)
+    for (int i = 0; i < CORE_KNOB(core->knobs, alloc, depth); i++)
         free(pipe[i]);
     free(pipe);
 }
@@ -151,8 +151,8 @@ bool core_alloc_IO_DPM_t::oldest_in_alloc(struct uop_t * uop)
 {
   struct core_knobs_t * knobs = core->knobs;
 
-  for(int stage=knobs->alloc.depth-1; stage>=0; stage--)
-   for(int i=0; i<knobs->alloc.width; i++)
+  for(int stage=CORE_KNOB(knobs, alloc, depth)-1; stage>=0; stage--)
+   for(int i=0; i<CORE_KNOB(knobs, alloc, width); i++)
      if(pipe[stage][i] && pipe[stage][i]->decode.uop_seq <
          uop->decode.uop_seq)
          return false;
@@ -172,10 +172,10 @@ void core_alloc_IO_DPM_t::step(void)
   list<struct uop_t *>::iterator it;
   /*========================================================================*/
   /*== Dispatch insts to the appropriate execution ports ==*/
-  stage = knobs->alloc.depth-1;
+  stage = CORE_KNOB(knobs, alloc, depth)-1;
   if(occupancy[stage]) /* are there uops in the last stage of the alloc pipe? */
   {
-    for(i=0; i < knobs->alloc.width; i++) /* if so, scan all slots (width) of this stage */
+    for(i=0; i < CORE_KNOB(knobs, alloc, width); i++) /* if so, scan all slots (width) of this stage */
     {
        struct uop_t * uop = pipe[stage][i];
        if(uop)
@@ -193,8 +193,8 @@ void core_alloc_IO_DPM_t::step(void)
     {
       struct uop_t * uop = *it;
       i = -1;
-      for (int j=0; j < knobs->alloc.width; j++)
-        for (int k=0; k < knobs->alloc.depth; k++)
+      for (int j=0; j < CORE_KNOB(knobs, alloc, width); j++)
+        for (int k=0; k < CORE_KNOB(knobs, alloc, depth); k++)
           if (pipe[k][j] == uop) {
             i = j;
             break;
@@ -241,7 +241,7 @@ void core_alloc_IO_DPM_t::step(void)
               int index = -1;
               int j;
               struct uop_t * exec_uop = uop;
-              for(j=0;j<knobs->exec.num_exec_ports;j++)
+              for(j=0;j<CORE_KNOB(knobs, exec, num_exec_ports);j++)
                  can_alloc[j] = true;
 
               /* fused uops should all go toghether - we look for a port that can execute the whole fusion */
@@ -255,7 +255,7 @@ void core_alloc_IO_DPM_t::step(void)
                 else
                 {
                   /* step through all exec ports and find if exec_uop can issue there; if not, we can't issue the whole fussion there */
-                  for(j=0;j<knobs->exec.num_exec_ports;j++)
+                  for(j=0;j<CORE_KNOB(knobs, exec, num_exec_ports);j++)
                   {
                     bool port_possible = false;
                     for(int k=0;k<knobs->exec.port_binding[exec_uop->decode.FU_class].num_FUs;k++)
@@ -277,7 +277,7 @@ void core_alloc_IO_DPM_t::step(void)
                   exec_uop = NULL;
               }
 
-              for(j=0;j<knobs->exec.num_exec_ports;j++)
+              for(j=0;j<CORE_KNOB(knobs, exec, num_exec_ports);j++)
               {
                  if(can_alloc[j] && core->exec->port_available(j) && port_loading[j] < min_load)
                  {
@@ -424,13 +424,13 @@ void core_alloc_IO_DPM_t::step(void)
   /*== Shuffle uops down the rename/alloc pipe ==*/
 
   /* walk pipe backwards */
-  for(stage=knobs->alloc.depth-1; stage > 0; stage--)
+  for(stage=CORE_KNOB(knobs, alloc, depth)-1; stage > 0; stage--)
   {
 //    if(0 == occupancy[stage]) /* implementing non-serpentine pipe (no compressing) - can't advance until stage is empty */
-    if(occupancy[stage] < knobs->alloc.width)
+    if(occupancy[stage] < CORE_KNOB(knobs, alloc, width))
     {
       /* move everyone from previous stage forward */
-      for(i=0;i<knobs->alloc.width;i++)
+      for(i=0;i<CORE_KNOB(knobs, alloc, width);i++)
       {
         if(pipe[stage][i] == NULL)
         {
@@ -440,7 +440,7 @@ void core_alloc_IO_DPM_t::step(void)
            {
              occupancy[stage]++;
              occupancy[stage-1]--;
-             zesto_assert(occupancy[stage] <= knobs->alloc.width,(void)0);
+             zesto_assert(occupancy[stage] <= CORE_KNOB(knobs, alloc, width),(void)0);
              zesto_assert(occupancy[stage-1] >= 0,(void)0);
            }
         }
@@ -451,17 +451,17 @@ void core_alloc_IO_DPM_t::step(void)
   /*==============================================*/
   /*== fill first alloc stage from decode stage ==*/
 //  if(0 == occupancy[0])
-  if(occupancy[0] < knobs->alloc.width)
+  if(occupancy[0] < CORE_KNOB(knobs, alloc, width))
   {
     /* while the uopQ sitll has uops in it, allocate up to alloc.width uops per cycle */
-    for(i=0;(i<knobs->alloc.width) && core->decode->uop_available();i++)
+    for(i=0;(i<CORE_KNOB(knobs, alloc, width)) && core->decode->uop_available();i++)
     {
       if(pipe[0][i] != NULL)
          continue;
 
       pipe[0][i] = core->decode->uop_peek(); core->decode->uop_consume();
       occupancy[0]++;
-      zesto_assert(occupancy[0] <= knobs->alloc.width,(void)0);
+      zesto_assert(occupancy[0] <= CORE_KNOB(knobs, alloc, width),(void)0);
 #ifdef ZTRACE
       ztrace_print(pipe[0][i],"a|alloc-pipe|enqueue");
 #endif
@@ -478,11 +478,11 @@ core_alloc_IO_DPM_t::recover(const struct Mop_t * const Mop)
 {
   struct core_knobs_t * knobs = core->knobs;
   int stage,i;
-  for(stage=0;stage<knobs->alloc.depth;stage++)
+  for(stage=0;stage<CORE_KNOB(knobs, alloc, depth);stage++)
   {
     /* slot N-1 is most speculative, start from there */
     if(occupancy[stage])
-      for(i=knobs->alloc.width-1;i>=0;i--)
+      for(i=CORE_KNOB(knobs, alloc, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -502,11 +502,11 @@ core_alloc_IO_DPM_t::recover(void)
 {
   struct core_knobs_t * knobs = core->knobs;
   int stage,i;
-  for(stage=0;stage<knobs->alloc.depth;stage++)
+  for(stage=0;stage<CORE_KNOB(knobs, alloc, depth);stage++)
   {
     /* slot N-1 is most speculative, start from there */
     if(occupancy[stage])
-      for(i=knobs->alloc.width-1;i>=0;i--)
+      for(i=CORE_KNOB(knobs, alloc, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -9,7 +9,7 @@
     return std::make_unique<class core_alloc_STM_t>(core);
 #else
 
-class core_alloc_STM_t:public core_alloc_t
+class core_alloc_STM_t final : public core_alloc_t
 {
   enum alloc_stall_t {ASTALL_NONE,   /* no stall */
                       ASTALL_EMPTY,
@@ -61,7 +61,7 @@ core_alloc_STM_t::core_alloc_STM_t(struct core_t * const arg_core)
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
 
-  port_loading = (int*) calloc(knobs->exec.num_exec_ports,sizeof(*port_loading));
+  port_loading = (int*) calloc(CORE_KNOB(knobs, exec, num_exec_ports),sizeof(*port_loading));
   if(!port_loading)
     fatal("couldn't calloc allocation port-loading scoreboard");
 }
@@ -126,7 +126,7 @@ void core_alloc_STM_t::step(void)
         drain_in_progress = false;
     }
 
-    for(int i=0; i < knobs->alloc.width; i++) /* if so, scan all slots (width) of this stage */
+    for(int i=0; i < CORE_KNOB(knobs, alloc, width); i++) /* if so, scan all slots (width) of this stage */
     {
       struct uop_t * uop = core->decode->uop_peek();
 
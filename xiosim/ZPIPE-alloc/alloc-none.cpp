@@ -3,7 +3,7 @@
     return std::make_unique<class core_alloc_NONE_t>(core);
 #else
 
-class core_alloc_NONE_t:public core_alloc_t
+class core_alloc_NONE_t final : public core_alloc_t
 {
 
   public:
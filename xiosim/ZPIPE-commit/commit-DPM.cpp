@@ -8,7 +8,7 @@
     return std::make_unique<class core_commit_DPM_t>(core);
 #else
 
-class core_commit_DPM_t:public core_commit_t
+class core_commit_DPM_t final : public core_commit_t
 {
   enum commit_stall_t {CSTALL_NONE,      /* no stall */
                        CSTALL_NOT_READY, /* oldest inst not done (no uops finished) */
@@ -56,7 +56,7 @@ class core_commit_DPM_t:public core_commit_t
   void ROB_pop_back();
   void ROB_pop_front();
   inline class uop_t* ROB_back() {
-      int back_ind = moddec(ROB_tail, core->knobs->commit.ROB_size);
+      int back_ind = moddec(ROB_tail, CORE_KNOB(core->knobs, commit, ROB_size));
       return ROB[back_ind];
   }
 
@@ -96,7 +96,7 @@ core_commit_DPM_t::core_commit_DPM_t(struct core_t * const arg_core):
 {
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
-  ROB = (struct uop_t**) calloc(knobs->commit.ROB_size,sizeof(*ROB));
+  ROB = (struct uop_t**) calloc(CORE_KNOB(knobs, commit, ROB_size),sizeof(*ROB));
   if(!ROB)
     fatal("couldn't calloc ROB");
 }
@@ -308,7 +308,7 @@ void core_commit_DPM_t::update_occupancy(void)
     /* ROB */
   core->stat.ROB_occupancy += ROB_num;
   core->stat.ROB_eff_occupancy += ROB_eff_num;
-  if(ROB_num >= core->knobs->commit.ROB_size)
+  if(ROB_num >= CORE_KNOB(core->knobs, commit, ROB_size))
     core->stat.ROB_full_cycles++;
   if(ROB_num <= 0)
     core->stat.ROB_empty_cycles++;
@@ -339,11 +339,11 @@ void core_commit_DPM_t::step(void)
   }
 
   /* deallocate at most commit_width stores from the (senior) STQ per cycle */
-  for(int STQ_commit_count = 0; STQ_commit_count < knobs->commit.width; STQ_commit_count++)
+  for(int STQ_commit_count = 0; STQ_commit_count < CORE_KNOB(knobs, commit, width); STQ_commit_count++)
     core->exec->STQ_deallocate_senior();
 
   /* MAIN COMMIT LOOP */
-  for(commit_count=0;commit_count<knobs->commit.width;commit_count++)
+  for(commit_count=0;commit_count<CORE_KNOB(knobs, commit, width);commit_count++)
   {
     if(ROB_num <= 0) /* nothing to commit */
     {
@@ -361,7 +361,7 @@ void core_commit_DPM_t::step(void)
       break;
     }
 
-    if(Mop->decode.is_ctrl && knobs->commit.branch_limit && (branches_committed >= knobs->commit.branch_limit))
+    if(Mop->decode.is_ctrl && CORE_KNOB(knobs, commit, branch_limit) && (branches_committed >= CORE_KNOB(knobs, commit, branch_limit)))
     {
       stall_reason = CSTALL_MAX_BRANCHES;
       break;
@@ -722,7 +722,7 @@ void core_commit_DPM_t::recover(void) {
 
 bool core_commit_DPM_t::ROB_available(void) {
     struct core_knobs_t* knobs = core->knobs;
-    return ROB_num < knobs->commit.ROB_size;
+    return ROB_num < CORE_KNOB(knobs, commit, ROB_size);
 }
 
 bool core_commit_DPM_t::ROB_empty(void) { return 0 == ROB_num; }
@@ -735,7 +735,7 @@ void core_commit_DPM_t::ROB_insert(struct uop_t* const uop) {
     uop->alloc.ROB_index = ROB_tail;
     ROB_num++;
     ROB_eff_num++;
-    ROB_tail = modinc(ROB_tail, knobs->commit.ROB_size);  //(ROB_tail+1) % knobs->commit.ROB_size;
+    ROB_tail = modinc(ROB_tail, CORE_KNOB(knobs, commit, ROB_size));  //(ROB_tail+1) % CORE_KNOB(knobs, commit, ROB_size);
 }
 
 void core_commit_DPM_t::ROB_fuse_insert(struct uop_t* const uop) {
@@ -744,7 +744,7 @@ void core_commit_DPM_t::ROB_fuse_insert(struct uop_t* const uop) {
 }
 
 void core_commit_DPM_t::ROB_pop_back() {
-    int back_ind = moddec(ROB_tail, core->knobs->commit.ROB_size);
+    int back_ind = moddec(ROB_tail, CORE_KNOB(core->knobs, commit, ROB_size));
     ROB[back_ind] = nullptr;
     ROB_tail = back_ind;
     ROB_num--;
@@ -756,7 +756,7 @@ void core_commit_DPM_t::ROB_pop_front() {
     ROB[ROB_head] = nullptr;
     ROB_num--;
     ROB_eff_num--;
-    ROB_head = modinc(ROB_head, core->knobs->commit.ROB_size);
+    ROB_head = modinc(ROB_head, CORE_KNOB(core->knobs, commit, ROB_size));
     xiosim_core_assert(ROB_num >= 0, core->id);
     xiosim_core_assert(ROB_eff_num >= 0, core->id);
 }
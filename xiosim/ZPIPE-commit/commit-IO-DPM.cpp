@@ -15,7 +15,7 @@
     return std::make_unique<class core_commit_IO_DPM_t>(core);
 #else
 
-class core_commit_IO_DPM_t:public core_commit_t
+class core_commit_IO_DPM_t final : public core_commit_t
 {
   enum commit_stall_t {CSTALL_NONE,      /* no stall */
                        CSTALL_NOT_READY, /* oldest inst not done (no uops finished) */
@@ -102,11 +102,11 @@ core_commit_IO_DPM_t::core_commit_IO_DPM_t(struct core_t * const arg_core):
 {
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
-  ROB = (struct uop_t**) calloc(knobs->commit.ROB_size,sizeof(*ROB));
+  ROB = (struct uop_t**) calloc(CORE_KNOB(knobs, commit, ROB_size),sizeof(*ROB));
   if(!ROB)
     fatal("couldn't calloc ROB");
 
-  pre_commit_pipe = (struct uop_t**) calloc(knobs->commit.pre_commit_depth, sizeof(*pre_commit_pipe));
+  pre_commit_pipe = (struct uop_t**) calloc(CORE_KNOB(knobs, commit, pre_commit_depth), sizeof(*pre_commit_pipe));
   if(!pre_commit_pipe)
     fatal("couldn't calloc pre-commit pipe");
 
@@ -320,7 +320,7 @@ void core_commit_IO_DPM_t::update_occupancy(void)
     /* ROB */
   core->stat.ROB_occupancy += ROB_num;
   core->stat.ROB_eff_occupancy += ROB_eff_num;
-  if(ROB_num >= core->knobs->commit.ROB_size)
+  if(ROB_num >= CORE_KNOB(core->knobs, commit, ROB_size))
     core->stat.ROB_full_cycles++;
   if(ROB_num <= 0)
     core->stat.ROB_empty_cycles++;
@@ -357,7 +357,7 @@ void core_commit_IO_DPM_t::IO_step(void)
   core->exec->STQ_deallocate_senior();
 
   /* MAIN COMMIT LOOP */
-  for(commit_count=0;commit_count<knobs->commit.width;commit_count++)
+  for(commit_count=0;commit_count<CORE_KNOB(knobs, commit, width);commit_count++)
   {
     if(ROB_num <= 0) /* nothing to commit */
     {
@@ -375,7 +375,7 @@ void core_commit_IO_DPM_t::IO_step(void)
       break;
     }
 
-    if(Mop->decode.is_ctrl && knobs->commit.branch_limit && (branches_committed >= knobs->commit.branch_limit))
+    if(Mop->decode.is_ctrl && CORE_KNOB(knobs, commit, branch_limit) && (branches_committed >= CORE_KNOB(knobs, commit, branch_limit)))
     {
       stall_reason = CSTALL_MAX_BRANCHES;
       break;
@@ -472,7 +472,7 @@ void core_commit_IO_DPM_t::IO_step(void)
         ROB[ROB_head] = NULL;
         ROB_num --;
         ROB_eff_num --;
-        ROB_head = modinc(ROB_head,knobs->commit.ROB_size); //(ROB_head+1) % knobs->commit.ROB_size;
+        ROB_head = modinc(ROB_head,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_head+1) % CORE_KNOB(knobs, commit, ROB_size);
         if(uop->decode.in_fusion)
         {
           ZESTO_STAT(core->stat.commit_fusions++;)
@@ -782,7 +782,7 @@ core_commit_IO_DPM_t::recover(const struct Mop_t * const Mop)
       /* if uop older than squashed one, leave it to commit */
       if(curr_uop->decode.Mop_seq <= Mop->oracle.seq)
       {
-        i=modinc(i, knobs->commit.ROB_size);
+        i=modinc(i, CORE_KNOB(knobs, commit, ROB_size));
         old_entries++;
         continue;
       }
@@ -799,15 +799,15 @@ core_commit_IO_DPM_t::recover(const struct Mop_t * const Mop)
       zesto_assert(ROB_eff_num >= 0,(void)0);
       squashed_uops++;
 
-      i=modinc(i, knobs->commit.ROB_size);
+      i=modinc(i, CORE_KNOB(knobs, commit, ROB_size));
     } while(i != ROB_tail);
   }
 
-  ROB_tail = (ROB_tail - squashed_uops) % knobs->commit.ROB_size;
+  ROB_tail = (ROB_tail - squashed_uops) % CORE_KNOB(knobs, commit, ROB_size);
   zesto_assert(ROB_num == old_entries, (void)0);
 
   /* flush uops in the pre_commit pipe */
-  for(int i=knobs->commit.pre_commit_depth-1; i>-1; i--)
+  for(int i=CORE_KNOB(knobs, commit, pre_commit_depth)-1; i>-1; i--)
   {
     curr_uop = pre_commit_pipe[i];
 
@@ -854,7 +854,7 @@ core_commit_IO_DPM_t::recover(void)
       zesto_assert(ROB_num >= 0,(void)0);
       zesto_assert(ROB_eff_num >= 0,(void)0);
 
-      i=modinc(i, knobs->commit.ROB_size);
+      i=modinc(i, CORE_KNOB(knobs, commit, ROB_size));
     } while(i != ROB_tail);
   }
 
@@ -863,7 +863,7 @@ core_commit_IO_DPM_t::recover(void)
   ROB_tail = ROB_head;
 
   /* flush uops in the pre_commit pipe */
-  for(int i=knobs->commit.pre_commit_depth-1; i>-1; i--)
+  for(int i=CORE_KNOB(knobs, commit, pre_commit_depth)-1; i>-1; i--)
   {
     curr_uop = pre_commit_pipe[i];
 
@@ -880,7 +880,7 @@ core_commit_IO_DPM_t::recover(void)
 bool core_commit_IO_DPM_t::ROB_available(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return ROB_num < knobs->commit.ROB_size;
+  return ROB_num < CORE_KNOB(knobs, commit, ROB_size);
 }
 
 bool core_commit_IO_DPM_t::ROB_empty(void)
@@ -893,7 +893,7 @@ bool core_commit_IO_DPM_t::pipe_empty(void)
   if(ROB_num > 0)
     return false;
 
-  for(int stage=core->knobs->commit.pre_commit_depth-1; stage>-1; stage--)
+  for(int stage=CORE_KNOB(core->knobs, commit, pre_commit_depth)-1; stage>-1; stage--)
     if(pre_commit_pipe[stage] != NULL)
       return false;
 
@@ -908,9 +908,9 @@ void core_commit_IO_DPM_t::ROB_insert(struct uop_t * const uop)
   ROB_num++;
   ROB_eff_num++;
 
-  ROB_tail = modinc(ROB_tail,knobs->commit.ROB_size); //(ROB_tail+1) % knobs->commit.ROB_size;
+  ROB_tail = modinc(ROB_tail,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_tail+1) % CORE_KNOB(knobs, commit, ROB_size);
 
-  zesto_assert(ROB_num <= knobs->commit.ROB_size, (void)0);
+  zesto_assert(ROB_num <= CORE_KNOB(knobs, commit, ROB_size), (void)0);
 }
 
 void core_commit_IO_DPM_t::ROB_fuse_insert(struct uop_t * const uop)
@@ -922,7 +922,7 @@ void core_commit_IO_DPM_t::ROB_fuse_insert(struct uop_t * const uop)
 bool core_commit_IO_DPM_t::pre_commit_available()
 {
   struct core_knobs_t * knobs = core->knobs;
-  for(int i=knobs->commit.width-1; i>-1; i--)
+  for(int i=CORE_KNOB(knobs, commit, width)-1; i>-1; i--)
     if(pre_commit_pipe[i] == NULL)
       return true;
 
@@ -932,7 +932,7 @@ bool core_commit_IO_DPM_t::pre_commit_available()
 void core_commit_IO_DPM_t::pre_commit_insert(struct uop_t * const uop)
 {
   struct core_knobs_t * knobs = core->knobs;
-  int i = knobs->commit.width-1;
+  int i = CORE_KNOB(knobs, commit, width)-1;
   for(; i>-1; i--)
     if(pre_commit_pipe[i] == NULL)
     {
@@ -955,14 +955,14 @@ void core_commit_IO_DPM_t::pre_commit_fused_insert(struct uop_t * const uop)
 void core_commit_IO_DPM_t::pre_commit_step()
 {
   struct core_knobs_t * knobs = core->knobs;
-  int stage = knobs->commit.pre_commit_depth-1;
+  int stage = CORE_KNOB(knobs, commit, pre_commit_depth)-1;
 
   struct uop_t * uop;
 
   bool stall = false;
 
   //send uops at the end of pipe to commit
-  for(int j=0; j < knobs->commit.width; j++)
+  for(int j=0; j < CORE_KNOB(knobs, commit, width); j++)
   {
     stage-=j;
     uop = pre_commit_pipe[stage];
@@ -1000,7 +1000,7 @@ void core_commit_IO_DPM_t::pre_commit_step()
   int dest_stage;
   for(;stage > -1; stage--)
   {
-    dest_stage = stage + knobs->commit.width;
+    dest_stage = stage + CORE_KNOB(knobs, commit, width);
     if(pre_commit_pipe[stage])
     {
        //should already be NULL-ed
@@ -1021,7 +1021,7 @@ void core_commit_IO_DPM_t::pre_commit_recover(struct Mop_t * const Mop)
   assert(Mop != NULL);
   struct core_knobs_t * knobs = core->knobs;
 
-  int stage = knobs->commit.pre_commit_depth-1;
+  int stage = CORE_KNOB(knobs, commit, pre_commit_depth)-1;
 
   while(stage >= 0)
   {
@@ -8,7 +8,7 @@
     return std::make_unique<class core_commit_STM_t>(core);
 #else
 
-class core_commit_STM_t:public core_commit_t
+class core_commit_STM_t final : public core_commit_t
 {
   enum commit_stall_t {CSTALL_NONE,      /* no stall */
                        CSTALL_NOT_READY, /* oldest inst not done (no uops finished) */
@@ -81,7 +81,7 @@ core_commit_STM_t::core_commit_STM_t(struct core_t * const arg_core):
 {
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
-  ROB = (struct uop_t**) calloc(knobs->commit.ROB_size,sizeof(*ROB));
+  ROB = (struct uop_t**) calloc(CORE_KNOB(knobs, commit, ROB_size),sizeof(*ROB));
   if(!ROB)
     fatal("couldn't calloc ROB");
 }
@@ -133,7 +133,7 @@ void core_commit_STM_t::update_occupancy(void)
 {
     /* ROB */
   core->stat.ROB_occupancy += ROB_num;
-  if(ROB_num >= core->knobs->commit.ROB_size)
+  if(ROB_num >= CORE_KNOB(core->knobs, commit, ROB_size))
     core->stat.ROB_full_cycles++;
   if(ROB_num <= 0)
     core->stat.ROB_empty_cycles++;
@@ -167,7 +167,7 @@ void core_commit_STM_t::step(void)
   }
 
   /* MAIN COMMIT LOOP */
-  for(commit_count=0;commit_count<knobs->commit.width;commit_count++)
+  for(commit_count=0;commit_count<CORE_KNOB(knobs, commit, width);commit_count++)
   {
     if(ROB_num <= 0) /* nothing to commit */
     {
@@ -237,7 +237,7 @@ void core_commit_STM_t::step(void)
       /* remove uop from ROB */
       ROB[ROB_head] = NULL;
       ROB_num --;
-      ROB_head = modinc(ROB_head,knobs->commit.ROB_size); //(ROB_head+1) % knobs->commit.ROB_size;
+      ROB_head = modinc(ROB_head,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_head+1) % CORE_KNOB(knobs, commit, ROB_size);
       uop->alloc.ROB_index = -1;
 
       /* this cleans up idep/odep ptrs, register mappings, and
@@ -299,7 +299,7 @@ core_commit_STM_t::recover(const struct Mop_t * const Mop)
   if(ROB_num > 0)
   {
     /* requested uop should always be in the ROB */
-    int index = moddec(ROB_tail,knobs->commit.ROB_size); //(ROB_tail-1+knobs->commit.ROB_size) % knobs->commit.ROB_size;
+    int index = moddec(ROB_tail,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_tail-1+CORE_KNOB(knobs, commit, ROB_size)) % CORE_KNOB(knobs, commit, ROB_size);
 
     /* if there's only the one inst in the pipe, then we don't need to drain */
     if(knobs->alloc.drain_flush && (ROB[index]->Mop != Mop))
@@ -381,11 +381,11 @@ core_commit_STM_t::recover(const struct Mop_t * const Mop)
       zesto_assert(dead_uop->exec.odep_uop == NULL,(void)0);
 
       ROB[index] = NULL;
-      ROB_tail = moddec(ROB_tail,knobs->commit.ROB_size); //(ROB_tail-1+knobs->commit.ROB_size) % knobs->commit.ROB_size;
+      ROB_tail = moddec(ROB_tail,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_tail-1+CORE_KNOB(knobs, commit, ROB_size)) % CORE_KNOB(knobs, commit, ROB_size);
       ROB_num --;
       zesto_assert(ROB_num >= 0,(void)0);
 
-      index = moddec(index,knobs->commit.ROB_size); //(index-1+knobs->commit.ROB_size) % knobs->commit.ROB_size;
+      index = moddec(index,CORE_KNOB(knobs, commit, ROB_size)); //(index-1+CORE_KNOB(knobs, commit, ROB_size)) % CORE_KNOB(knobs, commit, ROB_size);
     }
   }
 }
@@ -397,7 +397,7 @@ core_commit_STM_t::recover(void)
   if(ROB_num > 0)
   {
     /* requested uop should always be in the ROB */
-    int index = moddec(ROB_tail,knobs->commit.ROB_size); //(ROB_tail-1+knobs->commit.ROB_size) % knobs->commit.ROB_size;
+    int index = moddec(ROB_tail,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_tail-1+CORE_KNOB(knobs, commit, ROB_size)) % CORE_KNOB(knobs, commit, ROB_size);
 
     while(ROB[index])
     {
@@ -475,11 +475,11 @@ core_commit_STM_t::recover(void)
       zesto_assert(dead_uop->exec.odep_uop == NULL,(void)0);
 
       ROB[index] = NULL;
-      ROB_tail = moddec(ROB_tail,knobs->commit.ROB_size); //(ROB_tail-1+knobs->commit.ROB_size) % knobs->commit.ROB_size;
+      ROB_tail = moddec(ROB_tail,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_tail-1+CORE_KNOB(knobs, commit, ROB_size)) % CORE_KNOB(knobs, commit, ROB_size);
       ROB_num --;
       zesto_assert(ROB_num >= 0,(void)0);
 
-      index = moddec(index,knobs->commit.ROB_size); //(index-1+knobs->commit.ROB_size) % knobs->commit.ROB_size;
+      index = moddec(index,CORE_KNOB(knobs, commit, ROB_size)); //(index-1+CORE_KNOB(knobs, commit, ROB_size)) % CORE_KNOB(knobs, commit, ROB_size);
     }
   }
 
@@ -490,7 +490,7 @@ core_commit_STM_t::recover(void)
 bool core_commit_STM_t::ROB_available(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return ROB_num < knobs->commit.ROB_size;
+  return ROB_num < CORE_KNOB(knobs, commit, ROB_size);
 }
 
 bool core_commit_STM_t::ROB_empty(void)
@@ -509,7 +509,7 @@ void core_commit_STM_t::ROB_insert(struct uop_t * const uop)
   ROB[ROB_tail] = uop;
   uop->alloc.ROB_index = ROB_tail;
   ROB_num++;
-  ROB_tail = modinc(ROB_tail,knobs->commit.ROB_size); //(ROB_tail+1) % knobs->commit.ROB_size;
+  ROB_tail = modinc(ROB_tail,CORE_KNOB(knobs, commit, ROB_size)); //(ROB_tail+1) % CORE_KNOB(knobs, commit, ROB_size);
 }
 
 void core_commit_STM_t::ROB_fuse_insert(struct uop_t * const uop)
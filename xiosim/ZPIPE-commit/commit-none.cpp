@@ -3,7 +3,7 @@
     return std::make_unique<class core_commit_NONE_t>(core);
 #else
 
-class core_commit_NONE_t:public core_commit_t
+class core_commit_NONE_t final : public core_commit_t
 {
   public:
 
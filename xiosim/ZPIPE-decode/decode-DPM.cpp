@@ -9,7 +9,7 @@
     return std::make_unique<class core_decode_DPM_t>(core);
 #else
 
-class core_decode_DPM_t:public core_decode_t
+class core_decode_DPM_t final : public core_decode_t
 {
   enum decode_stall_t {DSTALL_NONE,   /* no stall */
                        DSTALL_FULL,   /* first decode stage is full */
@@ -79,32 +79,32 @@ core_decode_DPM_t::core_decode_DPM_t(struct core_t * const arg_core):
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
 
-  if(knobs->decode.depth <= 0)
+  if(CORE_KNOB(knobs, decode, depth) <= 0)
     fatal("decode pipe depth must be > 0");
 
-  if(knobs->decode.width <= 0)
+  if(CORE_KNOB(knobs, decode, width) <= 0)
     fatal("decode pipe width must be > 0");
 
-  if(knobs->decode.target_stage <= 0 || knobs->decode.target_stage >= knobs->decode.depth)
-    fatal("decode target resteer stage (%d) must be > 0, and less than decode pipe depth (currently set to %d)",knobs->decode.target_stage,knobs->decode.depth);
+  if(CORE_KNOB(knobs, decode, target_stage) <= 0 || CORE_KNOB(knobs, decode, target_stage) >= CORE_KNOB(knobs, decode, depth))
+    fatal("decode target resteer stage (%d) must be > 0, and less than decode pipe depth (currently set to %d)",CORE_KNOB(knobs, decode, target_stage),CORE_KNOB(knobs, decode, depth));
 
   /* if the pipe is N wide, we assume there are N decoders */
-  pipe = (struct Mop_t***) calloc(knobs->decode.depth,sizeof(*pipe));
+  pipe = (struct Mop_t***) calloc(CORE_KNOB(knobs, decode, depth),sizeof(*pipe));
   if(!pipe)
     fatal("couldn't calloc decode pipe");
 
-  for(int i=0;i<knobs->decode.depth;i++)
+  for(int i=0;i<CORE_KNOB(knobs, decode, depth);i++)
   {
-    pipe[i] = (struct Mop_t**) calloc(knobs->decode.width,sizeof(**pipe));
+    pipe[i] = (struct Mop_t**) calloc(CORE_KNOB(knobs, decode, width),sizeof(**pipe));
     if(!pipe[i])
       fatal("couldn't calloc decode pipe stage");
   }
 
-  occupancy = (int*) calloc(knobs->decode.depth,sizeof(*occupancy));
+  occupancy = (int*) calloc(CORE_KNOB(knobs, decode, depth),sizeof(*occupancy));
   if(!occupancy)
     fatal("couldn't calloc decode pipe occupancy array");
 
-  uopQ = (struct uop_t**) calloc(knobs->decode.uopQ_size,sizeof(*uopQ));
+  uopQ = (struct uop_t**) calloc(CORE_KNOB(knobs, decode, uopQ_size),sizeof(*uopQ));
   if(!uopQ)
     fatal("couldn't calloc uopQ");
 }
@@ -113,7 +113,7 @@ core_decode_DPM_t::~core_decode_DPM_t() {
     free(uopQ);
 
     free(occupancy);
-    for (int i = 0; i < core->knobs->decode.depth; i++)
+    for (int i = 0; i < CORE_KNOB(core->knobs, decode, depth); i++)
         free(pipe[i]);
     free(pipe);
 }
@@ -156,7 +156,7 @@ void core_decode_DPM_t::update_occupancy(void)
     /* uopQ */
   core->stat.uopQ_occupancy += uopQ_num;
   core->stat.uopQ_eff_occupancy += uopQ_eff_num;
-  if(uopQ_num >= core->knobs->decode.uopQ_size)
+  if(uopQ_num >= CORE_KNOB(core->knobs, decode, uopQ_size))
     core->stat.uopQ_full_cycles++;
   if(uopQ_num <= 0)
     core->stat.uopQ_empty_cycles++;
@@ -221,7 +221,7 @@ bool core_decode_DPM_t::check_flush(const int stage, const int idx)
 
   if(Mop)
   {
-    if((stage-1) == knobs->decode.target_stage)
+    if((stage-1) == CORE_KNOB(knobs, decode, target_stage))
     {
       if((stall_reason = check_target(Mop)))
       {
@@ -230,7 +230,7 @@ bool core_decode_DPM_t::check_flush(const int stage, const int idx)
         if(pipe[stage][idx]) {
           occupancy[stage]++;
           occupancy[stage-1]--;
-          zesto_assert(occupancy[stage] <= knobs->decode.width,false);
+          zesto_assert(occupancy[stage] <= CORE_KNOB(knobs, decode, width),false);
           zesto_assert(occupancy[stage-1] >= 0,false);
         }
         ZESTO_STAT(stat_add_sample(core->stat.decode_stall, (int)stall_reason);)
@@ -254,13 +254,13 @@ void core_decode_DPM_t::step(void)
   enum decode_stall_t stall_reason = DSTALL_NONE;
 
   /* move decoded uops to uopQ */
-  stage = knobs->decode.depth-1;
+  stage = CORE_KNOB(knobs, decode, depth)-1;
   if(occupancy[stage])
-    for(i=0;i<knobs->decode.width;i++)
+    for(i=0;i<CORE_KNOB(knobs, decode, width);i++)
     {
       if(pipe[stage][i])
       {
-        while(uopQ_num < knobs->decode.uopQ_size)   /* while uopQ is not full */
+        while(uopQ_num < CORE_KNOB(knobs, decode, uopQ_size))   /* while uopQ is not full */
         {
           struct Mop_t * Mop = pipe[stage][i];      /* Mop in current decoder */
           struct uop_t * uop = &Mop->uop[Mop->decode.last_stage_index]; /* first non-queued uop */
@@ -269,7 +269,7 @@ void core_decode_DPM_t::step(void)
           if((!uop->decode.in_fusion) || uop->decode.is_fusion_head) /* don't enqueue fusion body */
           {
             uopQ[uopQ_tail] = uop;      /* queue the uop */
-            uopQ_tail = modinc(uopQ_tail,knobs->decode.uopQ_size); //(uopQ_tail+1) % knobs->decode.uopQ_size;
+            uopQ_tail = modinc(uopQ_tail,CORE_KNOB(knobs, decode, uopQ_size)); //(uopQ_tail+1) % CORE_KNOB(knobs, decode, uopQ_size);
             uopQ_num++;
             if(uop->decode.is_fusion_head)
               uopQ_eff_num += uop->decode.fusion_size;
@@ -305,13 +305,13 @@ void core_decode_DPM_t::step(void)
             break;
           }
         }
-        if(uopQ_num >= knobs->decode.uopQ_size)
+        if(uopQ_num >= CORE_KNOB(knobs, decode, uopQ_size))
           break; /* uopQ is full */
       }
     }
 
   /* walk pipe backwards up to and but not including the first stage*/
-  for(stage=knobs->decode.depth-1; stage > 0; stage--)
+  for(stage=CORE_KNOB(knobs, decode, depth)-1; stage > 0; stage--)
   {
     if(0 == occupancy[stage]) /* implementing non-serpentine pipe (no compressing) - can't advance until stage is empty */
     {
@@ -322,7 +322,7 @@ void core_decode_DPM_t::step(void)
 
       /* move everyone from previous stage forward */
       if(occupancy[stage-1])
-        for(i=0;i<knobs->decode.width;i++)
+        for(i=0;i<CORE_KNOB(knobs, decode, width);i++)
         {
           if(check_flush(stage,i))
             return;
@@ -332,7 +332,7 @@ void core_decode_DPM_t::step(void)
           if(pipe[stage][i]) {
             occupancy[stage]++;
             occupancy[stage-1]--;
-            zesto_assert(occupancy[stage] <= knobs->decode.width,(void)0);
+            zesto_assert(occupancy[stage] <= CORE_KNOB(knobs, decode, width),(void)0);
             zesto_assert(occupancy[stage-1] >= 0,(void)0);
           }
         }
@@ -350,13 +350,13 @@ void core_decode_DPM_t::step(void)
     {
       int Mops_decoded = 0;
       int branches_decoded = 0;
-      for(i=0;(i<knobs->decode.width) && core->fetch->Mop_available();i++)
+      for(i=0;(i<CORE_KNOB(knobs, decode, width)) && core->fetch->Mop_available();i++)
       {
         if(pipe[0][i] == NULL) /* decoder available */
         {
           struct Mop_t * IQ_Mop = core->fetch->Mop_peek();
 
-          if(IQ_Mop->decode.is_ctrl && knobs->decode.branch_decode_limit && (branches_decoded >= knobs->decode.branch_decode_limit))
+          if(IQ_Mop->decode.is_ctrl && CORE_KNOB(knobs, decode, branch_decode_limit) && (branches_decoded >= CORE_KNOB(knobs, decode, branch_decode_limit)))
           {
             stall_reason = DSTALL_MAX_BRANCHES;
             break;
@@ -367,7 +367,7 @@ void core_decode_DPM_t::step(void)
             /* consume the Mop from the IQ */
             pipe[0][i] = IQ_Mop;
             occupancy[0]++;
-            zesto_assert(occupancy[0] <= knobs->decode.width,(void)0);
+            zesto_assert(occupancy[0] <= CORE_KNOB(knobs, decode, width),(void)0);
             core->fetch->Mop_consume();
             Mops_decoded++;
 
@@ -378,7 +378,7 @@ void core_decode_DPM_t::step(void)
             /* does this Mop need help from the MS? */
             if((knobs->decode.max_uops[i] && (pipe[0][i]->stat.num_uops > knobs->decode.max_uops[i])) ||
                 pipe[0][i]->decode.has_rep)
-              pipe[0][i]->timing.when_MS_started = core->sim_cycle + knobs->decode.MS_latency; /* all other insts (non-MS) have this timestamp default to TICK_T_MAX */
+              pipe[0][i]->timing.when_MS_started = core->sim_cycle + CORE_KNOB(knobs, decode, MS_latency); /* all other insts (non-MS) have this timestamp default to TICK_T_MAX */
             if(IQ_Mop->decode.is_ctrl)
               branches_decoded++;
           }
@@ -390,7 +390,7 @@ void core_decode_DPM_t::step(void)
               /* consume the Mop from the IQ */
               pipe[0][i] = IQ_Mop;
               occupancy[0]++;
-              zesto_assert(occupancy[0] <= knobs->decode.width,(void)0);
+              zesto_assert(occupancy[0] <= CORE_KNOB(knobs, decode, width),(void)0);
               core->fetch->Mop_consume();
               Mops_decoded++;
               if(IQ_Mop->decode.is_ctrl)
@@ -433,10 +433,10 @@ core_decode_DPM_t::recover(struct Mop_t * const Mop)
   struct core_knobs_t * knobs = core->knobs;
   /* walk pipe from youngest uop blowing everything away,
      stop if we encounter the recover-Mop */
-  for(int stage=0;stage<knobs->decode.depth;stage++)
+  for(int stage=0;stage<CORE_KNOB(knobs, decode, depth);stage++)
   {
     if(occupancy[stage])
-      for(int i=knobs->decode.width-1;i>=0;i--)
+      for(int i=CORE_KNOB(knobs, decode, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -462,7 +462,7 @@ core_decode_DPM_t::recover_uopQ(const struct Mop_t * const Mop)
 
   while(uopQ_num)
   {
-    int index = moddec(uopQ_tail,knobs->decode.uopQ_size); //(uopQ_tail-1+knobs->decode.uopQ_size) % knobs->decode.uopQ_size;
+    int index = moddec(uopQ_tail,CORE_KNOB(knobs, decode, uopQ_size)); //(uopQ_tail-1+CORE_KNOB(knobs, decode, uopQ_size)) % CORE_KNOB(knobs, decode, uopQ_size);
     if(uopQ[index]->Mop == Mop)
       return;
     if(uopQ[index]->decode.is_fusion_head)
@@ -485,13 +485,13 @@ core_decode_DPM_t::recover_uopQ(void)
   /*
   while(uopQ_num)
   {
-    int index = moddec(uopQ_tail,knobs->decode.uopQ_size); //(uopQ_tail-1+knobs->decode.uopQ_size) % knobs->decode.uopQ_size;
+    int index = moddec(uopQ_tail,CORE_KNOB(knobs, decode, uopQ_size)); //(uopQ_tail-1+CORE_KNOB(knobs, decode, uopQ_size)) % CORE_KNOB(knobs, decode, uopQ_size);
     uopQ[index] = NULL;
     uopQ_tail = index;
     uopQ_num--;
   }
   */
-  memzero(uopQ,sizeof(*uopQ)*knobs->decode.uopQ_size);
+  memzero(uopQ,sizeof(*uopQ)*CORE_KNOB(knobs, decode, uopQ_size));
   uopQ_head = 0;
   uopQ_tail = 0;
   uopQ_num = 0;
@@ -504,10 +504,10 @@ core_decode_DPM_t::recover_decode_pipe(const struct Mop_t * const Mop)
   struct core_knobs_t * knobs = core->knobs;
   /* walk pipe from youngest uop blowing everything away,
      stop if we encounter the recover-Mop */
-  for(int stage=0;stage<knobs->decode.depth;stage++)
+  for(int stage=0;stage<CORE_KNOB(knobs, decode, depth);stage++)
   {
     if(occupancy[stage])
-      for(int i=knobs->decode.width-1;i>=0;i--)
+      for(int i=CORE_KNOB(knobs, decode, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -529,10 +529,10 @@ void
 core_decode_DPM_t::recover_decode_pipe(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  for(int stage=0;stage<knobs->decode.depth;stage++)
+  for(int stage=0;stage<CORE_KNOB(knobs, decode, depth);stage++)
   {
     if(occupancy[stage])
-      for(int i=knobs->decode.width-1;i>=0;i--)
+      for(int i=CORE_KNOB(knobs, decode, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -565,7 +565,7 @@ void core_decode_DPM_t::uop_consume(void)
     uopQ_eff_num -= uop->decode.fusion_size;
   else
     uopQ_eff_num --;
-  uopQ_head = modinc(uopQ_head,knobs->decode.uopQ_size); //(uopQ_head+1)%knobs->decode.uopQ_size;
+  uopQ_head = modinc(uopQ_head,CORE_KNOB(knobs, decode, uopQ_size)); //(uopQ_head+1)%CORE_KNOB(knobs, decode, uopQ_size);
 }
 
 #endif
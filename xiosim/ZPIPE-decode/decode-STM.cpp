@@ -8,7 +8,7 @@
     return std::make_unique<class core_decode_STM_t>(core);
 #else
 
-class core_decode_STM_t:public core_decode_t
+class core_decode_STM_t final : public core_decode_t
 {
   enum decode_stall_t {DSTALL_NONE,   /* no stall */
                        DSTALL_FULL,   /* first decode stage is full */
@@ -57,35 +57,35 @@ core_decode_STM_t::core_decode_STM_t(struct core_t * const arg_core)
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
 
-  if(knobs->decode.depth <= 0)
+  if(CORE_KNOB(knobs, decode, depth) <= 0)
     fatal("decode pipe depth must be > 0");
 
-  if(knobs->decode.width <= 0)
+  if(CORE_KNOB(knobs, decode, width) <= 0)
     fatal("decode pipe width must be > 0");
 
-  if(knobs->decode.target_stage <= 0 || knobs->decode.target_stage >= knobs->decode.depth)
-    fatal("decode target resteer stage (%d) must be > 0, and less than decode pipe depth (currently set to %d)",knobs->decode.target_stage,knobs->decode.depth);
+  if(CORE_KNOB(knobs, decode, target_stage) <= 0 || CORE_KNOB(knobs, decode, target_stage) >= CORE_KNOB(knobs, decode, depth))
+    fatal("decode target resteer stage (%d) must be > 0, and less than decode pipe depth (currently set to %d)",CORE_KNOB(knobs, decode, target_stage),CORE_KNOB(knobs, decode, depth));
 
   /* if the pipe is N wide, we assume there are N decoders */
-  pipe = (struct Mop_t***) calloc(knobs->decode.depth,sizeof(*pipe));
+  pipe = (struct Mop_t***) calloc(CORE_KNOB(knobs, decode, depth),sizeof(*pipe));
   if(!pipe)
     fatal("couldn't calloc decode pipe");
 
-  for(int i=0;i<knobs->decode.depth;i++)
+  for(int i=0;i<CORE_KNOB(knobs, decode, depth);i++)
   {
-    pipe[i] = (struct Mop_t**) calloc(knobs->decode.width,sizeof(**pipe));
+    pipe[i] = (struct Mop_t**) calloc(CORE_KNOB(knobs, decode, width),sizeof(**pipe));
     if(!pipe[i])
       fatal("couldn't calloc decode pipe stage");
   }
 
-  occupancy = (int*) calloc(knobs->decode.depth,sizeof(*occupancy));
+  occupancy = (int*) calloc(CORE_KNOB(knobs, decode, depth),sizeof(*occupancy));
   if(!occupancy)
     fatal("couldn't calloc decode pipe occupancy array");
 }
 
 core_decode_STM_t::~core_decode_STM_t() {
     free(occupancy);
-    for (int i = 0; i < core->knobs->decode.depth; i++)
+    for (int i = 0; i < CORE_KNOB(core->knobs, decode, depth); i++)
         free(pipe[i]);
     free(pipe);
 }
@@ -165,7 +165,7 @@ bool core_decode_STM_t::check_flush(const int stage, const int idx)
 
   if(Mop)
   {
-    if((stage-1) == knobs->decode.target_stage)
+    if((stage-1) == CORE_KNOB(knobs, decode, target_stage))
     {
       if((stall_reason = check_target(Mop)))
       {
@@ -174,7 +174,7 @@ bool core_decode_STM_t::check_flush(const int stage, const int idx)
         if(pipe[stage][idx]) {
           occupancy[stage]++;
           occupancy[stage-1]--;
-          zesto_assert(occupancy[stage] <= knobs->decode.width,false);
+          zesto_assert(occupancy[stage] <= CORE_KNOB(knobs, decode, width),false);
           zesto_assert(occupancy[stage-1] >= 0,false);
         }
         ZESTO_STAT(stat_add_sample(core->stat.decode_stall, (int)stall_reason);)
@@ -195,7 +195,7 @@ void core_decode_STM_t::step(void)
   enum decode_stall_t stall_reason = DSTALL_NONE;
 
   /* walk pipe backwards up to and but not including the first stage*/
-  for(stage=knobs->decode.depth-1; stage > 0; stage--)
+  for(stage=CORE_KNOB(knobs, decode, depth)-1; stage > 0; stage--)
   {
     if(0 == occupancy[stage]) /* implementing non-serpentine pipe (no compressing) - can't advance until stage is empty */
     {
@@ -203,7 +203,7 @@ void core_decode_STM_t::step(void)
 
       /* move everyone from previous stage forward */
       if(occupancy[stage-1])
-        for(i=0;i<knobs->decode.width;i++)
+        for(i=0;i<CORE_KNOB(knobs, decode, width);i++)
         {
           if(check_flush(stage,i))
             return;
@@ -213,7 +213,7 @@ void core_decode_STM_t::step(void)
           if(pipe[stage][i]) {
             occupancy[stage]++;
             occupancy[stage-1]--;
-            zesto_assert(occupancy[stage] <= knobs->decode.width,(void)0);
+            zesto_assert(occupancy[stage] <= CORE_KNOB(knobs, decode, width),(void)0);
             zesto_assert(occupancy[stage-1] >= 0,(void)0);
           }
         }
@@ -228,7 +228,7 @@ void core_decode_STM_t::step(void)
   else if(occupancy[0] == 0) /* non-serpentine pipe; only decode if first stage is empty */
   {
     int Mops_decoded = 0;
-    for(i=0;(i<knobs->decode.width) && core->fetch->Mop_available();i++)
+    for(i=0;(i<CORE_KNOB(knobs, decode, width)) && core->fetch->Mop_available();i++)
     {
       if(pipe[0][i] == NULL) /* decoder available */
       {
@@ -237,7 +237,7 @@ void core_decode_STM_t::step(void)
         /* consume the Mop from fetch */
         pipe[0][i] = fetch_Mop;
         occupancy[0]++;
-        zesto_assert(occupancy[0] <= knobs->decode.width,(void)0);
+        zesto_assert(occupancy[0] <= CORE_KNOB(knobs, decode, width),(void)0);
         core->fetch->Mop_consume();
         Mops_decoded++;
       }
@@ -255,10 +255,10 @@ core_decode_STM_t::recover(struct Mop_t * const Mop)
   struct core_knobs_t * knobs = core->knobs;
   /* walk pipe from youngest uop blowing everything away,
      stop if we encounter the recover-Mop */
-  for(int stage=0;stage<knobs->decode.depth;stage++)
+  for(int stage=0;stage<CORE_KNOB(knobs, decode, depth);stage++)
   {
     if(occupancy[stage])
-      for(int i=knobs->decode.width-1;i>=0;i--)
+      for(int i=CORE_KNOB(knobs, decode, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -280,10 +280,10 @@ void
 core_decode_STM_t::recover(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  for(int stage=0;stage<knobs->decode.depth;stage++)
+  for(int stage=0;stage<CORE_KNOB(knobs, decode, depth);stage++)
   {
     if(occupancy[stage])
-      for(int i=knobs->decode.width-1;i>=0;i--)
+      for(int i=CORE_KNOB(knobs, decode, width)-1;i>=0;i--)
       {
         if(pipe[stage][i])
         {
@@ -302,7 +302,7 @@ core_decode_STM_t::recover(void)
 bool core_decode_STM_t::uop_available(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  int stage = knobs->decode.depth-1;
+  int stage = CORE_KNOB(knobs, decode, depth)-1;
   return occupancy[stage] != 0; /* if last stage is not empty, a uop is available */
 }
 
@@ -310,11 +310,11 @@ struct uop_t * core_decode_STM_t::uop_peek(void)
 {
   struct core_knobs_t * knobs = core->knobs;
   struct uop_t * uop = NULL;
-  int stage = knobs->decode.depth-1;
+  int stage = CORE_KNOB(knobs, decode, depth)-1;
 
 
   /* assumes uop_available has already been called */
-  for(int i=0;i<knobs->decode.width;i++)
+  for(int i=0;i<CORE_KNOB(knobs, decode, width);i++)
   {
     if(pipe[stage][i])
     {
@@ -334,10 +334,10 @@ void core_decode_STM_t::uop_consume(void)
 {
   struct core_knobs_t * knobs = core->knobs;
   struct uop_t * uop = NULL;
-  int stage = knobs->decode.depth-1;
+  int stage = CORE_KNOB(knobs, decode, depth)-1;
 
   /* assumes uop_available has already been called */
-  for(int i=0;i<knobs->decode.width;i++)
+  for(int i=0;i<CORE_KNOB(knobs, decode, width);i++)
   {
     if(pipe[stage][i])
     {
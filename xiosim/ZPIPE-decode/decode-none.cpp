@@ -3,7 +3,7 @@
     return std::make_unique<class core_decode_NONE_t>(core);
 #else
 
-class core_decode_NONE_t:public core_decode_t
+class core_decode_NONE_t final : public core_decode_t
 {
   public:
 
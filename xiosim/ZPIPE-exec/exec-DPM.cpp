@@ -9,7 +9,7 @@
     return std::make_unique<class core_exec_DPM_t>(core);
 #else
 
-class core_exec_DPM_t:public core_exec_t
+class core_exec_DPM_t final : public core_exec_t
 {
   /* readyQ for scheduling */
   struct readyQ_node_t {
@@ -225,22 +225,22 @@ core_exec_DPM_t::core_exec_DPM_t(struct core_t * const arg_core):
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
 
-  RS = (struct uop_t**) calloc(knobs->exec.RS_size,sizeof(*RS));
+  RS = (struct uop_t**) calloc(CORE_KNOB(knobs, exec, RS_size),sizeof(*RS));
   if(!RS)
     fatal("couldn't calloc RS");
 
-  LDQ = (core_exec_DPM_t::LDQ_t*) calloc(knobs->exec.LDQ_size,sizeof(*LDQ));
+  LDQ = (core_exec_DPM_t::LDQ_t*) calloc(CORE_KNOB(knobs, exec, LDQ_size),sizeof(*LDQ));
   if(!LDQ)
     fatal("couldn't calloc LDQ");
 
-  STQ = (core_exec_DPM_t::STQ_t*) calloc(knobs->exec.STQ_size,sizeof(*STQ));
+  STQ = (core_exec_DPM_t::STQ_t*) calloc(CORE_KNOB(knobs, exec, STQ_size),sizeof(*STQ));
   if(!STQ)
     fatal("couldn't calloc STQ");
 
   int i;
   /* This shouldn't be necessary, but I threw it in because valgrind (memcheck)
      was reporting that STQ[i].sta was being used uninitialized. -GL */
-  for(i=0;i<knobs->exec.STQ_size;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, STQ_size);i++)
     STQ[i].sta = NULL;
 
   create_caches(true);
@@ -248,12 +248,12 @@ core_exec_DPM_t::core_exec_DPM_t(struct core_t * const arg_core):
   /************************************/
   /* execution port payload pipelines */
   /************************************/
-  port = (core_exec_DPM_t::exec_port_t*) calloc(knobs->exec.num_exec_ports,sizeof(*port));
+  port = (core_exec_DPM_t::exec_port_t*) calloc(CORE_KNOB(knobs, exec, num_exec_ports),sizeof(*port));
   if(!port)
     fatal("couldn't calloc exec ports");
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
-    port[i].payload_pipe = (struct uop_action_t*) calloc(knobs->exec.payload_depth,sizeof(*port->payload_pipe));
+    port[i].payload_pipe = (struct uop_action_t*) calloc(CORE_KNOB(knobs, exec, payload_depth),sizeof(*port->payload_pipe));
     if(!port[i].payload_pipe)
       fatal("couldn't calloc payload pipe");
   }
@@ -292,7 +292,7 @@ core_exec_DPM_t::core_exec_DPM_t(struct core_t * const arg_core):
   }
 
   /* shortened list of the FU's available on each port (to speed up FU loop in ALU_exec) */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     port[i].num_FU_types = 0;
     int j;
@@ -319,7 +319,7 @@ core_exec_DPM_t::core_exec_DPM_t(struct core_t * const arg_core):
 }
 
 core_exec_DPM_t::~core_exec_DPM_t() {
-    for (int i = 0; i < core->knobs->exec.num_exec_ports; i++) {
+    for (int i = 0; i < CORE_KNOB(core->knobs, exec, num_exec_ports); i++) {
         free(port[i].FU_types);
         if (port[i].STQ) {
             free(port[i].STQ->pipe);
@@ -421,26 +421,26 @@ void core_exec_DPM_t::update_occupancy(void) {
     /* RS */
     core->stat.RS_occupancy += RS_num;
     core->stat.RS_eff_occupancy += RS_eff_num;
-    if (RS_num >= core->knobs->exec.RS_size)
+    if (RS_num >= CORE_KNOB(core->knobs, exec, RS_size))
         core->stat.RS_full_cycles++;
     if (RS_num <= 0)
         core->stat.RS_empty_cycles++;
 
     /* LDQ */
     core->stat.LDQ_occupancy += LDQ_num;
-    if (LDQ_num >= core->knobs->exec.LDQ_size)
+    if (LDQ_num >= CORE_KNOB(core->knobs, exec, LDQ_size))
         core->stat.LDQ_full_cycles++;
     if (LDQ_num <= 0)
         core->stat.LDQ_empty_cycles++;
 
     /* STQ */
     core->stat.STQ_occupancy += STQ_num;
-    if (STQ_senior_num >= core->knobs->exec.STQ_size)
+    if (STQ_senior_num >= CORE_KNOB(core->knobs, exec, STQ_size))
         core->stat.STQ_full_cycles++;
     if (STQ_senior_num <= 0)
         core->stat.STQ_empty_cycles++;
 
-    for (int i = 0; i < core->knobs->exec.num_exec_ports; i++) {
+    for (int i = 0; i < CORE_KNOB(core->knobs, exec, num_exec_ports); i++) {
         for (int j = 0; j < port[i].num_FU_types; j++) {
             enum fu_class FU_type = port[i].FU_types[j];
             switch (FU_type) {
@@ -469,7 +469,7 @@ void core_exec_DPM_t::update_occupancy(void) {
 void core_exec_DPM_t::reset_execution(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  for(int i=0; i<knobs->exec.num_exec_ports; i++)
+  for(int i=0; i<CORE_KNOB(knobs, exec, num_exec_ports); i++)
   {
     port[i].when_bypass_used = 0;
 
@@ -529,7 +529,7 @@ void core_exec_DPM_t::return_readyQ_node(struct readyQ_node_t * const p)
    one readyQ per execution port) */
 void core_exec_DPM_t::insert_ready_uop(struct uop_t * const uop)
 {
-  zesto_assert((uop->alloc.port_assignment >= 0) && (uop->alloc.port_assignment < core->knobs->exec.num_exec_ports),(void)0);
+  zesto_assert((uop->alloc.port_assignment >= 0) && (uop->alloc.port_assignment < CORE_KNOB(core->knobs, exec, num_exec_ports)),(void)0);
   zesto_assert(uop->timing.when_completed == TICK_T_MAX,(void)0);
   zesto_assert(uop->timing.when_exec == TICK_T_MAX,(void)0);
   zesto_assert(uop->timing.when_issued == TICK_T_MAX,(void)0);
@@ -580,7 +580,7 @@ void core_exec_DPM_t::RS_schedule(void) /* for uops in the RS */
   int i;
 
   /* select/pick from ready instructions and send to exec ports */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     struct readyQ_node_t * rq = port[i].readyQ;
     struct readyQ_node_t * prev = NULL;
@@ -618,7 +618,7 @@ void core_exec_DPM_t::RS_schedule(void) /* for uops in the RS */
           port[i].payload_pipe[0].uop = uop;
           port[i].payload_pipe[0].action_id = uop->exec.action_id;
           port[i].occupancy++;
-          zesto_assert(port[i].occupancy <= knobs->exec.payload_depth,(void)0);
+          zesto_assert(port[i].occupancy <= CORE_KNOB(knobs, exec, payload_depth),(void)0);
           uop->timing.when_issued = core->sim_cycle;
           check_for_work = true;
 
@@ -654,7 +654,7 @@ void core_exec_DPM_t::RS_schedule(void) /* for uops in the RS */
 
           if(uop->decode.is_load)
           {
-            zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+            zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
             LDQ[uop->alloc.LDQ_index].speculative_broadcast = true;
           }
 
@@ -697,13 +697,13 @@ bool core_exec_DPM_t::check_load_issue_conditions(const struct uop_t * const uop
   int num_stores = 0; /* need this extra condition because STQ could be full with all stores older than the load we're considering */
 
   /* don't reissue someone who's already issued */
-  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),false);
+  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),false);
   if(LDQ[uop->alloc.LDQ_index].when_issued != TICK_T_MAX)
     return false;
 
   /* Conservative fence implementation -- if there is an older fence in LDQ,
    * don't issue. */
-  for (int j = LDQ_head; j != uop->alloc.LDQ_index; j = modinc(j, knobs->exec.LDQ_size)) {
+  for (int j = LDQ_head; j != uop->alloc.LDQ_index; j = modinc(j, CORE_KNOB(knobs, exec, LDQ_size))) {
     if (LDQ[j].uop->decode.is_lfence &&
         LDQ[j].uop->timing.when_completed == TICK_T_MAX)
       return false;
@@ -714,8 +714,8 @@ bool core_exec_DPM_t::check_load_issue_conditions(const struct uop_t * const uop
 
   /* this searches the senior STQ as well. */
   for(i=LDQ[uop->alloc.LDQ_index].store_color;
-      ((modinc(i,knobs->exec.STQ_size)) != STQ_senior_head) && (STQ[i].uop_seq < uop->decode.uop_seq) && (num_stores < STQ_senior_num);
-      i=moddec(i,knobs->exec.STQ_size) )
+      ((modinc(i,CORE_KNOB(knobs, exec, STQ_size))) != STQ_senior_head) && (STQ[i].uop_seq < uop->decode.uop_seq) && (num_stores < STQ_senior_num);
+      i=moddec(i,CORE_KNOB(knobs, exec, STQ_size)) )
   {
     if (STQ[i].is_fence)
       continue;
@@ -794,7 +794,7 @@ void core_exec_DPM_t::snatch_back(struct uop_t * const replayed_uop)
 {
   struct core_knobs_t * knobs = core->knobs;
   int index = 0;
-  struct uop_t ** stack = (struct uop_t**) alloca(sizeof(*stack) * knobs->exec.RS_size);
+  struct uop_t ** stack = (struct uop_t**) alloca(sizeof(*stack) * CORE_KNOB(knobs, exec, RS_size));
   if(!stack)
     fatal("couldn't alloca snatch_back_stack");
   stack[0] = replayed_uop;
@@ -810,7 +810,7 @@ void core_exec_DPM_t::snatch_back(struct uop_t * const replayed_uop)
     uop->timing.when_otag_ready = TICK_T_MAX;
     if(uop->decode.is_load)
     {
-      zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+      zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
       zesto_assert(uop->timing.when_completed == TICK_T_MAX,(void)0);
       LDQ[uop->alloc.LDQ_index].hit_in_STQ = false;
       LDQ[uop->alloc.LDQ_index].addr_valid = false;
@@ -823,7 +823,7 @@ void core_exec_DPM_t::snatch_back(struct uop_t * const replayed_uop)
 
     /* remove uop from payload RAM pipe */
     if(port[uop->alloc.port_assignment].occupancy > 0)
-      for(int i=0;i<knobs->exec.payload_depth;i++)
+      for(int i=0;i<CORE_KNOB(knobs, exec, payload_depth);i++)
         if(port[uop->alloc.port_assignment].payload_pipe[i].uop == uop)
         {
           port[uop->alloc.port_assignment].payload_pipe[i].uop = NULL;
@@ -885,7 +885,7 @@ void core_exec_DPM_t::snatch_back(struct uop_t * const replayed_uop)
 
 void core_exec_DPM_t::load_writeback(struct uop_t * const uop)
 {
-  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < core->knobs->exec.LDQ_size),(void)0);
+  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(core->knobs, exec, LDQ_size)),(void)0);
   if(!LDQ[uop->alloc.LDQ_index].hit_in_STQ) /* no match in STQ, so use cache value */
   {
 #ifdef ZTRACE
@@ -1232,7 +1232,7 @@ void core_exec_DPM_t::load_miss_reschedule(void * const op, const int new_pred_l
     /* now assume a hit in this cache level */
     odep = uop->exec.odep_uop;
     if(new_pred_latency != BIG_LATENCY)
-      uop->timing.when_otag_ready = core->sim_cycle + new_pred_latency - knobs->exec.payload_depth - 1;
+      uop->timing.when_otag_ready = core->sim_cycle + new_pred_latency - CORE_KNOB(knobs, exec, payload_depth) - 1;
 
     while(odep)
     {
@@ -1295,19 +1295,19 @@ void core_exec_DPM_t::LDST_exec(void)
       ztrace_print(uop,"e|STQ|load searches STQ for addr match");
 #endif
       int num_stores = 0;
-      zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+      zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
 
       /* check STQ for match, including senior STQ */
       /*for(j=LDQ[uop->alloc.LDQ_index].store_color;
           STQ[j].sta && (STQ[j].sta->decode.uop_seq < uop->decode.uop_seq) && (num_stores < STQ_senior_num);
-          j=(j-1+knobs->exec.STQ_size) % knobs->exec.STQ_size)*/
+          j=(j-1+CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size))*/
 
       j=LDQ[uop->alloc.LDQ_index].store_color;
 
       int cond1 = STQ[j].sta != NULL;
       seq_t seq1 = (seq_t)-1, seq2 = (seq_t)-1;
       zesto_assert(j >= 0,(void)0);
-      zesto_assert(j < knobs->exec.STQ_size,(void)0);
+      zesto_assert(j < CORE_KNOB(knobs, exec, STQ_size),(void)0);
       if(j)
       {
         seq1 = (seq_t)-2;
@@ -1527,7 +1527,7 @@ void core_exec_DPM_t::LDST_exec(void)
 
         num_stores++;
 
-        j=moddec(j,knobs->exec.STQ_size); //(j-1+knobs->exec.STQ_size) % knobs->exec.STQ_size;
+        j=moddec(j,CORE_KNOB(knobs, exec, STQ_size)); //(j-1+CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
 
         cond1 = STQ[j].sta != NULL;
         cond2 = cond1 && (STQ[j].sta->decode.uop_seq < uop->decode.uop_seq);
@@ -1550,7 +1550,7 @@ void core_exec_DPM_t::LDQ_schedule(void)
 
   int i;
   int index;
-  for(i = 0, index = LDQ_head; i < LDQ_num; i++, index = modinc(index, knobs->exec.LDQ_size))
+  for(i = 0, index = LDQ_head; i < LDQ_num; i++, index = modinc(index, CORE_KNOB(knobs, exec, LDQ_size)))
   {
     /* Load fences */
     if(LDQ[index].uop->decode.is_lfence) {
@@ -1563,8 +1563,8 @@ void core_exec_DPM_t::LDQ_schedule(void)
        * this lets us have multiple lfences in the same Mop.
        * FIXME(skanev): this scan is expensive, we can optimize it. */
       bool older_completed = true;
-      for (int j = moddec(index, knobs->exec.LDQ_size); j != moddec(LDQ_head, knobs->exec.LDQ_size);
-           j = moddec(j, knobs->exec.LDQ_size)) {
+      for (int j = moddec(index, CORE_KNOB(knobs, exec, LDQ_size)); j != moddec(LDQ_head, CORE_KNOB(knobs, exec, LDQ_size));
+           j = moddec(j, CORE_KNOB(knobs, exec, LDQ_size))) {
         if (LDQ[j].uop->timing.when_completed == TICK_T_MAX) {
           older_completed = false;
           break;
@@ -1610,7 +1610,7 @@ void core_exec_DPM_t::LDQ_schedule(void)
             bool send_to_dl1 = (!uop->oracle.is_repeated || (uop->oracle.is_repeated && knobs->memory.DL1_rep_req));
             if(!LDQ[index].first_byte_requested)
             {
-              if((cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr))) &&
+              if((cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift))) &&
                  (!send_to_dl1 || (send_to_dl1 && cache_enqueuable(core->memory.DL1.get(), asid, uop->oracle.virt_addr))) &&
                  (!uop->oracle.is_repeated || (uop->oracle.is_repeated && core->memory.mem_repeater->enqueuable(CACHE_READ, asid, uop->oracle.virt_addr))) &&
                  (port[uop->alloc.port_assignment].STQ->pipe[0].uop == NULL))
@@ -1618,7 +1618,7 @@ void core_exec_DPM_t::LDQ_schedule(void)
                 uop->exec.when_data_loaded = TICK_T_MAX;
                 if(!uop->oracle.is_sync_op && (uop->exec.when_addr_translated == 0)) {
                   uop->exec.when_addr_translated = TICK_T_MAX;
-                  cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr), uop->exec.action_id, 0, NO_MSHR, uop, DTLB_callback, load_miss_reschedule, NULL, get_uop_action_id);
+                  cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift), uop->exec.action_id, 0, NO_MSHR, uop, DTLB_callback, load_miss_reschedule, NULL, get_uop_action_id);
                 }
                 else
                   // The wait address is bogus, don't schedule a TLB translation
@@ -1655,8 +1655,8 @@ void core_exec_DPM_t::LDQ_schedule(void)
                 if(!LDQ[index].speculative_broadcast) /* need to re-wakeup children */
                 {
                   struct odep_t * odep = LDQ[index].uop->exec.odep_uop;
-                  if(knobs->exec.payload_depth < core->memory.DL1->latency) /* assume DL1 hit */
-                    LDQ[index].uop->timing.when_otag_ready = core->sim_cycle + core->memory.DL1->latency - knobs->exec.payload_depth;
+                  if(CORE_KNOB(knobs, exec, payload_depth) < core->memory.DL1->latency) /* assume DL1 hit */
+                    LDQ[index].uop->timing.when_otag_ready = core->sim_cycle + core->memory.DL1->latency - CORE_KNOB(knobs, exec, payload_depth);
                   else
                     LDQ[index].uop->timing.when_otag_ready = core->sim_cycle;
                   while(odep)
@@ -1778,7 +1778,7 @@ void core_exec_DPM_t::ST_ALU_exec(const struct uop_t * const uop)
   struct core_knobs_t * knobs = core->knobs;
 
   /* XXX using oracle info here. */
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(knobs, exec, STQ_size)),(void)0);
   md_addr_t st_addr1 = STQ[uop->alloc.STQ_index].sta->oracle.virt_addr;
   md_addr_t st_addr2 = st_addr1 + STQ[uop->alloc.STQ_index].mem_size - 1;
 
@@ -1789,7 +1789,7 @@ void core_exec_DPM_t::ST_ALU_exec(const struct uop_t * const uop)
 
   for(idx=STQ[uop->alloc.STQ_index].next_load;
       LDQ[idx].uop && (LDQ[idx].uop->decode.uop_seq > uop->decode.uop_seq) && (num_loads < LDQ_num);
-      idx=modinc(idx,knobs->exec.LDQ_size))
+      idx=modinc(idx,CORE_KNOB(knobs, exec, LDQ_size)))
   {
     if(!LDQ[idx].uop->decode.is_load) {
       num_loads++;
@@ -1801,7 +1801,7 @@ void core_exec_DPM_t::ST_ALU_exec(const struct uop_t * const uop)
       /* scan store queue for younger loads to see if we've been overwritten */
       while(overwrite_index != LDQ[idx].store_color)
       {
-        overwrite_index = modinc(overwrite_index,knobs->exec.STQ_size); //(overwrite_index + 1) % knobs->exec.STQ_size;
+        overwrite_index = modinc(overwrite_index,CORE_KNOB(knobs, exec, STQ_size)); //(overwrite_index + 1) % CORE_KNOB(knobs, exec, STQ_size);
         if(overwrite_index == STQ_tail) {
           zesto_assert(false, (void)0);
         }
@@ -1938,7 +1938,7 @@ void core_exec_DPM_t::ST_ALU_exec(const struct uop_t * const uop)
 
 void core_exec_DPM_t::STQ_set_addr(struct uop_t * const uop)
 {
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   zesto_assert(!STQ[uop->alloc.STQ_index].addr_valid,(void)0);
   STQ[uop->alloc.STQ_index].virt_addr = uop->oracle.virt_addr;
   STQ[uop->alloc.STQ_index].addr_valid = true;
@@ -1946,7 +1946,7 @@ void core_exec_DPM_t::STQ_set_addr(struct uop_t * const uop)
 
 void core_exec_DPM_t::STQ_set_data(struct uop_t * const uop)
 {
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   zesto_assert(!STQ[uop->alloc.STQ_index].value_valid,(void)0);
   STQ[uop->alloc.STQ_index].value_valid = true;
 }
@@ -1964,7 +1964,7 @@ void core_exec_DPM_t::ALU_exec(void)
   bool work_found = false;
 
   /* Process Functional Units */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     int j;
     for(j=0;j<port[i].num_FU_types;j++)
@@ -2005,7 +2005,7 @@ void core_exec_DPM_t::ALU_exec(void)
             if(uop->decode.is_load) /* loads need to be processed differently */
             {
               /* update load queue entry */
-              zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+              zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
               LDQ[uop->alloc.LDQ_index].virt_addr = uop->oracle.virt_addr;
               LDQ[uop->alloc.LDQ_index].addr_valid = true;
               /* actual scheduling from load queue takes place in LDQ_schedule() */
@@ -2081,11 +2081,11 @@ void core_exec_DPM_t::ALU_exec(void)
   }
 
   /* Process Payload RAM pipestages */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     if(port[i].occupancy > 0)
     {
-      int stage = knobs->exec.payload_depth-1;
+      int stage = CORE_KNOB(knobs, exec, payload_depth)-1;
       struct uop_t * uop = port[i].payload_pipe[stage].uop;
       work_found = true;
 
@@ -2149,7 +2149,7 @@ void core_exec_DPM_t::ALU_exec(void)
         }
         else
         {
-          zesto_assert((uop->alloc.RS_index >= 0) && (uop->alloc.RS_index < knobs->exec.RS_size),(void)0);
+          zesto_assert((uop->alloc.RS_index >= 0) && (uop->alloc.RS_index < CORE_KNOB(knobs, exec, RS_size)),(void)0);
           if(uop->decode.in_fusion)
             uop->decode.fusion_head->exec.uops_in_RS--;
 #ifdef ZTRACE
@@ -2233,7 +2233,7 @@ void core_exec_DPM_t::recover(void)
 bool core_exec_DPM_t::RS_available(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return RS_num < knobs->exec.RS_size;
+  return RS_num < CORE_KNOB(knobs, exec, RS_size);
 }
 
 /* assumes you already called RS_available to check that
@@ -2243,12 +2243,12 @@ void core_exec_DPM_t::RS_insert(struct uop_t * const uop)
   struct core_knobs_t * knobs = core->knobs;
   int RS_index;
   /* find a free RS entry */
-  for(RS_index=0;RS_index < knobs->exec.RS_size;RS_index++)
+  for(RS_index=0;RS_index < CORE_KNOB(knobs, exec, RS_size);RS_index++)
   {
     if(RS[RS_index] == NULL)
       break;
   }
-  if(RS_index == knobs->exec.RS_size)
+  if(RS_index == CORE_KNOB(knobs, exec, RS_size))
     fatal("RS and RS_num out of sync");
 
   RS[RS_index] = uop;
@@ -2275,7 +2275,7 @@ void core_exec_DPM_t::RS_fuse_insert(struct uop_t * const uop)
 
 void core_exec_DPM_t::RS_deallocate(struct uop_t * const dead_uop)
 {
-  zesto_assert(dead_uop->alloc.RS_index < core->knobs->exec.RS_size,(void)0);
+  zesto_assert(dead_uop->alloc.RS_index < CORE_KNOB(core->knobs, exec, RS_size),(void)0);
   if(dead_uop->decode.in_fusion && (dead_uop->timing.when_exec == TICK_T_MAX))
   {
     dead_uop->decode.fusion_head->exec.uops_in_RS --;
@@ -2302,7 +2302,7 @@ void core_exec_DPM_t::RS_deallocate(struct uop_t * const dead_uop)
 
 bool core_exec_DPM_t::LDQ_available(void)
 {
-  return LDQ_num < core->knobs->exec.LDQ_size;
+  return LDQ_num < CORE_KNOB(core->knobs, exec, LDQ_size);
 }
 
 void core_exec_DPM_t::LDQ_insert(struct uop_t * const uop)
@@ -2312,7 +2312,7 @@ void core_exec_DPM_t::LDQ_insert(struct uop_t * const uop)
   memzero(&LDQ[LDQ_tail],sizeof(*LDQ));
   LDQ[LDQ_tail].uop = uop;
   LDQ[LDQ_tail].mem_size = uop->decode.mem_size;
-  int store_color = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  int store_color = moddec(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   LDQ[LDQ_tail].store_color = store_color;
   if (is_senior_STQ_entry_valid(store_color))
     LDQ[LDQ_tail].colored_store_action_id = STQ[store_color].action_id;
@@ -2321,7 +2321,7 @@ void core_exec_DPM_t::LDQ_insert(struct uop_t * const uop)
   LDQ[LDQ_tail].when_issued = TICK_T_MAX;
   uop->alloc.LDQ_index = LDQ_tail;
   LDQ_num++;
-  LDQ_tail = modinc(LDQ_tail,knobs->exec.LDQ_size); //(LDQ_tail+1) % knobs->exec.LDQ_size;
+  LDQ_tail = modinc(LDQ_tail,CORE_KNOB(knobs, exec, LDQ_size)); //(LDQ_tail+1) % CORE_KNOB(knobs, exec, LDQ_size);
 }
 
 /* called by commit */
@@ -2330,19 +2330,19 @@ void core_exec_DPM_t::LDQ_deallocate(struct uop_t * const uop)
   struct core_knobs_t * knobs = core->knobs;
   LDQ[LDQ_head].uop = NULL;
   LDQ_num --;
-  LDQ_head = modinc(LDQ_head,knobs->exec.LDQ_size); //(LDQ_head+1) % knobs->exec.LDQ_size;
+  LDQ_head = modinc(LDQ_head,CORE_KNOB(knobs, exec, LDQ_size)); //(LDQ_head+1) % CORE_KNOB(knobs, exec, LDQ_size);
   uop->alloc.LDQ_index = -1;
 }
 
 void core_exec_DPM_t::LDQ_squash(struct uop_t * const dead_uop)
 {
   struct core_knobs_t * knobs = core->knobs;
-  zesto_assert((dead_uop->alloc.LDQ_index >= 0) && (dead_uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.LDQ_index >= 0) && (dead_uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
   zesto_assert(LDQ[dead_uop->alloc.LDQ_index].uop == dead_uop,(void)0);
   //memset(&LDQ[dead_uop->alloc.LDQ_index],0,sizeof(LDQ[0]));
   memzero(&LDQ[dead_uop->alloc.LDQ_index],sizeof(LDQ[0]));
   LDQ_num --;
-  LDQ_tail = moddec(LDQ_tail,knobs->exec.LDQ_size); //(LDQ_tail - 1 + knobs->exec.LDQ_size) % knobs->exec.LDQ_size;
+  LDQ_tail = moddec(LDQ_tail,CORE_KNOB(knobs, exec, LDQ_size)); //(LDQ_tail - 1 + CORE_KNOB(knobs, exec, LDQ_size)) % CORE_KNOB(knobs, exec, LDQ_size);
   zesto_assert(LDQ_num >= 0,(void)0);
   dead_uop->alloc.LDQ_index = -1;
 }
@@ -2355,7 +2355,7 @@ bool core_exec_DPM_t::STQ_empty(void)
 bool core_exec_DPM_t::STQ_available(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return STQ_senior_num < knobs->exec.STQ_size;
+  return STQ_senior_num < CORE_KNOB(knobs, exec, STQ_size);
 }
 
 void core_exec_DPM_t::STQ_insert_sta(struct uop_t * const uop)
@@ -2372,14 +2372,14 @@ void core_exec_DPM_t::STQ_insert_sta(struct uop_t * const uop)
   uop->alloc.STQ_index = STQ_tail;
   STQ_num++;
   STQ_senior_num++;
-  STQ_tail = modinc(STQ_tail,knobs->exec.STQ_size); //(STQ_tail+1) % knobs->exec.STQ_size;
+  STQ_tail = modinc(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail+1) % CORE_KNOB(knobs, exec, STQ_size);
 }
 
 void core_exec_DPM_t::STQ_insert_std(struct uop_t * const uop)
 {
   struct core_knobs_t * knobs = core->knobs;
   /* STQ_tail already incremented from the STA.  Just add this uop to STQ->std */
-  int index = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  int index = moddec(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   uop->alloc.STQ_index = index;
   STQ[index].std = uop;
   zesto_assert(STQ[index].sta,(void)0); /* shouldn't have STD w/o a corresponding STA */
@@ -2419,7 +2419,7 @@ bool core_exec_DPM_t::STQ_deallocate_fence(struct uop_t* const uop) {
     STQ[STQ_senior_head].sta = nullptr;
     STQ[STQ_senior_head].std = nullptr;
     STQ_num--;
-    STQ_head = modinc(STQ_head, core->knobs->exec.STQ_size);
+    STQ_head = modinc(STQ_head, CORE_KNOB(core->knobs, exec, STQ_size));
     /* don't touch the senior STQ, we'll deallocate from there as usual */
     return true;
 }
@@ -2441,7 +2441,7 @@ bool core_exec_DPM_t::STQ_deallocate_std(struct uop_t * const uop)
   struct cache_t* tlb = (core->memory.DTLB2) ? core->memory.DTLB2.get() : core->memory.DTLB.get();
   /* Wait until we can submit to DTLB (sync ops don't use TLB) */
   if(get_STQ_request_type(uop) == CACHE_WRITE && 
-     !cache_enqueuable(tlb, asid, memory::page_table_address(asid, uop->oracle.virt_addr)))
+     !cache_enqueuable(tlb, asid, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift)))
     return false;
   /* Wait until we can submit to DL1 */
   if(send_to_dl1 && !cache_enqueuable(core->memory.DL1.get(), asid, uop->oracle.virt_addr))
@@ -2488,7 +2488,7 @@ bool core_exec_DPM_t::STQ_deallocate_std(struct uop_t * const uop)
       dtlb_uop->decode.Mop_seq = uop->decode.Mop_seq;
       dtlb_uop->decode.uop_seq = uop->decode.uop_seq;
 
-      cache_enqueue(core, tlb, NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr), dtlb_uop->exec.action_id, 0, NO_MSHR, dtlb_uop, store_dtlb_callback, NULL, NULL, get_uop_action_id);
+      cache_enqueue(core, tlb, NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift), dtlb_uop->exec.action_id, 0, NO_MSHR, dtlb_uop, store_dtlb_callback, NULL, NULL, get_uop_action_id);
     }
     else {
       STQ[STQ_head].translation_complete = true;
@@ -2576,7 +2576,7 @@ bool core_exec_DPM_t::STQ_deallocate_std(struct uop_t * const uop)
 
     STQ[STQ_head].std = NULL;
     STQ_num --;
-    STQ_head = modinc(STQ_head,knobs->exec.STQ_size); //(STQ_head+1) % knobs->exec.STQ_size;
+    STQ_head = modinc(STQ_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_head+1) % CORE_KNOB(knobs, exec, STQ_size);
 
     return true;
   }
@@ -2599,7 +2599,7 @@ void core_exec_DPM_t::STQ_deallocate_senior(void)
      * MFENCEs also rely on the new action_id to check that a store has
      * returned from all caches. */
     STQ[STQ_senior_head].action_id = core->new_action_id();
-    STQ_senior_head = modinc(STQ_senior_head,knobs->exec.STQ_size); //(STQ_senior_head + 1) % knobs->exec.STQ_size;
+    STQ_senior_head = modinc(STQ_senior_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_senior_head + 1) % CORE_KNOB(knobs, exec, STQ_size);
     STQ_senior_num--;
     zesto_assert(STQ_senior_num >= 0,(void)0);
     partial_forward_throttle = false;
@@ -2609,14 +2609,14 @@ void core_exec_DPM_t::STQ_deallocate_senior(void)
 void core_exec_DPM_t::STQ_squash_sta(struct uop_t * const dead_uop)
 {
   struct core_knobs_t * knobs = core->knobs;
-  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < knobs->exec.STQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < CORE_KNOB(knobs, exec, STQ_size)),(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].std == NULL,(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].sta == dead_uop,(void)0);
   //memset(&STQ[dead_uop->alloc.STQ_index],0,sizeof(STQ[0]));
   memzero(&STQ[dead_uop->alloc.STQ_index],sizeof(STQ[0]));
   STQ_num --;
   STQ_senior_num --;
-  STQ_tail = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  STQ_tail = moddec(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   zesto_assert(STQ_num >= 0,(void)0);
   zesto_assert(STQ_senior_num >= 0,(void)0);
   dead_uop->alloc.STQ_index = -1;
@@ -2624,7 +2624,7 @@ void core_exec_DPM_t::STQ_squash_sta(struct uop_t * const dead_uop)
 
 void core_exec_DPM_t::STQ_squash_std(struct uop_t * const dead_uop)
 {
-  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].std == dead_uop,(void)0);
   STQ[dead_uop->alloc.STQ_index].std = NULL;
   dead_uop->alloc.STQ_index = -1;
@@ -2641,10 +2641,10 @@ void core_exec_DPM_t::STQ_squash_senior(void)
 
     if((STQ_senior_head == STQ_head) && (STQ_num>0))
     {
-      STQ_head = modinc(STQ_head,knobs->exec.STQ_size); //(STQ_head + 1) % knobs->exec.STQ_size;
+      STQ_head = modinc(STQ_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_head + 1) % CORE_KNOB(knobs, exec, STQ_size);
       STQ_num--;
     }
-    STQ_senior_head = modinc(STQ_senior_head,knobs->exec.STQ_size); //(STQ_senior_head + 1) % knobs->exec.STQ_size;
+    STQ_senior_head = modinc(STQ_senior_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_senior_head + 1) % CORE_KNOB(knobs, exec, STQ_size);
     STQ_senior_num--;
   }
 }
@@ -2671,7 +2671,7 @@ void core_exec_DPM_t::store_dl1_callback(void * const op)
   ztrace_print(uop,"c|store|written to cache/memory");
 #endif
 
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(!uop->oracle.is_repeated) /* repeater accesses always have precedence */
   {
     if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
@@ -2697,7 +2697,7 @@ void core_exec_DPM_t::store_dl1_split_callback(void * const op)
   ztrace_print(uop,"c|store|written to cache/memory");
 #endif
 
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(!uop->oracle.is_repeated) /* repeater accesses always have precedence */
   {
     if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
@@ -2722,7 +2722,7 @@ void core_exec_DPM_t::store_dtlb_callback(void * const op)
   ztrace_print(uop,"c|store|translated");
 #endif
 
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
     E->STQ[uop->alloc.STQ_index].translation_complete = true;
   x86::return_uop_array(uop, 1);
@@ -2736,7 +2736,7 @@ bool core_exec_DPM_t::store_translated_callback(void * const op, const seq_t act
 
   if((uop->alloc.STQ_index == -1) || (uop->exec.action_id != E->STQ[uop->alloc.STQ_index].action_id))
     return true;
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),true);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),true);
   return E->STQ[uop->alloc.STQ_index].translation_complete;
 }
 
@@ -2752,7 +2752,7 @@ void core_exec_DPM_t::repeater_store_callback(void * const op, bool is_hit)
 
   zesto_assert(uop->oracle.is_repeated, (void)0);
   zesto_assert(is_hit, (void)0);
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
   {
     E->STQ[uop->alloc.STQ_index].first_byte_written = true;
@@ -2777,7 +2777,7 @@ void core_exec_DPM_t::repeater_split_store_callback(void * const op, bool is_hit
 
   zesto_assert(uop->oracle.is_repeated, (void)0);
   zesto_assert(is_hit, (void)0);
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
   {
     zesto_assert(!uop->oracle.is_sync_op, (void)0);
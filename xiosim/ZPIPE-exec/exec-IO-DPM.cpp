@@ -21,7 +21,7 @@
 #include <list>
 using namespace std;
 
-class core_exec_IO_DPM_t:public core_exec_t
+class core_exec_IO_DPM_t final : public core_exec_t
 {
   /* struct for a squashable in-flight uop (for example, a uop making its way
      down an ALU pipeline).  Changing the original uop's tag will make the tags
@@ -219,18 +219,18 @@ core_exec_IO_DPM_t::core_exec_IO_DPM_t(struct core_t * const arg_core):
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
 
-  LDQ = (core_exec_IO_DPM_t::LDQ_t*) calloc(knobs->exec.LDQ_size,sizeof(*LDQ));
+  LDQ = (core_exec_IO_DPM_t::LDQ_t*) calloc(CORE_KNOB(knobs, exec, LDQ_size),sizeof(*LDQ));
   if(!LDQ)
     fatal("couldn't calloc LDQ");
 
-  STQ = (core_exec_IO_DPM_t::STQ_t*) calloc(knobs->exec.STQ_size,sizeof(*STQ));
+  STQ = (core_exec_IO_DPM_t::STQ_t*) calloc(CORE_KNOB(knobs, exec, STQ_size),sizeof(*STQ));
   if(!STQ)
     fatal("couldn't calloc STQ");
 
   int i;
   /* This shouldn't be necessary, but I threw it in because valgrind (memcheck)
      was reporting that STQ[i].sta was being used uninitialized. -GL */
-  for(i=0;i<knobs->exec.STQ_size;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, STQ_size);i++)
     STQ[i].sta = NULL;
 
   create_caches(true);
@@ -238,12 +238,12 @@ core_exec_IO_DPM_t::core_exec_IO_DPM_t(struct core_t * const arg_core):
   /************************************/
   /* execution port payload pipelines */
   /************************************/
-  port = (core_exec_IO_DPM_t::exec_port_t*) calloc(knobs->exec.num_exec_ports,sizeof(*port));
+  port = (core_exec_IO_DPM_t::exec_port_t*) calloc(CORE_KNOB(knobs, exec, num_exec_ports),sizeof(*port));
   if(!port)
     fatal("couldn't calloc exec ports");
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
-    port[i].payload_pipe = (struct uop_action_t*) calloc(knobs->exec.payload_depth,sizeof(*port->payload_pipe));
+    port[i].payload_pipe = (struct uop_action_t*) calloc(CORE_KNOB(knobs, exec, payload_depth),sizeof(*port->payload_pipe));
     if(!port[i].payload_pipe)
       fatal("couldn't calloc payload pipe");
   }
@@ -282,7 +282,7 @@ core_exec_IO_DPM_t::core_exec_IO_DPM_t(struct core_t * const arg_core):
   }
 
   /* shortened list of the FU's available on each port (to speed up FU loop in ALU_exec) */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     port[i].num_FU_types = 0;
     int j;
@@ -309,7 +309,7 @@ core_exec_IO_DPM_t::core_exec_IO_DPM_t(struct core_t * const arg_core):
 }
 
 core_exec_IO_DPM_t::~core_exec_IO_DPM_t() {
-    for (int i = 0; i < core->knobs->exec.num_exec_ports; i++) {
+    for (int i = 0; i < CORE_KNOB(core->knobs, exec, num_exec_ports); i++) {
         free(port[i].FU_types);
         if (port[i].STQ) {
             free(port[i].STQ->pipe);
@@ -377,7 +377,7 @@ void core_exec_IO_DPM_t::reg_stats(xiosim::stats::StatsDatabase* sdb) {
             "fraction of loads requiring split accesses",
             DL1_load_split_accesses_st / (*DL1_load_lookups_st - DL1_load_split_accesses_st), NULL);
 
-    for (int i = 0; i < core->knobs->exec.num_exec_ports; i++) {
+    for (int i = 0; i < CORE_KNOB(core->knobs, exec, num_exec_ports); i++) {
         char buf[128];
         sprintf(buf, "port%d_issue_occupancy", i);
         auto& issue_occupancy_st =
@@ -413,19 +413,19 @@ void core_exec_IO_DPM_t::update_occupancy(void)
 {
     /* LDQ */
     core->stat.LDQ_occupancy += LDQ_num;
-    if (LDQ_num >= core->knobs->exec.LDQ_size)
+    if (LDQ_num >= CORE_KNOB(core->knobs, exec, LDQ_size))
         core->stat.LDQ_full_cycles++;
     if (LDQ_num <= 0)
         core->stat.LDQ_empty_cycles++;
 
     /* STQ */
     core->stat.STQ_occupancy += STQ_num;
-    if (STQ_senior_num >= core->knobs->exec.STQ_size)
+    if (STQ_senior_num >= CORE_KNOB(core->knobs, exec, STQ_size))
         core->stat.STQ_full_cycles++;
     if (STQ_senior_num <= 0)
         core->stat.STQ_empty_cycles++;
 
-    for (int i = 0; i < core->knobs->exec.num_exec_ports; i++) {
+    for (int i = 0; i < CORE_KNOB(core->knobs, exec, num_exec_ports); i++) {
         for (int j = 0; j < port[i].num_FU_types; j++) {
             enum fu_class FU_type = port[i].FU_types[j];
             switch (FU_type) {
@@ -454,7 +454,7 @@ void core_exec_IO_DPM_t::update_occupancy(void)
 void core_exec_IO_DPM_t::reset_execution(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  for(int i=0; i<knobs->exec.num_exec_ports; i++)
+  for(int i=0; i<CORE_KNOB(knobs, exec, num_exec_ports); i++)
   {
     port[i].when_stalled = 0;
     port[i].when_bypass_used = 0;
@@ -493,7 +493,7 @@ bool core_exec_IO_DPM_t::check_load_issue_conditions(const struct uop_t * const
   int num_stores = 0; /* need this extra condition because STQ could be full with all stores older than the load we're considering */
 
   /* don't reissue someone who's already issued */
-  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),false);
+  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),false);
   if(LDQ[uop->alloc.LDQ_index].when_issued != TICK_T_MAX)
     return false;
 
@@ -502,8 +502,8 @@ bool core_exec_IO_DPM_t::check_load_issue_conditions(const struct uop_t * const
 
   /* this searches the senior STQ as well. */
   for(i=LDQ[uop->alloc.LDQ_index].store_color;
-      ((modinc(i,knobs->exec.STQ_size)) != STQ_senior_head) && (STQ[i].uop_seq < uop->decode.uop_seq) && (num_stores < STQ_senior_num);
-      i=moddec(i,knobs->exec.STQ_size) )
+      ((modinc(i,CORE_KNOB(knobs, exec, STQ_size))) != STQ_senior_head) && (STQ[i].uop_seq < uop->decode.uop_seq) && (num_stores < STQ_senior_num);
+      i=moddec(i,CORE_KNOB(knobs, exec, STQ_size)) )
   {
     /* check addr match */
     int st_mem_size = STQ[i].mem_size;
@@ -585,7 +585,7 @@ bool core_exec_IO_DPM_t::check_load_issue_conditions(const struct uop_t * const
 
 void core_exec_IO_DPM_t::load_writeback(struct uop_t * const uop)
 {
-  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < core->knobs->exec.LDQ_size),(void)0);
+  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(core->knobs, exec, LDQ_size)),(void)0);
   if(!LDQ[uop->alloc.LDQ_index].hit_in_STQ) /* no match in STQ, so use cache value */
   {
 #ifdef ZTRACE
@@ -935,7 +935,7 @@ void core_exec_IO_DPM_t::load_miss_reschedule(void * const op, const int new_pre
     /* now assume a hit in this cache level */
     odep = uop->exec.odep_uop;
     if(new_pred_latency != BIG_LATENCY)
-      uop->timing.when_otag_ready = core->sim_cycle + new_pred_latency - knobs->exec.payload_depth - 1;
+      uop->timing.when_otag_ready = core->sim_cycle + new_pred_latency - CORE_KNOB(knobs, exec, payload_depth) - 1;
 
     while(odep)
     {
@@ -992,19 +992,19 @@ void core_exec_IO_DPM_t::LDST_exec(void)
       ztrace_print(uop,"e|STQ|load searches STQ for addr match");
 #endif
       int num_stores = 0;
-      zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+      zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
 
       /* check STQ for match, including senior STQ */
       /*for(j=LDQ[uop->alloc.LDQ_index].store_color;
           STQ[j].sta && (STQ[j].sta->decode.uop_seq < uop->decode.uop_seq) && (num_stores < STQ_senior_num);
-          j=(j-1+knobs->exec.STQ_size) % knobs->exec.STQ_size)*/
+          j=(j-1+CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size))*/
 
       j=LDQ[uop->alloc.LDQ_index].store_color;
 
       int cond1 = STQ[j].sta != NULL;
       seq_t seq1 = (seq_t)-1, seq2 = (seq_t)-1;
       zesto_assert(j >= 0,(void)0);
-      zesto_assert(j < knobs->exec.STQ_size,(void)0);
+      zesto_assert(j < CORE_KNOB(knobs, exec, STQ_size),(void)0);
       if(j)
       {
         seq1 = (seq_t)-2;
@@ -1232,7 +1232,7 @@ void core_exec_IO_DPM_t::LDST_exec(void)
 
         num_stores++;
 
-        j=moddec(j,knobs->exec.STQ_size); //(j-1+knobs->exec.STQ_size) % knobs->exec.STQ_size;
+        j=moddec(j,CORE_KNOB(knobs, exec, STQ_size)); //(j-1+CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
 
         cond1 = STQ[j].sta != NULL;
         cond2 = cond1 && (STQ[j].sta->decode.uop_seq < uop->decode.uop_seq);
@@ -1256,7 +1256,7 @@ void core_exec_IO_DPM_t::LDQ_schedule(void)
   int index = LDQ_head;
   for(i=0;i<LDQ_num;i++)
   {
-    //int index = (LDQ_head + i) % knobs->exec.LDQ_size;
+    //int index = (LDQ_head + i) % CORE_KNOB(knobs, exec, LDQ_size);
     if(LDQ[index].addr_valid) /* agen has finished */
     {
       if((!LDQ[index].partial_forward || !partial_forward_throttle) /* load not blocked on partially matching store */ )
@@ -1269,7 +1269,7 @@ void core_exec_IO_DPM_t::LDQ_schedule(void)
             bool send_to_dl1 = (!uop->oracle.is_repeated || (uop->oracle.is_repeated && knobs->memory.DL1_rep_req));
             if(!LDQ[index].first_byte_requested)
             {
-              if((cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr))) &&
+              if((cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift))) &&
                  (!send_to_dl1 || (send_to_dl1 && cache_enqueuable(core->memory.DL1.get(), asid, uop->oracle.virt_addr))) &&
                  (!uop->oracle.is_repeated || (uop->oracle.is_repeated && core->memory.mem_repeater->enqueuable(CACHE_READ, asid, uop->oracle.virt_addr))) &&
                  (port[uop->alloc.port_assignment].STQ->pipe[0].uop == NULL))
@@ -1277,7 +1277,7 @@ void core_exec_IO_DPM_t::LDQ_schedule(void)
                 uop->exec.when_data_loaded = TICK_T_MAX;
                 if(!uop->oracle.is_sync_op && (uop->exec.when_addr_translated == 0)) {
                   uop->exec.when_addr_translated = TICK_T_MAX;
-                  cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr), uop->exec.action_id, 0, NO_MSHR, uop, DTLB_callback, load_miss_reschedule, NULL, get_uop_action_id);
+                  cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift), uop->exec.action_id, 0, NO_MSHR, uop, DTLB_callback, load_miss_reschedule, NULL, get_uop_action_id);
                 }
                 else
                   // The wait address is bogus, don't schedule a TLB translation
@@ -1314,8 +1314,8 @@ void core_exec_IO_DPM_t::LDQ_schedule(void)
                 if(!LDQ[index].speculative_broadcast) /* need to re-wakeup children */
                 {
                   struct odep_t * odep = LDQ[index].uop->exec.odep_uop;
-                  if(knobs->exec.payload_depth < core->memory.DL1->latency) /* assume DL1 hit */
-                    LDQ[index].uop->timing.when_otag_ready = core->sim_cycle + core->memory.DL1->latency - knobs->exec.payload_depth;
+                  if(CORE_KNOB(knobs, exec, payload_depth) < core->memory.DL1->latency) /* assume DL1 hit */
+                    LDQ[index].uop->timing.when_otag_ready = core->sim_cycle + core->memory.DL1->latency - CORE_KNOB(knobs, exec, payload_depth);
                   else
                     LDQ[index].uop->timing.when_otag_ready = core->sim_cycle;
                   while(odep)
@@ -1429,7 +1429,7 @@ void core_exec_IO_DPM_t::LDQ_schedule(void)
         }
       }
     }
-    index = modinc(index,knobs->exec.LDQ_size);
+    index = modinc(index,CORE_KNOB(knobs, exec, LDQ_size));
   }
 }
 
@@ -1461,7 +1461,7 @@ void core_exec_IO_DPM_t::recover(const struct Mop_t * const Mop)
 
 
   /* Flush Functional Units */
-  for(int i=0;i<knobs->exec.num_exec_ports;i++)
+  for(int i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     for(int j=0;j<port[i].num_FU_types;j++)
     {
@@ -1500,11 +1500,11 @@ void core_exec_IO_DPM_t::recover(const struct Mop_t * const Mop)
 
 
   /* flush payload pipe */
-  for(int i=0;i<knobs->exec.num_exec_ports;i++)
+  for(int i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     if(port[i].occupancy > 0)
     {
-      int stage = knobs->exec.payload_depth-1;
+      int stage = CORE_KNOB(knobs, exec, payload_depth)-1;
 
       for(;stage>=0; stage--)
       {
@@ -1556,7 +1556,7 @@ void core_exec_IO_DPM_t::recover(void)
 
 
   /* Flush Functional Units */
-  for(int i=0;i<knobs->exec.num_exec_ports;i++)
+  for(int i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     for(int j=0;j<port[i].num_FU_types;j++)
     {
@@ -1592,11 +1592,11 @@ void core_exec_IO_DPM_t::recover(void)
 
 
   /* flush payload pipe */
-  for(int i=0;i<knobs->exec.num_exec_ports;i++)
+  for(int i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     if(port[i].occupancy > 0)
     {
-      int stage = knobs->exec.payload_depth-1;
+      int stage = CORE_KNOB(knobs, exec, payload_depth)-1;
 
       for(;stage>=0; stage--)
       {
@@ -1654,7 +1654,7 @@ bool core_exec_IO_DPM_t::port_available(int port_ind)
 bool core_exec_IO_DPM_t::exec_empty(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  for(int i=0;i<knobs->exec.num_exec_ports;i++)
+  for(int i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     if(port[i].occupancy > 0)
       return false;
@@ -1721,7 +1721,7 @@ void core_exec_IO_DPM_t::RS_deallocate(struct uop_t * const dead_uop)
 bool core_exec_IO_DPM_t::LDQ_available(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return LDQ_num < knobs->exec.LDQ_size;
+  return LDQ_num < CORE_KNOB(knobs, exec, LDQ_size);
 }
 
 //SK - called after AGEN in payload pipe
@@ -1732,11 +1732,11 @@ void core_exec_IO_DPM_t::LDQ_insert(struct uop_t * const uop)
   memzero(&LDQ[LDQ_tail],sizeof(*LDQ));
   LDQ[LDQ_tail].uop = uop;
   LDQ[LDQ_tail].mem_size = uop->decode.mem_size;
-  LDQ[LDQ_tail].store_color = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  LDQ[LDQ_tail].store_color = moddec(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   LDQ[LDQ_tail].when_issued = TICK_T_MAX;
   uop->alloc.LDQ_index = LDQ_tail;
   LDQ_num++;
-  LDQ_tail = modinc(LDQ_tail,knobs->exec.LDQ_size); //(LDQ_tail+1) % knobs->exec.LDQ_size;
+  LDQ_tail = modinc(LDQ_tail,CORE_KNOB(knobs, exec, LDQ_size)); //(LDQ_tail+1) % CORE_KNOB(knobs, exec, LDQ_size);
   zesto_assert(LDQ_tail >=0, (void)0);
 }
 
@@ -1747,7 +1747,7 @@ void core_exec_IO_DPM_t::LDQ_deallocate(struct uop_t * const uop)
   zesto_assert(LDQ[LDQ_head].uop == uop, (void)0);
   LDQ[LDQ_head].uop = NULL;
   LDQ_num --;
-  LDQ_head = modinc(LDQ_head,knobs->exec.LDQ_size); //(LDQ_head+1) % knobs->exec.LDQ_size;
+  LDQ_head = modinc(LDQ_head,CORE_KNOB(knobs, exec, LDQ_size)); //(LDQ_head+1) % CORE_KNOB(knobs, exec, LDQ_size);
 //To be removed
   zesto_assert(LDQ_head >= 0, (void)0);
   uop->alloc.LDQ_index = -1;
@@ -1756,12 +1756,12 @@ void core_exec_IO_DPM_t::LDQ_deallocate(struct uop_t * const uop)
 void core_exec_IO_DPM_t::LDQ_squash(struct uop_t * const dead_uop)
 {
   struct core_knobs_t * knobs = core->knobs;
-  zesto_assert((dead_uop->alloc.LDQ_index >= 0) && (dead_uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.LDQ_index >= 0) && (dead_uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
   zesto_assert(LDQ[dead_uop->alloc.LDQ_index].uop == dead_uop,(void)0);
   //memset(&LDQ[dead_uop->alloc.LDQ_index],0,sizeof(LDQ[0]));
   memzero(&LDQ[dead_uop->alloc.LDQ_index],sizeof(LDQ[0]));
   LDQ_num --;
-  LDQ_tail = moddec(LDQ_tail,knobs->exec.LDQ_size); //(LDQ_tail - 1 + knobs->exec.LDQ_size) % knobs->exec.LDQ_size;
+  LDQ_tail = moddec(LDQ_tail,CORE_KNOB(knobs, exec, LDQ_size)); //(LDQ_tail - 1 + CORE_KNOB(knobs, exec, LDQ_size)) % CORE_KNOB(knobs, exec, LDQ_size);
   zesto_assert(LDQ_tail >= 0, (void)0);
   zesto_assert(LDQ_num >= 0,(void)0);
   dead_uop->alloc.LDQ_index = -1;
@@ -1775,7 +1775,7 @@ bool core_exec_IO_DPM_t::STQ_empty(void)
 bool core_exec_IO_DPM_t::STQ_available(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return STQ_senior_num < knobs->exec.STQ_size;
+  return STQ_senior_num < CORE_KNOB(knobs, exec, STQ_size);
 }
 
 void core_exec_IO_DPM_t::STQ_insert_sta(struct uop_t * const uop)
@@ -1792,7 +1792,7 @@ void core_exec_IO_DPM_t::STQ_insert_sta(struct uop_t * const uop)
   uop->alloc.STQ_index = STQ_tail;
   STQ_num++;
   STQ_senior_num++;
-  STQ_tail = modinc(STQ_tail,knobs->exec.STQ_size); //(STQ_tail+1) % knobs->exec.STQ_size;
+  STQ_tail = modinc(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail+1) % CORE_KNOB(knobs, exec, STQ_size);
 }
 
 void core_exec_IO_DPM_t::STQ_insert_std(struct uop_t * const uop)
@@ -1800,7 +1800,7 @@ void core_exec_IO_DPM_t::STQ_insert_std(struct uop_t * const uop)
 
  struct core_knobs_t * knobs = core->knobs;
   /* STQ_tail already incremented from the STA.  Just add this uop to STQ->std */
-  int index = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  int index = moddec(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   uop->alloc.STQ_index = index;
   STQ[index].std = uop;
   zesto_assert(STQ[index].sta,(void)0); /* shouldn't have STD w/o a corresponding STA */
@@ -1827,7 +1827,7 @@ bool core_exec_IO_DPM_t::STQ_deallocate_std(struct uop_t * const uop)
   struct cache_t* tlb = (core->memory.DTLB2) ? core->memory.DTLB2.get() : core->memory.DTLB.get();
   /* Wait until we can submit to DTLB */
   if(get_STQ_request_type(uop) == CACHE_WRITE &&
-     !cache_enqueuable(tlb, asid, memory::page_table_address(asid, uop->oracle.virt_addr)))
+     !cache_enqueuable(tlb, asid, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift)))
     return false;
   /* Wait until we can submit to DL1 */
   if(send_to_dl1 && !cache_enqueuable(core->memory.DL1.get(), asid, uop->oracle.virt_addr))
@@ -1875,7 +1875,7 @@ bool core_exec_IO_DPM_t::STQ_deallocate_std(struct uop_t * const uop)
       dtlb_uop->decode.Mop_seq = uop->decode.Mop_seq;
       dtlb_uop->decode.uop_seq = uop->decode.uop_seq;
 
-      cache_enqueue(core,tlb, NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr), dtlb_uop->exec.action_id, 0, NO_MSHR, dtlb_uop, store_dtlb_callback, NULL, NULL, get_uop_action_id);
+      cache_enqueue(core,tlb, NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift), dtlb_uop->exec.action_id, 0, NO_MSHR, dtlb_uop, store_dtlb_callback, NULL, NULL, get_uop_action_id);
     }
     else {
       STQ[STQ_head].translation_complete = true;
@@ -1965,7 +1965,7 @@ bool core_exec_IO_DPM_t::STQ_deallocate_std(struct uop_t * const uop)
       STQ[STQ_head].std->alloc.STQ_index = -1;
     STQ[STQ_head].std = NULL;
     STQ_num --;
-    STQ_head = modinc(STQ_head,knobs->exec.STQ_size); //(STQ_head+1) % knobs->exec.STQ_size;
+    STQ_head = modinc(STQ_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_head+1) % CORE_KNOB(knobs, exec, STQ_size);
 
     return true;
   }
@@ -1984,7 +1984,7 @@ void core_exec_IO_DPM_t::STQ_deallocate_senior(void)
     /* In case request was fullfilled by only one of parallel caches (DL1 and repeater)
      * get a new action_id, to ignore callbacks from the other one */
     STQ[STQ_senior_head].action_id = core->new_action_id();
-    STQ_senior_head = modinc(STQ_senior_head,knobs->exec.STQ_size); //(STQ_senior_head + 1) % knobs->exec.STQ_size;
+    STQ_senior_head = modinc(STQ_senior_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_senior_head + 1) % CORE_KNOB(knobs, exec, STQ_size);
     STQ_senior_num--;
     zesto_assert(STQ_senior_num >= 0,(void)0);
     partial_forward_throttle = false;
@@ -1993,7 +1993,7 @@ void core_exec_IO_DPM_t::STQ_deallocate_senior(void)
 
 void core_exec_IO_DPM_t::STQ_squash_sta(struct uop_t * const dead_uop)
 {
-  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].sta == dead_uop,(void)0);
   STQ[dead_uop->alloc.STQ_index].sta = NULL;
   dead_uop->alloc.STQ_index = -1;
@@ -2002,14 +2002,14 @@ void core_exec_IO_DPM_t::STQ_squash_sta(struct uop_t * const dead_uop)
 void core_exec_IO_DPM_t::STQ_squash_std(struct uop_t * const dead_uop)
 {
   struct core_knobs_t * knobs = core->knobs;
-  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < knobs->exec.STQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < CORE_KNOB(knobs, exec, STQ_size)),(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].sta == NULL,(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].std == dead_uop,(void)0);
   //memset(&STQ[dead_uop->alloc.STQ_index],0,sizeof(STQ[0]));
   memzero(&STQ[dead_uop->alloc.STQ_index],sizeof(STQ[0]));
   STQ_num --;
   STQ_senior_num --;
-  STQ_tail = moddec(STQ_tail,knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  STQ_tail = moddec(STQ_tail,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   zesto_assert(STQ_num >= 0,(void)0);
   zesto_assert(STQ_senior_num >= 0,(void)0);
   dead_uop->alloc.STQ_index = -1;
@@ -2033,10 +2033,10 @@ void core_exec_IO_DPM_t::STQ_squash_senior(void)
 
     if((STQ_senior_head == STQ_head) && (STQ_num>0))
     {
-      STQ_head = modinc(STQ_head,knobs->exec.STQ_size); //(STQ_head + 1) % knobs->exec.STQ_size;
+      STQ_head = modinc(STQ_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_head + 1) % CORE_KNOB(knobs, exec, STQ_size);
       STQ_num--;
     }
-    STQ_senior_head = modinc(STQ_senior_head,knobs->exec.STQ_size); //(STQ_senior_head + 1) % knobs->exec.STQ_size;
+    STQ_senior_head = modinc(STQ_senior_head,CORE_KNOB(knobs, exec, STQ_size)); //(STQ_senior_head + 1) % CORE_KNOB(knobs, exec, STQ_size);
     STQ_senior_num--;
   }
 }
@@ -2062,7 +2062,7 @@ void core_exec_IO_DPM_t::store_dl1_callback(void * const op)
   ztrace_print(uop,"c|store|written to cache/memory");
 #endif
 
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(!uop->oracle.is_repeated) /* repeater accesses always have precedence */
   {
     if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
@@ -2088,7 +2088,7 @@ void core_exec_IO_DPM_t::store_dl1_split_callback(void * const op)
   ztrace_print(uop,"c|store|split written to cache/memory");
 #endif
 
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(!uop->oracle.is_repeated) /* repeater accesses always have precedence */
   {
     if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
@@ -2113,7 +2113,7 @@ void core_exec_IO_DPM_t::store_dtlb_callback(void * const op)
   ztrace_print(uop,"c|store|translated");
 #endif
 
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
     E->STQ[uop->alloc.STQ_index].translation_complete = true;
   x86::return_uop_array(uop, 1);
@@ -2127,7 +2127,7 @@ bool core_exec_IO_DPM_t::store_translated_callback(void * const op, const seq_t
 
   if((uop->alloc.STQ_index == -1) || (uop->exec.action_id != E->STQ[uop->alloc.STQ_index].action_id))
     return true;
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),true);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),true);
   return E->STQ[uop->alloc.STQ_index].translation_complete;
 }
 
@@ -2143,7 +2143,7 @@ void core_exec_IO_DPM_t::repeater_store_callback(void * const op, bool is_hit)
 
   zesto_assert(uop->oracle.is_repeated, (void)0);
   zesto_assert(is_hit, (void)0);
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
   {
     E->STQ[uop->alloc.STQ_index].first_byte_written = true;
@@ -2168,7 +2168,7 @@ void core_exec_IO_DPM_t::repeater_split_store_callback(void * const op, bool is_
 
   zesto_assert(uop->oracle.is_repeated, (void)0);
   zesto_assert(is_hit, (void)0);
-  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   if(uop->exec.action_id == E->STQ[uop->alloc.STQ_index].action_id)
   {
     zesto_assert(!uop->oracle.is_sync_op, (void)0);
@@ -2188,9 +2188,9 @@ void core_exec_IO_DPM_t::dump_payload()
   struct core_knobs_t * knobs = core->knobs;
   struct uop_t * uop;
   printf("cycle: %d\n",(int)core->sim_cycle);
-  for(int i=0; i<knobs->exec.num_exec_ports; i++){
+  for(int i=0; i<CORE_KNOB(knobs, exec, num_exec_ports); i++){
     printf("%d:|",i);
-    for(int stage=0; stage<knobs->exec.payload_depth; stage++)
+    for(int stage=0; stage<CORE_KNOB(knobs, exec, payload_depth); stage++)
     {
      uop = port[i].payload_pipe[stage].uop;
      if(uop)
@@ -2224,7 +2224,7 @@ void core_exec_IO_DPM_t::step()
   list<struct uop_t *> executed_uops;
   list<struct uop_t *>::iterator it;
 
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     struct uop_t * uop;
     for(int j=0;j<port[i].num_FU_types;j++)
@@ -2249,8 +2249,8 @@ void core_exec_IO_DPM_t::step()
        }
     }
 
-    uop = port[i].payload_pipe[knobs->exec.payload_depth-1].uop;
-    if(uop && port[i].payload_pipe[knobs->exec.payload_depth-1].action_id == uop->exec.action_id)
+    uop = port[i].payload_pipe[CORE_KNOB(knobs, exec, payload_depth)-1].uop;
+    if(uop && port[i].payload_pipe[CORE_KNOB(knobs, exec, payload_depth)-1].action_id == uop->exec.action_id)
     {
       if(uop->decode.in_fusion && uop->decode.is_load && uop->exec.ovalue_valid)
         uop = uop->decode.fusion_next;
@@ -2299,7 +2299,7 @@ void core_exec_IO_DPM_t::step()
     {
        /* This may happen when we process a jump prior in program order on the same cycle
         (flushing of instruction is already taken care of, but executed_uops (the local cache) isn't updated)*/
-       if(port[i].payload_pipe[knobs->exec.payload_depth-1].uop != uop)
+       if(port[i].payload_pipe[CORE_KNOB(knobs, exec, payload_depth)-1].uop != uop)
          continue;
 
        if(!core->commit->pre_commit_available())
@@ -2317,7 +2317,7 @@ void core_exec_IO_DPM_t::step()
        else
        {
           port[i].when_stalled = 0;
-          port[i].payload_pipe[knobs->exec.payload_depth-1].uop = NULL;
+          port[i].payload_pipe[CORE_KNOB(knobs, exec, payload_depth)-1].uop = NULL;
           port[i].occupancy--;
           zesto_assert(port[i].occupancy >= 0, (void)0);
 
@@ -2384,7 +2384,7 @@ void core_exec_IO_DPM_t::step()
       if(uop_goes_to_commit && !core->commit->pre_commit_available())
       {
          exec_stall = true;
-         for(int k=0;k<knobs->exec.num_exec_ports;k++)
+         for(int k=0;k<CORE_KNOB(knobs, exec, num_exec_ports);k++)
            if(port[k].when_stalled == 0)
              port[k].when_stalled = core->sim_cycle;
  //        break;
@@ -2479,7 +2479,7 @@ void core_exec_IO_DPM_t::step()
 
 
   /* shuffle the other stages forward (and update timing if we are in an exec_stal)*/
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     for(int j=0;j<port[i].num_FU_types;j++)
     {
@@ -2536,12 +2536,12 @@ void core_exec_IO_DPM_t::step()
 //3rd - cache access res + leave to FU
 //FIXME: This should be configurable
 
-  zesto_assert(knobs->exec.payload_depth == 3, (void)0);
-  int stage = knobs->exec.payload_depth-1;
+  zesto_assert(CORE_KNOB(knobs, exec, payload_depth) == 3, (void)0);
+  int stage = CORE_KNOB(knobs, exec, payload_depth)-1;
   bool stall = false;
   struct uop_t * uop;
 
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
    stall = port[i].when_stalled != 0;
    if(port[i].occupancy > 0)
@@ -2795,10 +2795,10 @@ void core_exec_IO_DPM_t::step()
   }
 
 
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
       stall = port[i].when_stalled != 0;
-      stage = knobs->exec.payload_depth - 2;
+      stage = CORE_KNOB(knobs, exec, payload_depth) - 2;
       uop = port[i].payload_pipe[stage].uop;
 
       /* uop in mem DC1 stage */
@@ -2951,7 +2951,7 @@ bool core_exec_IO_DPM_t::can_issue_IO(struct uop_t * const uop)
      when_otag_ready = core->sim_cycle;
 
 
-  for(int i=0;i<knobs->exec.num_exec_ports;i++)
+  for(int i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
      for(int j=0;j<port[i].num_FU_types;j++)
      {
@@ -2984,7 +2984,7 @@ bool core_exec_IO_DPM_t::can_issue_IO(struct uop_t * const uop)
 
      /* Also check last stage of payload (issue) pipe - there may be a prior op there (especially a stalled LD waiting for cache) */
 
-     int stage = knobs->exec.payload_depth-1;
+     int stage = CORE_KNOB(knobs, exec, payload_depth)-1;
      struct uop_t * curr_uop = port[i].payload_pipe[stage].uop;
      if(curr_uop)
      {
@@ -3078,7 +3078,7 @@ bool core_exec_IO_DPM_t::exec_fused_ST(struct uop_t * const uop)
   curr_uop->timing.when_completed = core->sim_cycle;
   core->exec->STQ_insert_sta(curr_uop);
 
-  zesto_assert((curr_uop->alloc.STQ_index >= 0) && (curr_uop->alloc.STQ_index < core->knobs->exec.STQ_size), false);
+  zesto_assert((curr_uop->alloc.STQ_index >= 0) && (curr_uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)), false);
   zesto_assert(!STQ[curr_uop->alloc.STQ_index].addr_valid, false);
   STQ[curr_uop->alloc.STQ_index].virt_addr = curr_uop->oracle.virt_addr;
   STQ[curr_uop->alloc.STQ_index].addr_valid = true;
@@ -3106,7 +3106,7 @@ bool core_exec_IO_DPM_t::exec_fused_ST(struct uop_t * const uop)
   curr_uop->timing.when_completed = core->sim_cycle;
   core->exec->STQ_insert_std(curr_uop);
 
-  zesto_assert((curr_uop->alloc.STQ_index >= 0) && (curr_uop->alloc.STQ_index < core->knobs->exec.STQ_size), false);
+  zesto_assert((curr_uop->alloc.STQ_index >= 0) && (curr_uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)), false);
   zesto_assert(!STQ[curr_uop->alloc.STQ_index].value_valid, false);
 
   curr_uop->exec.ovalue_valid = true;
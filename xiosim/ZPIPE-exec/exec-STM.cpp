@@ -9,7 +9,7 @@
     return std::make_unique<class core_exec_STM_t>(core);
 #else
 
-class core_exec_STM_t:public core_exec_t
+class core_exec_STM_t final : public core_exec_t
 {
   /* readyQ for scheduling */
   struct readyQ_node_t {
@@ -184,22 +184,22 @@ core_exec_STM_t::core_exec_STM_t(struct core_t * arg_core):
   struct core_knobs_t * knobs = arg_core->knobs;
   core = arg_core;
 
-  RS = (struct uop_t**) calloc(knobs->exec.RS_size,sizeof(*RS));
+  RS = (struct uop_t**) calloc(CORE_KNOB(knobs, exec, RS_size),sizeof(*RS));
   if(!RS)
     fatal("couldn't calloc RS");
 
-  LDQ = (core_exec_STM_t::LDQ_t*) calloc(knobs->exec.LDQ_size,sizeof(*LDQ));
+  LDQ = (core_exec_STM_t::LDQ_t*) calloc(CORE_KNOB(knobs, exec, LDQ_size),sizeof(*LDQ));
   if(!LDQ)
     fatal("couldn't calloc LDQ");
 
-  STQ = (core_exec_STM_t::STQ_t*) calloc(knobs->exec.STQ_size,sizeof(*STQ));
+  STQ = (core_exec_STM_t::STQ_t*) calloc(CORE_KNOB(knobs, exec, STQ_size),sizeof(*STQ));
   if(!STQ)
     fatal("couldn't calloc STQ");
 
   int i;
   /* This shouldn't be necessary, but I threw it in because valgrind (memcheck) was reporting
      that STQ[i].sta was being used uninitialized. */
-  for(i=0;i<knobs->exec.STQ_size;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, STQ_size);i++)
     STQ[i].sta = NULL;
 
   if (strcasecmp(knobs->memory.DTLB2_opt_str, "none") != 0)
@@ -209,7 +209,7 @@ core_exec_STM_t::core_exec_STM_t(struct core_t * arg_core):
   /*******************/
   /* execution ports */
   /*******************/
-  port = (core_exec_STM_t::exec_port_t*) calloc(knobs->exec.num_exec_ports,sizeof(*port));
+  port = (core_exec_STM_t::exec_port_t*) calloc(CORE_KNOB(knobs, exec, num_exec_ports),sizeof(*port));
   if(!port)
     fatal("couldn't calloc exec ports");
 
@@ -249,7 +249,7 @@ core_exec_STM_t::core_exec_STM_t(struct core_t * arg_core):
   }
 
   /* shortened list of the FU's available on each port (to speed up FU loop in ALU_exec) */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     port[i].num_FU_types = 0;
     int j;
@@ -274,7 +274,7 @@ core_exec_STM_t::core_exec_STM_t(struct core_t * arg_core):
 }
 
 core_exec_STM_t::~core_exec_STM_t() {
-    for (int i = 0; i < core->knobs->exec.num_exec_ports; i++) {
+    for (int i = 0; i < CORE_KNOB(core->knobs, exec, num_exec_ports); i++) {
         free(port[i].FU_types);
         if (port[i].STQ) {
             free(port[i].STQ->pipe);
@@ -348,21 +348,21 @@ void core_exec_STM_t::update_occupancy(void)
 {
     /* RS */
   core->stat.RS_occupancy += RS_num;
-  if(RS_num >= core->knobs->exec.RS_size)
+  if(RS_num >= CORE_KNOB(core->knobs, exec, RS_size))
     core->stat.RS_full_cycles++;
   if(RS_num <= 0)
     core->stat.RS_empty_cycles++;
 
     /* LDQ */
   core->stat.LDQ_occupancy += LDQ_num;
-  if(LDQ_num >= core->knobs->exec.LDQ_size)
+  if(LDQ_num >= CORE_KNOB(core->knobs, exec, LDQ_size))
     core->stat.LDQ_full_cycles++;
   if(LDQ_num <= 0)
     core->stat.LDQ_empty_cycles++;
 
     /* STQ */
   core->stat.STQ_occupancy += STQ_num;
-  if(STQ_num >= core->knobs->exec.STQ_size)
+  if(STQ_num >= CORE_KNOB(core->knobs, exec, STQ_size))
     core->stat.STQ_full_cycles++;
   if(STQ_num <= 0)
     core->stat.STQ_empty_cycles++;
@@ -371,7 +371,7 @@ void core_exec_STM_t::update_occupancy(void)
 void core_exec_STM_t::reset_execution(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  for(int i=0; i<knobs->exec.num_exec_ports; i++)
+  for(int i=0; i<CORE_KNOB(knobs, exec, num_exec_ports); i++)
   {
     for(int j=0; j<NUM_FU_CLASSES; j++)
       if(port[i].FU[j])
@@ -428,7 +428,7 @@ void core_exec_STM_t::return_readyQ_node(struct readyQ_node_t * const p)
    one readyQ per execution port) */
 void core_exec_STM_t::insert_ready_uop(struct uop_t * const uop)
 {
-  zesto_assert((uop->alloc.port_assignment >= 0) && (uop->alloc.port_assignment < core->knobs->exec.num_exec_ports),(void)0);
+  zesto_assert((uop->alloc.port_assignment >= 0) && (uop->alloc.port_assignment < CORE_KNOB(core->knobs, exec, num_exec_ports)),(void)0);
   zesto_assert(uop->timing.when_completed == TICK_T_MAX,(void)0);
   zesto_assert(uop->timing.when_issued == TICK_T_MAX,(void)0);
   zesto_assert(!uop->exec.in_readyQ,(void)0);
@@ -478,7 +478,7 @@ void core_exec_STM_t::RS_schedule(void) /* for uops in the RS */
   int i;
 
   /* select/pick from ready instructions and send to exec ports */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     struct readyQ_node_t * rq = port[i].readyQ;
     struct readyQ_node_t * prev = NULL;
@@ -556,13 +556,13 @@ bool core_exec_STM_t::check_load_issue_conditions(const struct uop_t * const uop
   int num_stores = 0; /* need this extra condition because STQ could be full with all stores older than the load we're considering */
 
   /* don't reissue someone who's already issued */
-  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),false);
+  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),false);
   /* assume you've already checked this before calling check_load_issue_conditions */
   md_addr_t ld_addr = LDQ[uop->alloc.LDQ_index].uop->oracle.virt_addr;
 
   for(i=LDQ[uop->alloc.LDQ_index].store_color;
-      ((modinc(i,knobs->exec.STQ_size)) != STQ_head) && (STQ[i].uop_seq < uop->decode.uop_seq) && (num_stores < STQ_num);
-      i=moddec(i,knobs->exec.STQ_size) )
+      ((modinc(i,CORE_KNOB(knobs, exec, STQ_size))) != STQ_head) && (STQ[i].uop_seq < uop->decode.uop_seq) && (num_stores < STQ_num);
+      i=moddec(i,CORE_KNOB(knobs, exec, STQ_size)) )
   {
     /* check addr match */
     md_addr_t st_addr;
@@ -607,7 +607,7 @@ bool core_exec_STM_t::check_load_issue_conditions(const struct uop_t * const uop
 
 void core_exec_STM_t::load_writeback(struct uop_t * const uop)
 {
-  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < core->knobs->exec.LDQ_size),(void)0);
+  zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(core->knobs, exec, LDQ_size)),(void)0);
   if(!LDQ[uop->alloc.LDQ_index].hit_in_STQ) /* no match in STQ, so use cache value */
   {
     uop->exec.ovalue_valid = true;
@@ -727,14 +727,14 @@ void core_exec_STM_t::LDST_exec(void)
       if(port[port_num].STQ->pipe[1].action_id == uop->exec.action_id)
       {
         int num_stores = 0;
-        zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+        zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
 
         j=LDQ[uop->alloc.LDQ_index].store_color;
 
         int cond1 = STQ[j].sta != NULL;
         seq_t seq1 = (seq_t)-1, seq2 = (seq_t)-1;
         zesto_assert(j >= 0,(void)0);
-        zesto_assert(j < knobs->exec.STQ_size,(void)0);
+        zesto_assert(j < CORE_KNOB(knobs, exec, STQ_size),(void)0);
         if(j)
         {
           seq1 = (seq_t)-2;
@@ -815,7 +815,7 @@ void core_exec_STM_t::LDST_exec(void)
 
           num_stores++;
 
-          j=moddec(j,knobs->exec.STQ_size); //(j-1+knobs->exec.STQ_size) % knobs->exec.STQ_size;
+          j=moddec(j,CORE_KNOB(knobs, exec, STQ_size)); //(j-1+CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
 
           cond1 = STQ[j].sta != NULL;
           cond2 = cond1 && (STQ[j].sta->decode.uop_seq < uop->decode.uop_seq);
@@ -844,7 +844,7 @@ void core_exec_STM_t::LDQ_schedule(void)
   /* walk LDQ, if anyone's ready, issue to DTLB/DL1 */
   for(i=0;i<LDQ_num;i++)
   {
-    //int index = (LDQ_head + i) % knobs->exec.LDQ_size; // incremented at bottom of loop
+    //int index = (LDQ_head + i) % CORE_KNOB(knobs, exec, LDQ_size); // incremented at bottom of loop
     if(LDQ[index].addr_valid) /* agen has finished */
     {
       if(LDQ[index].when_issued == TICK_T_MAX) /* load hasn't issued to DL1/STQ already */
@@ -852,13 +852,13 @@ void core_exec_STM_t::LDQ_schedule(void)
         if(check_load_issue_conditions(LDQ[index].uop)) /* retval of true means load is predicted to be cleared for issue */
         {
           struct uop_t * uop = LDQ[index].uop;
-          if((cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr))) &&
+          if((cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift))) &&
              (cache_enqueuable(core->memory.DL1.get(), asid, uop->oracle.virt_addr)) &&
              (port[uop->alloc.port_assignment].STQ->occupancy < port[uop->alloc.port_assignment].STQ->latency))
           {
             uop->exec.when_data_loaded = TICK_T_MAX;
             uop->exec.when_addr_translated = TICK_T_MAX;
-            cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr), uop->exec.action_id, 0, NO_MSHR, uop, DTLB_callback, NULL, NULL, get_uop_action_id);
+            cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift), uop->exec.action_id, 0, NO_MSHR, uop, DTLB_callback, NULL, NULL, get_uop_action_id);
             cache_enqueue(core, core->memory.DL1.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, uop->oracle.virt_addr, uop->exec.action_id, 0, NO_MSHR, uop, DL1_callback, NULL, translated_callback, get_uop_action_id);
 
             int insert_position = port[uop->alloc.port_assignment].STQ->occupancy+1;
@@ -878,7 +878,7 @@ void core_exec_STM_t::LDQ_schedule(void)
         }
       }
     }
-    index = modinc(index,knobs->exec.LDQ_size);
+    index = modinc(index,CORE_KNOB(knobs, exec, LDQ_size));
   }
 }
 
@@ -904,7 +904,7 @@ void core_exec_STM_t::ALU_exec(void)
   bool work_found = false;
 
   /* Process Functional Units */
-  for(i=0;i<knobs->exec.num_exec_ports;i++)
+  for(i=0;i<CORE_KNOB(knobs, exec, num_exec_ports);i++)
   {
     int j;
     for(j=0;j<port[i].num_FU_types;j++)
@@ -932,7 +932,7 @@ void core_exec_STM_t::ALU_exec(void)
             if(uop->decode.is_load) /* loads need to be processed differently */
             {
               /* update load queue entry */
-              zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < knobs->exec.LDQ_size),(void)0);
+              zesto_assert((uop->alloc.LDQ_index >= 0) && (uop->alloc.LDQ_index < CORE_KNOB(knobs, exec, LDQ_size)),(void)0);
               LDQ[uop->alloc.LDQ_index].virt_addr = uop->oracle.virt_addr;
               LDQ[uop->alloc.LDQ_index].addr_valid = true;
               /* actual scheduling from load queue takes place in LDQ_schedule() */
@@ -954,14 +954,14 @@ void core_exec_STM_t::ALU_exec(void)
               }
               else if(uop->decode.is_sta)
               {
-                zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < knobs->exec.STQ_size),(void)0);
+                zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(knobs, exec, STQ_size)),(void)0);
                 zesto_assert(!STQ[uop->alloc.STQ_index].addr_valid,(void)0);
                 STQ[uop->alloc.STQ_index].virt_addr = uop->oracle.virt_addr;
                 STQ[uop->alloc.STQ_index].addr_valid = true;
               }
               else if(uop->decode.is_std)
               {
-                zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < knobs->exec.STQ_size),(void)0);
+                zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(knobs, exec, STQ_size)),(void)0);
                 zesto_assert(!STQ[uop->alloc.STQ_index].value_valid,(void)0);
                 STQ[uop->alloc.STQ_index].value_valid = true;
               }
@@ -978,12 +978,12 @@ void core_exec_STM_t::ALU_exec(void)
                 int overwrite_index = uop->alloc.STQ_index;
 
                 /* XXX using oracle info here. */
-                zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < knobs->exec.STQ_size),(void)0);
+                zesto_assert((uop->alloc.STQ_index >= 0) && (uop->alloc.STQ_index < CORE_KNOB(knobs, exec, STQ_size)),(void)0);
                 md_addr_t st_addr = STQ[uop->alloc.STQ_index].sta->oracle.virt_addr;
 
                 for(idx=STQ[uop->alloc.STQ_index].next_load;
                     LDQ[idx].uop && (LDQ[idx].uop->decode.uop_seq > uop->decode.uop_seq) && (num_loads < LDQ_num);
-                    idx=modinc(idx,knobs->exec.LDQ_size))
+                    idx=modinc(idx,CORE_KNOB(knobs, exec, LDQ_size)))
                 {
                   if(LDQ[idx].store_color != uop->alloc.STQ_index) /* some younger stores present */
                   {
@@ -991,7 +991,7 @@ void core_exec_STM_t::ALU_exec(void)
                     /* scan store queue for younger loads to see if we've been overwritten */
                     while(overwrite_index != LDQ[idx].store_color)
                     {
-                      overwrite_index = modinc(overwrite_index,knobs->exec.STQ_size);
+                      overwrite_index = modinc(overwrite_index,CORE_KNOB(knobs, exec, STQ_size));
                       if(overwrite_index == STQ_tail)
                         fatal("searching for matching store color but hit the end of the STQ");
 
@@ -1091,7 +1091,7 @@ void core_exec_STM_t::recover(void)
 
 bool core_exec_STM_t::RS_available(void)
 {
-  return RS_num < core->knobs->exec.RS_size;
+  return RS_num < CORE_KNOB(core->knobs, exec, RS_size);
 }
 
 /* assumes you already called RS_available to check that
@@ -1100,12 +1100,12 @@ void core_exec_STM_t::RS_insert(struct uop_t * const uop)
 {
   int RS_index;
   /* find a free RS entry */
-  for(RS_index=0;RS_index < core->knobs->exec.RS_size;RS_index++)
+  for(RS_index=0;RS_index < CORE_KNOB(core->knobs, exec, RS_size);RS_index++)
   {
     if(RS[RS_index] == NULL)
       break;
   }
-  if(RS_index == core->knobs->exec.RS_size)
+  if(RS_index == CORE_KNOB(core->knobs, exec, RS_size))
     fatal("RS and RS_num out of sync");
 
   RS[RS_index] = uop;
@@ -1122,7 +1122,7 @@ void core_exec_STM_t::RS_fuse_insert(struct uop_t * const uop)
 
 void core_exec_STM_t::RS_deallocate(struct uop_t * const dead_uop)
 {
-  zesto_assert(dead_uop->alloc.RS_index < core->knobs->exec.RS_size,(void)0);
+  zesto_assert(dead_uop->alloc.RS_index < CORE_KNOB(core->knobs, exec, RS_size),(void)0);
 
   RS[dead_uop->alloc.RS_index] = NULL;
   RS_num --;
@@ -1132,7 +1132,7 @@ void core_exec_STM_t::RS_deallocate(struct uop_t * const dead_uop)
 
 bool core_exec_STM_t::LDQ_available(void)
 {
-  return LDQ_num < core->knobs->exec.LDQ_size;
+  return LDQ_num < CORE_KNOB(core->knobs, exec, LDQ_size);
 }
 
 void core_exec_STM_t::LDQ_insert(struct uop_t * const uop)
@@ -1141,11 +1141,11 @@ void core_exec_STM_t::LDQ_insert(struct uop_t * const uop)
   memzero(&LDQ[LDQ_tail],sizeof(*LDQ));
   LDQ[LDQ_tail].uop = uop;
   LDQ[LDQ_tail].mem_size = uop->decode.mem_size;
-  LDQ[LDQ_tail].store_color = moddec(STQ_tail,core->knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  LDQ[LDQ_tail].store_color = moddec(STQ_tail,CORE_KNOB(core->knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   LDQ[LDQ_tail].when_issued = TICK_T_MAX;
   uop->alloc.LDQ_index = LDQ_tail;
   LDQ_num++;
-  LDQ_tail = modinc(LDQ_tail,core->knobs->exec.LDQ_size); //(LDQ_tail+1) % knobs->exec.LDQ_size;
+  LDQ_tail = modinc(LDQ_tail,CORE_KNOB(core->knobs, exec, LDQ_size)); //(LDQ_tail+1) % CORE_KNOB(knobs, exec, LDQ_size);
 }
 
 /* called by commit */
@@ -1153,18 +1153,18 @@ void core_exec_STM_t::LDQ_deallocate(struct uop_t * const uop)
 {
   LDQ[LDQ_head].uop = NULL;
   LDQ_num --;
-  LDQ_head = modinc(LDQ_head,core->knobs->exec.LDQ_size); //(LDQ_head+1) % knobs->exec.LDQ_size;
+  LDQ_head = modinc(LDQ_head,CORE_KNOB(core->knobs, exec, LDQ_size)); //(LDQ_head+1) % CORE_KNOB(knobs, exec, LDQ_size);
   uop->alloc.LDQ_index = -1;
 }
 
 void core_exec_STM_t::LDQ_squash(struct uop_t * const dead_uop)
 {
-  zesto_assert((dead_uop->alloc.LDQ_index >= 0) && (dead_uop->alloc.LDQ_index < core->knobs->exec.LDQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.LDQ_index >= 0) && (dead_uop->alloc.LDQ_index < CORE_KNOB(core->knobs, exec, LDQ_size)),(void)0);
   zesto_assert(LDQ[dead_uop->alloc.LDQ_index].uop == dead_uop,(void)0);
   //memset(&LDQ[dead_uop->alloc.LDQ_index],0,sizeof(LDQ[0]));
   memzero(&LDQ[dead_uop->alloc.LDQ_index],sizeof(LDQ[0]));
   LDQ_num --;
-  LDQ_tail = moddec(LDQ_tail,core->knobs->exec.LDQ_size); //(LDQ_tail - 1 + knobs->exec.LDQ_size) % knobs->exec.LDQ_size;
+  LDQ_tail = moddec(LDQ_tail,CORE_KNOB(core->knobs, exec, LDQ_size)); //(LDQ_tail - 1 + CORE_KNOB(knobs, exec, LDQ_size)) % CORE_KNOB(knobs, exec, LDQ_size);
   zesto_assert(LDQ_num >= 0,(void)0);
   dead_uop->alloc.LDQ_index = -1;
 }
@@ -1176,7 +1176,7 @@ bool core_exec_STM_t::STQ_empty(void)
 
 bool core_exec_STM_t::STQ_available(void)
 {
-  return STQ_num < core->knobs->exec.STQ_size;
+  return STQ_num < CORE_KNOB(core->knobs, exec, STQ_size);
 }
 
 void core_exec_STM_t::STQ_insert_sta(struct uop_t * const uop)
@@ -1189,13 +1189,13 @@ void core_exec_STM_t::STQ_insert_sta(struct uop_t * const uop)
   STQ[STQ_tail].next_load = LDQ_tail;
   uop->alloc.STQ_index = STQ_tail;
   STQ_num++;
-  STQ_tail = modinc(STQ_tail,core->knobs->exec.STQ_size); //(STQ_tail+1) % knobs->exec.STQ_size;
+  STQ_tail = modinc(STQ_tail,CORE_KNOB(core->knobs, exec, STQ_size)); //(STQ_tail+1) % CORE_KNOB(knobs, exec, STQ_size);
 }
 
 void core_exec_STM_t::STQ_insert_std(struct uop_t * const uop)
 {
   /* STQ_tail already incremented from the STA.  Just add this uop to STQ->std */
-  int index = moddec(STQ_tail,core->knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  int index = moddec(STQ_tail,CORE_KNOB(core->knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   uop->alloc.STQ_index = index;
   STQ[index].std = uop;
   zesto_assert(STQ[index].sta,(void)0); /* shouldn't have STD w/o a corresponding STA */
@@ -1214,7 +1214,7 @@ bool core_exec_STM_t::STQ_deallocate_std(struct uop_t * const uop)
 
   /* Store write back occurs here at commit. */
   if(!cache_enqueuable(core->memory.DL1.get(), asid, uop->oracle.virt_addr) ||
-     !cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr)))
+     !cache_enqueuable(core->memory.DTLB.get(), asid, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift)))
     return false;
 
   /* These are just dummy placeholders, but we need them
@@ -1236,14 +1236,14 @@ bool core_exec_STM_t::STQ_deallocate_std(struct uop_t * const uop)
   dl1_uop->exec.action_id = STQ[STQ_head].action_id;
   dtlb_uop->exec.action_id = dl1_uop->exec.action_id;
 
-  cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr), dtlb_uop->exec.action_id, 0, NO_MSHR, dtlb_uop, store_dtlb_callback, NULL, NULL, get_uop_action_id);
+  cache_enqueue(core, core->memory.DTLB.get(), NULL, CACHE_READ, asid, uop->Mop->fetch.PC, memory::page_table_address(asid, uop->oracle.virt_addr, uop->oracle.page_shift), dtlb_uop->exec.action_id, 0, NO_MSHR, dtlb_uop, store_dtlb_callback, NULL, NULL, get_uop_action_id);
   cache_enqueue(core, core->memory.DL1.get(), NULL, CACHE_WRITE, asid, uop->Mop->fetch.PC, uop->oracle.virt_addr, dl1_uop->exec.action_id, 0, NO_MSHR, dl1_uop, store_dl1_callback, NULL, store_translated_callback, get_uop_action_id);
 
   STQ[STQ_head].std = NULL;
   STQ[STQ_head].translation_complete = false;
   STQ[STQ_head].write_complete = false;
   STQ_num --;
-  STQ_head = modinc(STQ_head,core->knobs->exec.STQ_size); //(STQ_head+1) % knobs->exec.STQ_size;
+  STQ_head = modinc(STQ_head,CORE_KNOB(core->knobs, exec, STQ_size)); //(STQ_head+1) % CORE_KNOB(knobs, exec, STQ_size);
 
   return true;
 }
@@ -1255,20 +1255,20 @@ void core_exec_STM_t::STQ_deallocate_senior(void)
 
 void core_exec_STM_t::STQ_squash_sta(struct uop_t * const dead_uop)
 {
-  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].std == NULL,(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].sta == dead_uop,(void)0);
   //memset(&STQ[dead_uop->alloc.STQ_index],0,sizeof(STQ[0]));
   memzero(&STQ[dead_uop->alloc.STQ_index],sizeof(STQ[0]));
   STQ_num --;
-  STQ_tail = moddec(STQ_tail,core->knobs->exec.STQ_size); //(STQ_tail - 1 + knobs->exec.STQ_size) % knobs->exec.STQ_size;
+  STQ_tail = moddec(STQ_tail,CORE_KNOB(core->knobs, exec, STQ_size)); //(STQ_tail - 1 + CORE_KNOB(knobs, exec, STQ_size)) % CORE_KNOB(knobs, exec, STQ_size);
   zesto_assert(STQ_num >= 0,(void)0);
   dead_uop->alloc.STQ_index = -1;
 }
 
 void core_exec_STM_t::STQ_squash_std(struct uop_t * const dead_uop)
 {
-  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < core->knobs->exec.STQ_size),(void)0);
+  zesto_assert((dead_uop->alloc.STQ_index >= 0) && (dead_uop->alloc.STQ_index < CORE_KNOB(core->knobs, exec, STQ_size)),(void)0);
   zesto_assert(STQ[dead_uop->alloc.STQ_index].std == dead_uop,(void)0);
   STQ[dead_uop->alloc.STQ_index].std = NULL;
   dead_uop->alloc.STQ_index = -1;
@@ -1293,7 +1293,7 @@ void core_exec_STM_t::store_dl1_callback(void * const op)
 {
   struct uop_t * const uop = (struct uop_t *)op;
   xiosim_core_assert((uop->alloc.STQ_index >= 0) &&
-                             (uop->alloc.STQ_index < uop->core->knobs->exec.STQ_size),
+                             (uop->alloc.STQ_index < CORE_KNOB(uop->core->knobs, exec, STQ_size)),
                      uop->core->id);
   x86::return_uop_array(uop, 1);
 }
@@ -1302,7 +1302,7 @@ void core_exec_STM_t::store_dtlb_callback(void * const op)
 {
   struct uop_t * const uop = (struct uop_t *)op;
   xiosim_core_assert((uop->alloc.STQ_index >= 0) &&
-                             (uop->alloc.STQ_index < uop->core->knobs->exec.STQ_size),
+                             (uop->alloc.STQ_index < CORE_KNOB(uop->core->knobs, exec, STQ_size)),
                      uop->core->id);
   x86::return_uop_array(uop, 1);
 }
@@ -3,7 +3,7 @@
     return std::make_unique<class core_exec_NONE_t>(core);
 #else
 
-class core_exec_NONE_t:public core_exec_t
+class core_exec_NONE_t final : public core_exec_t
 {
   public:
 
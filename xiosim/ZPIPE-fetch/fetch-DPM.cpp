@@ -8,7 +8,7 @@
 		  || !strcasecmp(fetch_opt_string,"IO-DPM"))
     return std::make_unique<class core_fetch_DPM_t>(core);
 #else
-class core_fetch_DPM_t:public core_fetch_t
+class core_fetch_DPM_t final : public core_fetch_t
 {
   enum fetch_stall_t {FSTALL_byteQ_FULL, /* byteQ is full */
                       FSTALL_TBR,      /* predicted taken */
@@ -59,6 +59,7 @@ class core_fetch_DPM_t:public core_fetch_t
      per entry. */
   struct byteQ_entry_t {
     md_addr_t addr;
+    md_addr_t page_shift; /* of the page mapping addr */
     tick_t when_fetch_requested;
     tick_t when_fetched;
     tick_t when_translation_requested;
@@ -93,7 +94,7 @@ class core_fetch_DPM_t:public core_fetch_t
   static const char *fetch_stall_str[FSTALL_num];
 
   bool predecode_enqueue(struct Mop_t * const Mop);
-  void byteQ_request(const md_addr_t lineaddr);
+  void byteQ_request(const md_addr_t lineaddr, const md_addr_t page_shift);
   bool byteQ_is_full(void);
   bool byteQ_already_requested(const md_addr_t addr);
 
@@ -140,34 +141,34 @@ core_fetch_DPM_t::core_fetch_DPM_t(struct core_t * const arg_core):
       knobs->fetch.ras_opt_str
     );
 
-  if(knobs->fetch.jeclear_delay)
+  if(CORE_KNOB(knobs, fetch, jeclear_delay))
   {
-    jeclear_pipe = (jeclear_pipe_t*) calloc(knobs->fetch.jeclear_delay,sizeof(*jeclear_pipe));
+    jeclear_pipe = (jeclear_pipe_t*) calloc(CORE_KNOB(knobs, fetch, jeclear_delay),sizeof(*jeclear_pipe));
     if(!jeclear_pipe)
       fatal("couldn't calloc jeclear pipe");
   }
 
   create_caches();
 
-  byteQ = (byteQ_entry_t*) calloc(knobs->fetch.byteQ_size,sizeof(*byteQ));
+  byteQ = (byteQ_entry_t*) calloc(CORE_KNOB(knobs, fetch, byteQ_size),sizeof(*byteQ));
   byteQ_head = byteQ_tail = 0;
   if(!byteQ)
     fatal("couldn't calloc byteQ");
 
-  byteQ_linemask = ~(md_addr_t)(knobs->fetch.byteQ_linesize - 1);
+  byteQ_linemask = ~(md_addr_t)(CORE_KNOB(knobs, fetch, byteQ_linesize) - 1);
 
-  pipe = (struct Mop_t***) calloc(knobs->fetch.depth,sizeof(*pipe));
+  pipe = (struct Mop_t***) calloc(CORE_KNOB(knobs, fetch, depth),sizeof(*pipe));
   if(!pipe)
     fatal("couldn't calloc predecode pipe");
 
-  for(int i=0;i<knobs->fetch.depth;i++)
+  for(int i=0;i<CORE_KNOB(knobs, fetch, depth);i++)
   {
-    pipe[i] = (struct Mop_t**) calloc(knobs->fetch.width,sizeof(**pipe));
+    pipe[i] = (struct Mop_t**) calloc(CORE_KNOB(knobs, fetch, width),sizeof(**pipe));
     if(!pipe[i])
       fatal("couldn't calloc predecode pipe[%d]",i);
   }
 
-  IQ = (struct Mop_t**) calloc(knobs->fetch.IQ_size,sizeof(*IQ));
+  IQ = (struct Mop_t**) calloc(CORE_KNOB(knobs, fetch, IQ_size),sizeof(*IQ));
   if(!IQ)
     fatal("couldn't calloc decode instruction queue");
   IQ_head = IQ_tail = 0;
@@ -176,7 +177,7 @@ core_fetch_DPM_t::core_fetch_DPM_t(struct core_t * const arg_core):
 core_fetch_DPM_t::~core_fetch_DPM_t() {
     free(IQ);
 
-    for (int i = 0; i < core->knobs->fetch.depth; i++) {
+    for (int i = 0; i < CORE_KNOB(core->knobs, fetch, depth); i++) {
         free(pipe[i]);
     }
     free(pipe);
@@ -269,7 +270,7 @@ void core_fetch_DPM_t::update_occupancy(void)
 
     /* IQ */
   core->stat.IQ_occupancy += IQ_num;
-  if(IQ_num >= core->knobs->fetch.IQ_size)
+  if(IQ_num >= CORE_KNOB(core->knobs, fetch, IQ_size))
     core->stat.IQ_full_cycles++;
   if(IQ_num <= 0)
     core->stat.IQ_empty_cycles++;
@@ -283,14 +284,14 @@ void core_fetch_DPM_t::update_occupancy(void)
 bool core_fetch_DPM_t::byteQ_is_full(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return (byteQ_num >= knobs->fetch.byteQ_size);
+  return (byteQ_num >= CORE_KNOB(knobs, fetch, byteQ_size));
 }
 
 /* is this line already the most recently requested? */
 bool core_fetch_DPM_t::byteQ_already_requested(const md_addr_t addr)
 {
   struct core_knobs_t * knobs = core->knobs;
-  int index = moddec(byteQ_tail,knobs->fetch.byteQ_size); //(byteQ_tail-1+knobs->fetch.byteQ_size) % knobs->fetch.byteQ_size;
+  int index = moddec(byteQ_tail,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_tail-1+CORE_KNOB(knobs, fetch, byteQ_size)) % CORE_KNOB(knobs, fetch, byteQ_size);
   if(byteQ_num && (byteQ[index].addr == (addr & byteQ_linemask)))
     return true;
   else
@@ -298,7 +299,7 @@ bool core_fetch_DPM_t::byteQ_already_requested(const md_addr_t addr)
 }
 
 /* Initiate a fetch request */
-void core_fetch_DPM_t::byteQ_request(const md_addr_t lineaddr)
+void core_fetch_DPM_t::byteQ_request(const md_addr_t lineaddr, const md_addr_t page_shift)
 {
   struct core_knobs_t * knobs = core->knobs;
   /* this function assumes you already called byteQ_already_requested so that
@@ -308,9 +309,10 @@ void core_fetch_DPM_t::byteQ_request(const md_addr_t lineaddr)
   byteQ[byteQ_tail].when_translation_requested = TICK_T_MAX;
   byteQ[byteQ_tail].when_translated = TICK_T_MAX;
   byteQ[byteQ_tail].addr = lineaddr;
+  byteQ[byteQ_tail].page_shift = page_shift;
   byteQ[byteQ_tail].action_id = core->new_action_id();
   byteQ[byteQ_tail].core = core;
-  byteQ_tail = modinc(byteQ_tail,knobs->fetch.byteQ_size); //(byteQ_tail+1)%knobs->fetch.byteQ_size;
+  byteQ_tail = modinc(byteQ_tail,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_tail+1)%CORE_KNOB(knobs, fetch, byteQ_size);
   byteQ_num++;
 
   return;
@@ -350,10 +352,10 @@ bool core_fetch_DPM_t::predecode_enqueue(struct Mop_t * const Mop)
 {
   struct core_knobs_t * knobs = core->knobs;
   int i;
-  int free_index = knobs->fetch.width;
+  int free_index = CORE_KNOB(knobs, fetch, width);
 
   /* Find the first free entry after the last occupied entry */
-  for(i=knobs->fetch.width-1;i>=0;i--)
+  for(i=CORE_KNOB(knobs, fetch, width)-1;i>=0;i--)
   {
     if(pipe[0][i])
     {
@@ -364,7 +366,7 @@ bool core_fetch_DPM_t::predecode_enqueue(struct Mop_t * const Mop)
   if(i<0) /* stage was completely empty */
     free_index = 0;
 
-  if(free_index < knobs->fetch.width)
+  if(free_index < CORE_KNOB(knobs, fetch, width))
   {
     pipe[0][free_index] = Mop;
 #ifdef ZTRACE
@@ -393,11 +395,11 @@ void core_fetch_DPM_t::post_fetch(void)
   lk_unlock(&cache_lock);
 
   /* check predecode pipe's last stage for instructions to put into the IQ */
-  for(i=0;(i<knobs->fetch.width) && (IQ_num < knobs->fetch.IQ_size);i++)
+  for(i=0;(i<CORE_KNOB(knobs, fetch, width)) && (IQ_num < CORE_KNOB(knobs, fetch, IQ_size));i++)
   {
-    if(pipe[knobs->fetch.depth-1][i])
+    if(pipe[CORE_KNOB(knobs, fetch, depth)-1][i])
     {
-      struct Mop_t * Mop= pipe[knobs->fetch.depth-1][i];
+      struct Mop_t * Mop= pipe[CORE_KNOB(knobs, fetch, depth)-1][i];
       if(Mop->uop[Mop->decode.last_uop_index].decode.EOM)
       {
         ZESTO_STAT(core->stat.predecode_insn++;)
@@ -406,9 +408,9 @@ void core_fetch_DPM_t::post_fetch(void)
       }
       ZESTO_STAT(core->stat.predecode_bytes += Mop->fetch.len;)
 
-      IQ[IQ_tail] = pipe[knobs->fetch.depth-1][i];
-      pipe[knobs->fetch.depth-1][i] = NULL;
-      IQ_tail = modinc(IQ_tail,knobs->fetch.IQ_size); //(IQ_tail + 1) % knobs->fetch.IQ_size;
+      IQ[IQ_tail] = pipe[CORE_KNOB(knobs, fetch, depth)-1][i];
+      pipe[CORE_KNOB(knobs, fetch, depth)-1][i] = NULL;
+      IQ_tail = modinc(IQ_tail,CORE_KNOB(knobs, fetch, IQ_size)); //(IQ_tail + 1) % CORE_KNOB(knobs, fetch, IQ_size);
       IQ_num ++;
       IQ_uop_num += Mop->stat.num_uops;
       IQ_eff_uop_num += Mop->stat.num_eff_uops;
@@ -419,11 +421,11 @@ void core_fetch_DPM_t::post_fetch(void)
   }
 
   /* shuffle predecode pipe (non-serpentine) */
-  for(i=knobs->fetch.depth-1;i>0;i--)
+  for(i=CORE_KNOB(knobs, fetch, depth)-1;i>0;i--)
   {
     int j;
     int this_stage_free = true;
-    for(j=0;j<knobs->fetch.width;j++)
+    for(j=0;j<CORE_KNOB(knobs, fetch, width);j++)
     {
       if(pipe[i][j])
       {
@@ -434,7 +436,7 @@ void core_fetch_DPM_t::post_fetch(void)
 
     if(this_stage_free)
     {
-      for(j=0;j<knobs->fetch.width;j++)
+      for(j=0;j<CORE_KNOB(knobs, fetch, width);j++)
       {
         pipe[i][j] = pipe[i-1][j];
         pipe[i-1][j] = NULL;
@@ -481,7 +483,7 @@ void core_fetch_DPM_t::post_fetch(void)
       byteQ[byteQ_index].when_translation_requested = TICK_T_MAX;
       byteQ[byteQ_index].when_translated = TICK_T_MAX;
       byteQ_num--;
-      byteQ_head = modinc(byteQ_index,knobs->fetch.byteQ_size); //(byteQ_index+1)%knobs->fetch.byteQ_size;
+      byteQ_head = modinc(byteQ_index,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_index+1)%CORE_KNOB(knobs, fetch, byteQ_size);
     }
   }
 
@@ -509,7 +511,7 @@ void core_fetch_DPM_t::pre_fetch(void)
         break;
       }
     }
-    index = modinc(index,knobs->fetch.byteQ_size);
+    index = modinc(index,CORE_KNOB(knobs, fetch, byteQ_size));
   }
 
   index = byteQ_head;
@@ -517,24 +519,24 @@ void core_fetch_DPM_t::pre_fetch(void)
   {
     if(byteQ[index].when_translation_requested == TICK_T_MAX)
     {
-      if(cache_enqueuable(core->memory.ITLB.get(), asid, memory::page_table_address(asid, byteQ[index].addr)))
+      if(cache_enqueuable(core->memory.ITLB.get(), asid, memory::page_table_address(asid, byteQ[index].addr, byteQ[index].page_shift)))
       {
-        cache_enqueue(core, core->memory.ITLB.get(), NULL, CACHE_READ, 0, asid, memory::page_table_address(asid, byteQ[index].addr), byteQ[index].action_id, 0, NO_MSHR, &byteQ[index], ITLB_callback, NULL, NULL, get_byteQ_action_id);
+        cache_enqueue(core, core->memory.ITLB.get(), NULL, CACHE_READ, 0, asid, memory::page_table_address(asid, byteQ[index].addr, byteQ[index].page_shift), byteQ[index].action_id, 0, NO_MSHR, &byteQ[index], ITLB_callback, NULL, NULL, get_byteQ_action_id);
         byteQ[index].when_translation_requested = core->sim_cycle;
         break;
       }
     }
-    index = modinc(index,knobs->fetch.byteQ_size);
+    index = modinc(index,CORE_KNOB(knobs, fetch, byteQ_size));
   }
 
   /* process jeclears */
-  if(knobs->fetch.jeclear_delay)
+  if(CORE_KNOB(knobs, fetch, jeclear_delay))
   {
-    struct Mop_t * Mop = jeclear_pipe[knobs->fetch.jeclear_delay-1].Mop;
-    md_addr_t New_PC = jeclear_pipe[knobs->fetch.jeclear_delay-1].New_PC;
+    struct Mop_t * Mop = jeclear_pipe[CORE_KNOB(knobs, fetch, jeclear_delay)-1].Mop;
+    md_addr_t New_PC = jeclear_pipe[CORE_KNOB(knobs, fetch, jeclear_delay)-1].New_PC;
 
     /* there's a jeclear and it's still valid */
-    if(Mop && (jeclear_pipe[knobs->fetch.jeclear_delay-1].action_id == Mop->fetch.jeclear_action_id))
+    if(Mop && (jeclear_pipe[CORE_KNOB(knobs, fetch, jeclear_delay)-1].action_id == Mop->fetch.jeclear_action_id))
     {
 #ifdef ZTRACE
       ztrace_print(Mop,"f|jeclear_pipe|jeclear dequeued");
@@ -551,7 +553,7 @@ void core_fetch_DPM_t::pre_fetch(void)
     }
 
     /* advance jeclear pipe */
-    for(i=knobs->fetch.jeclear_delay-1;i>0;i--)
+    for(i=CORE_KNOB(knobs, fetch, jeclear_delay)-1;i>0;i--)
       jeclear_pipe[i] = jeclear_pipe[i-1];
     jeclear_pipe[0].Mop = NULL;
   }
@@ -616,7 +618,7 @@ bool core_fetch_DPM_t::do_fetch(void)
       ztrace_print(Mop,"f|byteQ|first byte requested");
 #endif
     Mop->fetch.first_byte_requested = true;
-    byteQ_request(start_PC & byteQ_linemask);
+    byteQ_request(start_PC & byteQ_linemask, Mop->fetch.page_shift);
   }
 
   if(byteQ_already_requested(end_PC)) /* this should hit if end_PC is on same cache line as start_PC */
@@ -644,7 +646,11 @@ bool core_fetch_DPM_t::do_fetch(void)
 #ifdef ZTRACE
     ztrace_print(Mop,"f|byteQ|last byte requested");
 #endif
-    byteQ_request(end_PC & byteQ_linemask);
+    /* The oracle only looked up the page of the first byte. */
+    md_addr_t end_page_shift = Mop->fetch.page_shift;
+    if((end_PC >> end_page_shift) != (start_PC >> end_page_shift))
+      end_page_shift = memory::page_shift(core->asid, end_PC);
+    byteQ_request(end_PC & byteQ_linemask, end_page_shift);
   }
 
   zesto_assert(Mop->fetch.first_byte_requested && Mop->fetch.last_byte_requested,false);
@@ -653,7 +659,7 @@ bool core_fetch_DPM_t::do_fetch(void)
      and let the oracle know we're done with it so can proceed to the next
      one */
 
-  int byteQ_index = moddec(byteQ_tail,knobs->fetch.byteQ_size); //(byteQ_tail-1+knobs->fetch.byteQ_size)%knobs->fetch.byteQ_size;
+  int byteQ_index = moddec(byteQ_tail,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_tail-1+CORE_KNOB(knobs, fetch, byteQ_size))%CORE_KNOB(knobs, fetch, byteQ_size);
   if(byteQ[byteQ_index].num_Mop == 0)
     byteQ[byteQ_index].MopQ_first_index = core->oracle->get_index(Mop);
   byteQ[byteQ_index].num_Mop++;
@@ -743,7 +749,7 @@ void core_fetch_DPM_t::Mop_consume(void)
   struct core_knobs_t * knobs = core->knobs;
   struct Mop_t * Mop = IQ[IQ_head];
   IQ[IQ_head] = NULL;
-  IQ_head = modinc(IQ_head,knobs->fetch.IQ_size); //(IQ_head + 1) % knobs->fetch.IQ_size;
+  IQ_head = modinc(IQ_head,CORE_KNOB(knobs, fetch, IQ_size)); //(IQ_head + 1) % CORE_KNOB(knobs, fetch, IQ_size);
   IQ_num --;
   IQ_uop_num -= Mop->stat.num_uops;
   IQ_eff_uop_num -= Mop->stat.num_eff_uops;
@@ -792,7 +798,7 @@ core_fetch_DPM_t::recover(const md_addr_t new_PC)
   PC = new_PC;
 
   /* clear out the byteQ */
-  for(i=0;i<knobs->fetch.byteQ_size;i++)
+  for(i=0;i<CORE_KNOB(knobs, fetch, byteQ_size);i++)
   {
     byteQ[i].addr = 0;
     byteQ[i].when_fetch_requested = TICK_T_MAX;
@@ -808,17 +814,17 @@ core_fetch_DPM_t::recover(const md_addr_t new_PC)
   byteQ_head = 0;
   byteQ_tail = 0;
 
-  memzero(IQ,knobs->fetch.IQ_size*sizeof(*IQ));
+  memzero(IQ,CORE_KNOB(knobs, fetch, IQ_size)*sizeof(*IQ));
   IQ_num = 0;
   IQ_uop_num = 0;
   IQ_eff_uop_num = 0;
   IQ_head = 0;
   IQ_tail = 0;
 
-  for(i=0;i<knobs->fetch.depth;i++)
+  for(i=0;i<CORE_KNOB(knobs, fetch, depth);i++)
   {
     int j;
-    for(j=0;j<knobs->fetch.width;j++)
+    for(j=0;j<CORE_KNOB(knobs, fetch, width);j++)
       pipe[i][j] = NULL;
   }
 }
@@ -8,7 +8,7 @@
     return std::make_unique<class core_fetch_STM_t>(core);
 #else
 
-class core_fetch_STM_t:public core_fetch_t
+class core_fetch_STM_t final : public core_fetch_t
 {
   enum fetch_stall_t {FSTALL_byteQ_FULL, /* byteQ is full */
                       FSTALL_TBR,      /* predicted taken */
@@ -55,6 +55,7 @@ class core_fetch_STM_t:public core_fetch_t
      per entry. */
   struct byteQ_entry_t {
     md_addr_t addr;
+    md_addr_t page_shift; /* of the page mapping addr */
     tick_t when_fetch_requested;
     tick_t when_fetched;
     tick_t when_translation_requested;
@@ -70,7 +71,7 @@ class core_fetch_STM_t:public core_fetch_t
 
   static const char *fetch_stall_str[FSTALL_num];
 
-  void byteQ_request(const md_addr_t lineaddr);
+  void byteQ_request(const md_addr_t lineaddr, const md_addr_t page_shift);
   bool byteQ_is_full(void);
   bool byteQ_already_requested(const md_addr_t addr);
 
@@ -111,16 +112,16 @@ core_fetch_STM_t::core_fetch_STM_t(struct core_t * const arg_core):
       knobs->fetch.ras_opt_str
     );
 
-  zesto_assert(knobs->fetch.jeclear_delay == 0, void);
+  zesto_assert(CORE_KNOB(knobs, fetch, jeclear_delay) == 0, void);
 
   create_caches();
 
-  byteQ = (byteQ_entry_t*) calloc(knobs->fetch.byteQ_size,sizeof(*byteQ));
+  byteQ = (byteQ_entry_t*) calloc(CORE_KNOB(knobs, fetch, byteQ_size),sizeof(*byteQ));
   byteQ_head = byteQ_tail = 0;
   if(!byteQ)
     fatal("couldn't calloc byteQ");
 
-  byteQ_linemask = ~(md_addr_t)(knobs->fetch.byteQ_linesize - 1);
+  byteQ_linemask = ~(md_addr_t)(CORE_KNOB(knobs, fetch, byteQ_linesize) - 1);
 }
 
 core_fetch_STM_t::~core_fetch_STM_t() {
@@ -178,14 +179,14 @@ void core_fetch_STM_t::update_occupancy(void)
 bool core_fetch_STM_t::byteQ_is_full(void)
 {
   struct core_knobs_t * knobs = core->knobs;
-  return (byteQ_num >= knobs->fetch.byteQ_size);
+  return (byteQ_num >= CORE_KNOB(knobs, fetch, byteQ_size));
 }
 
 /* is this line already the most recently requested? */
 bool core_fetch_STM_t::byteQ_already_requested(const md_addr_t addr)
 {
   struct core_knobs_t * knobs = core->knobs;
-  int index = moddec(byteQ_tail,knobs->fetch.byteQ_size); //(byteQ_tail-1+knobs->fetch.byteQ_size) % knobs->fetch.byteQ_size;
+  int index = moddec(byteQ_tail,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_tail-1+CORE_KNOB(knobs, fetch, byteQ_size)) % CORE_KNOB(knobs, fetch, byteQ_size);
   if(byteQ_num && (byteQ[index].addr == (addr & byteQ_linemask)))
     return true;
   else
@@ -193,7 +194,7 @@ bool core_fetch_STM_t::byteQ_already_requested(const md_addr_t addr)
 }
 
 /* Initiate a fetch request */
-void core_fetch_STM_t::byteQ_request(const md_addr_t lineaddr)
+void core_fetch_STM_t::byteQ_request(const md_addr_t lineaddr, const md_addr_t page_shift)
 {
   struct core_knobs_t * knobs = core->knobs;
   /* this function assumes you already called byteQ_already_requested so that
@@ -203,9 +204,10 @@ void core_fetch_STM_t::byteQ_request(const md_addr_t lineaddr)
   byteQ[byteQ_tail].when_translation_requested = TICK_T_MAX;
   byteQ[byteQ_tail].when_translated = TICK_T_MAX;
   byteQ[byteQ_tail].addr = lineaddr;
+  byteQ[byteQ_tail].page_shift = page_shift;
   byteQ[byteQ_tail].action_id = core->new_action_id();
   byteQ[byteQ_tail].core = core;
-  byteQ_tail = modinc(byteQ_tail,knobs->fetch.byteQ_size); //(byteQ_tail+1)%knobs->fetch.byteQ_size;
+  byteQ_tail = modinc(byteQ_tail,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_tail+1)%CORE_KNOB(knobs, fetch, byteQ_size);
   byteQ_num++;
 
   return;
@@ -264,7 +266,7 @@ void core_fetch_STM_t::pre_fetch(void)
         break;
       }
     }
-    index = modinc(index,knobs->fetch.byteQ_size);
+    index = modinc(index,CORE_KNOB(knobs, fetch, byteQ_size));
   }
 
   index = byteQ_head;
@@ -272,14 +274,14 @@ void core_fetch_STM_t::pre_fetch(void)
   {
     if(byteQ[index].when_translation_requested == TICK_T_MAX)
     {
-      if(cache_enqueuable(core->memory.ITLB.get(), asid, memory::page_table_address(asid, byteQ[index].addr)))
+      if(cache_enqueuable(core->memory.ITLB.get(), asid, memory::page_table_address(asid, byteQ[index].addr, byteQ[index].page_shift)))
       {
-        cache_enqueue(core, core->memory.ITLB.get(), NULL, CACHE_READ, 0, asid, memory::page_table_address(asid, byteQ[index].addr), byteQ[index].action_id, 0, NO_MSHR, &byteQ[index], ITLB_callback, NULL, NULL, get_byteQ_action_id);
+        cache_enqueue(core, core->memory.ITLB.get(), NULL, CACHE_READ, 0, asid, memory::page_table_address(asid, byteQ[index].addr, byteQ[index].page_shift), byteQ[index].action_id, 0, NO_MSHR, &byteQ[index], ITLB_callback, NULL, NULL, get_byteQ_action_id);
         byteQ[index].when_translation_requested = core->sim_cycle;
         break;
       }
     }
-    index = modinc(index,knobs->fetch.byteQ_size);
+    index = modinc(index,CORE_KNOB(knobs, fetch, byteQ_size));
   }
 }
 
@@ -308,7 +310,7 @@ void core_fetch_STM_t::post_fetch(void)
     byteQ[byteQ_head].when_translation_requested = TICK_T_MAX;
     byteQ[byteQ_head].when_translated = TICK_T_MAX;
     byteQ_num--;
-    byteQ_head = modinc(byteQ_head,knobs->fetch.byteQ_size); //(byteQ_head+1)%knobs->fetch.byteQ_size;
+    byteQ_head = modinc(byteQ_head,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_head+1)%CORE_KNOB(knobs, fetch, byteQ_size);
   }
 
   stall_reason = FSTALL_EOL;
@@ -361,7 +363,7 @@ bool core_fetch_STM_t::do_fetch(void)
     if(Mop->timing.when_fetch_started == TICK_T_MAX)
       Mop->timing.when_fetch_started = core->sim_cycle;
     Mop->fetch.first_byte_requested = true;
-    byteQ_request(Mop->fetch.PC & byteQ_linemask);
+    byteQ_request(Mop->fetch.PC & byteQ_linemask, Mop->fetch.page_shift);
   }
 
   /* STM model doesn't deal with fetches across cache lines */
@@ -373,7 +375,7 @@ bool core_fetch_STM_t::do_fetch(void)
      and let the oracle know we're done with it so can proceed to the next
      one */
 
-  int byteQ_index = moddec(byteQ_tail,knobs->fetch.byteQ_size); //(byteQ_tail-1+knobs->fetch.byteQ_size)%knobs->fetch.byteQ_size;
+  int byteQ_index = moddec(byteQ_tail,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_tail-1+CORE_KNOB(knobs, fetch, byteQ_size))%CORE_KNOB(knobs, fetch, byteQ_size);
   if(byteQ[byteQ_index].num_Mop == 0)
     byteQ[byteQ_index].MopQ_first_index = core->oracle->get_index(Mop);
   byteQ[byteQ_index].num_Mop++;
@@ -475,7 +477,7 @@ void core_fetch_STM_t::Mop_consume(void)
     byteQ[byteQ_head].when_translation_requested = TICK_T_MAX;
     byteQ[byteQ_head].when_translated = TICK_T_MAX;
     byteQ_num--;
-    byteQ_head = modinc(byteQ_head,knobs->fetch.byteQ_size); //(byteQ_head+1)%knobs->fetch.byteQ_size;
+    byteQ_head = modinc(byteQ_head,CORE_KNOB(knobs, fetch, byteQ_size)); //(byteQ_head+1)%CORE_KNOB(knobs, fetch, byteQ_size);
   }
 }
 
@@ -494,7 +496,7 @@ core_fetch_STM_t::recover(const md_addr_t new_PC)
   PC = new_PC;
 
   /* clear out the byteQ */
-  for(i=0;i<knobs->fetch.byteQ_size;i++)
+  for(i=0;i<CORE_KNOB(knobs, fetch, byteQ_size);i++)
   {
     byteQ[i].addr = 0;
     byteQ[i].when_fetch_requested = TICK_T_MAX;
@@ -3,7 +3,7 @@
     return std::make_unique<class core_fetch_NONE_t>(core);
 #else
 
-class core_fetch_NONE_t:public core_fetch_t
+class core_fetch_NONE_t final : public core_fetch_t
 {
 
   public:
@@ -0,0 +1,146 @@
+/* assoc_table.h - Set-associative table for prefetcher (and similar
+ * predictor) state.
+ *
+ * An entry is found by a key (a page number, a PC, ...). The key gets hashed
+ * to a set of up to 16 ways, which are scanned linearly; the entries of a set
+ * are next to each other in memory. Each set keeps its recency order packed
+ * in a single word -- 4 bits per recency position, holding the way that is
+ * there, MRU first -- so updating LRU state doesn't chase any pointers.
+ *
+ * A table with a single set is fully associative with true LRU.
+ */
+
+#ifndef __ASSOC_TABLE_H__
+#define __ASSOC_TABLE_H__
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+#include "host.h"
+
+namespace xiosim {
+
+template <typename T>
+class assoc_table_t {
+  public:
+    static const int MAX_ASSOC = 16;
+
+    struct entry_t {
+        T data;
+        uint64_t key;
+    };
+
+    /* @num_entries / @assoc sets, which has to be a power of two. */
+    assoc_table_t(int num_entries, int assoc)
+        : assoc(assoc)
+        , num_sets(num_entries / assoc)
+        , set_bits(log2_pow2(num_sets))
+        , entries(new entry_t[num_entries]())
+        , sets(new set_t[num_sets]) {
+        assert(assoc > 0 && assoc <= MAX_ASSOC);
+        assert(num_sets * assoc == num_entries);
+        assert((1 << set_bits) == num_sets);
+        clear();
+    }
+
+    /* Entry for @key, or nullptr. Doesn't change the recency order. */
+    entry_t* find(uint64_t key) {
+        const int set = get_set(key);
+        entry_t* ways = &entries[set * assoc];
+        for (int i = 0; i < assoc; i++)
+            if ((sets[set].valid & (1 << i)) && ways[i].key == key)
+                return &ways[i];
+        return nullptr;
+    }
+
+    /* Make @e the most recently used entry of its set. */
+    void touch(entry_t* e) {
+        const int index = e - entries.get();
+        move_to_front(sets[index / assoc], index % assoc);
+    }
+
+    /* Reuse the least recently used entry of @key's set for @key. The data is
+     * left as it was; the entry becomes the most recently used one. */
+    entry_t* replace(uint64_t key) {
+        const int set = get_set(key);
+        set_t& s = sets[set];
+        const int way = (s.order >> (4 * (assoc - 1))) & 0xf;
+        entry_t* e = &entries[set * assoc + way];
+        e->key = key;
+        s.valid |= (1 << way);
+        move_to_front(s, way);
+        return e;
+    }
+
+    /* Visit every entry -- set by set, most recently used first -- as
+     * f(entry, valid). */
+    template <typename F>
+    void for_each(F f) const {
+        for (int set = 0; set < num_sets; set++) {
+            for (int pos = 0; pos < assoc; pos++) {
+                const int way = (sets[set].order >> (4 * pos)) & 0xf;
+                f(entries[set * assoc + way], (sets[set].valid & (1 << way)) != 0);
+            }
+        }
+    }
+
+    /* Invalidate everything, and reset the recency order. */
+    void clear() {
+        uint64_t order = 0;
+        for (int way = 0; way < assoc; way++)
+            order |= (uint64_t)way << (4 * way);
+        for (int set = 0; set < num_sets; set++) {
+            sets[set].order = order;
+            sets[set].valid = 0;
+        }
+    }
+
+    int get_num_entries() const { return num_sets * assoc; }
+
+  private:
+    struct set_t {
+        uint64_t order; /* way at each recency position, 4 bits each */
+        uint32_t valid; /* bit per way */
+    };
+
+    static int log2_pow2(int x) {
+        int res = 0;
+        while ((1 << res) < x)
+            res++;
+        return res;
+    }
+
+    int get_set(uint64_t key) const {
+        if (!set_bits)
+            return 0;
+        /* Fibonacci hashing, so strided keys spread over all sets. */
+        return (key * 0x9E3779B97F4A7C15ULL) >> (64 - set_bits);
+    }
+
+    /* Recency position of @way: the lowest nibble of order ^ way that is
+     * zero. Borrows only propagate upwards, so the lowest flagged nibble is
+     * always a real match. */
+    static int position_of(uint64_t order, int way) {
+        const uint64_t x = order ^ (0x1111111111111111ULL * way);
+        const uint64_t zero = (x - 0x1111111111111111ULL) & ~x & 0x8888888888888888ULL;
+        return __builtin_ctzll(zero) / 4;
+    }
+
+    void move_to_front(set_t& s, int way) {
+        const int pos = position_of(s.order, way);
+        const uint64_t below = s.order & ((1ULL << (4 * pos)) - 1);
+        const uint64_t above = (pos == MAX_ASSOC - 1) ? 0 : s.order & (~0ULL << (4 * (pos + 1)));
+        s.order = above | (below << 4) | way;
+    }
+
+    const int assoc;
+    const int num_sets;
+    const int set_bits;
+    std::unique_ptr<entry_t[]> entries;
+    std::unique_ptr<set_t[]> sets;
+};
+
+}  // xiosim
+
+#endif /* __ASSOC_TABLE_H__ */
@@ -0,0 +1,253 @@
+/* Replays branch traces (see brtrace_format.h) through many branch predictor
+ * configurations, without a timing simulation, and reports MPKI for each.
+ *
+ * Usage: bpred_sweep [-j threads] <sweep file> <brtrace file>...
+ *
+ * Every line of the sweep file (except blank ones and #-comments) is one
+ * configuration, using the same strings as branch_pred_cfg:
+ *   <label> <type>[,<type>...] <fusion> <btb> <ibtb> <ras>
+ * e.g.
+ *   tage5 tage:TAGE5:5:2048:512:9:6:75 none btac:BTB:512:4:8:l none stack:RAS:16
+ *
+ * Configurations are spread across host threads. Every thread walks the
+ * mmap-ed trace once, a block at a time, and runs each block through all of
+ * its predictors while the block is still in cache.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "brtrace_format.h"
+#include "zesto-bpred.h"
+
+using namespace xiosim::brtrace;
+
+/* Records per block -- a couple MB, to stay in a host L2/L3. */
+const size_t BLOCK_RECORDS = 1 << 16;
+
+struct config_t {
+    std::string label;
+    std::vector<std::string> types;
+    std::string fusion;
+    std::string btb;
+    std::string ibtb;
+    std::string ras;
+};
+
+struct result_t {
+    uint64_t branches;
+    uint64_t mispreds;
+    uint64_t insts;
+};
+
+static bool parse_sweep_file(const char* fname, std::vector<config_t>& configs) {
+    FILE* fp = fopen(fname, "r");
+    if (!fp) {
+        fprintf(stderr, "Couldn't open %s.\n", fname);
+        return false;
+    }
+
+    char line[4096];
+    int line_num = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_num++;
+        char* comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+
+        std::istringstream ss(line);
+        config_t config;
+        std::string types;
+        if (!(ss >> config.label))
+            continue; /* blank */
+        if (!(ss >> types >> config.fusion >> config.btb >> config.ibtb >> config.ras)) {
+            fprintf(stderr, "%s:%d: expected <label> <types> <fusion> <btb> <ibtb> <ras>\n",
+                    fname, line_num);
+            fclose(fp);
+            return false;
+        }
+
+        std::istringstream type_ss(types);
+        std::string type;
+        while (std::getline(type_ss, type, ','))
+            config.types.push_back(type);
+        configs.push_back(config);
+    }
+    fclose(fp);
+    return true;
+}
+
+/* Read-only mapping of a brtrace file's records. */
+class trace_t {
+  public:
+    ~trace_t() {
+        if (base != MAP_FAILED)
+            munmap(base, size);
+    }
+
+    bool open(const char* fname) {
+        int fd = ::open(fname, O_RDONLY);
+        if (fd == -1) {
+            fprintf(stderr, "Couldn't open %s.\n", fname);
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(header_t)) {
+            fprintf(stderr, "%s: not a brtrace file.\n", fname);
+            close(fd);
+            return false;
+        }
+        size = st.st_size;
+        base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            fprintf(stderr, "Couldn't map %s.\n", fname);
+            return false;
+        }
+        madvise(base, size, MADV_SEQUENTIAL);
+
+        const header_t* header = static_cast<const header_t*>(base);
+        if (header->magic != MAGIC || header->version != FORMAT_VERSION) {
+            fprintf(stderr, "%s: bad magic or version.\n", fname);
+            return false;
+        }
+        records = reinterpret_cast<const record_t*>(header + 1);
+        num_records = (size - sizeof(header_t)) / sizeof(record_t);
+        return true;
+    }
+
+    const record_t* records = nullptr;
+    size_t num_records = 0;
+
+  private:
+    void* base = MAP_FAILED;
+    size_t size = 0;
+};
+
+static std::unique_ptr<bpred_t> make_bpred(const config_t& config) {
+    std::vector<const char*> types;
+    for (auto& type : config.types)
+        types.push_back(type.c_str());
+    return std::unique_ptr<bpred_t>(new bpred_t(nullptr, types.size(), types.data(),
+                                                config.fusion.c_str(), config.btb.c_str(),
+                                                config.ibtb.c_str(), config.ras.c_str()));
+}
+
+static inst_flags_t unpack_flags(uint16_t flags) {
+    inst_flags_t res;
+    memset(&res, 0, sizeof(res));
+    res.CTRL = flags & FLAG_CTRL;
+    res.UNCOND = flags & FLAG_UNCOND;
+    res.COND = flags & FLAG_COND;
+    res.INDIR = flags & FLAG_INDIR;
+    res.CALL = flags & FLAG_CALL;
+    res.RETN = flags & FLAG_RETN;
+    return res;
+}
+
+/* Same sequence of calls as fetch and commit make for a branch, with the
+ * update happening right away (as if the pipeline were one branch deep). */
+static void replay(bpred_t* bpred, const record_t* begin, const record_t* end, result_t* out) {
+    /* Results of different threads share cache lines, count locally. */
+    result_t local = *out;
+    result_t* res = &local;
+    for (const record_t* rec = begin; rec != end; rec++) {
+        const inst_flags_t opflags = unpack_flags(rec->flags);
+        const bool taken = rec->taken();
+
+        bpred_state_cache_t* sc = bpred->get_state_cache();
+        md_addr_t pred_NPC = bpred->lookup(sc, opflags, rec->PC, rec->fallthru_PC,
+                                           rec->target_PC, rec->next_PC, taken);
+        bpred->spec_update(sc, opflags, rec->PC, rec->target_PC, rec->next_PC, sc->our_pred);
+        if (pred_NPC != rec->next_PC) {
+            bpred->recover(sc, taken);
+            res->mispreds++;
+        }
+        bpred->update(sc, opflags, rec->PC, rec->fallthru_PC, rec->target_PC, rec->next_PC,
+                      taken);
+        bpred->return_state_cache(sc);
+
+        res->branches++;
+        res->insts += rec->insts;
+    }
+    *out = local;
+}
+
+/* Run configurations @thread_id, @thread_id + @num_threads, ... over @trace. */
+static void sweep_thread(int thread_id,
+                         int num_threads,
+                         const trace_t& trace,
+                         const std::vector<config_t>& configs,
+                         std::vector<result_t>& results) {
+    std::vector<size_t> mine;
+    std::vector<std::unique_ptr<bpred_t>> bpreds;
+    for (size_t i = thread_id; i < configs.size(); i += num_threads) {
+        mine.push_back(i);
+        bpreds.push_back(make_bpred(configs[i]));
+    }
+
+    for (size_t start = 0; start < trace.num_records; start += BLOCK_RECORDS) {
+        const record_t* begin = trace.records + start;
+        const record_t* end = trace.records + std::min(start + BLOCK_RECORDS, trace.num_records);
+        for (size_t i = 0; i < mine.size(); i++)
+            replay(bpreds[i].get(), begin, end, &results[mine[i]]);
+    }
+}
+
+int main(int argc, const char* argv[]) {
+    int num_threads = std::thread::hardware_concurrency();
+    int argi = 1;
+    if (argi + 1 < argc && !strcmp(argv[argi], "-j")) {
+        num_threads = atoi(argv[argi + 1]);
+        argi += 2;
+    }
+    if (argc - argi < 2 || num_threads < 1) {
+        fprintf(stderr, "Usage: %s [-j threads] <sweep file> <brtrace file>...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<config_t> configs;
+    if (!parse_sweep_file(argv[argi], configs))
+        return 1;
+    if (configs.empty()) {
+        fprintf(stderr, "%s: no configurations.\n", argv[argi]);
+        return 1;
+    }
+    num_threads = std::min<int>(num_threads, configs.size());
+
+    printf("%-24s %-16s %14s %12s %16s %8s\n", "trace", "config", "branches", "mispreds", "insts",
+           "MPKI");
+    for (int t = argi + 1; t < argc; t++) {
+        trace_t trace;
+        if (!trace.open(argv[t]))
+            return 1;
+
+        std::vector<result_t> results(configs.size(), result_t{ 0, 0, 0 });
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; i++)
+            threads.emplace_back(sweep_thread, i, num_threads, std::cref(trace),
+                                 std::cref(configs), std::ref(results));
+        for (auto& thread : threads)
+            thread.join();
+
+        for (size_t i = 0; i < configs.size(); i++) {
+            const result_t& res = results[i];
+            double mpki = res.insts ? 1000.0 * res.mispreds / res.insts : 0.0;
+            printf("%-24s %-16s %14" PRIu64 " %12" PRIu64 " %16" PRIu64 " %8.3f\n", argv[t],
+                   configs[i].label.c_str(), res.branches, res.mispreds, res.insts, mpki);
+        }
+    }
+    return 0;
+}
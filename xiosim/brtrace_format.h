@@ -0,0 +1,53 @@
+/* brtrace_format.h - Binary branch trace records.
+ * Shared between the oracle, which writes one record per committed branch
+ * (system_cfg.brtrace_file_prefix), and bpred_sweep, which replays them
+ * through branch predictor configurations without a timing simulation.
+ *
+ * A trace file is a header_t followed by record_t's until EOF.
+ */
+
+#ifndef __BRTRACE_FORMAT_H__
+#define __BRTRACE_FORMAT_H__
+
+#include <cstdint>
+
+namespace xiosim {
+namespace brtrace {
+
+const uint32_t MAGIC = 0x42525452; /* "BRTR" */
+const uint32_t FORMAT_VERSION = 1;
+
+struct header_t {
+    uint32_t magic;
+    uint32_t version;
+};
+
+/* inst_flags_t bits that matter to the branch predictor. */
+enum flag_bits_t : uint16_t {
+    FLAG_CTRL = 1 << 0,
+    FLAG_UNCOND = 1 << 1,
+    FLAG_COND = 1 << 2,
+    FLAG_INDIR = 1 << 3,
+    FLAG_CALL = 1 << 4,
+    FLAG_RETN = 1 << 5,
+};
+
+/* Everything bpred_t::lookup() / update() get from a Mop. */
+struct record_t {
+    uint64_t PC;
+    uint64_t fallthru_PC;
+    uint64_t target_PC; /* decoded target, for direct branches */
+    uint64_t next_PC;   /* where execution actually went */
+    /* Instructions committed since the previous record, this one included. */
+    uint32_t insts;
+    uint16_t flags; /* flag_bits_t */
+    uint16_t pad;
+
+    bool taken() const { return next_PC != fallthru_PC; }
+};
+static_assert(sizeof(record_t) == 40, "record_t is an on-disk format");
+
+}  // xiosim::brtrace
+}  // xiosim
+
+#endif /* __BRTRACE_FORMAT_H__ */
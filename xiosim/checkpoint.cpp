@@ -0,0 +1,176 @@
+/* checkpoint.cpp - Binary checkpoints of warmed microarchitectural state.
+ *
+ * File layout: magic, VERSION, number of sections, then for each section
+ * its key, identity, payload size and payload. Strings are a uint32 length
+ * followed by the characters.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "misc.h"
+
+#include "checkpoint.h"
+
+namespace xiosim {
+namespace checkpoint {
+
+static const char MAGIC[8] = { 'X', 'I', 'O', 'C', 'K', 'P', 'T', '\0' };
+
+static void write_bytes(FILE* fd, const void* data, size_t size, const char* fname) {
+    if (size && fwrite(data, size, 1, fd) != 1)
+        fatal("couldn't write checkpoint %s", fname);
+}
+
+static void write_string(FILE* fd, const std::string& str, const char* fname) {
+    uint32_t len = str.size();
+    write_bytes(fd, &len, sizeof(len), fname);
+    write_bytes(fd, str.data(), len, fname);
+}
+
+static void read_bytes(FILE* fd, void* data, size_t size, const char* fname) {
+    if (size && fread(data, size, 1, fd) != 1)
+        fatal("checkpoint %s is truncated", fname);
+}
+
+static std::string read_string(FILE* fd, const char* fname) {
+    uint32_t len;
+    read_bytes(fd, &len, sizeof(len), fname);
+    std::string res(len, '\0');
+    read_bytes(fd, &res[0], len, fname);
+    return res;
+}
+
+void writer_t::begin_section(const std::string& key, const std::string& identity) {
+    for (auto& section : sections)
+        if (section.key == key)
+            fatal("duplicate checkpoint section %s", key.c_str());
+    sections.push_back({ key, identity, {} });
+}
+
+void writer_t::append(const void* data, size_t size) {
+    if (sections.empty())
+        fatal("checkpoint data outside of a section");
+    auto& buf = sections.back().data;
+    const char* bytes = static_cast<const char*>(data);
+    buf.insert(buf.end(), bytes, bytes + size);
+}
+
+void writer_t::put_string(const std::string& str) {
+    put<uint32_t>(str.size());
+    put_array(str.data(), str.size());
+}
+
+void writer_t::write(const char* fname) const {
+    /* Don't leave a half-written checkpoint behind if we die midway. */
+    std::string tmp_fname = std::string(fname) + ".tmp";
+    FILE* fd = fopen(tmp_fname.c_str(), "wb");
+    if (fd == NULL)
+        fatal("couldn't open checkpoint %s", tmp_fname.c_str());
+
+    uint32_t num_sections = sections.size();
+    write_bytes(fd, MAGIC, sizeof(MAGIC), fname);
+    write_bytes(fd, &VERSION, sizeof(VERSION), fname);
+    write_bytes(fd, &num_sections, sizeof(num_sections), fname);
+    for (auto& section : sections) {
+        uint64_t size = section.data.size();
+        write_string(fd, section.key, fname);
+        write_string(fd, section.identity, fname);
+        write_bytes(fd, &size, sizeof(size), fname);
+        write_bytes(fd, section.data.data(), size, fname);
+    }
+
+    if (fclose(fd) != 0)
+        fatal("couldn't write checkpoint %s", fname);
+    if (rename(tmp_fname.c_str(), fname) != 0)
+        fatal("couldn't move checkpoint to %s", fname);
+}
+
+reader_t::reader_t(const char* fname)
+    : curr(nullptr)
+    , pos(0) {
+    FILE* fd = fopen(fname, "rb");
+    if (fd == NULL)
+        fatal("couldn't open checkpoint %s", fname);
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version, num_sections;
+    read_bytes(fd, magic, sizeof(magic), fname);
+    if (memcmp(magic, MAGIC, sizeof(MAGIC)))
+        fatal("%s is not a checkpoint", fname);
+    read_bytes(fd, &version, sizeof(version), fname);
+    if (version != VERSION)
+        fatal("checkpoint %s is version %u, expected %u", fname, version, VERSION);
+    read_bytes(fd, &num_sections, sizeof(num_sections), fname);
+
+    for (uint32_t i = 0; i < num_sections; i++) {
+        std::string key = read_string(fd, fname);
+        section_t& section = sections[key];
+        section.identity = read_string(fd, fname);
+        section.used = false;
+        uint64_t size;
+        read_bytes(fd, &size, sizeof(size), fname);
+        section.data.resize(size);
+        read_bytes(fd, section.data.data(), size, fname);
+    }
+    fclose(fd);
+}
+
+bool reader_t::begin_section(const std::string& key, const std::string& identity) {
+    curr = nullptr;
+    curr_key = key;
+    auto it = sections.find(key);
+    if (it == sections.end()) {
+        fprintf(stderr, "warning: no checkpoint state for %s, starting it cold\n", key.c_str());
+        return false;
+    }
+    if (it->second.identity != identity) {
+        fprintf(stderr,
+                "warning: checkpoint state for %s is from \"%s\", not \"%s\", starting it cold\n",
+                key.c_str(),
+                it->second.identity.c_str(),
+                identity.c_str());
+        return false;
+    }
+    curr = &it->second;
+    curr->used = true;
+    pos = 0;
+    return true;
+}
+
+void reader_t::end_section() {
+    if (curr == nullptr)
+        fatal("no checkpoint section to end");
+    if (pos != curr->data.size())
+        fatal("checkpoint section %s has %zu extra bytes",
+              curr_key.c_str(),
+              curr->data.size() - pos);
+    curr = nullptr;
+}
+
+void reader_t::consume(void* data, size_t size) {
+    if (curr == nullptr)
+        fatal("checkpoint read outside of a section");
+    if (pos + size > curr->data.size())
+        fatal("checkpoint section %s is too short", curr_key.c_str());
+    memcpy(data, curr->data.data() + pos, size);
+    pos += size;
+}
+
+std::string reader_t::get_string() {
+    uint32_t len = get<uint32_t>();
+    std::string res(len, '\0');
+    get_array(&res[0], len);
+    return res;
+}
+
+std::vector<std::string> reader_t::unused_sections() const {
+    std::vector<std::string> res;
+    for (auto& it : sections)
+        if (!it.second.used)
+            res.push_back(it.first);
+    return res;
+}
+
+}  // xiosim::checkpoint
+}  // xiosim
@@ -0,0 +1,110 @@
+/* checkpoint.h - Binary checkpoints of warmed microarchitectural state.
+ *
+ * A checkpoint is a set of named sections, one per structure (a cache, a
+ * branch predictor component, the page tables, ...). Each section also
+ * records the identity of the structure that wrote it -- its type and
+ * geometry. On restore, a structure only picks up a section with its own key
+ * and identity; everything else starts cold. So a checkpoint of a warmed
+ * memory hierarchy can seed runs that sweep core parameters.
+ *
+ * Sections are raw bytes in host byte order, so checkpoints are meant to be
+ * restored by the same build on the same kind of machine.
+ */
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xiosim {
+namespace checkpoint {
+
+/* Bump on any change to what a structure writes. */
+const uint32_t VERSION = 2;
+
+class writer_t {
+  public:
+    /* Start section @key. Everything put() until the next one goes there. */
+    void begin_section(const std::string& key, const std::string& identity);
+
+    template <typename T>
+    void put(const T& val) {
+        put_array(&val, 1);
+    }
+
+    template <typename T>
+    void put_array(const T* arr, size_t n) {
+        static_assert(std::is_trivially_copyable<T>::value, "only raw bytes go in a checkpoint");
+        append(arr, n * sizeof(T));
+    }
+
+    void put_string(const std::string& str);
+
+    /* Write all sections to @fname. */
+    void write(const char* fname) const;
+
+  private:
+    void append(const void* data, size_t size);
+
+    struct section_t {
+        std::string key;
+        std::string identity;
+        std::vector<char> data;
+    };
+    std::vector<section_t> sections;
+};
+
+class reader_t {
+  public:
+    /* Load checkpoint @fname. Dies if it is not a checkpoint of this VERSION. */
+    explicit reader_t(const char* fname);
+
+    /* Start reading section @key. Returns false (with a warning) if there is
+     * no such section, or if a structure other than @identity wrote it. */
+    bool begin_section(const std::string& key, const std::string& identity);
+
+    /* Check that the current section was read exactly to its end. */
+    void end_section();
+
+    template <typename T>
+    T get() {
+        T val;
+        get_array(&val, 1);
+        return val;
+    }
+
+    template <typename T>
+    void get_array(T* arr, size_t n) {
+        static_assert(std::is_trivially_copyable<T>::value, "only raw bytes go in a checkpoint");
+        consume(arr, n * sizeof(T));
+    }
+
+    std::string get_string();
+
+    /* Sections in the file that no structure asked for. */
+    std::vector<std::string> unused_sections() const;
+
+  private:
+    void consume(void* data, size_t size);
+
+    struct section_t {
+        std::string identity;
+        std::vector<char> data;
+        bool used;
+    };
+    std::map<std::string, section_t> sections;
+    std::string curr_key;
+    section_t* curr;
+    size_t pos;
+};
+
+}  // xiosim::checkpoint
+}  // xiosim
+
+#endif /* __CHECKPOINT_H__ */
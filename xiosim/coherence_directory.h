@@ -0,0 +1,220 @@
+/* coherence_directory.h - Sparse directory for MESI coherence between the
+ * private cache hierarchies of different cores.
+ *
+ * Per cache line, the directory records which cores may hold a copy, and
+ * which one (if any) holds it exclusively (E or M). It is split into shards,
+ * one per LLC bank, each behind its own lock, so requests to different banks
+ * don't serialize on each other. A shard is a flat, set-associative hash
+ * table: a line hashes to a set of @assoc entries, which get scanned
+ * linearly. When a set is full, the least recently used entry gets recalled,
+ * and the caller has to invalidate its sharers.
+ *
+ * Only state lives here; timing and delivering invalidations to the caches is
+ * up to the coherence controller (ZCOMPS-coherence/mesi.cpp).
+ */
+
+#ifndef __COHERENCE_DIRECTORY_H__
+#define __COHERENCE_DIRECTORY_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include "host.h"
+#include "synchronization.h"
+
+namespace xiosim {
+namespace coherence {
+
+const int NO_OWNER = -1;
+const int MAX_CORES = 64; /* sharers are a bit vector */
+
+/* A core's permissions for a line, as far as the directory knows. */
+enum class dir_state_t { INVALID, SHARED, EXCLUSIVE };
+
+/* What a request did to the other cores. */
+struct dir_result_t {
+    uint64_t invalidate = 0;     /* cores that lose their copy */
+    int forward_from = NO_OWNER; /* previous exclusive owner, supplies the data */
+    bool exclusive = false;      /* requester is the only holder */
+    /* A set conflict evicted the entry for this line, so these cores have to
+     * drop it too. */
+    md_paddr_t recalled_addr = 0;
+    uint64_t recalled_sharers = 0;
+};
+
+class directory_t {
+  public:
+    /* @num_shards and @sets_per_shard are powers of two. A line's shard is
+     * picked by the address bits starting at @shard_shift (the LLC bank bits). */
+    directory_t(int num_shards, int shard_shift, int line_shift, int sets_per_shard, int assoc)
+        : num_shards(num_shards)
+        , shard_shift(shard_shift)
+        , line_shift(line_shift)
+        , set_bits(log2_pow2(sets_per_shard))
+        , assoc(assoc)
+        , shards(new_shards(num_shards), shard_deleter_t{ num_shards }) {
+        for (int i = 0; i < num_shards; i++)
+            shards[i].entries.reset(new entry_t[sets_per_shard * assoc]());
+    }
+
+    /* @core reads @paddr (GetS). A previous exclusive owner gets downgraded
+     * and forwards the data. */
+    dir_result_t read(md_paddr_t paddr, int core) {
+        dir_result_t res;
+        shard_t& shard = get_shard(paddr);
+        std::lock_guard<XIOSIM_LOCK> l(shard.lock);
+        entry_t* e = find_or_allocate(shard, paddr, res);
+        if (e->owner != NO_OWNER && e->owner != core)
+            res.forward_from = e->owner;
+        e->sharers |= bit(core);
+        res.exclusive = (e->sharers == bit(core));
+        e->owner = res.exclusive ? core : NO_OWNER;
+        return res;
+    }
+
+    /* @core writes @paddr (GetM). Everyone else gets invalidated. */
+    dir_result_t write(md_paddr_t paddr, int core) {
+        dir_result_t res;
+        shard_t& shard = get_shard(paddr);
+        std::lock_guard<XIOSIM_LOCK> l(shard.lock);
+        entry_t* e = find_or_allocate(shard, paddr, res);
+        if (e->owner != NO_OWNER && e->owner != core)
+            res.forward_from = e->owner;
+        res.invalidate = e->sharers & ~bit(core);
+        e->sharers = bit(core);
+        e->owner = core;
+        res.exclusive = true;
+        return res;
+    }
+
+    /* @core wrote @paddr back to the LLC. It gives up ownership, but stays a
+     * sharer -- caches closer to the core can still have a copy. */
+    void writeback(md_paddr_t paddr, int core) {
+        shard_t& shard = get_shard(paddr);
+        std::lock_guard<XIOSIM_LOCK> l(shard.lock);
+        entry_t* e = find(shard, paddr);
+        if (e && e->owner == core)
+            e->owner = NO_OWNER;
+    }
+
+    /* What may @core do with its copy of @paddr? */
+    dir_state_t probe(md_paddr_t paddr, int core) {
+        shard_t& shard = get_shard(paddr);
+        std::lock_guard<XIOSIM_LOCK> l(shard.lock);
+        const entry_t* e = find(shard, paddr);
+        if (!e || !(e->sharers & bit(core)))
+            return dir_state_t::INVALID;
+        return (e->owner == core) ? dir_state_t::EXCLUSIVE : dir_state_t::SHARED;
+    }
+
+    int get_num_shards() const { return num_shards; }
+
+  private:
+    struct entry_t {
+        md_paddr_t line;
+        uint64_t sharers; /* 0 = free entry */
+        int32_t owner;
+        uint32_t last_use;
+    };
+
+    /* Own cache line per shard, so cores spinning on one shard's lock don't
+     * bounce the others. */
+    struct alignas(64) shard_t {
+        XIOSIM_LOCK lock;
+        std::unique_ptr<entry_t[]> entries;
+        uint32_t clock = 0;
+    };
+
+    /* Plain new[] doesn't have to honor the shards' alignment before C++17. */
+    static shard_t* new_shards(int num_shards) {
+        void* space = nullptr;
+        if (posix_memalign(&space, alignof(shard_t), num_shards * sizeof(shard_t)))
+            throw std::bad_alloc();
+        return new (space) shard_t[num_shards];
+    }
+
+    struct shard_deleter_t {
+        int num_shards;
+        void operator()(shard_t* shards) const {
+            for (int i = 0; i < num_shards; i++)
+                shards[i].~shard_t();
+            free(shards);
+        }
+    };
+
+    static int log2_pow2(int x) {
+        int res = 0;
+        while ((1 << res) < x)
+            res++;
+        return res;
+    }
+
+    static uint64_t bit(int core) { return 1ULL << core; }
+
+    shard_t& get_shard(md_paddr_t paddr) {
+        return shards[(paddr >> shard_shift) & (num_shards - 1)];
+    }
+
+    entry_t* get_set(shard_t& shard, md_paddr_t line) {
+        if (!set_bits)
+            return &shard.entries[0];
+        /* Fibonacci hashing; the low line bits also pick the shard. */
+        const uint64_t set = (line * 0x9E3779B97F4A7C15ULL) >> (64 - set_bits);
+        return &shard.entries[set * assoc];
+    }
+
+    entry_t* find(shard_t& shard, md_paddr_t paddr) {
+        const md_paddr_t line = paddr >> line_shift;
+        entry_t* set = get_set(shard, line);
+        for (int i = 0; i < assoc; i++) {
+            if (set[i].sharers && set[i].line == line) {
+                set[i].last_use = ++shard.clock;
+                return &set[i];
+            }
+        }
+        return nullptr;
+    }
+
+    entry_t* find_or_allocate(shard_t& shard, md_paddr_t paddr, dir_result_t& res) {
+        entry_t* e = find(shard, paddr);
+        if (e)
+            return e;
+
+        const md_paddr_t line = paddr >> line_shift;
+        entry_t* set = get_set(shard, line);
+        entry_t* victim = &set[0];
+        for (int i = 0; i < assoc; i++) {
+            if (!set[i].sharers) {
+                victim = &set[i];
+                break;
+            }
+            /* Wrap-around safe, relative to the current clock. */
+            if (shard.clock - set[i].last_use > shard.clock - victim->last_use)
+                victim = &set[i];
+        }
+        if (victim->sharers) {
+            res.recalled_addr = victim->line << line_shift;
+            res.recalled_sharers = victim->sharers;
+        }
+        victim->line = line;
+        victim->sharers = 0;
+        victim->owner = NO_OWNER;
+        victim->last_use = ++shard.clock;
+        return victim;
+    }
+
+    const int num_shards;
+    const int shard_shift;
+    const int line_shift;
+    const int set_bits;
+    const int assoc;
+    std::unique_ptr<shard_t[], shard_deleter_t> shards;
+};
+
+}  // xiosim::coherence
+}  // xiosim
+
+#endif /* __COHERENCE_DIRECTORY_H__ */
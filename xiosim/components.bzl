@@ -1,5 +1,15 @@
-def gen_list(component, dirs, extra_deps=[], extra_srcs=[]):
+# opt_in: {config_setting: (cpp file names, deps)} for implementations that
+# only get built (and pull in their deps) under that config_setting.
+def gen_list(component, dirs, extra_deps=[], extra_srcs=[], opt_in={}):
+    opt_in_files = []
+    for setting in opt_in:
+        opt_in_files += opt_in[setting][0]
+
     for dir_ in dirs:
+        opt_in_srcs = {"//conditions:default": []}
+        for setting in opt_in:
+            opt_in_srcs[setting] = native.glob(["%s/%s" % (dir_, f) for f in opt_in[setting][0]])
+
         # Generate a filegroup for each cpp in the directory
         native.filegroup(
             name = "%s" % dir_,
@@ -7,9 +17,8 @@ def gen_list(component, dirs, extra_deps=[], extra_srcs=[]):
                 [ "%s/*.cpp" % dir_],
                 exclude = [
                     "%s/repeater-default.cpp" % dir_, # for now
-                    "%s/MC-dramsim.cpp" % dir_,       # for now
-                ]
-            )
+                ] + ["%s/%s" % (dir_, f) for f in opt_in_files],
+            ) + select(opt_in_srcs)
         )
 
         # Generate {DIR}.list.h, which includes each cpp in the directory
@@ -30,6 +39,10 @@ def gen_list(component, dirs, extra_deps=[], extra_srcs=[]):
     for dir_ in dirs:
         srcs += [ "%s.list.h" % dir_ ]
 
+    opt_in_deps = {"//conditions:default": []}
+    for setting in opt_in:
+        opt_in_deps[setting] = opt_in[setting][1]
+
     native.cc_library(
         name = "zesto-%s" % component,
         hdrs = hdrs,
@@ -38,5 +51,5 @@ def gen_list(component, dirs, extra_deps=[], extra_srcs=[]):
             ":stats",
             ":uarch_headers",
             ":x86",
-        ] + extra_deps,
+        ] + extra_deps + select(opt_in_deps),
     )
@@ -2,7 +2,9 @@
 #define __EXPRESSION_H__
 
 #include <cmath>
+#include <functional>
 #include <memory>
+#include <string>
 
 namespace xiosim {
 namespace stats {
@@ -33,6 +35,38 @@ class Expression {
     virtual Result evaluate() const = 0;
     /* Returns a deep copy of the current expression and all its subexpressions. */
     virtual std::unique_ptr<Expression> deep_copy() const = 0;
+    /* Returns the expression in infix form, fully parenthesized, with
+     * statistics as {name}. Lets tools re-evaluate formulas from dumped
+     * values (see stat_format.h). */
+    virtual std::string to_string() const = 0;
+};
+
+/* Infix symbols for the operations used in expression trees. */
+template <typename Operation>
+struct op_symbol;
+template <>
+struct op_symbol<std::plus<Result>> {
+    static constexpr const char* value = "+";
+};
+template <>
+struct op_symbol<std::minus<Result>> {
+    static constexpr const char* value = "-";
+};
+template <>
+struct op_symbol<std::multiplies<Result>> {
+    static constexpr const char* value = "*";
+};
+template <>
+struct op_symbol<std::divides<Result>> {
+    static constexpr const char* value = "/";
+};
+template <>
+struct op_symbol<power<Result>> {
+    static constexpr const char* value = "^";
+};
+template <>
+struct op_symbol<std::negate<Result>> {
+    static constexpr const char* value = "-";
 };
 
 }  // namespace stats
@@ -31,6 +31,11 @@ class Constant : public Expression {
 
     virtual Result evaluate() const { return value; }
     virtual std::unique_ptr<Expression> deep_copy() const { return std::make_unique<Constant>(value); }
+    virtual std::string to_string() const {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.9g", value);
+        return buf;
+    }
 
   protected:
     const Result value;
@@ -58,6 +63,9 @@ class SingleExpression : public Expression {
 
     /* Just copy-construct and return as an Expression pointer. */
     virtual std::unique_ptr<Expression> deep_copy() const { return std::make_unique<SingleExpression>(*this); }
+    virtual std::string to_string() const {
+        return std::string("(") + op_symbol<Operation>::value + lhs->to_string() + ")";
+    }
 
   protected:
     const std::unique_ptr<Expression> lhs;
@@ -88,6 +96,10 @@ class CompoundExpression : public Expression {
 
     /* Just copy-construct and return as an Expression pointer. */
     virtual std::unique_ptr<Expression> deep_copy() const { return std::make_unique<CompoundExpression>(*this); }
+    virtual std::string to_string() const {
+        return "(" + lhs->to_string() + " " + op_symbol<Operation>::value + " " + rhs->to_string() +
+               ")";
+    }
 
   protected:
     const std::unique_ptr<Expression> lhs;
@@ -236,6 +248,20 @@ class Formula : public BaseStatistic, public Expression {
         fprintf(fd, " # %s\n", desc.c_str());
     }
 
+    virtual void write_json(FILE* fd) {
+        write_json_header(fd, STAT_FORMULA, name, desc);
+        fputs(", \"value\": ", fd);
+        write_json_number(fd, evaluate());
+        fputs(", \"expr\": ", fd);
+        write_json_string(fd, expr->to_string());
+        fputs("}", fd);
+    }
+
+    virtual void write_binary(FILE* fd) {
+        write_binary_header(fd, STAT_FORMULA, name, desc);
+        write_binary_value<double>(fd, evaluate());
+    }
+
     // Formula statistics are not scaled, accumulated, or saved; if the
     // terms are, then the formula will be recomputed anyways.
     virtual void scale_value(double weight) {}
@@ -247,6 +273,8 @@ class Formula : public BaseStatistic, public Expression {
 
     virtual Result evaluate() const { return expr->evaluate(); }
     virtual std::unique_ptr<Expression> deep_copy() const { return std::make_unique<Formula>(*this); }
+    /* Expanded rather than by name, since the nested formula may not be dumped. */
+    virtual std::string to_string() const { return expr->to_string(); }
 
   protected:
     std::unique_ptr<Expression> expr;
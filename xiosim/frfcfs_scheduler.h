@@ -0,0 +1,316 @@
+/* frfcfs_scheduler.h - First-ready, first-come-first-served ordering of DRAM
+ * requests over per-channel, per-bank queues.
+ *
+ * Addresses are spread over channels every @interleave bytes. Within a
+ * channel, banks and rows are picked like dram-simplesdram does it: 4KB
+ * row-buffer pages, bank bits right above the page offset, row bits above
+ * those. Each bank remembers the row it last opened.
+ *
+ * Every cycle, each channel sends at most one request to DRAM. Among the
+ * banks that can take one, we prefer (1) requests that have waited for more
+ * than @starvation_cap cycles, (2) hits to the open row, (3) everything else;
+ * oldest first within each class. Writes are held back in their own queues
+ * until they pass the @WQ_high watermark, and then drained down to @WQ_low
+ * (or sent whenever there are no reads to do).
+ *
+ * Requests are slots in a fixed pool, sized for full read and write queues on
+ * every channel. A slot stays taken from enqueue() until the owner release()s
+ * it, which includes the time the request spends in DRAM.
+ */
+
+#ifndef __FRFCFS_SCHEDULER_H__
+#define __FRFCFS_SCHEDULER_H__
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "host.h"
+
+namespace xiosim {
+
+class frfcfs_scheduler_t {
+  public:
+    static const int PAGE_SHIFT = 12;
+
+    counter_t row_hits;
+    counter_t row_conflicts;
+    counter_t starved_issues;
+    counter_t write_drains;
+
+    /* Parameters are expected to be checked by the owner: powers of two for
+     * @num_channels, @num_banks (at most 64) and @interleave, non-empty
+     * queues, and 0 <= @WQ_low < @WQ_high <= @WQ_size. */
+    frfcfs_scheduler_t(int num_channels,
+                       int num_banks,
+                       int interleave,
+                       int RQ_size,
+                       int WQ_size,
+                       int WQ_high,
+                       int WQ_low,
+                       tick_t starvation_cap)
+        : row_hits(0)
+        , row_conflicts(0)
+        , starved_issues(0)
+        , write_drains(0)
+        , num_channels(num_channels)
+        , num_banks(num_banks)
+        , interleave_shift(__builtin_ctz(interleave))
+        , channel_bits(__builtin_ctz(num_channels))
+        , bank_bits(__builtin_ctz(num_banks))
+        , RQ_size(RQ_size)
+        , WQ_size(WQ_size)
+        , WQ_high(WQ_high)
+        , WQ_low(WQ_low)
+        , starvation_cap(starvation_cap)
+        , channels(num_channels)
+        , requests(num_channels * (RQ_size + WQ_size)) {
+        assert(num_banks <= 64);
+        for (auto& channel : channels)
+            channel.banks.resize(num_banks);
+        free_requests.reserve(requests.size());
+        for (int i = requests.size() - 1; i >= 0; i--)
+            free_requests.push_back(i);
+    }
+
+    /* Is there room for a request to @addr? We don't know if it's a read or
+     * a write yet. Requests that are still in DRAM hold on to their slots. */
+    bool enqueuable(md_paddr_t addr) const {
+        const channel_t& channel = channels[get_channel(addr)];
+        return !free_requests.empty() && (channel.num_reads < RQ_size) &&
+               (channel.num_writes < WQ_size);
+    }
+
+    /* Queue a request to @addr, arriving at @now. Returns its slot. */
+    int enqueue(md_paddr_t addr, bool is_write, tick_t now) {
+        assert(enqueuable(addr));
+        int idx = free_requests.back();
+        free_requests.pop_back();
+
+        request_t& req = requests[idx];
+        req.addr = addr;
+        req.when_enqueued = now;
+        req.channel = get_channel(addr);
+        md_paddr_t channel_addr = get_channel_addr(addr);
+        req.bank = (channel_addr >> PAGE_SHIFT) & (num_banks - 1);
+        req.row = channel_addr >> (PAGE_SHIFT + bank_bits);
+        req.is_write = is_write;
+
+        channel_t& channel = channels[req.channel];
+        bank_t& bank = channel.banks[req.bank];
+        if (is_write) {
+            bank.writes.push_back(idx);
+            channel.banks_with_writes |= 1ULL << req.bank;
+            channel.num_writes++;
+        } else {
+            bank.reads.push_back(idx);
+            channel.banks_with_reads |= 1ULL << req.bank;
+            channel.num_reads++;
+        }
+        return idx;
+    }
+
+    /* Send up to one request per channel to DRAM at @now. For each,
+     * @access(slot) does the DRAM access and returns when it completes;
+     * the bank is busy until then. */
+    template <typename F>
+    void step(tick_t now, F access) {
+        for (auto& channel : channels)
+            if (channel.num_reads || channel.num_writes)
+                step_channel(channel, now, access);
+    }
+
+    /* The request in @idx is done, its slot can be reused. */
+    void release(int idx) { free_requests.push_back(idx); }
+
+    int get_num_free() const { return free_requests.size(); }
+
+    void print(FILE* fp) const {
+        for (int c = 0; c < num_channels; c++) {
+            const channel_t& channel = channels[c];
+            fprintf(fp, "channel %d: %d reads, %d writes%s\n", c, channel.num_reads,
+                    channel.num_writes, channel.draining_writes ? " (draining writes)" : "");
+            for (int b = 0; b < num_banks; b++) {
+                const bank_t& bank = channel.banks[b];
+                if (bank.reads.empty() && bank.writes.empty())
+                    continue;
+                fprintf(fp, "  bank %d (row %llx%s):", b, (unsigned long long)bank.open_row,
+                        bank.row_open ? "" : ", closed");
+                for (int idx : bank.reads)
+                    fprintf(fp, " R:%llx", (unsigned long long)requests[idx].addr);
+                for (int idx : bank.writes)
+                    fprintf(fp, " W:%llx", (unsigned long long)requests[idx].addr);
+                fprintf(fp, "\n");
+            }
+        }
+    }
+
+  private:
+    struct request_t {
+        md_paddr_t addr;
+        tick_t when_enqueued;
+        int channel;
+        int bank;
+        md_paddr_t row;
+        bool is_write;
+    };
+
+    struct bank_t {
+        std::deque<int> reads; /* indices into requests, oldest first */
+        std::deque<int> writes;
+        md_paddr_t open_row = 0;
+        bool row_open = false;
+        tick_t when_available = 0; /* when the last access to this bank completes */
+    };
+
+    struct channel_t {
+        std::vector<bank_t> banks;
+        uint64_t banks_with_reads = 0; /* bit per bank */
+        uint64_t banks_with_writes = 0;
+        int num_reads = 0;
+        int num_writes = 0;
+        bool draining_writes = false;
+    };
+
+    int get_channel(md_paddr_t addr) const {
+        return (addr >> interleave_shift) & (num_channels - 1);
+    }
+
+    /* address with the channel bits squeezed out */
+    md_paddr_t get_channel_addr(md_paddr_t addr) const {
+        md_paddr_t low = addr & ((1ULL << interleave_shift) - 1);
+        return ((addr >> (interleave_shift + channel_bits)) << interleave_shift) | low;
+    }
+
+    /* Pick the index (in @queue) of the request we'd send to @bank, if any.
+     * Sets @klass to the priority class of the pick (lower goes first). */
+    int pick_in_bank(const bank_t& bank, const std::deque<int>& queue, tick_t now,
+                     int& klass) const {
+        const request_t& head = requests[queue.front()];
+        bool bank_ready = bank.when_available <= now;
+        bool head_hits = bank.row_open && (head.row == bank.open_row);
+
+        /* Someone has waited long enough, nothing else goes to this bank. */
+        if (now - head.when_enqueued >= starvation_cap) {
+            klass = 0;
+            return (bank_ready || head_hits) ? 0 : -1;
+        }
+
+        if (head_hits) {
+            klass = 1;
+            return 0;
+        }
+
+        if (bank.row_open) {
+            for (size_t i = 1; i < queue.size(); i++)
+                if (requests[queue[i]].row == bank.open_row) {
+                    klass = 1;
+                    return i;
+                }
+        }
+
+        klass = 2;
+        return bank_ready ? 0 : -1;
+    }
+
+    /* Send the best request among @bank_mask's @writes (or reads) to DRAM. */
+    template <typename F>
+    bool issue(channel_t& channel, uint64_t bank_mask, bool writes, tick_t now, F& access) {
+        int best_bank = -1;
+        int best_pos = -1;
+        int best_klass = INT_MAX;
+        tick_t best_age = 0;
+
+        while (bank_mask) {
+            int b = __builtin_ctzll(bank_mask);
+            bank_mask &= bank_mask - 1;
+
+            const bank_t& bank = channel.banks[b];
+            const std::deque<int>& queue = writes ? bank.writes : bank.reads;
+            int klass;
+            int pos = pick_in_bank(bank, queue, now, klass);
+            if (pos < 0)
+                continue;
+
+            tick_t age = now - requests[queue[pos]].when_enqueued;
+            if ((klass < best_klass) || ((klass == best_klass) && (age > best_age))) {
+                best_bank = b;
+                best_pos = pos;
+                best_klass = klass;
+                best_age = age;
+            }
+        }
+
+        if (best_bank == -1)
+            return false;
+
+        bank_t& bank = channel.banks[best_bank];
+        std::deque<int>& queue = writes ? bank.writes : bank.reads;
+        int idx = queue[best_pos];
+        queue.erase(queue.begin() + best_pos);
+        if (writes) {
+            channel.num_writes--;
+            if (queue.empty())
+                channel.banks_with_writes &= ~(1ULL << best_bank);
+        } else {
+            channel.num_reads--;
+            if (queue.empty())
+                channel.banks_with_reads &= ~(1ULL << best_bank);
+        }
+
+        const request_t& req = requests[idx];
+        if (bank.row_open && (bank.open_row == req.row))
+            row_hits++;
+        else if (bank.row_open)
+            row_conflicts++;
+        if (best_klass == 0)
+            starved_issues++;
+        bank.open_row = req.row;
+        bank.row_open = true;
+
+        tick_t when_finished = access(idx);
+        bank.when_available = std::max(bank.when_available, when_finished);
+        return true;
+    }
+
+    template <typename F>
+    void step_channel(channel_t& channel, tick_t now, F& access) {
+        /* Write queue watermarks */
+        if (!channel.draining_writes && (channel.num_writes >= WQ_high)) {
+            channel.draining_writes = true;
+            write_drains++;
+        } else if (channel.draining_writes && (channel.num_writes <= WQ_low))
+            channel.draining_writes = false;
+
+        if (channel.draining_writes || (channel.num_reads == 0)) {
+            if (issue(channel, channel.banks_with_writes, true, now, access))
+                return;
+            /* All banks with writes are busy, try a read in the meantime. */
+        }
+        if (channel.num_reads > 0)
+            issue(channel, channel.banks_with_reads, false, now, access);
+    }
+
+    const int num_channels;
+    const int num_banks; /* per channel */
+    const int interleave_shift;
+    const int channel_bits;
+    const int bank_bits;
+    const int RQ_size; /* per channel */
+    const int WQ_size; /* per channel */
+    const int WQ_high;
+    const int WQ_low;
+    const tick_t starvation_cap;
+
+    std::vector<channel_t> channels;
+    std::vector<request_t> requests;
+    std::vector<int> free_requests;
+};
+
+}  // xiosim
+
+#endif /* __FRFCFS_SCHEDULER_H__ */
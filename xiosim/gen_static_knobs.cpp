@@ -0,0 +1,36 @@
+/* Generates the header of compile-time core knobs for a config-specialized
+ * build. Parses a config file exactly like timing_sim does (including defaults)
+ * and prints the values of STATIC_CORE_KNOBS to stdout.
+ *
+ * Usage: gen_static_knobs <config.cfg> > static_knobs.gen.h
+ */
+
+#include <cstdio>
+
+#include "knobs.h"
+#include "static_knobs.h"
+#include "zesto-config.h"
+
+struct core_knobs_t core_knobs;
+struct uncore_knobs_t uncore_knobs;
+struct system_knobs_t system_knobs;
+
+int main(int argc, const char* argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <config file>\n", argv[0]);
+        return 1;
+    }
+
+    read_config_file(argv[1], &core_knobs, &uncore_knobs, &system_knobs);
+
+    printf("/* Generated by gen_static_knobs from %s. Do not edit. */\n\n", argv[1]);
+    printf("namespace xiosim {\nnamespace static_knobs {\n\n");
+#define PRINT_STATIC_KNOB(section, field)                                                          \
+    printf("constexpr int " #section "_" #field " = %d;\n", core_knobs.section.field);
+    STATIC_CORE_KNOBS(PRINT_STATIC_KNOB)
+#undef PRINT_STATIC_KNOB
+    printf("\n}  // xiosim::static_knobs\n}  // xiosim\n");
+
+    free_config();
+    return 0;
+}
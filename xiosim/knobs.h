@@ -21,6 +21,7 @@ struct prefetcher_knobs_t {
 
     /* prefetcher FIFO */
     int pff_size;
+    int pff_issue_width;
 
     /* prefetcher filter */
     int pf_thresh;
@@ -144,6 +145,7 @@ struct uncore_knobs_t {
     const char* LLC_MSHR_cmd;
     float LLC_magic_hit_rate;
     bool LLC_sample_misses;
+    bool LLC_sparse_sets;
     double LLC_speed;
 
     const char* LLC_controller_str;
@@ -169,17 +171,53 @@ struct system_knobs_t {
     /* Prefix for ztrace output files.
      * Final filenames will be @ztrace_filename.{coreID}. */
     const char* ztrace_filename;
+    /* Prefix for committed branch traces, for offline bpred sweeps ("" = off).
+     * Final filenames will be @brtrace_filename.{coreID}. */
+    const char* brtrace_filename;
     /* Simulator output file. */
     const char* sim_simout;
+    /* Largest page size for big aligned mappings: "none", "2M" or "1G". */
+    const char* huge_pages;
+    /* Machine-readable copy of the stats: "none", "json" or "binary". */
+    const char* structured_stats;
+    /* Write warmed microarchitectural state here at the end of simulation ("" = don't). */
+    const char* checkpoint_save;
+    /* Start from the state in this checkpoint ("" = cold start). */
+    const char* checkpoint_restore;
 
     /* Power simulation knobs. */
     struct {
         bool compute;
         int rtp_interval;
         const char* rtp_filename;
+        /* Runtime power model: "mcpat" (full McPAT every interval), or "linear"
+         * (per-event energies calibrated from McPAT at init). */
+        const char* model;
+        /* With the linear model, also run McPAT every @check_interval
+         * intervals and report the error (0 = never). */
+        int check_interval;
+        /* Directory for cached McPAT array results ("" = no caching). */
+        const char* cache_dir;
     } power;
 
     int scheduler_tick;
+    /* Move threads waiting on busy cores to idle ones. */
+    bool load_balance;
+    /* When balancing, prefer threads whose caches are warm on the idle core. */
+    bool migration_cache_affinity;
+
+    /* Interval statistics sampling. See stat_sampler.h. */
+    struct {
+        /* Uncore cycles between samples. 0 disables sampling. */
+        int interval;
+        /* Sample buffer size. When full, the interval doubles. */
+        int max_samples;
+        /* Names of the sampled statistics and formulas. */
+        std::vector<std::string> stats;
+        const char* filename;
+        /* "csv" or "binary". */
+        const char* format;
+    } sampling;
 
     /* Core allocation policy. Valid options:
      * "gang", "local", or "penalty". See pintool/base_allocator.h for more
@@ -6,8 +6,10 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <strings.h>
 #include <unordered_map>
 #include <mutex>
 
@@ -23,20 +25,279 @@
 namespace xiosim {
 namespace memory {
 
-/* VPN to PPN hash map. Note: these are page numbers, not addresses. */
-typedef std::unordered_map<md_addr_t, md_paddr_t> page_table_t;
+/* VPN to PPN map. Note: these are page numbers, not addresses.
+ * A 4-level radix tree (9 bits per level) covers 48-bit virtual addresses.
+ * Directory entries one level above the leaves map 2MB, and two levels above, 1GB.
+ * Such an entry can map a huge page directly -- then it holds (base PPN << 1) | 1
+ * instead of a pointer to the next level.
+ * Anything above 48 bits (vsyscall et al.) goes to a small hash map, 4K pages only.
+ * PPN 0 is never allocated, so it marks an unmapped page. */
+class page_table_t {
+  public:
+    page_table_t()
+        : root(new_dir()) {}
+    ~page_table_t() { free_dir(root, 0); }
+
+    /* Returns the PPN of the 4K page @vpn (0 if unmapped). Sets @shift to the
+     * page shift of the mapping it belongs to. */
+    md_paddr_t lookup(md_addr_t vpn, md_addr_t* shift) const {
+        *shift = PAGE_SHIFT;
+        if (vpn >> RADIX_BITS) {
+            auto it = far_pages.find(vpn);
+            return (it == far_pages.end()) ? 0 : it->second;
+        }
+
+        const dir_t* dir = root;
+        for (int level = 0; level < NUM_LEVELS - 1; level++) {
+            const void* next = dir->next[index(vpn, level)];
+            if (next == nullptr)
+                return 0;
+            if (is_huge(next)) {
+                *shift = PAGE_SHIFT + entry_shift(level);
+                return huge_ppn(next) + (vpn & entry_mask(level));
+            }
+            dir = static_cast<const dir_t*>(next);
+        }
+        const leaf_t* leaf = reinterpret_cast<const leaf_t*>(dir);
+        return leaf->ppn[index(vpn, NUM_LEVELS - 1)];
+    }
+
+    /* Map 4K page @vpn. It must not be part of a huge page. */
+    void insert(md_addr_t vpn, md_paddr_t ppn) {
+        assert(ppn != 0);
+        if (vpn >> RADIX_BITS) {
+            far_pages[vpn] = ppn;
+            return;
+        }
+
+        dir_t* dir = root;
+        for (int level = 0; level < NUM_LEVELS - 1; level++) {
+            void*& next = dir->next[index(vpn, level)];
+            assert(!is_huge(next));
+            if (next == nullptr)
+                next = (level == NUM_LEVELS - 2) ? static_cast<void*>(new_leaf())
+                                                 : static_cast<void*>(new_dir());
+            dir = static_cast<dir_t*>(next);
+        }
+        leaf_t* leaf = reinterpret_cast<leaf_t*>(dir);
+        leaf->ppn[index(vpn, NUM_LEVELS - 1)] = ppn;
+    }
+
+    /* Can we map a huge page with @shift at @vpn? Only if nothing in its range
+     * is mapped already. */
+    bool can_insert_huge(md_addr_t vpn, md_addr_t shift) const {
+        if (vpn >> RADIX_BITS)
+            return false;
+        int huge_level = level_for_shift(shift);
+        assert((vpn & entry_mask(huge_level)) == 0);
+
+        const dir_t* dir = root;
+        for (int level = 0; level < huge_level; level++) {
+            const void* next = dir->next[index(vpn, level)];
+            if (next == nullptr)
+                return true;
+            if (is_huge(next))
+                return false;
+            dir = static_cast<const dir_t*>(next);
+        }
+        return dir->next[index(vpn, huge_level)] == nullptr;
+    }
+
+    /* Map huge page at @vpn, with @shift, to physical pages starting at @ppn. */
+    void insert_huge(md_addr_t vpn, md_addr_t shift, md_paddr_t ppn) {
+        assert(can_insert_huge(vpn, shift));
+        int huge_level = level_for_shift(shift);
+
+        dir_t* dir = root;
+        for (int level = 0; level < huge_level; level++) {
+            void*& next = dir->next[index(vpn, level)];
+            if (next == nullptr)
+                next = new_dir();
+            dir = static_cast<dir_t*>(next);
+        }
+        dir->next[index(vpn, huge_level)] = make_huge(ppn);
+    }
+
+    /* Unmap 4K page @vpn. If it is part of a huge page, the huge page gets
+     * split into smaller ones first. */
+    void erase(md_addr_t vpn) {
+        if (vpn >> RADIX_BITS) {
+            far_pages.erase(vpn);
+            return;
+        }
+
+        dir_t* dir = root;
+        for (int level = 0; level < NUM_LEVELS - 1; level++) {
+            void*& next = dir->next[index(vpn, level)];
+            if (next == nullptr)
+                return;
+            if (is_huge(next))
+                next = split(next, level);
+            dir = static_cast<dir_t*>(next);
+        }
+        leaf_t* leaf = reinterpret_cast<leaf_t*>(dir);
+        leaf->ppn[index(vpn, NUM_LEVELS - 1)] = 0;
+    }
+
+    /* Unmap the whole huge page starting at @vpn, with @shift. */
+    void erase_huge(md_addr_t vpn, md_addr_t shift) {
+        int huge_level = level_for_shift(shift);
+        dir_t* dir = root;
+        for (int level = 0; level < huge_level; level++)
+            dir = static_cast<dir_t*>(dir->next[index(vpn, level)]);
+        void*& entry = dir->next[index(vpn, huge_level)];
+        assert(is_huge(entry));
+        entry = nullptr;
+    }
+
+    /* Call @f(vpn, shift, ppn) for every mapping, once per huge page. */
+    template <typename F>
+    void for_each(F f) const {
+        for_each_in(root, 0, 0, f);
+        for (auto& it : far_pages)
+            f(it.first, PAGE_SHIFT, it.second);
+    }
+
+    /* Unmap everything. */
+    void clear() {
+        free_dir(root, 0);
+        root = new_dir();
+        far_pages.clear();
+    }
+
+  private:
+    static const int LEVEL_BITS = 9;
+    static const int NUM_LEVELS = 4;
+    static const int RADIX_BITS = LEVEL_BITS * NUM_LEVELS;
+    static const size_t LEVEL_SIZE = 1 << LEVEL_BITS;
+
+    struct dir_t {
+        void* next[LEVEL_SIZE];
+    };
+    struct leaf_t {
+        md_paddr_t ppn[LEVEL_SIZE];
+    };
+
+    /* log2 of the number of 4K pages an entry at @level covers. */
+    static int entry_shift(int level) { return (NUM_LEVELS - 1 - level) * LEVEL_BITS; }
+    static md_addr_t entry_mask(int level) { return (md_addr_t(1) << entry_shift(level)) - 1; }
+    static int level_for_shift(md_addr_t shift) {
+        int level = NUM_LEVELS - 1 - (shift - PAGE_SHIFT) / LEVEL_BITS;
+        assert(level > 0 && level < NUM_LEVELS - 1);
+        assert(PAGE_SHIFT + entry_shift(level) == shift);
+        return level;
+    }
+
+    static size_t index(md_addr_t vpn, int level) {
+        return (vpn >> entry_shift(level)) & (LEVEL_SIZE - 1);
+    }
+
+    static bool is_huge(const void* entry) { return reinterpret_cast<uintptr_t>(entry) & 1; }
+    static void* make_huge(md_paddr_t ppn) { return reinterpret_cast<void*>((ppn << 1) | 1); }
+    static md_paddr_t huge_ppn(const void* entry) { return reinterpret_cast<uintptr_t>(entry) >> 1; }
+
+    /* Replace huge page @entry at @level with a next-level table of smaller pages. */
+    static void* split(const void* entry, int level) {
+        md_paddr_t base = huge_ppn(entry);
+        md_paddr_t sub_pages = md_paddr_t(1) << entry_shift(level + 1);
+        if (level + 1 == NUM_LEVELS - 1) {
+            leaf_t* leaf = new_leaf();
+            for (size_t i = 0; i < LEVEL_SIZE; i++)
+                leaf->ppn[i] = base + i;
+            return leaf;
+        }
+        dir_t* dir = new_dir();
+        for (size_t i = 0; i < LEVEL_SIZE; i++)
+            dir->next[i] = make_huge(base + i * sub_pages);
+        return dir;
+    }
+
+    static dir_t* new_dir() {
+        dir_t* res = (dir_t*)calloc(1, sizeof(dir_t));
+        if (!res)
+            fatal("couldn't calloc page table directory");
+        return res;
+    }
+
+    static leaf_t* new_leaf() {
+        leaf_t* res = (leaf_t*)calloc(1, sizeof(leaf_t));
+        if (!res)
+            fatal("couldn't calloc page table leaf");
+        return res;
+    }
+
+    template <typename F>
+    static void for_each_in(const dir_t* dir, int level, md_addr_t base_vpn, F& f) {
+        for (size_t i = 0; i < LEVEL_SIZE; i++) {
+            const void* next = dir->next[i];
+            md_addr_t vpn = base_vpn | (md_addr_t(i) << entry_shift(level));
+            if (next == nullptr)
+                continue;
+            if (is_huge(next)) {
+                f(vpn, PAGE_SHIFT + entry_shift(level), huge_ppn(next));
+            } else if (level < NUM_LEVELS - 2) {
+                for_each_in(static_cast<const dir_t*>(next), level + 1, vpn, f);
+            } else {
+                const leaf_t* leaf = static_cast<const leaf_t*>(next);
+                for (size_t j = 0; j < LEVEL_SIZE; j++)
+                    if (leaf->ppn[j])
+                        f(vpn | j, PAGE_SHIFT, leaf->ppn[j]);
+            }
+        }
+    }
+
+    static void free_dir(dir_t* dir, int level) {
+        for (size_t i = 0; i < LEVEL_SIZE; i++) {
+            void* next = dir->next[i];
+            if (next == nullptr || is_huge(next))
+                continue;
+            if (level < NUM_LEVELS - 2)
+                free_dir(static_cast<dir_t*>(next), level + 1);
+            else
+                free(next);
+        }
+        free(dir);
+    }
+
+    dir_t* root;
+    std::unordered_map<md_addr_t, md_paddr_t> far_pages;
+};
+
+/* Small direct-mapped cache of recent translations, checked before taking memory_lock.
+ * It is thread-local, and each simulated core runs on its own thread, so it is
+ * effectively per-core. Only successful translations are cached. An entry is valid
+ * only in the mapping epoch it was filled in -- anything that removes mappings
+ * (munmap, shrinking brk) starts a new epoch. New mappings don't invalidate anything. */
+struct v2p_cache_entry_t {
+    uint64_t epoch;
+    int asid;
+    md_addr_t vpn;
+    md_paddr_t ppn;
+    md_addr_t shift;
+};
+const size_t V2P_CACHE_SIZE = 512;
+static thread_local v2p_cache_entry_t v2p_cache[V2P_CACHE_SIZE];
+/* Starts at 1, so zero-initialized cache entries are invalid. */
+static std::atomic<uint64_t> mapping_epoch(1);
 
 static int num_address_spaces;
 static page_table_t * page_tables;
 static md_addr_t * brk_point;
 
 static counter_t * page_count;
+static counter_t * huge_page_count;
 static counter_t phys_page_count;
 
+/* Largest page size (as a shift) mem_newmap() can use for large aligned regions.
+ * PAGE_SHIFT means no huge pages. */
+static md_addr_t max_page_shift = PAGE_SHIFT;
+const md_addr_t HUGE_PAGE_SHIFTS[] = { 30, 21 }; /* 1G, 2M; largest first */
+
 static XIOSIM_LOCK memory_lock;
 
-/* given a set of pages, this creates a set of new page mappings. */
-static void mem_newmap(int asid, md_addr_t addr, size_t length);
+/* given a set of pages, this creates a set of new page mappings.
+ * If @allow_huge, it uses huge pages for aligned regions, as per the huge page policy. */
+static void mem_newmap(int asid, md_addr_t addr, size_t length, bool allow_huge = false);
 /* given a set of pages, this removes them from our map. */
 static void mem_delmap(int asid, md_addr_t addr, size_t length);
 /* check if a virtual address has been added to the mapping */
@@ -45,21 +306,35 @@ static bool mem_is_mapped(int asid, md_addr_t addr);
 static md_addr_t get_brk(int asid);
 static void set_brk(int asid, md_addr_t brk);
 
-void init(int num_processes)
+void init(int num_processes, const char* huge_pages)
 {
     num_address_spaces = num_processes;
 
+    if (!strcasecmp(huge_pages, "none"))
+        max_page_shift = PAGE_SHIFT;
+    else if (!strcasecmp(huge_pages, "2M"))
+        max_page_shift = 21;
+    else if (!strcasecmp(huge_pages, "1G"))
+        max_page_shift = 30;
+    else
+        fatal("unknown huge page policy \"%s\" (none|2M|1G)", huge_pages);
+
     page_tables = new page_table_t[num_processes];
     page_count = new counter_t[num_processes];
+    huge_page_count = new counter_t[num_processes];
     brk_point = new md_addr_t[num_processes];
 
     memset(page_count, 0, num_processes * sizeof(page_count[0]));
+    memset(huge_page_count, 0, num_processes * sizeof(huge_page_count[0]));
     memset(brk_point, 0, num_processes * sizeof(brk_point[0]));
+    mapping_epoch++;
 }
 
 void deinit()
 {
+    mapping_epoch++;
     delete[] brk_point;
+    delete[] huge_page_count;
     delete[] page_count;
     delete[] page_tables;
 }
@@ -68,7 +343,24 @@ void deinit()
  * first-come-first-serve basis. Seems like linux frowns upon
  * page coloring, so should be reasonably accurate. */
 static md_paddr_t next_ppn_to_allocate = 0x00000100; /* arbitrary starting point; */
-static void mem_newmap(int asid, md_addr_t addr, size_t length)
+
+/* Largest huge page shift we can use to map @curr_addr, given that the
+ * mapped range ends at @end_addr. PAGE_SHIFT if none fits. */
+static md_addr_t huge_page_fit(int asid, md_addr_t curr_addr, md_addr_t end_addr)
+{
+    for (md_addr_t shift : HUGE_PAGE_SHIFTS) {
+        md_addr_t size = md_addr_t(1) << shift;
+        if (shift > max_page_shift || (curr_addr & (size - 1)))
+            continue;
+        if (curr_addr + size > end_addr || curr_addr + size < curr_addr)
+            continue;
+        if (page_tables[asid].can_insert_huge(curr_addr >> PAGE_SHIFT, shift))
+            return shift;
+    }
+    return PAGE_SHIFT;
+}
+
+static void mem_newmap(int asid, md_addr_t addr, size_t length, bool allow_huge)
 {
     ZTRACE_PRINT(INVALID_CORE, "mem_newmap: %d, %" PRIxPTR", length: %zd\n", asid, addr, length);
 
@@ -83,12 +375,31 @@ static void mem_newmap(int asid, md_addr_t addr, size_t length)
 
     /* Add every page in the range to page table */
     md_addr_t last_addr = page_round_up(addr + length);
-    for (md_addr_t curr_addr = addr; (curr_addr <= last_addr) && curr_addr; curr_addr += PAGE_SIZE) {
+    md_addr_t curr_addr = addr;
+    for (; (curr_addr <= last_addr) && curr_addr; curr_addr += PAGE_SIZE) {
+        /* Aligned huge regions get a single mapping. */
+        md_addr_t shift = allow_huge ? huge_page_fit(asid, curr_addr, last_addr + PAGE_SIZE)
+                                     : PAGE_SHIFT;
+        if (shift != PAGE_SHIFT) {
+            md_paddr_t num_pages = md_paddr_t(1) << (shift - PAGE_SHIFT);
+            /* Huge pages are physically contiguous and aligned. */
+            next_ppn_to_allocate = (next_ppn_to_allocate + num_pages - 1) & ~(num_pages - 1);
+            page_tables[asid].insert_huge(curr_addr >> PAGE_SHIFT, shift, next_ppn_to_allocate);
+            next_ppn_to_allocate += num_pages;
+
+            page_count[asid] += num_pages;
+            huge_page_count[asid]++;
+            phys_page_count += num_pages;
+
+            curr_addr += (md_addr_t(1) << shift) - PAGE_SIZE;
+            continue;
+        }
+
         if (mem_is_mapped(asid, curr_addr))
             continue; /* Attempting to double-map is ok */
 
         md_addr_t curr_vpn = curr_addr >> PAGE_SHIFT;
-        page_tables[asid][curr_vpn] = next_ppn_to_allocate;
+        page_tables[asid].insert(curr_vpn, next_ppn_to_allocate);
 
         next_ppn_to_allocate++;
 
@@ -109,13 +420,30 @@ static void mem_delmap(int asid, md_addr_t addr, size_t length)
         abort();
     }
 
+    /* Invalidate all cached translations, some might be for pages in the range. */
+    mapping_epoch++;
+
     /* Remove every page in the range from page table */
     md_addr_t last_addr = page_round_up(addr + length);
     for (md_addr_t curr_addr = addr; (curr_addr <= last_addr) && curr_addr; curr_addr += PAGE_SIZE) {
-        if (!mem_is_mapped(asid, curr_addr))
+        md_addr_t curr_vpn = curr_addr >> PAGE_SHIFT;
+        md_addr_t shift;
+        if (page_tables[asid].lookup(curr_vpn, &shift) == 0)
             continue; /* Attempting to remove something missing is ok */
 
-        md_addr_t curr_vpn = curr_addr >> PAGE_SHIFT;
+        /* Whole huge page in the range -- drop it at once. Otherwise, it gets split. */
+        md_addr_t size = md_addr_t(1) << shift;
+        if (shift != PAGE_SHIFT && !(curr_addr & (size - 1)) &&
+            (curr_addr + size - PAGE_SIZE <= last_addr)) {
+            page_tables[asid].erase_huge(curr_vpn, shift);
+
+            md_paddr_t num_pages = md_paddr_t(1) << (shift - PAGE_SHIFT);
+            page_count[asid] -= num_pages;
+            phys_page_count -= num_pages;
+
+            curr_addr += size - PAGE_SIZE;
+            continue;
+        }
         page_tables[asid].erase(curr_vpn);
 
         page_count[asid]--;
@@ -128,7 +456,8 @@ static bool mem_is_mapped(int asid, md_addr_t addr)
 {
     assert(asid >= 0 && asid < num_address_spaces);
     md_addr_t vpn = addr >> PAGE_SHIFT;
-    return (page_tables[asid].count(vpn) > 0);
+    md_addr_t shift;
+    return (page_tables[asid].lookup(vpn, &shift) != 0);
 }
 
 /* Get top of data segment */
@@ -145,25 +474,65 @@ static void set_brk(int asid, md_addr_t brk_)
     brk_point[asid] = brk_;
 }
 
-md_paddr_t v2p_translate(int asid, md_addr_t addr)
+/* Look up the PPN and page size of the 4K page @vpn. Returns 0 for unmapped pages. */
+static md_paddr_t translate_vpn(int asid, md_addr_t vpn, md_addr_t* shift)
 {
+    v2p_cache_entry_t& entry = v2p_cache[(vpn ^ asid) & (V2P_CACHE_SIZE - 1)];
+    if (entry.epoch == mapping_epoch.load(std::memory_order_acquire) && entry.vpn == vpn &&
+        entry.asid == asid) {
+        *shift = entry.shift;
+        return entry.ppn;
+    }
+
     std::lock_guard<XIOSIM_LOCK> l(memory_lock);
+    assert(asid >= 0 && asid < num_address_spaces);
+    md_paddr_t ppn = page_tables[asid].lookup(vpn, shift);
+    if (ppn != 0) {
+        /* Epoch can only change under memory_lock, so this entry is consistent. */
+        entry.epoch = mapping_epoch.load(std::memory_order_relaxed);
+        entry.asid = asid;
+        entry.vpn = vpn;
+        entry.ppn = ppn;
+        entry.shift = *shift;
+    }
+    return ppn;
+}
+
+md_paddr_t v2p_translate(int asid, md_addr_t addr)
+{
+    md_addr_t shift;
+    return v2p_translate(asid, addr, &shift);
+}
+
+md_paddr_t v2p_translate(int asid, md_addr_t addr, md_addr_t* shift)
+{
+    *shift = PAGE_SHIFT;
     /* Some caches call this with an already translated address. Just ignore. */
     if (asid == DO_NOT_TRANSLATE)
         return addr;
 
-    assert(asid >= 0 && asid < num_address_spaces);
     /* Page is mapped, just look it up */
-    if (mem_is_mapped(asid, addr)) {
-        md_addr_t vpn = addr >> PAGE_SHIFT;
-        return (page_tables[asid][vpn] << PAGE_SHIFT) + page_offset(addr);
-    }
+    md_paddr_t ppn = translate_vpn(asid, addr >> PAGE_SHIFT, shift);
+    if (ppn != 0)
+        return (ppn << PAGE_SHIFT) + page_offset(addr);
 
     /* Else, return zeroth page and someone in higher layers will
      * complain if necessary */
+    *shift = PAGE_SHIFT;
     return 0 + page_offset(addr);
 }
 
+md_addr_t page_shift(int asid, md_addr_t addr)
+{
+    if (max_page_shift == PAGE_SHIFT || asid == DO_NOT_TRANSLATE)
+        return PAGE_SHIFT;
+
+    md_addr_t shift;
+    if (translate_vpn(asid, addr >> PAGE_SHIFT, &shift) == 0)
+        return PAGE_SHIFT;
+    return shift;
+}
+
 void notify_write(int asid, md_addr_t addr)
 {
     std::lock_guard<XIOSIM_LOCK> l(memory_lock);
@@ -177,7 +546,7 @@ void notify_mmap(int asid, md_addr_t addr, size_t length, bool mod_brk)
     md_addr_t page_addr = page_round_down(addr);
     size_t page_length = page_round_up(length);
 
-    mem_newmap(asid, page_addr, page_length);
+    mem_newmap(asid, page_addr, page_length, true);
 
     md_addr_t curr_brk = get_brk(asid);
     if(mod_brk && page_addr > curr_brk)
@@ -238,7 +607,69 @@ void reg_stats(xiosim::stats::StatsDatabase* sdb)
         sprintf(buf, "prog_%d.page_count", i);
         stat_reg_counter(sdb, TRUE, buf, "total number of pages allocated",
             (page_count + i), 0, FALSE, NULL);
+        if (max_page_shift != PAGE_SHIFT) {
+            sprintf(buf, "prog_%d.huge_page_count", i);
+            stat_reg_counter(sdb, TRUE, buf, "number of huge page mappings created",
+                (huge_page_count + i), 0, FALSE, NULL);
+        }
+    }
+}
+
+static std::string ckpt_identity()
+{
+    return std::to_string(num_address_spaces) + ":" + std::to_string(max_page_shift);
+}
+
+void save(xiosim::checkpoint::writer_t& ckpt, const std::string& key)
+{
+    std::lock_guard<XIOSIM_LOCK> l(memory_lock);
+    ckpt.begin_section(key, ckpt_identity());
+    for (int asid = 0; asid < num_address_spaces; asid++) {
+        ckpt.put(brk_point[asid]);
+        ckpt.put(page_count[asid]);
+        ckpt.put(huge_page_count[asid]);
+
+        uint64_t num_mappings = 0;
+        page_tables[asid].for_each([&](md_addr_t, md_addr_t, md_paddr_t) { num_mappings++; });
+        ckpt.put(num_mappings);
+        page_tables[asid].for_each([&](md_addr_t vpn, md_addr_t shift, md_paddr_t ppn) {
+            ckpt.put(vpn);
+            ckpt.put(shift);
+            ckpt.put(ppn);
+        });
+    }
+    ckpt.put(phys_page_count);
+    ckpt.put(next_ppn_to_allocate);
+}
+
+void restore(xiosim::checkpoint::reader_t& ckpt, const std::string& key)
+{
+    std::lock_guard<XIOSIM_LOCK> l(memory_lock);
+    if (!ckpt.begin_section(key, ckpt_identity()))
+        return;
+
+    /* Everything we might have cached is stale now. */
+    mapping_epoch++;
+    for (int asid = 0; asid < num_address_spaces; asid++) {
+        page_tables[asid].clear();
+        brk_point[asid] = ckpt.get<md_addr_t>();
+        page_count[asid] = ckpt.get<counter_t>();
+        huge_page_count[asid] = ckpt.get<counter_t>();
+
+        uint64_t num_mappings = ckpt.get<uint64_t>();
+        for (uint64_t i = 0; i < num_mappings; i++) {
+            md_addr_t vpn = ckpt.get<md_addr_t>();
+            md_addr_t shift = ckpt.get<md_addr_t>();
+            md_paddr_t ppn = ckpt.get<md_paddr_t>();
+            if (shift == PAGE_SHIFT)
+                page_tables[asid].insert(vpn, ppn);
+            else
+                page_tables[asid].insert_huge(vpn, shift, ppn);
+        }
     }
+    phys_page_count = ckpt.get<counter_t>();
+    next_ppn_to_allocate = ckpt.get<md_paddr_t>();
+    ckpt.end_section();
 }
 }
 }
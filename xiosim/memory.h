@@ -6,6 +6,9 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include <string>
+
+#include "checkpoint.h"
 #include "host.h"
 #include "stats.h"
 
@@ -22,8 +25,9 @@ const md_addr_t PAGE_MASK = PAGE_SIZE - 1;
 /* special address space id to indicate an already-translated address */
 const int DO_NOT_TRANSLATE = -1;
 
-/* initialize memory system  */
-void init(int num_processes);
+/* initialize memory system. @huge_pages is the huge page policy:
+ * "none", "2M" or "1G" (largest page size for big aligned mappings). */
+void init(int num_processes, const char* huge_pages);
 
 /* clean up */
 void deinit();
@@ -31,8 +35,19 @@ void deinit();
 /* register memory system-specific statistics */
 void reg_stats(xiosim::stats::StatsDatabase* sdb);
 
+/* checkpoint the page tables and allocation state in section @key */
+void save(xiosim::checkpoint::writer_t& ckpt, const std::string& key);
+void restore(xiosim::checkpoint::reader_t& ckpt, const std::string& key);
+
 /* map each (address-space-id,virtual-address) pair to a simulated physical address */
 md_paddr_t v2p_translate(int asid, md_addr_t addr);
+/* same, also returning the page size (as in page_shift()) in @shift */
+md_paddr_t v2p_translate(int asid, md_addr_t addr, md_addr_t* shift);
+
+/* log2 of the size of the page that maps @addr (PAGE_SHIFT for 4K pages,
+ * and for unmapped addresses). */
+md_addr_t page_shift(int asid, md_addr_t addr);
+
 
 /* notify the virtual memory system of a non-speculative write.
  * This will allocate a new page if the page was unmapped. */
@@ -70,9 +85,13 @@ inline md_addr_t page_offset(const md_addr_t addr) {
    by PAGE_SHIFT yields the virtual page number, the masking is
    just to hash the address down to something that's less than the
    start of the .text section, and the additional offset is so that
-   we don't generate a really low (e.g., NULL) address. */
-inline md_addr_t page_table_address(const int asid, const md_addr_t addr) {
-    return ((((addr >> PAGE_SHIFT) << 4) + asid) + 0x00080000) & 0x03ffffff;
+   we don't generate a really low (e.g., NULL) address.
+   Addresses in the same huge page share a page table entry (and a TLB entry);
+   the page size (@shift, from the translation) is mixed in so they don't alias
+   with 4K entries. */
+inline md_addr_t page_table_address(const int asid, const md_addr_t addr, const md_addr_t shift) {
+    const md_addr_t size_tag = (shift - PAGE_SHIFT) << 20;
+    return ((((addr >> shift) << 4) + asid + size_tag) + 0x00080000) & 0x03ffffff;
     /* TODO(skanev): Check for 64b */
 }
 
@@ -0,0 +1,185 @@
+/* perceptron_kernels.cpp - Vectorized perceptron dot product and training.
+ *
+ * All versions work on 16-bit lanes. A lane's sign mask m is 0 when its
+ * history bit is taken and -1 when it's not, so (w ^ m) - m is w or -w
+ * without a branch. Training adds (m ^ t) | 1, i.e. +1 when the history bit
+ * agrees with the outcome (t is the outcome's mask) and -1 otherwise.
+ *
+ * Vector loops take 8 (SSE2) or 16 (AVX2) history bits at a time out of one
+ * 64-bit word, so chunks never straddle two words. Leftovers are scalar.
+ */
+
+#include "perceptron_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PERCEPTRON_X86
+#endif
+
+namespace xiosim {
+namespace bpred {
+
+static inline int16_t lane_mask(const uint64_t* hist, int i) {
+    return ((hist[i >> 6] >> (i & 63)) & 1) ? 0 : -1;
+}
+
+static inline int dot_tail(const int16_t* w, const uint64_t* hist, int from, int n) {
+    int sum = 0;
+    for (int i = from; i < n; i++) {
+        int16_t m = lane_mask(hist, i);
+        sum += (int16_t)((w[i] ^ m) - m);
+    }
+    return sum;
+}
+
+static inline void train_tail(int16_t* w,
+                              const uint64_t* hist,
+                              int from,
+                              int n,
+                              int16_t t,
+                              int16_t w_min,
+                              int16_t w_max) {
+    for (int i = from; i < n; i++) {
+        int delta = (lane_mask(hist, i) ^ t) | 1;
+        int val = w[i] + delta;
+        w[i] = (val < w_min) ? w_min : ((val > w_max) ? w_max : val);
+    }
+}
+
+int perceptron_dot_scalar(const int16_t* w, const uint64_t* hist, int n) {
+    return dot_tail(w, hist, 0, n);
+}
+
+void perceptron_train_scalar(
+        int16_t* w, const uint64_t* hist, int n, bool outcome, int16_t w_min, int16_t w_max) {
+    train_tail(w, hist, 0, n, outcome ? 0 : -1, w_min, w_max);
+}
+
+#if defined(PERCEPTRON_X86) && defined(__SSE2__)
+/* Sign masks for the 8 history bits in the low byte of @bits. */
+static inline __m128i sse2_masks(uint64_t bits) {
+    const __m128i sel = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+    __m128i b = _mm_set1_epi16((int16_t)(bits & 0xff));
+    /* taken lanes are all ones, so flip */
+    __m128i taken = _mm_cmpeq_epi16(_mm_and_si128(b, sel), sel);
+    return _mm_xor_si128(taken, _mm_set1_epi16(-1));
+}
+
+static int dot_sse2(const int16_t* w, const uint64_t* hist, int n) {
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i m = sse2_masks(hist[i >> 6] >> (i & 63));
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        x = _mm_sub_epi16(_mm_xor_si128(x, m), m);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(x, ones));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc) + dot_tail(w, hist, i, n);
+}
+
+static void train_sse2(
+        int16_t* w, const uint64_t* hist, int n, int16_t t, int16_t w_min, int16_t w_max) {
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i vt = _mm_set1_epi16(t);
+    const __m128i vmin = _mm_set1_epi16(w_min);
+    const __m128i vmax = _mm_set1_epi16(w_max);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i m = sse2_masks(hist[i >> 6] >> (i & 63));
+        __m128i delta = _mm_or_si128(_mm_xor_si128(m, vt), one);
+        __m128i* p = reinterpret_cast<__m128i*>(w + i);
+        __m128i x = _mm_add_epi16(_mm_loadu_si128(p), delta);
+        _mm_storeu_si128(p, _mm_min_epi16(_mm_max_epi16(x, vmin), vmax));
+    }
+    train_tail(w, hist, i, n, t, w_min, w_max);
+}
+#endif
+
+#ifdef PERCEPTRON_X86
+/* Sign masks for the 16 history bits in the low half-word of @bits. */
+__attribute__((target("avx2"))) static inline __m256i avx2_masks(uint64_t bits) {
+    const __m256i sel = _mm256_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048,
+                                          4096, 8192, 16384, (int16_t)0x8000);
+    __m256i b = _mm256_set1_epi16((int16_t)(bits & 0xffff));
+    __m256i taken = _mm256_cmpeq_epi16(_mm256_and_si256(b, sel), sel);
+    return _mm256_xor_si256(taken, _mm256_set1_epi16(-1));
+}
+
+__attribute__((target("avx2"))) static int dot_avx2(const int16_t* w,
+                                                     const uint64_t* hist,
+                                                     int n) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i m = avx2_masks(hist[i >> 6] >> (i & 63));
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        x = _mm256_sub_epi16(_mm256_xor_si256(x, m), m);
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, ones));
+    }
+    __m128i acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                                   _mm256_extracti128_si256(acc, 1));
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc128) + dot_tail(w, hist, i, n);
+}
+
+__attribute__((target("avx2"))) static void train_avx2(
+        int16_t* w, const uint64_t* hist, int n, int16_t t, int16_t w_min, int16_t w_max) {
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i vt = _mm256_set1_epi16(t);
+    const __m256i vmin = _mm256_set1_epi16(w_min);
+    const __m256i vmax = _mm256_set1_epi16(w_max);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i m = avx2_masks(hist[i >> 6] >> (i & 63));
+        __m256i delta = _mm256_or_si256(_mm256_xor_si256(m, vt), one);
+        __m256i* p = reinterpret_cast<__m256i*>(w + i);
+        __m256i x = _mm256_add_epi16(_mm256_loadu_si256(p), delta);
+        _mm256_storeu_si256(p, _mm256_min_epi16(_mm256_max_epi16(x, vmin), vmax));
+    }
+    train_tail(w, hist, i, n, t, w_min, w_max);
+}
+
+static bool have_avx2() {
+    static const bool res = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return res;
+}
+#endif
+
+int perceptron_dot(const int16_t* w, const uint64_t* hist, int n) {
+#ifdef PERCEPTRON_X86
+    if (have_avx2())
+        return dot_avx2(w, hist, n);
+#endif
+#if defined(PERCEPTRON_X86) && defined(__SSE2__)
+    return dot_sse2(w, hist, n);
+#else
+    return perceptron_dot_scalar(w, hist, n);
+#endif
+}
+
+void perceptron_train(
+        int16_t* w, const uint64_t* hist, int n, bool outcome, int16_t w_min, int16_t w_max) {
+    int16_t t = outcome ? 0 : -1;
+#ifdef PERCEPTRON_X86
+    if (have_avx2()) {
+        train_avx2(w, hist, n, t, w_min, w_max);
+        return;
+    }
+#endif
+#if defined(PERCEPTRON_X86) && defined(__SSE2__)
+    train_sse2(w, hist, n, t, w_min, w_max);
+#else
+    perceptron_train_scalar(w, hist, n, outcome, w_min, w_max);
+#endif
+}
+
+}  // xiosim::bpred
+}  // xiosim
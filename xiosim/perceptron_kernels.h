@@ -0,0 +1,37 @@
+/* perceptron_kernels.h - Dot product and training for perceptron-style
+ * branch predictors.
+ *
+ * A perceptron row is a contiguous array of n int16 weights, one per
+ * history position. History is a bit vector -- bit i of @hist is bit (i % 64)
+ * of hist[i / 64], with 1 meaning taken. The kernels expand it into a
+ * sign mask a vector at a time, so callers keep their usual bhr words.
+ *
+ * Weights aren't padded, any n works. Vector code (AVX2 when the host has
+ * it, SSE2 otherwise) gives bit-identical results to the scalar reference.
+ */
+
+#ifndef __PERCEPTRON_KERNELS_H__
+#define __PERCEPTRON_KERNELS_H__
+
+#include <cstdint>
+
+namespace xiosim {
+namespace bpred {
+
+/* sum(w[i] * (hist[i] ? 1 : -1)) for i in [0, n). */
+int perceptron_dot(const int16_t* w, const uint64_t* hist, int n);
+
+/* Move w[i] towards agreeing with @outcome: +1 if hist[i] == @outcome, -1
+ * otherwise, saturating at [@w_min, @w_max]. */
+void perceptron_train(
+        int16_t* w, const uint64_t* hist, int n, bool outcome, int16_t w_min, int16_t w_max);
+
+/* Plain C versions, for reference and for tests. */
+int perceptron_dot_scalar(const int16_t* w, const uint64_t* hist, int n);
+void perceptron_train_scalar(
+        int16_t* w, const uint64_t* hist, int n, bool outcome, int16_t w_min, int16_t w_max);
+
+}  // xiosim::bpred
+}  // xiosim
+
+#endif /* __PERCEPTRON_KERNELS_H__ */
@@ -24,6 +24,8 @@ static std::unordered_map<pid_t, void*> readBuffer_;
  * time we write to any of the unordered maps above. After that,
  * we can just access them lock-free. */
 static XIOSIM_LOCK init_lock_;
+/* Signalled after allocating a thread, for sim threads that got to it first. */
+static XIOSIM_EVENT allocated_;
 
 void InitBufferManagerConsumer(pid_t harness_pid) {
     InitBufferManager(harness_pid);
@@ -46,7 +48,12 @@ void AllocateThreadConsumer(pid_t tid, int buffer_capacity) {
     readBuffer_[tid] = malloc(4096);
     assert(readBuffer_[tid]);
 
-    consumeBuffer_[tid] = new Buffer<handshake_container_t>(buffer_capacity);
+    /* Build the buffer before inserting it, so no one ever sees a NULL entry. */
+    auto buffer = new Buffer<handshake_container_t>(buffer_capacity);
+    auto res = consumeBuffer_.emplace(tid, buffer);
+    if (!res.second)
+        res.first->second = buffer;
+    allocated_.signal();
 }
 
 handshake_container_t* Front(pid_t tid) {
@@ -69,12 +76,25 @@ handshake_container_t* Front(pid_t tid) {
 }
 
 int GetConsumerSize(pid_t tid) {
-    // Another thread might be doing the allocation
-    while (consumeBuffer_[tid] == NULL)
-        ;
+    /* Look the thread up under init_lock_ -- another thread might be
+     * allocating one right now, and rehash the map under us.
+     * If it's not there yet, wait for the allocation. */
+    Buffer<handshake_container_t>* buffer = NULL;
+    while (true) {
+        int32_t ticket = allocated_.ticket();
+        {
+            std::lock_guard<XIOSIM_LOCK> l(init_lock_);
+            auto it = consumeBuffer_.find(tid);
+            if (it != consumeBuffer_.end()) {
+                buffer = it->second;
+                break;
+            }
+        }
+        allocated_.wait(ticket);
+    }
 
-    assert(consumeBuffer_[tid] != NULL);
-    return consumeBuffer_[tid]->size();
+    assert(buffer != NULL);
+    return buffer->size();
 }
 
 void Pop(pid_t tid) { consumeBuffer_[tid]->pop(); }
@@ -2,28 +2,40 @@
 
 SHARED_VAR_DEFINE(MessageQueue, ipcMessageQueue)
 SHARED_VAR_DEFINE(MessageQueue, ipcEarlyMessageQueue)
-SHARED_VAR_DEFINE(AckMessageMap, ackMessages)
-SHARED_VAR_DEFINE(XIOSIM_LOCK, lk_ipcMessageQueue)
-
-static ipc_message_allocator_t* ipc_queue_allocator;
+SHARED_VAR_DEFINE(ipc_ack_slot_t, ackSlots)
+SHARED_VAR_DEFINE(XIOSIM_EVENT, simWakeup)
 
 void InitIPCQueues(void) {
-    ipc_queue_allocator = new ipc_message_allocator_t(global_shm->get_segment_manager());
-
-    SHARED_VAR_INIT(MessageQueue, ipcMessageQueue, *ipc_queue_allocator);
-    SHARED_VAR_INIT(MessageQueue, ipcEarlyMessageQueue, *ipc_queue_allocator);
-    SHARED_VAR_INIT(XIOSIM_LOCK, lk_ipcMessageQueue);
-
-    SHARED_VAR_CONSTRUCT(AckMessageMap, ackMessages);
+    SHARED_VAR_INIT(MessageQueue, ipcMessageQueue);
+    SHARED_VAR_INIT(MessageQueue, ipcEarlyMessageQueue);
+    SHARED_VAR_ARRAY_INIT(ipc_ack_slot_t, ackSlots, MAX_ACK_SLOTS);
+    SHARED_VAR_INIT(XIOSIM_EVENT, simWakeup);
 }
 
-void DeinitIPCQueues(void) {
-    delete ipc_queue_allocator;
+void DeinitIPCQueues(void) {}
+
+/* Grab a free ack slot and mark it with what we'll be waiting on. */
+static int ClaimAckSlot(const ipc_message_t& msg) {
+    while (true) {
+        for (int i = 0; i < MAX_ACK_SLOTS; i++) {
+            int32_t expected = ACK_FREE;
+            if (__atomic_compare_exchange_n(&ackSlots[i].state, &expected, ACK_CLAIMED, false,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                ackSlots[i].id = msg.id;
+                ackSlots[i].arg0 = msg.arg0;
+                __atomic_store_n(&ackSlots[i].state, ACK_WAITING, __ATOMIC_RELEASE);
+                return i;
+            }
+        }
+        /* Every slot has a blocked sender. Some will get acked eventually. */
+        yield();
+    }
 }
 
 void SendIPCMessage(ipc_message_t msg, bool blocking) {
     MessageQueue* q = msg.ConsumableEarly() ? ipcEarlyMessageQueue : ipcMessageQueue;
     msg.blocking = blocking;
+    msg.ack_slot = blocking ? ClaimAckSlot(msg) : -1;
 
 #ifdef IPC_DEBUG
     lk_lock(printing_lock, 1);
@@ -31,20 +43,43 @@ void SendIPCMessage(ipc_message_t msg, bool blocking) {
     lk_unlock(printing_lock);
 #endif
 
-    lk_lock(lk_ipcMessageQueue, 1);
-    q->push_back(msg);
-
-    if (blocking)
-        ackMessages->operator[](msg) = false;
-    lk_unlock(lk_ipcMessageQueue);
+    q->push(msg);
+    /* Sim threads pick up early messages between handshake batches.
+     * Idle ones are asleep, wake them up. */
+    if (msg.ConsumableEarly())
+        simWakeup->signal();
 
     if (blocking) {
-        lk_lock(lk_ipcMessageQueue, 1);
-        while (ackMessages->at(msg) == false) {
-            lk_unlock(lk_ipcMessageQueue);
-            xio_sleep(10);
-            lk_lock(lk_ipcMessageQueue, 1);
-        }
-        lk_unlock(lk_ipcMessageQueue);
+        int32_t* state = &ackSlots[msg.ack_slot].state;
+        while (__atomic_load_n(state, __ATOMIC_ACQUIRE) == ACK_WAITING)
+            xio_futex_wait(state, ACK_WAITING);
+        __atomic_store_n(state, ACK_FREE, __ATOMIC_RELEASE);
+    }
+}
+
+/* Flip @slot from waiting to done, unless someone else beat us to it. */
+static bool TryAck(int slot) {
+    int32_t* state = &ackSlots[slot].state;
+    int32_t expected = ACK_WAITING;
+    if (!__atomic_compare_exchange_n(state, &expected, ACK_DONE, false, __ATOMIC_RELEASE,
+                                     __ATOMIC_RELAXED))
+        return false;
+    xio_futex_wake(state, 1);
+    return true;
+}
+
+void AckIPCMessage(int slot) {
+    assert(slot >= 0 && slot < MAX_ACK_SLOTS);
+    bool acked = TryAck(slot);
+    assert(acked);
+    (void)acked;
+}
+
+void AckIPCMessages(ipc_message_id_t id, int64_t arg0) {
+    for (int i = 0; i < MAX_ACK_SLOTS; i++) {
+        if (__atomic_load_n(&ackSlots[i].state, __ATOMIC_ACQUIRE) != ACK_WAITING)
+            continue;
+        if (ackSlots[i].id == id && ackSlots[i].arg0 == arg0)
+            TryAck(i);
     }
 }
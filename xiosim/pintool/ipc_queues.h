@@ -8,16 +8,15 @@
 #include "xiosim/host.h"
 
 #include "multiprocess_shared.h"
+#include "ipc_ring.h"
 
 struct ipc_message_t;
 
 /* Send an IPC message. The flow now is from multiple producers
  * (different feeders, harness) to possible multiple consumers
  * (threads inside timing_sim). For now, we can get message responses
- * only by blocking messages.
- * XXX: We are assuming only one blocking message with a certain
- * type and parameters at a time. Otherwise, the blocking mechanism
- * will fail silently and graciously. */
+ * only by blocking messages. A blocking sender sleeps on an ack slot
+ * of its own until the message has been processed. */
 void SendIPCMessage(ipc_message_t msg, bool blocking = false);
 
 /* Consume messages from IPC queue until empty.
@@ -64,6 +63,8 @@ struct ipc_message_t {
     /* Does sender wait until message has been *processed*,
      * not only consumed. */
     bool blocking;
+    /* For blocking messages, the ack slot the sender is waiting on. */
+    int32_t ack_slot;
 
     ipc_message_t()
         : id(INVALID_MSG)
@@ -71,7 +72,8 @@ struct ipc_message_t {
         , arg1(0)
         , arg2(0)
         , arg3(0)
-        , blocking(false) {}
+        , blocking(false)
+        , ack_slot(-1) {}
 
     /* Some messages need to be conusmed early in timing_sim.
      * Mostly related to setup. */
@@ -203,23 +205,41 @@ struct ipc_message_t {
                (this->arg2 == rhs.arg2);
     }
 };
-static size_t hash_value(ipc_message_t const& obj) {
-    std::hash<int> hasher;
-    return hasher(obj.id) ^ hasher(obj.arg0);
-}
 
-/* Message queue form calling functions in timing_sim from feeder */
-typedef boost::interprocess::allocator<ipc_message_t,
-                                       boost::interprocess::managed_shared_memory::segment_manager>
-    ipc_message_allocator_t;
-
-typedef boost::interprocess::deque<ipc_message_t, ipc_message_allocator_t> MessageQueue;
+/* Message queue form calling functions in timing_sim from feeder.
+ * Producers wait (yielding) if it ever fills up. */
+const size_t IPC_QUEUE_SIZE = 1024;
+typedef ipc_ring_t<ipc_message_t, IPC_QUEUE_SIZE> MessageQueue;
 SHARED_VAR_DECLARE(MessageQueue, ipcMessageQueue);
 SHARED_VAR_DECLARE(MessageQueue, ipcEarlyMessageQueue);
-/* A response queue to acknowledge recieving blocking messages. */
-typedef xiosim::shared::SharedUnorderedMap<ipc_message_t, bool> AckMessageMap;
-SHARED_VAR_DECLARE(AckMessageMap, ackMessages)
-SHARED_VAR_DECLARE(XIOSIM_LOCK, lk_ipcMessageQueue);
+
+/* Acknowledgements for blocking messages. A sender claims a free slot,
+ * puts its index in the message, and sleeps on @state (a futex) until
+ * the consumer flips it to ACK_DONE. */
+enum ipc_ack_state_t { ACK_FREE, ACK_CLAIMED, ACK_WAITING, ACK_DONE };
+struct ipc_ack_slot_t {
+    int32_t state;
+    /* What we are waiting on, for consumers that ack a group of messages. */
+    ipc_message_id_t id;
+    int64_t arg0;
+
+    ipc_ack_slot_t()
+        : state(ACK_FREE)
+        , id(INVALID_MSG)
+        , arg0(0) {}
+};
+const int MAX_ACK_SLOTS = 256;
+SHARED_VAR_DECLARE(ipc_ack_slot_t, ackSlots);
+
+/* Idle sim threads sleep on this. It gets signalled whenever there might be
+ * something for them to do: an early message, a thread scheduled on a core,
+ * or a request to stop. */
+SHARED_VAR_DECLARE(XIOSIM_EVENT, simWakeup);
+
+/* Wake up the sender waiting on @slot. */
+void AckIPCMessage(int slot);
+/* Wake up all senders waiting on a message like @id(@arg0, ...). */
+void AckIPCMessages(ipc_message_id_t id, int64_t arg0);
 
 extern XIOSIM_LOCK* printing_lock;
 
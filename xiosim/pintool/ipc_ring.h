@@ -0,0 +1,112 @@
+/* ipc_ring.h - Bounded lock-free message ring for shared memory.
+ *
+ * Any number of producers (feeder threads, the harness) and consumers
+ * (simulation threads) can use it concurrently, each from any process that
+ * maps it. Every cell carries a sequence number that says whose turn it is:
+ * a producer may fill cell i on lap L when its sequence is i + L * SIZE, and a
+ * consumer may drain it once the producer has bumped it by one. So producers
+ * and consumers only contend on their own position counter.
+ * (This is D. Vyukov's bounded MPMC queue.)
+ *
+ * Only plain integers and trivially copyable payloads live in the ring, so it
+ * can be placement-constructed in a shared segment.
+ */
+
+#ifndef __IPC_RING_H__
+#define __IPC_RING_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "xiosim/synchronization.h"
+
+template <typename T, size_t SIZE>
+class ipc_ring_t {
+    static_assert((SIZE & (SIZE - 1)) == 0, "ring size must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "ring entries are copied between processes");
+
+  public:
+    ipc_ring_t()
+        : enqueue_pos(0)
+        , dequeue_pos(0) {
+        for (size_t i = 0; i < SIZE; i++)
+            __atomic_store_n(&cells[i].seq, i, __ATOMIC_RELAXED);
+    }
+
+    ipc_ring_t(const ipc_ring_t&) = delete;
+    ipc_ring_t& operator=(const ipc_ring_t&) = delete;
+
+    /* Add @val at the tail. Returns false if the ring is full. */
+    bool try_push(const T& val) {
+        uint64_t pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+        while (true) {
+            cell_t& cell = cells[pos & (SIZE - 1)];
+            uint64_t seq = __atomic_load_n(&cell.seq, __ATOMIC_ACQUIRE);
+            int64_t diff = (int64_t)seq - (int64_t)pos;
+            if (diff == 0) {
+                if (__atomic_compare_exchange_n(&enqueue_pos, &pos, pos + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    cell.data = val;
+                    __atomic_store_n(&cell.seq, pos + 1, __ATOMIC_RELEASE);
+                    return true;
+                }
+                /* @pos got reloaded by the failed CAS */
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    /* Add @val at the tail, waiting for consumers to make room if needed. */
+    void push(const T& val) {
+        while (!try_push(val))
+            yield();
+    }
+
+    /* Remove the head into @val. Returns false if there is nothing (yet). */
+    bool try_pop(T* val) {
+        uint64_t pos = __atomic_load_n(&dequeue_pos, __ATOMIC_RELAXED);
+        while (true) {
+            cell_t& cell = cells[pos & (SIZE - 1)];
+            uint64_t seq = __atomic_load_n(&cell.seq, __ATOMIC_ACQUIRE);
+            int64_t diff = (int64_t)seq - (int64_t)(pos + 1);
+            if (diff == 0) {
+                if (__atomic_compare_exchange_n(&dequeue_pos, &pos, pos + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    *val = cell.data;
+                    __atomic_store_n(&cell.seq, pos + SIZE, __ATOMIC_RELEASE);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = __atomic_load_n(&dequeue_pos, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    /* Cheap check for the common nothing-to-do case: two loads, no writes.
+     * A message that is being pushed right now may or may not show up. */
+    bool empty() const {
+        return __atomic_load_n(&dequeue_pos, __ATOMIC_ACQUIRE) ==
+               __atomic_load_n(&enqueue_pos, __ATOMIC_ACQUIRE);
+    }
+
+  private:
+    struct cell_t {
+        uint64_t seq;
+        T data;
+    };
+
+    /* Keep producers and consumers off each other's cache lines. */
+    uint64_t enqueue_pos;
+    char pad0[64 - sizeof(uint64_t)];
+    uint64_t dequeue_pos;
+    char pad1[64 - sizeof(uint64_t)];
+    cell_t cells[SIZE];
+};
+
+#endif /* __IPC_RING_H__ */
@@ -3,12 +3,14 @@
  * Copyright, Svilen Kanev, 2013
  */
 
-#include <queue>
+#include <algorithm>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <list>
 #include <vector>
 
+#include "ipc_queues.h"
 #include "multiprocess_shared.h"
 
 #include "xiosim/core_const.h"
@@ -32,7 +34,7 @@ struct RunQueue {
 
     XIOSIM_LOCK lk;
     // XXX: SHARED -- lock protects those
-    std::queue<pid_t> q;
+    std::deque<pid_t> q;
     // XXX: END SHARED
 };
 
@@ -49,6 +51,7 @@ static int GetThreadAffinity(pid_t tid);
 static void UpdateSHMCoreThread(int coreID, pid_t tid);
 static void UpdateSHMThreadCore(pid_t tid, int coreID);
 static void RemoveSHMThread(pid_t tid);
+static void NotifyWaitingThread();
 
 struct TCB {
     pid_t tid;
@@ -68,10 +71,15 @@ struct TCB {
      * while the thread is waiting on a queue as well. */
     int run_queue_ID;
 
+    /* Core this thread last went on. Its caches there might still be warm,
+     * which the load balancer can take into account. */
+    int last_coreID;
+
     TCB(pid_t tid)
         : tid(tid)
         , blocked_on(INVALID_THREADID)
-        , run_queue_ID(INVALID_CORE) {}
+        , run_queue_ID(INVALID_CORE)
+        , last_coreID(INVALID_CORE) {}
 };
 static std::map<pid_t, TCB> threads;
 static XIOSIM_LOCK tcb_lk;
@@ -145,8 +153,11 @@ int ScheduleNewThread(pid_t tid, bool check_reschedule) {
     lk_unlock(printing_lock);
 #endif
 
-    run_queues[coreID].q.push(tid);
+    bool waiting = !run_queues[coreID].q.empty();
+    run_queues[coreID].q.push_back(tid);
     lk_unlock(&run_queues[coreID].lk);
+    if (waiting)
+        NotifyWaitingThread();
     return coreID;
 
     /* TODO: UpdateProcessCoreSet if not called from ScheduleProcessThreads,
@@ -197,8 +208,8 @@ static void RequeueSleepers(int coreID) {
             return;
 
         /* Else, a blocked thread gives up its slot. And we are still fair. */
-        run_queues[coreID].q.pop();
-        run_queues[coreID].q.push(curr_head);
+        run_queues[coreID].q.pop_front();
+        run_queues[coreID].q.push_back(curr_head);
 
         /* We've gone a full round around the runQ and found nothing. */
         if (first_tid == run_queues[coreID].q.front()) {
@@ -263,7 +274,7 @@ void DescheduleActiveThread(int coreID) {
 #endif
 
     /* This thread is no more. */
-    run_queues[coreID].q.pop();
+    run_queues[coreID].q.pop_front();
     RemoveSHMThread(tid);
     {
         std::lock_guard<XIOSIM_LOCK> l(tcb_lk);
@@ -292,7 +303,7 @@ void GiveUpCore(int coreID, bool reschedule_thread) {
 #endif
 
     /* This thread gets descheduled. */
-    run_queues[coreID].q.pop();
+    run_queues[coreID].q.pop_front();
 
     pid_t new_tid = GetRealRunQHead(coreID);
     if (new_tid != INVALID_THREADID) {
@@ -323,7 +334,7 @@ void GiveUpCore(int coreID, bool reschedule_thread) {
 
     if (reschedule_thread) {
         /* Reschedule at the back of (possibly empty) runqueue for @coreID. */
-        run_queues[coreID].q.push(tid);
+        run_queues[coreID].q.push_back(tid);
 
 #ifdef SCHEDULER_DEBUG
         lk_lock(printing_lock, tid + 1);
@@ -334,6 +345,7 @@ void GiveUpCore(int coreID, bool reschedule_thread) {
         /* If old thread is requeued behind a new thread, update old's SHM status. */
         if (new_tid != tid && new_tid != INVALID_THREADID) {
             UpdateSHMThreadCore(tid, INVALID_CORE);
+            NotifyWaitingThread();
         }
     } else {
         /* For all we know in this case, old thread will never be scheduled again.
@@ -403,11 +415,26 @@ static void UpdateSHMCoreThread(int coreID, pid_t tid) {
     lk_lock(lk_coreThreads, 1);
     coreThreads[coreID] = tid;
     lk_unlock(lk_coreThreads);
+
+    /* @coreID's sim thread might be asleep waiting for work. */
+    if (tid != INVALID_THREADID)
+        simWakeup->signal();
+}
+
+/* Helper to let idle sim threads know a thread just started waiting on a runQ,
+ * so they can try stealing it. */
+static void NotifyWaitingThread() {
+    if (system_knobs.load_balance)
+        simWakeup->signal();
 }
 
 static void UpdateSHMThreadCore(pid_t tid, int coreID) {
     if (tid == INVALID_THREADID)
         return;
+    if (coreID != INVALID_CORE) {
+        std::lock_guard<XIOSIM_LOCK> l(tcb_lk);
+        threads.at(tid).last_coreID = coreID;
+    }
     lk_lock(lk_coreThreads, 1);
     threadCores->operator[](tid) = coreID;
     lk_unlock(lk_coreThreads);
@@ -476,6 +503,8 @@ void UnblockSleepers(pid_t tid) {
             xiosim::libsim::activate_core(run_queue_ID);
             UpdateSHMThreadCore(blockee, run_queue_ID);
             UpdateSHMCoreThread(run_queue_ID, blockee);
+        } else {
+            NotifyWaitingThread();
         }
     }
 }
@@ -492,7 +521,7 @@ void MigrateThread(pid_t tid, int coreID) {
         assert(run_queues[coreID].q.front() == tid);
         /* Deschedule thread, but don't update it's metadata, so we can do it atomically
          * on schedule. */
-        run_queues[coreID].q.pop();
+        run_queues[coreID].q.pop_front();
         run_queues[coreID].last_reschedule = cores[coreID]->sim_cycle;
         /* Advance the core we're leaving. */
         ScheduleNextUnblockedThread(coreID);
@@ -502,4 +531,129 @@ void MigrateThread(pid_t tid, int coreID) {
     ScheduleNewThread(tid, false);
 }
 
+/* Helper to check if thread @tid is allowed to go on core @coreID. */
+static bool CanRunOn(pid_t tid, int coreID) {
+    int affine_coreID = GetThreadAffinity(tid);
+    return affine_coreID == INVALID_CORE || affine_coreID == coreID;
+}
+
+/* Helper to check that nothing can run on @coreID right now.
+ * Assumes the caller is holding run_queues[@coreID].lk */
+static bool IsCoreIdle(int coreID) {
+    return GetRealRunQHead(coreID) == INVALID_THREADID &&
+           !xiosim::libsim::is_core_active(coreID);
+}
+
+/* Helper to pick a thread waiting on @src_coreID that can go on @dst_coreID.
+ * Never picks the head -- it is (about to be) running.
+ * We take the thread that would wait the longest, i.e. the one closest to the
+ * back of the runQ. With migration_cache_affinity, we'd rather take one that
+ * last ran on @dst_coreID, again the one closest to the back.
+ * Returns the position in the runQ, 0 if there is no candidate.
+ * Assumes the caller is holding run_queues[@src_coreID].lk */
+static size_t PickMigrationCandidate(int src_coreID, int dst_coreID) {
+    auto& q = run_queues[src_coreID].q;
+    size_t res = 0;
+    if (q.empty())
+        return res;
+    for (size_t i = q.size() - 1; i > 0; i--) {
+        pid_t tid = q[i];
+        if (IsThreadBlocked(tid) || !CanRunOn(tid, dst_coreID))
+            continue;
+
+        if (res == 0)
+            res = i;
+        if (!system_knobs.migration_cache_affinity)
+            break;
+
+        int last_coreID;
+        {
+            std::lock_guard<XIOSIM_LOCK> l(tcb_lk);
+            last_coreID = threads.at(tid).last_coreID;
+        }
+        if (last_coreID == dst_coreID)
+            return i;
+    }
+    return res;
+}
+
+/* Helper to move a waiting thread from @src_coreID to @dst_coreID, if the
+ * latter is idle. Returns true if a thread moved. */
+static bool MoveWaitingThread(int src_coreID, int dst_coreID) {
+    assert(src_coreID != dst_coreID);
+    /* Always grab runQ locks in core order, so balancers don't deadlock. */
+    std::lock_guard<XIOSIM_LOCK> l1(run_queues[std::min(src_coreID, dst_coreID)].lk);
+    std::lock_guard<XIOSIM_LOCK> l2(run_queues[std::max(src_coreID, dst_coreID)].lk);
+
+    if (!IsCoreIdle(dst_coreID))
+        return false;
+
+    size_t pos = PickMigrationCandidate(src_coreID, dst_coreID);
+    if (pos == 0)
+        return false;
+
+    auto& src_q = run_queues[src_coreID].q;
+    pid_t tid = src_q[pos];
+    src_q.erase(src_q.begin() + pos);
+    {
+        std::lock_guard<XIOSIM_LOCK> l(tcb_lk);
+        threads.at(tid).run_queue_ID = dst_coreID;
+    }
+
+    /* Blocked threads on @dst_coreID's runQ will get shuffled behind us. */
+    run_queues[dst_coreID].q.push_back(tid);
+    pid_t new_head = GetRealRunQHead(dst_coreID);
+    assert(new_head == tid);
+    (void)new_head;
+    run_queues[dst_coreID].last_reschedule = cores[dst_coreID]->sim_cycle;
+
+    xiosim::libsim::activate_core(dst_coreID);
+    UpdateSHMThreadCore(tid, dst_coreID);
+    UpdateSHMCoreThread(dst_coreID, tid);
+
+    /* Balancers of other cores update these too. */
+    __atomic_fetch_add(&cores[src_coreID]->stat.sched_migrations_out, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cores[dst_coreID]->stat.sched_migrations_in, 1, __ATOMIC_RELAXED);
+
+#ifdef SCHEDULER_DEBUG
+    {
+        std::lock_guard<XIOSIM_LOCK> l(*printing_lock);
+        std::cerr << "Balancing thread " << tid << " from core " << src_coreID << " to core "
+                  << dst_coreID << std::endl;
+    }
+#endif
+    return true;
+}
+
+/* ========================================================================== */
+void BalanceRunQueues(int coreID) {
+    if (!system_knobs.load_balance)
+        return;
+
+    for (int i = 1; i < num_cores; i++) {
+        int dst_coreID = (coreID + i) % num_cores;
+        if (xiosim::libsim::is_core_active(dst_coreID))
+            continue;
+        /* Keep going while we have waiting threads to give away. */
+        if (!MoveWaitingThread(coreID, dst_coreID)) {
+            std::lock_guard<XIOSIM_LOCK> l(run_queues[coreID].lk);
+            if (run_queues[coreID].q.size() < 2)
+                return;
+        }
+    }
+}
+
+/* ========================================================================== */
+bool StealThread(int coreID) {
+    if (!system_knobs.load_balance)
+        return false;
+
+    for (int i = 1; i < num_cores; i++) {
+        int src_coreID = (coreID + i) % num_cores;
+        if (MoveWaitingThread(src_coreID, coreID))
+            return true;
+    }
+    return false;
+}
+
 }  // namespace xiosim
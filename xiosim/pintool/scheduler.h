@@ -61,6 +61,16 @@ void BlockThread(int coreID, pid_t tid, pid_t blocked_on);
  * Different from GiveUpCore(@tid, true), which will always reschedule on the same core */
 void MigrateThread(pid_t tid, int coreID);
 
+/* Hand threads waiting on core @coreID over to idle cores
+ * they are allowed to run on. No-op unless load_balance is set.
+ * Called every scheduler_tick, after @coreID reschedules. */
+void BalanceRunQueues(int coreID);
+
+/* Have idle core @coreID take a waiting thread from another
+ * core's run queue. Returns true if it got one.
+ * No-op unless load_balance is set. */
+bool StealThread(int coreID);
+
 }  // namespace xiosim
 
 #endif /* __SCHEDULER_H__ */
@@ -0,0 +1,97 @@
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "ipc_ring.h"
+
+struct test_msg_t {
+    int producer;
+    int seq;
+};
+
+TEST_CASE("Single-threaded ring", "ipc_ring") {
+    ipc_ring_t<test_msg_t, 8> ring;
+    test_msg_t msg;
+
+    REQUIRE(ring.empty());
+    REQUIRE_FALSE(ring.try_pop(&msg));
+
+    SECTION("FIFO order") {
+        for (int i = 0; i < 5; i++)
+            REQUIRE(ring.try_push({ 0, i }));
+        REQUIRE_FALSE(ring.empty());
+        for (int i = 0; i < 5; i++) {
+            REQUIRE(ring.try_pop(&msg));
+            REQUIRE(msg.seq == i);
+        }
+        REQUIRE(ring.empty());
+    }
+
+    SECTION("Full ring") {
+        for (int i = 0; i < 8; i++)
+            REQUIRE(ring.try_push({ 0, i }));
+        REQUIRE_FALSE(ring.try_push({ 0, 8 }));
+        REQUIRE(ring.try_pop(&msg));
+        REQUIRE(msg.seq == 0);
+        REQUIRE(ring.try_push({ 0, 8 }));
+    }
+
+    SECTION("Wrap around") {
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(ring.try_push({ 0, i }));
+            REQUIRE(ring.try_pop(&msg));
+            REQUIRE(msg.seq == i);
+        }
+        REQUIRE(ring.empty());
+    }
+}
+
+TEST_CASE("Concurrent producers and consumers", "ipc_ring") {
+    const int num_producers = 4;
+    const int num_consumers = 2;
+    const int msgs_per_producer = 100000;
+
+    ipc_ring_t<test_msg_t, 64> ring;
+    std::vector<std::vector<int>> received(num_consumers);
+    /* Catch assertions aren't thread-safe, so consumers just record problems. */
+    std::vector<int> out_of_order(num_consumers, 0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_producers; p++)
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < msgs_per_producer; i++)
+                ring.push({ p, i });
+        });
+    for (int c = 0; c < num_consumers; c++)
+        threads.emplace_back([&ring, &received, &out_of_order, c]() {
+            std::vector<int> last_seq(num_producers, -1);
+            test_msg_t msg;
+            int total = num_producers * msgs_per_producer / num_consumers;
+            while ((int)received[c].size() < total) {
+                if (!ring.try_pop(&msg))
+                    continue;
+                /* Each producer's messages come out in order. */
+                if (msg.seq <= last_seq[msg.producer])
+                    out_of_order[c]++;
+                last_seq[msg.producer] = msg.seq;
+                received[c].push_back(msg.producer * msgs_per_producer + msg.seq);
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+
+    for (int c = 0; c < num_consumers; c++)
+        REQUIRE(out_of_order[c] == 0);
+
+    /* Everything arrived exactly once. */
+    std::vector<bool> seen(num_producers * msgs_per_producer, false);
+    for (auto& msgs : received)
+        for (int id : msgs) {
+            REQUIRE_FALSE(seen[id]);
+            seen[id] = true;
+        }
+    for (bool s : seen)
+        REQUIRE(s);
+    REQUIRE(ring.empty());
+}
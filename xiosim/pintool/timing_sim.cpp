@@ -22,6 +22,8 @@ struct uncore_knobs_t uncore_knobs;
 struct system_knobs_t system_knobs;
 
 static sim_thread_state_t thread_states[xiosim::MAX_CORES];
+/* Signalled by each sim thread on its way out. */
+static XIOSIM_EVENT sim_stopped_event;
 
 inline sim_thread_state_t* get_sim_tls(int coreID) { return &thread_states[coreID]; }
 
@@ -37,6 +39,10 @@ void* SimulatorLoop(void* arg) {
     sim_thread_state_t* tstate = get_sim_tls(coreID);
 
     while (true) {
+        /* Whatever can give us work below signals simWakeup. Grab a ticket before
+         * looking, so we don't sleep through a signal that came in meanwhile. */
+        int32_t wakeup_ticket = simWakeup->ticket();
+
         /* Check kill flag */
         lk_lock(&tstate->lock, 1);
 
@@ -44,6 +50,7 @@ void* SimulatorLoop(void* arg) {
             xiosim::libsim::deactivate_core(coreID);
             tstate->sim_stopped = true;
             lk_unlock(&tstate->lock);
+            sim_stopped_event.signal();
             return NULL;
         }
         lk_unlock(&tstate->lock);
@@ -55,14 +62,16 @@ void* SimulatorLoop(void* arg) {
         // Get the latest thread we are running from the scheduler
         pid_t instrument_tid = GetCoreThread(coreID);
         if (instrument_tid == INVALID_THREADID) {
-            xio_sleep(10);
+            /* Nothing to do here, see if another core has a backlog.
+             * Otherwise, sleep until something changes. */
+            if (!StealThread(coreID))
+                simWakeup->wait(wakeup_ticket);
             continue;
         }
 
         /* Process all handshakes in the in-memory consumeBuffer_ at once.
          * If there are none, the first call to fron will populate the buffer.
-         * Doing this helps reduce contention on the IPCMessageQueue lock, which we
-         * don't need to bang on too frequently. */
+         * Doing this means we check the IPC queues less often. */
         int consumerHandshakes = xiosim::buffer_management::GetConsumerSize(instrument_tid);
         if (consumerHandshakes == 0) {
             xiosim::buffer_management::Front(instrument_tid);
@@ -140,6 +149,7 @@ void* SimulatorLoop(void* arg) {
             // The scheduler has decided it's our time to let go of this core.
             if (NeedsReschedule(coreID)) {
                 GiveUpCore(coreID, true);
+                BalanceRunQueues(coreID);
                 break;
             }
         }
@@ -187,10 +197,13 @@ void StopSimulation(bool kill_sim_threads, int caller_coreID) {
             curr_tstate->is_running = false;
             lk_unlock(&curr_tstate->lock);
         }
+        /* Idle ones are asleep, they need to notice. */
+        simWakeup->signal();
 
-        /* Spin until SimulatorLoop actually finishes */
-        volatile bool is_stopped;
+        /* Wait until SimulatorLoop actually finishes */
+        bool is_stopped;
         do {
+            int32_t stopped_ticket = sim_stopped_event.ticket();
             is_stopped = true;
 
             for (int coreID = 0; coreID < system_knobs.num_cores; coreID++) {
@@ -202,6 +215,8 @@ void StopSimulation(bool kill_sim_threads, int caller_coreID) {
                 is_stopped &= curr_tstate->sim_stopped;
                 lk_unlock(&curr_tstate->lock);
             }
+            if (!is_stopped)
+                sim_stopped_event.wait(stopped_ticket);
         } while (!is_stopped);
     }
 
@@ -259,15 +274,11 @@ void CheckIPCMessageQueue(bool isEarly, int caller_coreID) {
         ipc_message_t ipcMessage;
         MessageQueue* q = isEarly ? ipcEarlyMessageQueue : ipcMessageQueue;
 
-        lk_lock(lk_ipcMessageQueue, 1);
-        if (q->empty()) {
-            lk_unlock(lk_ipcMessageQueue);
+        /* Common case -- nothing there. Don't bother with the atomics. */
+        if (q->empty())
+            break;
+        if (!q->try_pop(&ipcMessage))
             break;
-        }
-
-        ipcMessage = q->front();
-        q->pop_front();
-        lk_unlock(lk_ipcMessageQueue);
 
 #ifdef IPC_DEBUG
         lk_lock(printing_lock, 1);
@@ -356,26 +367,13 @@ void CheckIPCMessageQueue(bool isEarly, int caller_coreID) {
             /* Typically, a blocking message is ack-ed straight away and
              * all is good with the world. */
             if (!ack_list_valid) {
-                lk_lock(lk_ipcMessageQueue, 1);
-                assert(ackMessages->at(ipcMessage) == false);
-                ackMessages->at(ipcMessage) = true;
-                lk_unlock(lk_ipcMessageQueue);
+                AckIPCMessage(ipcMessage.ack_slot);
             } else {
                 /* Some messages are special. They want to ack a (possibly empty)
                  * list of messages of the same type (say, ack everyone after we are
                  * done with the last one). */
-                lk_lock(lk_ipcMessageQueue, 1);
-                for (int unblock_asid : ack_list) {
-                    for (auto ack_it = ackMessages->begin(); ack_it != ackMessages->end();
-                         ++ack_it) {
-                        if (ack_it->first.id == ipcMessage.id &&
-                            ack_it->first.arg0 == unblock_asid) {
-                            assert(ack_it->second == false);
-                            ackMessages->at(ack_it->first) = true;
-                        }
-                    }
-                }
-                lk_unlock(lk_ipcMessageQueue);
+                for (int unblock_asid : ack_list)
+                    AckIPCMessages(ipcMessage.id, unblock_asid);
             }
         }
     }
@@ -0,0 +1,224 @@
+/* power_linear.cpp - Linear surrogate of McPAT's runtime dynamic power. */
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+
+#include "power_linear.h"
+
+/* Count fields translate_stats() fills in for a core. */
+static const size_t core_event_offsets[] = {
+    offsetof(system_core, total_instructions),
+    offsetof(system_core, int_instructions),
+    offsetof(system_core, fp_instructions),
+    offsetof(system_core, branch_instructions),
+    offsetof(system_core, branch_mispredictions),
+    offsetof(system_core, committed_instructions),
+    offsetof(system_core, committed_int_instructions),
+    offsetof(system_core, committed_fp_instructions),
+    offsetof(system_core, load_instructions),
+    offsetof(system_core, store_instructions),
+    offsetof(system_core, ROB_reads),
+    offsetof(system_core, ROB_writes),
+    offsetof(system_core, rename_reads),
+    offsetof(system_core, rename_writes),
+    offsetof(system_core, fp_rename_reads),
+    offsetof(system_core, fp_rename_writes),
+    offsetof(system_core, inst_window_reads),
+    offsetof(system_core, inst_window_writes),
+    offsetof(system_core, inst_window_wakeup_accesses),
+    offsetof(system_core, fp_inst_window_reads),
+    offsetof(system_core, fp_inst_window_writes),
+    offsetof(system_core, fp_inst_window_wakeup_accesses),
+    offsetof(system_core, int_regfile_reads),
+    offsetof(system_core, float_regfile_reads),
+    offsetof(system_core, int_regfile_writes),
+    offsetof(system_core, float_regfile_writes),
+    offsetof(system_core, function_calls),
+    offsetof(system_core, context_switches),
+    offsetof(system_core, ialu_accesses),
+    offsetof(system_core, fpu_accesses),
+    offsetof(system_core, mul_accesses),
+    offsetof(system_core, cdb_alu_accesses),
+    offsetof(system_core, cdb_mul_accesses),
+    offsetof(system_core, cdb_fpu_accesses),
+    offsetof(system_core, itlb.total_accesses),
+    offsetof(system_core, itlb.total_misses),
+    offsetof(system_core, dtlb.total_accesses),
+    offsetof(system_core, dtlb.total_misses),
+    offsetof(system_core, icache.read_accesses),
+    offsetof(system_core, icache.read_misses),
+    offsetof(system_core, dcache.read_accesses),
+    offsetof(system_core, dcache.read_misses),
+    offsetof(system_core, dcache.write_accesses),
+    offsetof(system_core, dcache.write_misses),
+    offsetof(system_core, BTB.read_accesses),
+    offsetof(system_core, BTB.write_accesses),
+};
+
+/* Same for an L2 or L3 (identical layout for these fields). */
+static const size_t cache_event_offsets[][2] = {
+    { offsetof(system_L2, read_accesses), offsetof(system_L3, read_accesses) },
+    { offsetof(system_L2, read_misses), offsetof(system_L3, read_misses) },
+    { offsetof(system_L2, write_accesses), offsetof(system_L3, write_accesses) },
+    { offsetof(system_L2, write_misses), offsetof(system_L3, write_misses) },
+};
+
+/* Calibration interval length, and the count we set each event to. Big enough
+ * to stay away from McPAT's rounding, in the range of real intervals. */
+static const double CALIBRATION_CYCLES = 1e6;
+
+linear_power_model_t::linear_power_model_t(int num_cores, bool private_l2)
+    : num_cores(num_cores)
+    , private_l2(private_l2)
+    , uncore_cycle_coef(0.0) {
+    for (size_t offset : core_event_offsets)
+        core_inputs.push_back({ CORE_FIELD, offset });
+    core_inputs.push_back({ CORE_DUTY_CYCLES, 0 });
+    /* A private L2 is part of the core in McPAT; a shared one (or the L3 behind
+     * private L2s) is uncore. */
+    for (auto& offsets : cache_event_offsets) {
+        if (private_l2) {
+            core_inputs.push_back({ CORE_L2_FIELD, offsets[0] });
+            uncore_inputs.push_back({ UNCORE_FIELD, offsets[1] });
+        } else {
+            uncore_inputs.push_back({ UNCORE_FIELD, offsets[0] });
+        }
+    }
+}
+
+static double& field(void* base, size_t offset) {
+    return *reinterpret_cast<double*>(static_cast<char*>(base) + offset);
+}
+
+static double field(const void* base, size_t offset) {
+    return *reinterpret_cast<const double*>(static_cast<const char*>(base) + offset);
+}
+
+double linear_power_model_t::get_input(const root_system& sys,
+                                       int core,
+                                       const input_t& input) const {
+    switch (input.kind) {
+    case CORE_FIELD:
+        return field(&sys.core[core], input.offset);
+    case CORE_L2_FIELD:
+        return field(&sys.L2[core], input.offset);
+    case CORE_DUTY_CYCLES:
+        return sys.core[core].pipeline_duty_cycle * sys.core[core].total_cycles;
+    case UNCORE_FIELD:
+        return private_l2 ? field(&sys.L3[0], input.offset) : field(&sys.L2[0], input.offset);
+    }
+    return 0.0;
+}
+
+void linear_power_model_t::set_input(root_system& sys,
+                                     int core,
+                                     const input_t& input,
+                                     double value) const {
+    switch (input.kind) {
+    case CORE_FIELD:
+        field(&sys.core[core], input.offset) = value;
+        break;
+    case CORE_L2_FIELD:
+        field(&sys.L2[core], input.offset) = value;
+        break;
+    case CORE_DUTY_CYCLES:
+        sys.core[core].pipeline_duty_cycle = value / sys.core[core].total_cycles;
+        break;
+    case UNCORE_FIELD:
+        if (private_l2)
+            field(&sys.L3[0], input.offset) = value;
+        else
+            field(&sys.L2[0], input.offset) = value;
+        break;
+    }
+}
+
+/* Same as McPAT's: dynamic power = dynamic energy / execution time. */
+double linear_power_model_t::execution_time(const system_core& core) {
+    if (core.clock_rate <= 0)
+        return 0.0;
+    return core.total_cycles / (core.clock_rate * 1e6);
+}
+
+void linear_power_model_t::calibrate(const root_system& sys, const mcpat_fn_t& run_mcpat) {
+    const double N = CALIBRATION_CYCLES;
+    size_t n_core = core_inputs.size();
+    size_t n_uncore = uncore_inputs.size();
+
+    /* root_system is big; keep it off the stack. */
+    std::unique_ptr<root_system> base(new root_system);
+    std::unique_ptr<root_system> probe(new root_system);
+    memcpy(base.get(), &sys, sizeof(sys));
+
+    /* Baseline: N cycles of no activity. */
+    base->total_cycles = N;
+    for (int c = 0; c < num_cores; c++) {
+        base->core[c].total_cycles = N;
+        base->core[c].busy_cycles = N;
+        base->core[c].idle_cycles = 0;
+        for (auto& input : core_inputs)
+            set_input(*base, c, input, 0.0);
+    }
+    for (auto& input : uncore_inputs)
+        set_input(*base, 0, input, 0.0);
+
+    std::vector<double> base_rtp(num_cores), rtp(num_cores);
+    double base_uncore, uncore;
+    run_mcpat(*base, base_rtp.data(), &base_uncore);
+
+    core_cycle_coefs.resize(num_cores);
+    for (int c = 0; c < num_cores; c++)
+        core_cycle_coefs[c] = base_rtp[c] * execution_time(base->core[c]) / N;
+    uncore_cycle_coef = base_uncore / N;
+
+    /* Cores don't interact in McPAT, so probe one event on all cores at once. */
+    core_coefs.assign(num_cores * n_core, 0.0);
+    uncore_core_coefs.assign(n_core, 0.0);
+    for (size_t i = 0; i < n_core; i++) {
+        memcpy(probe.get(), base.get(), sizeof(*base));
+        for (int c = 0; c < num_cores; c++)
+            set_input(*probe, c, core_inputs[i], N);
+        run_mcpat(*probe, rtp.data(), &uncore);
+        for (int c = 0; c < num_cores; c++)
+            core_coefs[c * n_core + i] =
+                    (rtp[c] - base_rtp[c]) * execution_time(probe->core[c]) / N;
+        uncore_core_coefs[i] = (uncore - base_uncore) / (N * num_cores);
+    }
+
+    uncore_coefs.assign(n_uncore, 0.0);
+    for (size_t i = 0; i < n_uncore; i++) {
+        memcpy(probe.get(), base.get(), sizeof(*base));
+        set_input(*probe, 0, uncore_inputs[i], N);
+        run_mcpat(*probe, rtp.data(), &uncore);
+        uncore_coefs[i] = (uncore - base_uncore) / N;
+    }
+}
+
+void linear_power_model_t::estimate(const root_system& sys,
+                                    double* cores_rtp,
+                                    double* uncore_rtp) const {
+    assert(!core_cycle_coefs.empty());
+    size_t n_core = core_inputs.size();
+    std::vector<double> x(n_core);
+
+    double uncore = uncore_cycle_coef * sys.total_cycles;
+    for (int c = 0; c < num_cores; c++) {
+        for (size_t i = 0; i < n_core; i++)
+            x[i] = get_input(sys, c, core_inputs[i]);
+
+        const double* coefs = &core_coefs[c * n_core];
+        double energy = core_cycle_coefs[c] * sys.core[c].total_cycles;
+        for (size_t i = 0; i < n_core; i++)
+            energy += coefs[i] * x[i];
+        for (size_t i = 0; i < n_core; i++)
+            uncore += uncore_core_coefs[i] * x[i];
+
+        double time = execution_time(sys.core[c]);
+        cores_rtp[c] = (time > 0.0) ? energy / time : 0.0;
+    }
+
+    for (size_t i = 0; i < uncore_inputs.size(); i++)
+        uncore += uncore_coefs[i] * get_input(sys, 0, uncore_inputs[i]);
+    *uncore_rtp = uncore;
+}
@@ -0,0 +1,61 @@
+/* power_linear.h - Linear surrogate of McPAT's runtime dynamic power.
+ *
+ * McPAT's dynamic energy for an interval is, to a very good approximation,
+ * linear in the access counts we feed it (per-access energies times counts,
+ * plus per-cycle clock/pipeline energy). We calibrate those per-event energies
+ * once, by running McPAT on a handful of synthetic inputs, and then estimate
+ * each interval as a dot product over the same McPAT input fields that
+ * core_power_t::translate_stats() fills in.
+ */
+
+#ifndef __POWER_LINEAR_H__
+#define __POWER_LINEAR_H__
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "third_party/mcpat/XML_Parse.h"
+
+class linear_power_model_t {
+  public:
+    /* Runs full McPAT on @sys, returning per-core dynamic power and uncore
+     * dynamic power in the same units as mcpat_compute_energy(). */
+    typedef std::function<void(const root_system& sys, double* cores_rtp, double* uncore_rtp)>
+            mcpat_fn_t;
+
+    linear_power_model_t(int num_cores, bool private_l2);
+
+    /* Fit the coefficients around the McPAT input @sys (params already
+     * translated). Takes one McPAT run per modeled event. */
+    void calibrate(const root_system& sys, const mcpat_fn_t& run_mcpat);
+
+    /* Estimate power for the interval described by @sys. */
+    void estimate(const root_system& sys, double* cores_rtp, double* uncore_rtp) const;
+
+  private:
+    /* Where an event count lives in the McPAT input. */
+    enum input_kind_t { CORE_FIELD, CORE_L2_FIELD, CORE_DUTY_CYCLES, UNCORE_FIELD };
+    struct input_t {
+        input_kind_t kind;
+        size_t offset;  // Byte offset of a double in its struct.
+    };
+
+    double get_input(const root_system& sys, int core, const input_t& input) const;
+    void set_input(root_system& sys, int core, const input_t& input, double value) const;
+    static double execution_time(const system_core& core);
+
+    int num_cores;
+    bool private_l2;
+    std::vector<input_t> core_inputs;    // One set per core.
+    std::vector<input_t> uncore_inputs;  // Shared L2 or L3.
+
+    /* Energy per event, row-major: core_coefs[core * core_inputs.size() + i]. */
+    std::vector<double> core_coefs;
+    std::vector<double> core_cycle_coefs;     // Energy per core cycle, at no activity.
+    std::vector<double> uncore_core_coefs;    // Uncore power per core event (any core).
+    std::vector<double> uncore_coefs;         // Uncore power per uncore event.
+    double uncore_cycle_coef;                 // Uncore power per uncore cycle.
+};
+
+#endif /* __POWER_LINEAR_H__ */
@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <cmath>
+#include <string>
 
 #include "core_const.h"
 #include "host.h"
@@ -26,8 +27,10 @@
 #include "zesto-MC.h"
 #include "zesto-power.h"
 #include "zesto-dvfs.h"
+#include "zesto-pipeline.h"
 #include "ztrace.h"
 
+#include "checkpoint.h"
 #include "synchronization.h"
 #include "libsim.h"
 
@@ -51,11 +54,15 @@ static double sync_interval;
 static int heartbeat_count = 0;
 static int deadlock_count = 0;
 
+/* Pipeline model of all cores. Selects the simulate_handshake() specialization. */
+static pipeline_model_t pipeline_model;
+
 static void sim_drain_pipe(int coreID);
 
 void sim_loop_init(void) {
     // Time between updating global state (uncore, different nocs)
     sync_interval = std::min(1e-3 / uncore_knobs.LLC_speed, 1e-3 / cores[0]->memory.mem_repeater->speed);
+    pipeline_model = pipeline_model_parse(core_knobs.model);
 }
 
 static void global_step(void) {
@@ -119,6 +126,12 @@ static void global_step(void) {
             compute_rtp_power();
         }
 
+        /* interval statistics */
+        if ((system_knobs.sampling.interval > 0) &&
+            (uncore->sim_cycle % system_knobs.sampling.interval == 0)) {
+            sample_stats();
+        }
+
         if (system_knobs.dvfs_interval > 0) {
             for (int i = 0; i < system_knobs.num_cores; i++) {
                 if (cores[i]->sim_cycle >= cores[i]->vf_controller->next_invocation) {
@@ -156,7 +169,9 @@ static void global_step(void) {
 // Returns true if another instruction can be fetched in the same cycle
 static bool sim_main_slave_fetch_insn(int coreID) { return cores[coreID]->fetch->do_fetch(); }
 
-static void sim_main_slave_pre_pin(int coreID) {
+/* Advances the core's local clock and, if it's time, synchronizes with the uncore.
+ * Returns false if all cores got deactivated while we were waiting. */
+static bool sim_main_slave_sync(int coreID) {
     volatile int cores_finished_cycle = 0;
     volatile int cores_active = 0;
 
@@ -211,8 +226,14 @@ static void sim_main_slave_pre_pin(int coreID) {
             } while (true);
 
             /* Process shared state once all cores are gathered here. */
+            tick_t prev_cpu_cycles = uncore->default_cpu_cycles;
             global_step();
 
+            /* Whatever time passed, inactive cores spent idle. */
+            for (int i = 0; i < system_knobs.num_cores; i++)
+                if (!cores[i]->active)
+                    cores[i]->stat.idle_cycles += uncore->default_cpu_cycles - prev_cpu_cycles;
+
             /* HACKEDY HACKEDY HACK */
             /* Non-active cores should still step their private caches because there might
              * be accesses scheduled there from the repeater network */
@@ -244,7 +265,7 @@ static void sim_main_slave_pre_pin(int coreID) {
                         min_coreID, "Returning from step loop looking suspicious %d", coreID);
                     cores[coreID]->oracle->consumed = true;
                     lk_unlock(&cycle_lock);
-                    return;
+                    return false;
                 }
 
             non_master_core:
@@ -256,41 +277,27 @@ static void sim_main_slave_pre_pin(int coreID) {
             lk_unlock(&cycle_lock);
         }
     }
+    return true;
+}
 
-    step_core_PF_controllers(cores[coreID]);
-
-    cores[coreID]->commit->IO_step(); /* IO cores only */  // UGLY UGLY UGLY
-
-    /* all memory processed here */
-    // XXX: RR
-    cores[coreID]->exec->LDST_exec();
-
-    cores[coreID]->commit->step(); /* OoO cores only */
-
-    cores[coreID]->commit->pre_commit_step(); /* IO cores only */
-
-    cores[coreID]->exec->step();     /* IO cores only */
-    cores[coreID]->exec->ALU_exec(); /* OoO cores only */
-
-    cores[coreID]->exec->LDQ_schedule();
-
-    cores[coreID]->exec->RS_schedule(); /* OoO cores only */
-
-    cores[coreID]->alloc->step();
+template <pipeline_model_t model>
+static void sim_main_slave_pre_pin(int coreID) {
+    if (!sim_main_slave_sync(coreID))
+        return;
 
-    cores[coreID]->decode->step();
+    step_core_PF_controllers(cores[coreID]);
 
-    /* round-robin on which cache to process first so that one core
-       doesn't get continual priority over the others for L2 access */
+    /* all pipeline stages, in reverse order */
     // XXX: RR
-    cores[coreID]->fetch->post_fetch();
+    core_pipeline_t<model>::step(cores[coreID]);
 }
 
-void sim_main_slave_post_pin(int coreID) {
+template <pipeline_model_t model>
+static void sim_main_slave_post_pin(int coreID) {
     /* round-robin on which cache to process first so that one core
        doesn't get continual priority over the others for L2 access */
     // XXX: RR
-    cores[coreID]->fetch->pre_fetch();
+    core_pipeline_t<model>::pre_fetch(cores[coreID]);
 
     /* this is done last in the cycle so that prefetch requests have the
        lowest priority when competing for queues, buffers, etc. */
@@ -319,8 +326,8 @@ void sim_main_slave_post_pin(int coreID) {
     }
 }
 
-void simulate_handshake(int coreID, handshake_container_t* handshake) {
-    assert(coreID >= 0 && coreID < system_knobs.num_cores);
+template <pipeline_model_t model>
+static void simulate_handshake(int coreID, handshake_container_t* handshake) {
     struct core_t* core = cores[coreID];
     bool slice_start = handshake->flags.isFirstInsn;
 
@@ -411,10 +418,10 @@ void simulate_handshake(int coreID, handshake_container_t* handshake) {
         }
 
         /* Ok, we can't fetch more, wrap this cycle up. */
-        sim_main_slave_post_pin(coreID);
+        sim_main_slave_post_pin<model>(coreID);
 
         /* This is already next cycle, up to fetch. */
-        sim_main_slave_pre_pin(coreID);
+        sim_main_slave_pre_pin<model>(coreID);
 
         /* Re-check for nuke recoveries (they could happen here if jeclear_delay == 0). */
         nuke_recovery = core->oracle->on_nuke_recovery_path();
@@ -427,6 +434,26 @@ void simulate_handshake(int coreID, handshake_container_t* handshake) {
              core->oracle->is_draining());
 }
 
+void simulate_handshake(int coreID, handshake_container_t* handshake) {
+    assert(coreID >= 0 && coreID < system_knobs.num_cores);
+    /* Dispatch once per handshake, so that the per-cycle stage sequence
+     * is statically bound for the configured pipeline model. */
+    switch (pipeline_model) {
+    case pipeline_model_t::DPM:
+        simulate_handshake<pipeline_model_t::DPM>(coreID, handshake);
+        break;
+    case pipeline_model_t::IO_DPM:
+        simulate_handshake<pipeline_model_t::IO_DPM>(coreID, handshake);
+        break;
+    case pipeline_model_t::STM:
+        simulate_handshake<pipeline_model_t::STM>(coreID, handshake);
+        break;
+    case pipeline_model_t::NONE:
+        simulate_handshake<pipeline_model_t::NONE>(coreID, handshake);
+        break;
+    }
+}
+
 void deactivate_core(int coreID) {
     assert(coreID >= 0 && coreID < system_knobs.num_cores);
     ZTRACE_PRINT(coreID, "deactivate %d\n", coreID);
@@ -481,6 +508,58 @@ static void sim_drain_pipe(int coreID) {
         core->memory.mem_repeater->flush(core->asid, NULL);
 }
 
+/* Call @f(key, cache) for every cache we checkpoint. */
+template <typename F>
+static void for_each_ckpt_cache(F f) {
+    for (int i = 0; i < system_knobs.num_cores; i++) {
+        auto& mem = cores[i]->memory;
+        std::string prefix = "c" + std::to_string(i) + ".";
+        for (auto cp : { mem.IL1.get(), mem.ITLB.get(), mem.DL1.get(), mem.DL2.get(),
+                         mem.DTLB.get(), mem.DTLB2.get() })
+            if (cp)
+                f(prefix + cp->name, cp);
+    }
+    f(std::string("LLC"), uncore->LLC.get());
+}
+
+void save_checkpoint(const char* fname) {
+    xiosim::checkpoint::writer_t ckpt;
+
+    for (int i = 0; i < system_knobs.num_cores; i++)
+        sim_drain_pipe(i);
+
+    xiosim::memory::save(ckpt, "memory");
+    for (int i = 0; i < system_knobs.num_cores; i++)
+        cores[i]->fetch->bpred->save(ckpt, "c" + std::to_string(i) + ".bpred");
+    for_each_ckpt_cache([&](const std::string& key, struct cache_t* cp) {
+        cache_save(cp, ckpt, key);
+    });
+    ckpt.begin_section("dram", uncore_knobs.dram_opt_string);
+    dram->save(ckpt);
+
+    ckpt.write(fname);
+    fprintf(stderr, "sim: saved checkpoint %s\n", fname);
+}
+
+void restore_checkpoint(const char* fname) {
+    xiosim::checkpoint::reader_t ckpt(fname);
+
+    xiosim::memory::restore(ckpt, "memory");
+    for (int i = 0; i < system_knobs.num_cores; i++)
+        cores[i]->fetch->bpred->restore(ckpt, "c" + std::to_string(i) + ".bpred");
+    for_each_ckpt_cache([&](const std::string& key, struct cache_t* cp) {
+        cache_restore(cp, ckpt, key);
+    });
+    if (ckpt.begin_section("dram", uncore_knobs.dram_opt_string)) {
+        dram->restore(ckpt);
+        ckpt.end_section();
+    }
+
+    for (auto& key : ckpt.unused_sections())
+        fprintf(stderr, "warning: checkpoint section %s has no matching structure\n", key.c_str());
+    fprintf(stderr, "sim: restored checkpoint %s\n", fname);
+}
+
 void simulate_warmup(int asid, md_addr_t addr, bool is_write) {
     struct core_t* core = cores[0];
 
@@ -3,5 +3,11 @@ namespace libsim {
 
 void sim_loop_init(void);
 
+/* Drain all pipelines and write the warmed state of the memory hierarchy,
+ * predictors and page tables to checkpoint @fname. */
+void save_checkpoint(const char* fname);
+/* Load whatever state in checkpoint @fname matches the current configuration. */
+void restore_checkpoint(const char* fname);
+
 }  // xiosim::libsim
 }  // xiosim
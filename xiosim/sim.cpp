@@ -13,12 +13,14 @@
 #include <sys/io.h>
 
 #include <map>
+#include <string>
 #include <cstddef>
 
 #include "core_const.h"
 #include "host.h"
 #include "misc.h"
 #include "memory.h"
+#include "stat_sampler.h"
 #include "stats.h"
 #include "sim.h"
 #include "slices.h"
@@ -50,6 +52,9 @@ xiosim::stats::StatsDatabase* sim_sdb;
 /* power stats database */
 xiosim::stats::StatsDatabase* rtp_sdb;
 
+/* interval samples of sim_sdb stats */
+static xiosim::stats::StatsSampler* sampler;
+
 /* microarchitecture state */
 struct core_t** cores = NULL;
 
@@ -64,6 +69,7 @@ namespace libsim {
 
 static void create_modules(void);
 static void sim_print_stats(FILE* fd);
+static void dump_samples(void);
 void on_assert_fail(int coreID);
 
 void init() {
@@ -96,7 +102,7 @@ void init() {
     register_assert_fail_handler(on_assert_fail);
 
     /* Initialize virtual memory */
-    xiosim::memory::init(*num_processes);
+    xiosim::memory::init(*num_processes, system_knobs.huge_pages);
 
     /* initialize all simulation modules */
     create_modules();
@@ -104,6 +110,10 @@ void init() {
     /* initialize simulator loop state */
     sim_loop_init();
 
+    /* start from a warmed-up checkpoint */
+    if (strlen(system_knobs.checkpoint_restore))
+        restore_checkpoint(system_knobs.checkpoint_restore);
+
     /* register all simulator stats */
     sim_sdb = stat_new();
     sim_reg_stats(sim_sdb);
@@ -113,6 +123,10 @@ void init() {
     sim_reg_stats(rtp_sdb);
     stat_save_stats(rtp_sdb);
 
+    if (system_knobs.sampling.interval > 0)
+        sampler = new xiosim::stats::StatsSampler(
+                sim_sdb, system_knobs.sampling.stats, system_knobs.sampling.max_samples);
+
     /* record start of execution time, used in rate stats */
     time_t sim_start_time = time((time_t*)NULL);
 
@@ -130,17 +144,29 @@ void init() {
 }
 
 void deinit() {
+    /* dump interval samples, before slice scaling touches the counters */
+    if (sampler) {
+        dump_samples();
+        delete sampler;
+        sampler = NULL;
+    }
+
     /* scale stats if running multiple simulation slices */
     scale_all_slices();
 
     /* print simulator stats */
     sim_print_stats(stderr);
+    dump_structured_stats(sim_sdb, system_knobs.sim_simout ? system_knobs.sim_simout : "sim.out");
     if (system_knobs.power.compute) {
         stat_save_stats(sim_sdb);
         compute_power(sim_sdb, true);
         deinit_power();
     }
 
+    /* stats are done -- drain the pipes and checkpoint the warm state */
+    if (strlen(system_knobs.checkpoint_save))
+        save_checkpoint(system_knobs.checkpoint_save);
+
     repeater_shutdown(core_knobs.exec.repeater_opt_str);
 
     /* If captured, print out ztrace */
@@ -319,10 +345,45 @@ void sim_print_stats(FILE* fd) {
 
 void compute_rtp_power(void) {
     stat_save_stats_delta(rtp_sdb);  // Store delta values for translation
-    compute_power(rtp_sdb, false);
+    compute_power_async(rtp_sdb);
     stat_save_stats(rtp_sdb);  // Create new checkpoint for next delta
 }
 
+void sample_stats(void) {
+    sampler->sample(uncore->sim_cycle);
+}
+
+void sample_counters_reset(void) {
+    if (sampler)
+        sampler->counters_reset();
+}
+
+static void dump_samples(void) {
+    bool binary = !strcmp(system_knobs.sampling.format, "binary");
+    FILE* fd = fopen(system_knobs.sampling.filename, binary ? "wb" : "w");
+    if (fd == NULL)
+        fatal("couldn't open sample file %s", system_knobs.sampling.filename);
+    if (binary)
+        sampler->dump_binary(fd);
+    else
+        sampler->dump_csv(fd);
+    fclose(fd);
+}
+
+void dump_structured_stats(xiosim::stats::StatsDatabase* sdb, const char* base_name) {
+    const char* format = system_knobs.structured_stats;
+    if (!strcmp(format, "none"))
+        return;
+
+    bool binary = !strcmp(format, "binary");
+    std::string filename = std::string(base_name) + (binary ? ".stats" : ".json");
+    FILE* fd = fopen(filename.c_str(), binary ? "wb" : "w");
+    if (fd == NULL)
+        fatal("couldn't open structured stats file %s", filename.c_str());
+    stat_dump_stats(sdb, format, fd);
+    fclose(fd);
+}
+
 /* On assertion failure, dump ztrace. Potentially spin so we can attach a debugger. */
 void on_assert_fail(int coreID) {
     if (coreID != xiosim::INVALID_CORE) {
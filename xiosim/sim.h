@@ -12,6 +12,12 @@ namespace libsim {
 /* register simulation statistics */
 void sim_reg_stats(xiosim::stats::StatsDatabase* sdb);
 void compute_rtp_power(void);
+/* take a snapshot of the sampled stats (see system_cfg.sampling_cfg) */
+void sample_stats(void);
+/* tell the sampler that the stat counters are about to be reset */
+void sample_counters_reset(void);
+/* write @sdb to @base_name.json or @base_name.stats (see system_cfg.structured_stats) */
+void dump_structured_stats(xiosim::stats::StatsDatabase* sdb, const char* base_name);
 
 }  // xiosim::libsim
 }  // xiosim
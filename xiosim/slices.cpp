@@ -38,7 +38,8 @@ void start_slice(unsigned int slice_num) {
     /* create stats database for this slice */
     xiosim::stats::StatsDatabase* new_stat_db = stat_new();
 
-    /* register new database with stat counters */
+    /* register new database with stat counters, which resets them */
+    xiosim::libsim::sample_counters_reset();
     xiosim::libsim::sim_reg_stats(new_stat_db);
 
     all_stats.push_back(new_stat_db);
@@ -95,6 +96,7 @@ void end_slice(unsigned int slice_num,
         FILE* curr_fd = freopen(curr_filename, "w", stderr);
         if (curr_fd != NULL) {
             stat_print_stats(curr_sdb, stderr);
+            xiosim::libsim::dump_structured_stats(curr_sdb, curr_filename);
             if (system_knobs.power.compute)
                 compute_power(curr_sdb, true);
             fclose(curr_fd);
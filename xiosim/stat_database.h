@@ -219,6 +219,38 @@ class StatsDatabase {
         }
     }
 
+    /* Structured output of the same stats print_all_stats() prints.
+     * See stat_format.h for the layouts. Unnamed stats (notes) are skipped. */
+    void dump_json(FILE* fd) {
+        fprintf(fd, "{\"version\": %u, \"weight\": ", STAT_FORMAT_VERSION);
+        write_json_number(fd, slice_weight);
+        fputs(", \"stats\": [\n", fd);
+        bool first = true;
+        for (auto stat : stat_list) {
+            if (!is_dumped(stat))
+                continue;
+            if (!first)
+                fputs(",\n", fd);
+            stat->write_json(fd);
+            first = false;
+        }
+        fputs("\n]}\n", fd);
+    }
+
+    void dump_binary(FILE* fd) {
+        uint32_t num_stats = 0;
+        for (auto stat : stat_list)
+            num_stats += is_dumped(stat);
+
+        const char magic[] = "XIOSTAT1";
+        fwrite(magic, 1, sizeof(magic) - 1, fd);
+        write_binary_value<double>(fd, slice_weight);
+        write_binary_value<uint32_t>(fd, num_stats);
+        for (auto stat : stat_list)
+            if (is_dumped(stat))
+                stat->write_binary(fd);
+    }
+
     // Scale all stats by slice_weight.
     void scale_all_stats() {
         for (auto stat : stat_list) {
@@ -258,6 +290,8 @@ class StatsDatabase {
     double slice_weight;
 
   private:
+    bool is_dumped(BaseStatistic* stat) { return stat->is_printed() && !stat->get_name().empty(); }
+
     /* To act as a heterogeneous container for Statistic<T>, Distribution, and
      * Formula types, this vector stores pointers to BaseStatistic objects. From
      * the StatsDatabase class, all that is required of each BaseStatistic
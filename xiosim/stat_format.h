@@ -0,0 +1,145 @@
+/* Structured (JSON and binary) output of statistics.
+ *
+ * JSON: {"version": 1, "weight": <slice weight>, "stats": [<stat>, ...]}, where
+ * every stat is an object with "name", "desc", "type" and type-specific fields:
+ *   "int", "float", "formula": "value"
+ *   "formula": also "expr", e.g. "({c0.commit_insn} / {c0.sim_cycle})", so that
+ *              formulas can be re-evaluated over merged (e.g. per-slice) stats
+ *   "string": "value" (a string)
+ *   "distribution": "counts" (list), "labels" (list, optional), "overflows"
+ *   "histogram": "counts" (list of [key, count] pairs)
+ *
+ * Binary, little-endian:
+ *   char magic[8] = "XIOSTAT1"; double weight; uint32_t num_stats;
+ *   num_stats x { uint8_t type; string name; string desc; payload }
+ * with strings stored as uint32_t length + bytes, and payloads:
+ *   STAT_INT: int64_t; STAT_FLOAT, STAT_FORMULA: double; STAT_STRING: string
+ *   STAT_DISTRIBUTION: uint32_t n; uint32_t overflows; uint64_t counts[n];
+ *                      uint8_t has_labels; [string labels[n]]
+ *   STAT_HISTOGRAM: uint32_t n; n x { uint64_t key; uint64_t count; }
+ *
+ * scripts/xiosim_stat.py reads both.
+ */
+
+#ifndef __STAT_FORMAT_H__
+#define __STAT_FORMAT_H__
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+namespace xiosim {
+namespace stats {
+
+const uint32_t STAT_FORMAT_VERSION = 1;
+
+enum stat_type_t : uint8_t {
+    STAT_INT,
+    STAT_FLOAT,
+    STAT_STRING,
+    STAT_DISTRIBUTION,
+    STAT_HISTOGRAM,
+    STAT_FORMULA,
+};
+
+inline const char* stat_type_name(stat_type_t type) {
+    switch (type) {
+    case STAT_INT:
+        return "int";
+    case STAT_FLOAT:
+        return "float";
+    case STAT_STRING:
+        return "string";
+    case STAT_DISTRIBUTION:
+        return "distribution";
+    case STAT_HISTOGRAM:
+        return "histogram";
+    case STAT_FORMULA:
+        return "formula";
+    }
+    return "unknown";
+}
+
+inline void write_json_string(FILE* fd, const std::string& str) {
+    fputc('"', fd);
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            fputs("\\\"", fd);
+            break;
+        case '\\':
+            fputs("\\\\", fd);
+            break;
+        case '\n':
+            fputs("\\n", fd);
+            break;
+        case '\t':
+            fputs("\\t", fd);
+            break;
+        default:
+            if ((unsigned char)c < 0x20)
+                fprintf(fd, "\\u%04x", c);
+            else
+                fputc(c, fd);
+        }
+    }
+    fputc('"', fd);
+}
+
+/* JSON has no NaN or infinity. */
+inline void write_json_number(FILE* fd, double value) {
+    if (std::isfinite(value))
+        fprintf(fd, "%.17g", value);
+    else
+        fputs("null", fd);
+}
+
+/* Enough digits to round-trip a float, without double noise. */
+inline void write_json_number(FILE* fd, float value) {
+    if (std::isfinite(value))
+        fprintf(fd, "%.9g", value);
+    else
+        fputs("null", fd);
+}
+
+inline void write_json_number(FILE* fd, int64_t value) { fprintf(fd, "%" PRId64, value); }
+
+/* Opens a stat object and writes the common fields. The caller adds its own
+ * fields (each starting with a comma) and closes the object. */
+inline void write_json_header(FILE* fd,
+                              stat_type_t type,
+                              const std::string& name,
+                              const std::string& desc) {
+    fputs("{\"name\": ", fd);
+    write_json_string(fd, name);
+    fputs(", \"desc\": ", fd);
+    write_json_string(fd, desc);
+    fprintf(fd, ", \"type\": \"%s\"", stat_type_name(type));
+}
+
+template <typename T>
+inline void write_binary_value(FILE* fd, T value) {
+    static_assert(std::is_arithmetic<T>::value, "only raw numbers");
+    fwrite(&value, sizeof(value), 1, fd);
+}
+
+inline void write_binary_string(FILE* fd, const std::string& str) {
+    write_binary_value<uint32_t>(fd, str.size());
+    fwrite(str.data(), 1, str.size(), fd);
+}
+
+inline void write_binary_header(FILE* fd,
+                                stat_type_t type,
+                                const std::string& name,
+                                const std::string& desc) {
+    write_binary_value<uint8_t>(fd, type);
+    write_binary_string(fd, name);
+    write_binary_string(fd, desc);
+}
+
+}  // namespace stats
+}  // namespace xiosim
+
+#endif /* __STAT_FORMAT_H__ */
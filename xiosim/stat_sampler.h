@@ -0,0 +1,237 @@
+/* Interval sampling of statistics.
+ *
+ * A StatsSampler takes a snapshot of a subset of the scalar statistics in a
+ * StatsDatabase on every call to sample() (the simulator does that every N
+ * cycles) and stores it in a preallocated, column-major buffer. When the buffer
+ * fills up, every other snapshot is dropped and the sampling interval doubles,
+ * so memory stays bounded on arbitrarily long runs.
+ *
+ * Snapshots are cumulative; dumps report per-interval deltas. When the sampled
+ * counters get reset (a new StatsDatabase registering them at a slice boundary
+ * sets them back to their initial values), the owner has to call
+ * counters_reset() first, so snapshots keep counting from where they were.
+ * Formulas are not
+ * touched while sampling. At dump time, each interval's deltas are loaded into
+ * the sampled statistics and the formulas are evaluated on them, so a formula
+ * only makes sense per interval if all the statistics it refers to are sampled.
+ */
+
+#ifndef __STAT_SAMPLER_H__
+#define __STAT_SAMPLER_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "expression_impl.h"
+#include "stat_database.h"
+#include "statistic.h"
+
+namespace xiosim {
+namespace stats {
+
+class StatsSampler {
+  public:
+    /* Track @stat_names from @sdb, keeping at most @capacity snapshots.
+     * Unknown names and unsupported statistic types (strings, distributions)
+     * are reported and skipped. */
+    StatsSampler(StatsDatabase* sdb, const std::vector<std::string>& stat_names, size_t capacity)
+        : capacity(capacity + (capacity & 1))
+        , stride(1)
+        , num_calls(0)
+        , num_samples(0) {
+        if (this->capacity < 2)
+            this->capacity = 2;
+
+        for (auto& name : stat_names) {
+            BaseStatistic* stat = sdb->get_statistic(name);
+            if (stat == nullptr) {
+                fprintf(stderr, "Warning: can't sample unknown statistic %s\n", name.c_str());
+                continue;
+            }
+            if (Formula* formula = dynamic_cast<Formula*>(stat)) {
+                formulas.push_back(formula);
+                continue;
+            }
+            if (!(try_add_column<int>(stat) || try_add_column<unsigned int>(stat) ||
+                  try_add_column<int64_t>(stat) || try_add_column<uint64_t>(stat) ||
+                  try_add_column<float>(stat) || try_add_column<double>(stat)))
+                fprintf(stderr, "Warning: can't sample non-scalar statistic %s\n", name.c_str());
+        }
+
+        cycles.resize(this->capacity);
+        data.resize(this->capacity * columns.size());
+        baseline.resize(columns.size());
+        offset.resize(columns.size());
+        for (size_t c = 0; c < columns.size(); c++)
+            baseline[c] = columns[c].read(columns[c].stat);
+    }
+
+    /* The sampled counters are about to go back to their initial values.
+     * Fold what they have accumulated so far into the following snapshots. */
+    void counters_reset() {
+        for (size_t c = 0; c < columns.size(); c++)
+            offset[c] += columns[c].read(columns[c].stat) - columns[c].init(columns[c].stat);
+    }
+
+    /* Take a snapshot at @cycle. Cheap: one read per sampled statistic. */
+    void sample(int64_t cycle) {
+        num_calls++;
+        if (num_calls % stride != 0)
+            return;
+
+        if (num_samples == capacity) {
+            decimate();
+            if (num_calls % stride != 0)
+                return;
+        }
+
+        cycles[num_samples] = cycle;
+        for (size_t c = 0; c < columns.size(); c++)
+            data[c * capacity + num_samples] = columns[c].read(columns[c].stat) + offset[c];
+        num_samples++;
+    }
+
+    size_t get_num_samples() const { return num_samples; }
+
+    /* How many sample() calls each snapshot currently covers. */
+    size_t get_stride() const { return stride; }
+
+    /* Write one row per interval: its end cycle, the deltas of the sampled
+     * statistics, and the formulas evaluated on those deltas. */
+    void dump_csv(FILE* fd) {
+        std::vector<double> out = compute_intervals();
+        fprintf(fd, "cycle");
+        for (auto& column : columns)
+            fprintf(fd, ",%s", column.stat->get_name().c_str());
+        for (auto formula : formulas)
+            fprintf(fd, ",%s", formula->get_name().c_str());
+        fprintf(fd, "\n");
+
+        size_t num_columns = columns.size() + formulas.size();
+        for (size_t row = 0; row < num_samples; row++) {
+            fprintf(fd, "%" PRId64, cycles[row]);
+            for (size_t c = 0; c < num_columns; c++)
+                fprintf(fd, ",%.12g", out[c * num_samples + row]);
+            fprintf(fd, "\n");
+        }
+    }
+
+    /* Same contents as dump_csv(), column-major:
+     *   char magic[8] = "XIOSAMP1"
+     *   uint32_t num_columns, num_rows (the cycle column is not counted)
+     *   num_columns x { uint32_t length; char name[length]; }
+     *   int64_t cycles[num_rows]
+     *   double values[num_columns][num_rows]
+     */
+    void dump_binary(FILE* fd) {
+        std::vector<double> out = compute_intervals();
+        uint32_t num_columns = columns.size() + formulas.size();
+        uint32_t num_rows = num_samples;
+        const char magic[] = "XIOSAMP1";
+        fwrite(magic, 1, sizeof(magic) - 1, fd);
+        fwrite(&num_columns, sizeof(num_columns), 1, fd);
+        fwrite(&num_rows, sizeof(num_rows), 1, fd);
+        auto write_name = [fd](const std::string& name) {
+            uint32_t len = name.size();
+            fwrite(&len, sizeof(len), 1, fd);
+            fwrite(name.c_str(), 1, len, fd);
+        };
+        for (auto& column : columns)
+            write_name(column.stat->get_name());
+        for (auto formula : formulas)
+            write_name(formula->get_name());
+        fwrite(cycles.data(), sizeof(cycles[0]), num_rows, fd);
+        fwrite(out.data(), sizeof(out[0]), out.size(), fd);
+    }
+
+  private:
+    /* Type-erased access to a Statistic<V>. */
+    struct column_t {
+        BaseStatistic* stat;
+        double (*read)(BaseStatistic*);
+        double (*init)(BaseStatistic*);
+        void (*write)(BaseStatistic*, double);
+    };
+
+    template <typename V>
+    static double read_stat(BaseStatistic* stat) {
+        return static_cast<Statistic<V>*>(stat)->get_value();
+    }
+
+    template <typename V>
+    static double init_stat(BaseStatistic* stat) {
+        return static_cast<Statistic<V>*>(stat)->get_init_val();
+    }
+
+    template <typename V>
+    static void write_stat(BaseStatistic* stat, double value) {
+        static_cast<Statistic<V>*>(stat)->set_value(static_cast<V>(value));
+    }
+
+    template <typename V>
+    bool try_add_column(BaseStatistic* stat) {
+        if (dynamic_cast<Statistic<V>*>(stat) == nullptr)
+            return false;
+        columns.push_back({ stat, &read_stat<V>, &init_stat<V>, &write_stat<V> });
+        return true;
+    }
+
+    /* Keep every other snapshot. They still end on interval boundaries,
+     * just twice as far apart. */
+    void decimate() {
+        for (size_t row = 0; row < capacity / 2; row++) {
+            cycles[row] = cycles[2 * row + 1];
+            for (size_t c = 0; c < columns.size(); c++)
+                data[c * capacity + row] = data[c * capacity + 2 * row + 1];
+        }
+        num_samples = capacity / 2;
+        stride *= 2;
+    }
+
+    /* Column-major interval deltas, followed by formula values. */
+    std::vector<double> compute_intervals() {
+        size_t num_columns = columns.size() + formulas.size();
+        std::vector<double> out(num_columns * num_samples);
+
+        /* We'll clobber the live values to evaluate formulas. */
+        std::vector<double> live(columns.size());
+        for (size_t c = 0; c < columns.size(); c++)
+            live[c] = columns[c].read(columns[c].stat);
+
+        for (size_t row = 0; row < num_samples; row++) {
+            for (size_t c = 0; c < columns.size(); c++) {
+                double curr = data[c * capacity + row];
+                double prev = (row == 0) ? baseline[c] : data[c * capacity + row - 1];
+                double delta = curr - prev;
+                out[c * num_samples + row] = delta;
+                columns[c].write(columns[c].stat, delta);
+            }
+            for (size_t f = 0; f < formulas.size(); f++)
+                out[(columns.size() + f) * num_samples + row] = formulas[f]->evaluate();
+        }
+
+        for (size_t c = 0; c < columns.size(); c++)
+            columns[c].write(columns[c].stat, live[c]);
+        return out;
+    }
+
+    std::vector<column_t> columns;
+    std::vector<Formula*> formulas;
+
+    size_t capacity;    // Max number of snapshots (even).
+    size_t stride;      // Snapshot every @stride calls to sample().
+    size_t num_calls;   // Calls to sample() so far.
+    size_t num_samples; // Valid snapshots in the buffer.
+
+    std::vector<double> baseline; // Values at construction.
+    std::vector<double> offset;   // Accumulated before counter resets.
+    std::vector<int64_t> cycles;  // End cycle of each interval.
+    std::vector<double> data;     // capacity x columns, column-major.
+};
+
+}  // namespace stats
+}  // namespace xiosim
+
+#endif /* __STAT_SAMPLER_H__ */
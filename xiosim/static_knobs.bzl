@@ -0,0 +1,17 @@
+def static_knobs(name, config):
+    # Generate {name}/static_knobs.gen.h with the constexpr core knobs of @config.
+    native.genrule(
+        name = "gen-%s" % name,
+        srcs = [ config ],
+        tools = [ ":gen_static_knobs" ],
+        cmd = "$(location :gen_static_knobs) $(location %s) > $@" % config,
+        outs = [ "%s/static_knobs.gen.h" % name ],
+    )
+
+    # Depending on this turns CORE_KNOB() into compile-time constants.
+    native.cc_library(
+        name = name,
+        hdrs = [ "%s/static_knobs.gen.h" % name ],
+        includes = [ name ],
+        defines = [ "XIOSIM_STATIC_KNOBS" ],
+    )
@@ -0,0 +1,70 @@
+/* Compile-time core knobs for config-specialized builds.
+ *
+ * Pipeline stages read widths, depths and structure sizes through
+ * CORE_KNOB(knobs, section, field). In a regular build that is just
+ * knobs->section.field. When built with --define static_knobs=<cfg> (see
+ * static_knobs.bzl), the values of the knobs in STATIC_CORE_KNOBS come from a
+ * header generated from that config file, and the compiler can unroll and
+ * constant-fold the stage loops. Such a binary can only simulate the config it
+ * was built for, which check_static_knobs() enforces at startup.
+ */
+
+#ifndef __STATIC_KNOBS_H__
+#define __STATIC_KNOBS_H__
+
+#include "knobs.h"
+
+/* All specialized knobs -- integer fields of core_knobs_t. */
+#define STATIC_CORE_KNOBS(X)       \
+    X(fetch, byteQ_size)           \
+    X(fetch, byteQ_linesize)       \
+    X(fetch, depth)                \
+    X(fetch, width)                \
+    X(fetch, IQ_size)              \
+    X(fetch, jeclear_delay)        \
+    X(decode, depth)               \
+    X(decode, width)               \
+    X(decode, target_stage)        \
+    X(decode, MS_latency)          \
+    X(decode, uopQ_size)           \
+    X(decode, branch_decode_limit) \
+    X(alloc, depth)                \
+    X(alloc, width)                \
+    X(exec, RS_size)               \
+    X(exec, LDQ_size)              \
+    X(exec, STQ_size)              \
+    X(exec, num_exec_ports)        \
+    X(exec, payload_depth)         \
+    X(exec, fp_penalty)            \
+    X(commit, ROB_size)            \
+    X(commit, width)               \
+    X(commit, branch_limit)        \
+    X(commit, pre_commit_depth)
+
+#ifdef XIOSIM_STATIC_KNOBS
+
+/* Generated by gen_static_knobs. Defines xiosim::static_knobs::<section>_<field>. */
+#include "static_knobs.gen.h"
+
+#define CORE_KNOB(knobs, section, field) (xiosim::static_knobs::section##_##field)
+
+#include "misc.h"
+
+inline void check_static_knobs(const core_knobs_t* knobs) {
+#define CHECK_STATIC_KNOB(section, field)                                                     \
+    if (knobs->section.field != xiosim::static_knobs::section##_##field)                      \
+        fatal("binary specialized for %s.%s = %d, config has %d. Use a generic build.",      \
+              #section, #field, xiosim::static_knobs::section##_##field, knobs->section.field);
+    STATIC_CORE_KNOBS(CHECK_STATIC_KNOB)
+#undef CHECK_STATIC_KNOB
+}
+
+#else
+
+#define CORE_KNOB(knobs, section, field) ((knobs)->section.field)
+
+inline void check_static_knobs(const core_knobs_t* knobs) {}
+
+#endif /* XIOSIM_STATIC_KNOBS */
+
+#endif /* __STATIC_KNOBS_H__ */
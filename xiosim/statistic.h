@@ -18,6 +18,7 @@
 
 #include "host.h"
 #include "expression.h"
+#include "stat_format.h"
 
 // NOTE: Temporary.
 const int PF_COUNT = 0x0001;
@@ -90,6 +91,11 @@ class BaseStatistic {
     /* Saves the difference of the current and initial value as the final value. */
     virtual void save_delta() = 0;
 
+    /* Write the statistic as a JSON object or a binary record, with the value
+     * print_value() would print. See stat_format.h for the layouts. */
+    virtual void write_json(FILE* fd) = 0;
+    virtual void write_binary(FILE* fd) = 0;
+
   protected:
     std::string name;        // Statistic name.
     std::string desc;        // Statistic description.
@@ -182,6 +188,18 @@ class Statistic : public StatisticCommon<V> {
     virtual void save_value() {}
     virtual void save_delta() {}
 
+    virtual void write_json(FILE* fd) {
+        write_json_header(fd, STAT_STRING, this->name, this->desc);
+        fputs(", \"value\": ", fd);
+        write_json_string(fd, value ? value : "");
+        fputs("}", fd);
+    }
+
+    virtual void write_binary(FILE* fd) {
+        write_binary_header(fd, STAT_STRING, this->name, this->desc);
+        write_binary_string(fd, value ? value : "");
+    }
+
   protected:
     const V value;     // Immutable copy of the value;
 };
@@ -231,6 +249,10 @@ class Statistic<V, typename std::enable_if_t<std::is_arithmetic<V>::value>>
         *value += stat->final_val;
     }
 
+    /* Overwrites the tracked variable. StatsSampler uses this to evaluate
+     * formulas on sampled values. */
+    void set_value(V val) { *value = val; }
+
     /* Saves the current value as the final value. */
     void save_value() { final_val = *value; }
 
@@ -244,6 +266,23 @@ class Statistic<V, typename std::enable_if_t<std::is_arithmetic<V>::value>>
         fprintf(fd, " # %s\n", this->desc.c_str());
     }
 
+    /* Integers stay exact; everything else is a double. */
+    static constexpr stat_type_t STAT_TYPE = std::is_integral<V>::value ? STAT_INT : STAT_FLOAT;
+    typedef std::conditional_t<std::is_integral<V>::value, int64_t, double> output_t;
+    typedef std::conditional_t<std::is_same<V, float>::value, float, output_t> json_t;
+
+    virtual void write_json(FILE* fd) {
+        write_json_header(fd, STAT_TYPE, this->name, this->desc);
+        fputs(", \"value\": ", fd);
+        write_json_number(fd, static_cast<json_t>(*value));
+        fputs("}", fd);
+    }
+
+    virtual void write_binary(FILE* fd) {
+        write_binary_header(fd, STAT_TYPE, this->name, this->desc);
+        write_binary_value<output_t>(fd, static_cast<output_t>(*value));
+    }
+
     /* Different types of data have different output format defaults. SFINAE
      * is used heavily here to assign different format strings for different
      * template types. */
@@ -290,6 +329,7 @@ class Statistic<V, typename std::enable_if_t<std::is_arithmetic<V>::value>>
 
     virtual Result evaluate() const { return get_value(); }
     virtual std::unique_ptr<Expression> deep_copy() const { return std::make_unique<Statistic<V>>(*this); }
+    virtual std::string to_string() const { return "{" + this->name + "}"; }
 
   protected:
     V* value;     // Pointer to allocated memory storing the value.
@@ -430,6 +470,36 @@ class Distribution : public BaseStatistic {
         fprintf(fd, "%s.end_dist\n", name.c_str());
     }
 
+    virtual void write_json(FILE* fd) {
+        write_json_header(fd, STAT_DISTRIBUTION, name, desc);
+        fputs(", \"counts\": [", fd);
+        for (unsigned int i = 0; i < array_sz; i++)
+            fprintf(fd, i ? ", %u" : "%u", array[i]);
+        fputs("]", fd);
+        if (stat_labels) {
+            fputs(", \"labels\": [", fd);
+            for (unsigned int i = 0; i < array_sz; i++) {
+                if (i)
+                    fputs(", ", fd);
+                write_json_string(fd, stat_labels[i]);
+            }
+            fputs("]", fd);
+        }
+        fprintf(fd, ", \"overflows\": %u}", overflows);
+    }
+
+    virtual void write_binary(FILE* fd) {
+        write_binary_header(fd, STAT_DISTRIBUTION, name, desc);
+        write_binary_value<uint32_t>(fd, array_sz);
+        write_binary_value<uint32_t>(fd, overflows);
+        for (unsigned int i = 0; i < array_sz; i++)
+            write_binary_value<uint64_t>(fd, array[i]);
+        write_binary_value<uint8_t>(fd, stat_labels != NULL);
+        if (stat_labels)
+            for (unsigned int i = 0; i < array_sz; i++)
+                write_binary_string(fd, stat_labels[i]);
+    }
+
   private:
     unsigned int* array;        // Distribution array.
     unsigned int* final_array;  // Final distribution values.
@@ -516,6 +586,26 @@ class SparseHistogram : public BaseStatistic {
         fprintf(fd, "%s.end_hist\n", name.c_str());
     }
 
+    virtual void write_json(FILE* fd) {
+        write_json_header(fd, STAT_HISTOGRAM, name, desc);
+        fputs(", \"counts\": [", fd);
+        bool first = true;
+        for (auto& kv : counts) {
+            fprintf(fd, "%s[%" PRIu64 ", %" PRIu64 "]", first ? "" : ", ", kv.first, kv.second);
+            first = false;
+        }
+        fputs("]}", fd);
+    }
+
+    virtual void write_binary(FILE* fd) {
+        write_binary_header(fd, STAT_HISTOGRAM, name, desc);
+        write_binary_value<uint32_t>(fd, counts.size());
+        for (auto& kv : counts) {
+            write_binary_value<uint64_t>(fd, kv.first);
+            write_binary_value<uint64_t>(fd, kv.second);
+        }
+    }
+
   private:
     std::string label_fmt;                      // Format for histogram keys.
     std::map<uint64_t, uint64_t> counts;        // Current counts.
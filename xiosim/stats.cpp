@@ -1,5 +1,8 @@
 /* Implementation of temporary replacement statistics library layer. */
 
+#include <cassert>
+#include <cstring>
+
 #include "core_const.h"
 #include "expression.h"
 #include "statistic.h"
@@ -498,6 +501,15 @@ void stat_print_stats(StatsDatabase* sdb, FILE* fd) { sdb->print_all_stats(fd);
 
 void stat_print_stat(BaseStatistic* stat, FILE* fd) { stat->print_value(fd); }
 
+void stat_dump_stats(StatsDatabase* sdb, const char* format, FILE* fd) {
+    if (!strcmp(format, "json"))
+        sdb->dump_json(fd);
+    else if (!strcmp(format, "binary"))
+        sdb->dump_binary(fd);
+    else
+        assert(false && "unknown structured stats format");
+}
+
 Distribution* stat_find_dist(StatsDatabase* sdb, const char* stat_name) {
     return static_cast<Distribution*>(sdb->get_statistic(stat_name));
 }
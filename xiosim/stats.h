@@ -303,6 +303,9 @@ void stat_print_stats(StatsDatabase* sdb, FILE* fd);
 
 void stat_print_stat(BaseStatistic* stat, FILE* fd);
 
+/* Structured output of all printed stats: @format is "json" or "binary". */
+void stat_dump_stats(StatsDatabase* sdb, const char* format, FILE* fd);
+
 // TODO: Make this return a reference instead of a pointer, so we can avoid
 // using dereferences in the reg_stats code.
 template <typename V>
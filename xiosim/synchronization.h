@@ -6,8 +6,10 @@
 
 #ifndef __SYNCHRONIZATION_H__
 #define __SYNCHRONIZATION_H__
+#include <linux/futex.h>
 #include <pthread.h>
 #include <stdint.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <mutex>
 #include <utility>
@@ -22,6 +24,20 @@ inline void yield()
     pthread_yield();
 }
 
+/* Sleep while *@addr == @val, until someone calls xio_futex_wake() on @addr.
+ * @addr can be in memory shared between processes. Returns spuriously on
+ * occasion, so callers re-check their condition in a loop. */
+inline void xio_futex_wait(int32_t* addr, int32_t val)
+{
+    syscall(SYS_futex, addr, FUTEX_WAIT, val, NULL, NULL, 0);
+}
+
+/* Wake up at most @count threads sleeping on @addr. */
+inline void xio_futex_wake(int32_t* addr, int32_t count)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
 /* Custom lock implementaion -- faster than the futeces that pin uses
  * because it stays in userspace only */
 
@@ -98,6 +114,47 @@ inline void lk_init(XIOSIM_LOCK* lk)
 {
 }
 
+/* Something threads can sleep on until another thread signals it.
+ * Only plain integers inside, so it also works when placed in memory shared
+ * between processes, and signalling is just an atomic add when nobody sleeps.
+ * Waiters grab a ticket, check their condition, and only then wait() on the
+ * ticket. A signal() that lands in between makes wait() return immediately,
+ * so it can't get lost. */
+class XIOSIM_EVENT {
+  public:
+    XIOSIM_EVENT() : seq(0), waiters(0) {}
+
+    XIOSIM_EVENT(const XIOSIM_EVENT &) = delete;
+    XIOSIM_EVENT & operator= (const XIOSIM_EVENT &) = delete;
+
+    inline int32_t ticket() const
+    {
+        return __atomic_load_n(&seq, __ATOMIC_ACQUIRE);
+    }
+
+    /* Sleep until someone signals after @ticket was taken.
+     * Can return spuriously, callers re-check their condition. */
+    inline void wait(int32_t ticket)
+    {
+        __atomic_add_fetch(&waiters, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&seq, __ATOMIC_SEQ_CST) == ticket)
+            xio_futex_wait(&seq, ticket);
+        __atomic_sub_fetch(&waiters, 1, __ATOMIC_SEQ_CST);
+    }
+
+    /* Wake up everyone sleeping on the event. */
+    inline void signal()
+    {
+        __atomic_add_fetch(&seq, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&waiters, __ATOMIC_SEQ_CST) > 0)
+            xio_futex_wake(&seq, INT32_MAX);
+    }
+
+  private:
+    int32_t seq;
+    int32_t waiters;
+};
+
 /* Make sure printing to the console is deadlock-free */
 extern XIOSIM_LOCK *printing_lock;
 
@@ -0,0 +1,82 @@
+/* Unit tests for the set-associative table. */
+
+#include <vector>
+
+#include "catch.hpp"
+
+#include "assoc_table.h"
+
+using namespace xiosim;
+
+TEST_CASE("Fully associative LRU", "assoc_table") {
+    assoc_table_t<int> table(4, 4);
+
+    for (int i = 1; i <= 4; i++)
+        table.replace(i)->data = i * 10;
+    REQUIRE(table.find(1)->data == 10);
+    REQUIRE(table.find(4)->data == 40);
+    REQUIRE(table.find(5) == nullptr);
+
+    /* 1 is the oldest, unless it gets touched */
+    table.touch(table.find(1));
+    table.replace(5);
+    REQUIRE(table.find(1) != nullptr);
+    REQUIRE(table.find(2) == nullptr);
+    table.replace(6);
+    REQUIRE(table.find(3) == nullptr);
+    REQUIRE(table.find(4) != nullptr);
+
+    /* find() alone doesn't count as a use */
+    table.find(4);
+    table.replace(7);
+    REQUIRE(table.find(4) == nullptr);
+}
+
+TEST_CASE("Fresh entries go first", "assoc_table") {
+    assoc_table_t<int> table(12, 12);
+
+    for (int i = 0; i < 12; i++) {
+        auto e = table.replace(100 + i);
+        REQUIRE(e - table.find(100 + i) == 0);
+    }
+    for (int i = 0; i < 12; i++)
+        REQUIRE(table.find(100 + i) != nullptr);
+}
+
+TEST_CASE("Recency order", "assoc_table") {
+    assoc_table_t<int> table(16, 16);
+
+    for (int i = 0; i < 16; i++)
+        table.replace(i);
+    /* shuffle the order around, touching the LRU and MRU ends too */
+    const int touches[] = { 0, 15, 7, 0, 3, 12, 15 };
+    for (int key : touches)
+        table.touch(table.find(key));
+
+    std::vector<uint64_t> order;
+    table.for_each([&](const assoc_table_t<int>::entry_t& e, bool valid) {
+        REQUIRE(valid);
+        order.push_back(e.key);
+    });
+    const std::vector<uint64_t> expected = { 15, 12, 3, 0, 7, 14, 13, 11,
+                                             10, 9,  8, 6, 5, 4, 2, 1 };
+    REQUIRE(order == expected);
+}
+
+TEST_CASE("Sets", "assoc_table") {
+    assoc_table_t<int> table(64, 4);
+
+    /* More keys than entries -- at least the most recent 4 are left. */
+    for (int i = 0; i < 200; i++)
+        table.replace(i * 4096);
+    for (int i = 196; i < 200; i++)
+        REQUIRE(table.find(i * 4096) != nullptr);
+
+    int valid_entries = 0;
+    table.for_each([&](const assoc_table_t<int>::entry_t&, bool valid) { valid_entries += valid; });
+    REQUIRE(valid_entries == 64);
+
+    table.clear();
+    for (int i = 0; i < 200; i++)
+        REQUIRE(table.find(i * 4096) == nullptr);
+}
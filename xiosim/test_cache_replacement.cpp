@@ -0,0 +1,162 @@
+/* Unit tests for cache replacement policies, with dense and sparse sets. */
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "checkpoint.h"
+#include "knobs.h"
+#include "zesto-cache.h"
+
+/* configuration parameters/knobs */
+struct core_knobs_t core_knobs;
+struct uncore_knobs_t uncore_knobs;
+struct system_knobs_t system_knobs;
+
+const int SETS = 4;
+const int ASSOC = 4;
+const int LINESIZE = 64;
+
+/* Line numbers within a set; 8 lines fight over 4 ways. */
+const std::vector<int> TRACE = { 0, 1, 2, 3, 0, 4, 1, 5, 2, 0, 6, 3,
+                                 4, 0, 7, 1, 2, 5, 0, 6, 3, 3, 7, 4 };
+
+static std::unique_ptr<struct cache_t> make_cache(char policy, bool sparse) {
+    srandom(42);
+    return cache_create(NULL, "LLC", CACHE_READWRITE, SETS, ASSOC, LINESIZE, policy, 'W', 'B',
+                        'N', 1, 64, 3, 8, 2, 1, NULL, NULL, -1.0, false, "fcfs", sparse);
+}
+
+static md_paddr_t line_addr(int line, int set) {
+    return (md_paddr_t)(line * SETS + set) * LINESIZE;
+}
+
+/* Access @trace in @set. Each access shows up as "h<way>" for a hit, or as
+ * "m<way>" for a miss that evicted <way>. Every @write_every'th access is a
+ * write. */
+static std::string run(struct cache_t* cp, const std::vector<int>& trace, int set,
+                       int write_every = 0) {
+    std::string res;
+    for (size_t i = 0; i < trace.size(); i++) {
+        const md_paddr_t addr = line_addr(trace[i], set);
+        const enum cache_command cmd =
+                (write_every && (i % write_every == 0)) ? CACHE_WRITE : CACHE_READ;
+        struct cache_line_t* line = cache_is_hit(cp, cmd, addr, NULL);
+        if (line) {
+            res += "h" + std::to_string(line->way) + " ";
+        } else {
+            struct cache_line_t* evictee = cache_get_evictee(cp, addr, NULL);
+            res += "m" + std::to_string(evictee->way) + " ";
+            evictee->valid = evictee->dirty = false;
+            cache_insert_block(cp, cmd, addr, NULL);
+        }
+    }
+    return res;
+}
+
+/* Recorded from the simulator before sets were packed and allocated lazily. */
+TEST_CASE("Replacement policies", "cache") {
+    struct expected_t {
+        char policy;
+        std::string sequence;
+    };
+    const std::vector<expected_t> expected = {
+        { 'l', "m0 m1 m2 m3 h0 m1 m2 m3 m0 m1 m2 m3 m0 h1 m2 m3 m0 m1 m2 m3 m0 h0 m1 m2 " },
+        { 'm', "m0 m1 m2 m3 h0 m0 h1 m1 h2 m2 m2 h3 h0 m0 m0 m0 m0 h1 m1 h2 h3 h3 m3 m3 " },
+        { 'p', "m0 m1 m2 m3 h0 m3 h1 m1 h2 h0 m0 m2 h3 m3 m0 m1 m0 m3 m2 m1 m3 h3 m1 m1 " },
+        { 'c', "m0 m1 m2 m3 h0 m1 m2 m3 m0 m1 m2 m3 m0 h1 m2 m3 m0 m1 m2 m3 m0 h0 m1 m2 " },
+    };
+
+    for (auto& e : expected) {
+        for (bool sparse : { false, true }) {
+            auto cp = make_cache(e.policy, sparse);
+            REQUIRE(run(cp.get(), TRACE, 0) == e.sequence);
+            /* Other sets don't care. */
+            REQUIRE(run(cp.get(), TRACE, 3) == e.sequence);
+        }
+    }
+}
+
+TEST_CASE("Sparse sets", "cache") {
+    auto cp = make_cache('l', true);
+    for (int i = 0; i < SETS; i++)
+        REQUIRE(cp->blocks[i].lines == NULL);
+
+    /* Lookups in untouched sets just miss, and don't allocate them. */
+    REQUIRE(cache_is_hit(cp.get(), CACHE_READ, line_addr(0, 1), NULL) == NULL);
+    REQUIRE(cache_peek(cp.get(), line_addr(0, 1)) == NULL);
+    REQUIRE(cp->blocks[1].lines == NULL);
+
+    run(cp.get(), { 0, 1 }, 1);
+    REQUIRE(cp->blocks[1].lines != NULL);
+    REQUIRE(cache_peek(cp.get(), line_addr(1, 1)) != NULL);
+    REQUIRE(cp->blocks[0].lines == NULL);
+}
+
+/* A fresh name for a checkpoint file in /tmp. */
+static std::string temp_ckpt_name() {
+    char buf[] = "/tmp/tmp_ckpt_XXXXXX";
+    int fd = mkstemp(buf);
+    REQUIRE(fd != -1);
+    close(fd);
+    return std::string(buf);
+}
+
+/* A sparse cache with sets 0 and 2 touched, some lines dirty. */
+static std::unique_ptr<struct cache_t> warm_cache(char policy) {
+    const std::vector<int> warmup(TRACE.begin(), TRACE.begin() + 14);
+    auto cp = make_cache(policy, true);
+    run(cp.get(), warmup, 0, 3);
+    run(cp.get(), warmup, 2, 3);
+    return cp;
+}
+
+TEST_CASE("Sparse checkpoint round trip", "cache") {
+    const std::vector<int> rest(TRACE.begin() + 14, TRACE.end());
+
+    for (char policy : std::string("lmpc")) {
+        std::string fname = temp_ckpt_name();
+        auto cp = warm_cache(policy);
+        xiosim::checkpoint::writer_t writer;
+        cache_save(cp.get(), writer, "LLC");
+        writer.write(fname.c_str());
+
+        for (bool sparse : { true, false }) {
+            auto restored = make_cache(policy, sparse);
+            xiosim::checkpoint::reader_t reader(fname.c_str());
+            cache_restore(restored.get(), reader, "LLC");
+            REQUIRE(reader.unused_sections().empty());
+
+            /* Untouched sets stay unallocated. */
+            if (sparse) {
+                REQUIRE(restored->blocks[0].lines != NULL);
+                REQUIRE(restored->blocks[1].lines == NULL);
+                REQUIRE(restored->blocks[2].lines != NULL);
+                REQUIRE(restored->blocks[3].lines == NULL);
+            }
+
+            for (int line = 0; line < 8; line++) {
+                for (int set = 0; set < SETS; set++) {
+                    const struct cache_line_t* orig = cache_peek(cp.get(), line_addr(line, set));
+                    const struct cache_line_t* copy =
+                            cache_peek(restored.get(), line_addr(line, set));
+                    REQUIRE((orig == NULL) == (copy == NULL));
+                    if (orig) {
+                        REQUIRE(orig->way == copy->way);
+                        REQUIRE(orig->dirty == copy->dirty);
+                    }
+                }
+            }
+
+            /* Replacement state made it too. */
+            auto orig = warm_cache(policy);
+            REQUIRE(run(restored.get(), rest, 0) == run(orig.get(), rest, 0));
+            REQUIRE(run(restored.get(), rest, 2) == run(orig.get(), rest, 2));
+        }
+        unlink(fname.c_str());
+    }
+}
@@ -0,0 +1,65 @@
+/* Unit tests for checkpoint files. */
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "checkpoint.h"
+
+using namespace xiosim::checkpoint;
+
+/* A fresh name for a checkpoint file in /tmp. */
+static std::string temp_ckpt_name() {
+    char buf[] = "/tmp/tmp_ckpt_XXXXXX";
+    int fd = mkstemp(buf);
+    REQUIRE(fd != -1);
+    close(fd);
+    return std::string(buf);
+}
+
+TEST_CASE("Checkpoint round trip", "checkpoint") {
+    std::string fname = temp_ckpt_name();
+
+    std::vector<int> table = { 3, 1, 4, 1, 5, 9, 2, 6 };
+    writer_t writer;
+    writer.begin_section("c0.bpred.dir0", "2lev:gshare:4096");
+    writer.put_array(table.data(), table.size());
+    writer.put<uint64_t>(0xdecafbad);
+    writer.begin_section("LLC", "1024:16:64:0");
+    writer.put_string("hello");
+    writer.put<char>('x');
+    writer.write(fname.c_str());
+
+    reader_t reader(fname.c_str());
+
+    SECTION("Matching sections read back") {
+        REQUIRE(reader.begin_section("LLC", "1024:16:64:0"));
+        REQUIRE(reader.get_string() == "hello");
+        REQUIRE(reader.get<char>() == 'x');
+        reader.end_section();
+
+        REQUIRE(reader.begin_section("c0.bpred.dir0", "2lev:gshare:4096"));
+        std::vector<int> read_table(table.size());
+        reader.get_array(read_table.data(), read_table.size());
+        REQUIRE(read_table == table);
+        REQUIRE(reader.get<uint64_t>() == 0xdecafbad);
+        reader.end_section();
+
+        REQUIRE(reader.unused_sections().empty());
+    }
+
+    SECTION("Other structures start cold") {
+        REQUIRE_FALSE(reader.begin_section("LLC", "2048:16:64:0"));
+        REQUIRE_FALSE(reader.begin_section("c1.bpred.dir0", "2lev:gshare:4096"));
+
+        auto unused = reader.unused_sections();
+        REQUIRE(unused.size() == 2);
+        REQUIRE(unused[0] == "LLC");
+        REQUIRE(unused[1] == "c0.bpred.dir0");
+    }
+
+    std::remove(fname.c_str());
+}
@@ -0,0 +1,84 @@
+/* Unit tests for the MESI directory. */
+
+#include "catch.hpp"
+
+#include "coherence_directory.h"
+
+using namespace xiosim::coherence;
+
+/* 2 shards on bit 6 (64B lines), 4 sets x 2 ways each. */
+static directory_t make_directory() { return directory_t(2, 6, 6, 4, 2); }
+
+TEST_CASE("Read grants", "directory") {
+    auto dir = make_directory();
+
+    auto res = dir.read(0x1000, 0);
+    REQUIRE(res.exclusive);
+    REQUIRE(res.forward_from == NO_OWNER);
+    REQUIRE(dir.probe(0x1000, 0) == dir_state_t::EXCLUSIVE);
+    REQUIRE(dir.probe(0x1000, 1) == dir_state_t::INVALID);
+
+    /* second reader downgrades the first, which forwards */
+    res = dir.read(0x1000, 1);
+    REQUIRE_FALSE(res.exclusive);
+    REQUIRE(res.forward_from == 0);
+    REQUIRE(res.invalidate == 0);
+    REQUIRE(dir.probe(0x1000, 0) == dir_state_t::SHARED);
+    REQUIRE(dir.probe(0x1000, 1) == dir_state_t::SHARED);
+
+    /* same line, different byte */
+    REQUIRE(dir.probe(0x1010, 1) == dir_state_t::SHARED);
+}
+
+TEST_CASE("Write invalidates", "directory") {
+    auto dir = make_directory();
+
+    dir.read(0x2000, 0);
+    dir.read(0x2000, 1);
+    dir.read(0x2000, 2);
+
+    auto res = dir.write(0x2000, 1);
+    REQUIRE(res.invalidate == ((1 << 0) | (1 << 2)));
+    REQUIRE(res.forward_from == NO_OWNER);
+    REQUIRE(dir.probe(0x2000, 1) == dir_state_t::EXCLUSIVE);
+    REQUIRE(dir.probe(0x2000, 0) == dir_state_t::INVALID);
+    REQUIRE(dir.probe(0x2000, 2) == dir_state_t::INVALID);
+
+    /* another writer takes it from the owner */
+    res = dir.write(0x2000, 3);
+    REQUIRE(res.forward_from == 1);
+    REQUIRE(res.invalidate == (1 << 1));
+    REQUIRE(dir.probe(0x2000, 3) == dir_state_t::EXCLUSIVE);
+}
+
+TEST_CASE("Writeback", "directory") {
+    auto dir = make_directory();
+
+    dir.write(0x3000, 0);
+    dir.writeback(0x3000, 0);
+    /* no longer the owner, but may still have it closer to the core */
+    REQUIRE(dir.probe(0x3000, 0) == dir_state_t::SHARED);
+
+    auto res = dir.read(0x3000, 1);
+    REQUIRE(res.forward_from == NO_OWNER);
+}
+
+TEST_CASE("Recall on set conflicts", "directory") {
+    auto dir = make_directory();
+
+    /* Lines in shard 0, until some set holds a third one. */
+    md_paddr_t recalled = 0;
+    uint64_t recalled_sharers = 0;
+    int reads = 0;
+    for (md_paddr_t addr = 0; !recalled_sharers; addr += 0x80) {
+        auto res = dir.read(addr, reads % 4);
+        recalled = res.recalled_addr;
+        recalled_sharers = res.recalled_sharers;
+        reads++;
+        REQUIRE(reads <= 4 * 2 + 1);
+    }
+    REQUIRE(reads > 2);
+    REQUIRE(recalled % 0x80 == 0);
+    for (int core = 0; core < 4; core++)
+        REQUIRE(dir.probe(recalled, core) == dir_state_t::INVALID);
+}
@@ -0,0 +1,166 @@
+/* Unit tests for the FR-FCFS DRAM request scheduler. */
+
+#include <vector>
+
+#include "catch.hpp"
+
+#include "frfcfs_scheduler.h"
+
+using namespace xiosim;
+
+/* With 4 banks and 4KB pages, rows of the same bank are 16KB apart. */
+const md_paddr_t ROW = 16 * 1024;
+const md_paddr_t BANK = 4 * 1024;
+
+/* Record the order requests get sent to DRAM, each taking @latency. Unless
+ * @hold_slots, requests give their slots back as soon as they are sent. */
+struct dram_t {
+    std::vector<int> issued;
+    tick_t now = 0;
+    tick_t latency = 10;
+    bool hold_slots = false;
+
+    tick_t operator()(int idx) {
+        issued.push_back(idx);
+        return now + latency;
+    }
+};
+
+static void step(frfcfs_scheduler_t& sched, dram_t& dram, tick_t now) {
+    dram.now = now;
+    size_t num_issued = dram.issued.size();
+    sched.step(now, [&](int idx) { return dram(idx); });
+    if (!dram.hold_slots)
+        for (size_t i = num_issued; i < dram.issued.size(); i++)
+            sched.release(dram.issued[i]);
+}
+
+TEST_CASE("Open row first", "frfcfs") {
+    frfcfs_scheduler_t sched(1, 4, 64, 8, 8, 6, 2, 1000);
+    dram_t dram;
+
+    int first = sched.enqueue(0, false, 0);
+    step(sched, dram, 0);
+    REQUIRE(dram.issued == std::vector<int>{ first });
+
+    /* A conflict arrives before a hit to the row we just opened. */
+    int conflict = sched.enqueue(ROW, false, 1);
+    int hit = sched.enqueue(64, false, 2);
+    step(sched, dram, 2);
+    REQUIRE(dram.issued.back() == hit);
+    REQUIRE(sched.row_hits == 1);
+
+    /* The conflict waits for the bank to finish the hit. */
+    step(sched, dram, 3);
+    REQUIRE(dram.issued.size() == 2);
+    step(sched, dram, 12);
+    REQUIRE(dram.issued.back() == conflict);
+    REQUIRE(sched.row_conflicts == 1);
+}
+
+TEST_CASE("Oldest first across banks", "frfcfs") {
+    frfcfs_scheduler_t sched(1, 4, 64, 8, 8, 6, 2, 1000);
+    dram_t dram;
+
+    int younger = sched.enqueue(2 * BANK, false, 5);
+    int older = sched.enqueue(BANK, false, 3);
+    step(sched, dram, 5);
+    step(sched, dram, 6);
+    REQUIRE(dram.issued == (std::vector<int>{ older, younger }));
+}
+
+TEST_CASE("Starvation cap", "frfcfs") {
+    frfcfs_scheduler_t sched(1, 4, 64, 8, 8, 6, 2, 20);
+    dram_t dram;
+    dram.latency = 1;
+
+    sched.enqueue(0, false, 0);
+    step(sched, dram, 0);
+    int starving = sched.enqueue(ROW, false, 1);
+    /* Row hits keep coming, and go first until @starving waits long enough. */
+    tick_t now = 2;
+    for (; now < 30; now++) {
+        sched.enqueue(64 * (now % 64), false, now);
+        step(sched, dram, now);
+        if (dram.issued.back() == starving)
+            break;
+    }
+    REQUIRE(dram.issued.back() == starving);
+    REQUIRE(now == 21);
+    REQUIRE(sched.starved_issues == 1);
+}
+
+TEST_CASE("Write drain watermarks", "frfcfs") {
+    frfcfs_scheduler_t sched(1, 4, 64, 8, 8, 4, 1, 1000);
+    dram_t dram;
+    dram.latency = 1;
+
+    std::vector<int> writes;
+    for (int i = 0; i < 3; i++)
+        writes.push_back(sched.enqueue(i * BANK, true, 0));
+    int read = sched.enqueue(3 * BANK, false, 0);
+
+    /* Below the high watermark, reads go first. */
+    step(sched, dram, 0);
+    REQUIRE(dram.issued == std::vector<int>{ read });
+
+    /* No reads left, so writes go anyway. */
+    step(sched, dram, 1);
+    REQUIRE(dram.issued.back() == writes[0]);
+
+    /* Over the high watermark, writes drain to the low one before reads. */
+    for (int i = 0; i < 2; i++)
+        writes.push_back(sched.enqueue((i + 4) * ROW, true, 2));
+    read = sched.enqueue(5 * ROW + 3 * BANK, false, 2);
+    step(sched, dram, 2);
+    step(sched, dram, 3);
+    step(sched, dram, 4);
+    REQUIRE(sched.write_drains == 1);
+    REQUIRE(dram.issued.size() == 5);
+    for (size_t i = 2; i < 5; i++)
+        REQUIRE(dram.issued[i] != read);
+    step(sched, dram, 5);
+    REQUIRE(dram.issued.back() == read);
+}
+
+TEST_CASE("Channels issue in parallel", "frfcfs") {
+    frfcfs_scheduler_t sched(2, 4, 256, 4, 4, 3, 1, 1000);
+    dram_t dram;
+
+    int a = sched.enqueue(0, false, 0);
+    int b = sched.enqueue(256, false, 0);
+    /* Same channel and bank as @a (the channel bit is squeezed out), another
+     * row. */
+    int c = sched.enqueue(512 + ROW * 2, false, 0);
+    step(sched, dram, 0);
+    REQUIRE(dram.issued == (std::vector<int>{ a, b }));
+    step(sched, dram, 1);
+    REQUIRE(dram.issued.size() == 2);
+    step(sched, dram, 10);
+    REQUIRE(dram.issued.back() == c);
+    REQUIRE(sched.row_conflicts == 1);
+}
+
+TEST_CASE("Requests in DRAM keep their slots", "frfcfs") {
+    /* One channel, room for 2 reads and 1 write: 3 slots. */
+    frfcfs_scheduler_t sched(1, 4, 64, 2, 1, 1, 0, 1000);
+    dram_t dram;
+    dram.hold_slots = true;
+
+    int a = sched.enqueue(0, false, 0);
+    sched.enqueue(BANK, false, 0);
+    REQUIRE(!sched.enqueuable(2 * BANK));
+    step(sched, dram, 0);
+    /* The read queue has room again, and there is one free slot. */
+    REQUIRE(sched.enqueuable(2 * BANK));
+    sched.enqueue(2 * BANK, false, 1);
+    step(sched, dram, 1);
+
+    /* Both queues have room, but every slot is taken by a request that
+     * hasn't come back from DRAM. */
+    REQUIRE(sched.get_num_free() == 0);
+    REQUIRE(!sched.enqueuable(3 * BANK));
+
+    sched.release(a);
+    REQUIRE(sched.enqueuable(3 * BANK));
+}
@@ -0,0 +1,64 @@
+/* Unit tests for the perceptron predictor kernels. */
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "perceptron_kernels.h"
+
+using namespace xiosim::bpred;
+
+/* Straight from the definition, no sign-mask tricks. */
+static int naive_dot(const std::vector<int16_t>& w, const uint64_t* hist) {
+    int sum = 0;
+    for (size_t i = 0; i < w.size(); i++) {
+        bool taken = (hist[i / 64] >> (i % 64)) & 1;
+        sum += taken ? w[i] : -w[i];
+    }
+    return sum;
+}
+
+TEST_CASE("Dot product", "perceptron") {
+    std::vector<int16_t> w = { 3, -5, 7, 0, 127, -128 };
+    uint64_t hist[2] = { 0x5, 0 };  // taken, not taken, taken, ...
+    REQUIRE(perceptron_dot(w.data(), hist, w.size()) == 3 + 5 + 7 - 0 - 127 + 128);
+    REQUIRE(perceptron_dot(w.data(), hist, 0) == 0);
+}
+
+TEST_CASE("Training saturates", "perceptron") {
+    std::vector<int16_t> w = { 127, -128, 0, 127, -128 };
+    uint64_t hist[2] = { 0x3, 0 };
+
+    perceptron_train(w.data(), hist, w.size(), true, -128, 127);
+    REQUIRE(w == std::vector<int16_t>({ 127, -127, -1, 126, -128 }));
+
+    perceptron_train(w.data(), hist, w.size(), false, -128, 127);
+    REQUIRE(w == std::vector<int16_t>({ 126, -128, 0, 127, -127 }));
+}
+
+TEST_CASE("Vector code matches reference", "perceptron") {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int> weight(-128, 127);
+
+    /* Cover every tail length for both vector widths, and the 64-bit
+     * history word boundary. */
+    for (int n = 0; n <= 128; n++) {
+        for (int iter = 0; iter < 20; iter++) {
+            uint64_t hist[2] = { rng(), rng() };
+            std::vector<int16_t> w(n);
+            for (auto& x : w)
+                x = weight(rng);
+            std::vector<int16_t> w_ref = w;
+
+            REQUIRE(perceptron_dot(w.data(), hist, n) == naive_dot(w, hist));
+            REQUIRE(perceptron_dot_scalar(w.data(), hist, n) == naive_dot(w, hist));
+
+            bool outcome = rng() & 1;
+            perceptron_train(w.data(), hist, n, outcome, -100, 100);
+            perceptron_train_scalar(w_ref.data(), hist, n, outcome, -100, 100);
+            REQUIRE(w == w_ref);
+        }
+    }
+}
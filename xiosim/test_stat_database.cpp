@@ -11,6 +11,7 @@
 #include <string>
 
 #include "stat_database.h"
+#include "stat_sampler.h"
 #include "stats.h"
 
 using namespace xiosim::stats;
@@ -364,6 +365,12 @@ TEST_CASE("Formula statistics", "formulas") {
         stat_3_value = 5;
         CHECK(madd.evaluate() == 15);
         CHECK(nested_madd.evaluate() == 20);
+
+        CHECK(madd.to_string() == "(({stat_1} * {stat_2}) + {stat_3})");
+        CHECK(nested_madd.to_string() == "({stat_1} * ({stat_2} + {stat_3}))");
+        Formula scaled("scaled", "Nested formula with constants");
+        scaled = -(madd / 2) ^ 0.5;
+        CHECK(scaled.to_string() == "((-((({stat_1} * {stat_2}) + {stat_3}) / 2)) ^ 0.5)");
     }
 
     SECTION("Testing assignment operators", "assignment") {
@@ -535,3 +542,158 @@ TEST_CASE("Full statistics database", "database") {
     check_printfs(temp_file, XIOSIM_PACKAGE_PATH + "test_data/test_stat.database.out");
     cleanup_temp_file(temp_file, temp_file_name);
 }
+
+TEST_CASE("Structured statistics output", "structured") {
+    int int_value = 0;
+    double double_value = 0.0;
+    const char* str_value = "string \"quoted\"";
+    const char* labels[] = { "a", "b" };
+
+    StatsDatabase sdb;
+    auto int_stat = sdb.add_statistic("integer_stat", "integer description", &int_value, 0);
+    auto double_stat = sdb.add_statistic("double_stat", "double description", &double_value, 0);
+    sdb.add_statistic("string_stat", "string description", str_value);
+    sdb.add_statistic("hidden_stat", "not printed", &int_value, 0, "%12d", false);
+    Distribution* dist = sdb.add_distribution("dist", "dist description", 0, 2, labels);
+    SparseHistogram* hist = sdb.add_sparse_histogram("hist", "hist description");
+    stat_reg_note(&sdb, "# a note");
+    stat_reg_formula(&sdb, true, "ratio", "ratio description", *double_stat / *int_stat, NULL);
+
+    dist->add_samples(1, 3);
+    dist->add_samples(5, 1);
+    hist->add_samples(10, 7);
+    int_value = 100;
+    double_value = 50.125;
+    sdb.slice_weight = 0.5;
+
+    SECTION("JSON") {
+        char temp_file_name[21];
+        FILE* temp_file = open_temp_file(temp_file_name);
+        stat_dump_stats(&sdb, "json", temp_file);
+        check_printfs(temp_file, XIOSIM_PACKAGE_PATH + "test_data/test_stat.database.json.out");
+        cleanup_temp_file(temp_file, temp_file_name);
+    }
+
+    SECTION("Binary") {
+        char temp_file_name[21];
+        FILE* temp_file = open_temp_file(temp_file_name);
+        stat_dump_stats(&sdb, "binary", temp_file);
+        rewind(temp_file);
+
+        char magic[8];
+        double weight;
+        uint32_t num_stats;
+        REQUIRE(fread(magic, 1, sizeof(magic), temp_file) == sizeof(magic));
+        REQUIRE(fread(&weight, sizeof(weight), 1, temp_file) == 1);
+        REQUIRE(fread(&num_stats, sizeof(num_stats), 1, temp_file) == 1);
+        CHECK(std::string(magic, sizeof(magic)) == "XIOSTAT1");
+        CHECK(weight == 0.5);
+        CHECK(num_stats == 6);
+
+        // First record is integer_stat.
+        uint8_t type;
+        uint32_t len;
+        char name[32] = {};
+        REQUIRE(fread(&type, sizeof(type), 1, temp_file) == 1);
+        REQUIRE(fread(&len, sizeof(len), 1, temp_file) == 1);
+        REQUIRE(len < sizeof(name));
+        REQUIRE(fread(name, 1, len, temp_file) == len);
+        CHECK(type == STAT_INT);
+        CHECK(std::string(name) == "integer_stat");
+        cleanup_temp_file(temp_file, temp_file_name);
+    }
+}
+
+TEST_CASE("Interval sampling", "sampler") {
+    StatsDatabase sdb;
+    int64_t insns = 0;
+    int64_t cycles = 0;
+    auto insn_stat = stat_reg_sqword(
+            &sdb, true, "insns", "instructions", &insns, 0, false, NULL);
+    auto cycle_stat = stat_reg_sqword(
+            &sdb, true, "cycles", "cycles", &cycles, 0, false, NULL);
+    stat_reg_formula(&sdb, true, "ipc", "IPC", insn_stat / cycle_stat, NULL);
+
+    SECTION("Deltas and formulas per interval") {
+        StatsSampler sampler(&sdb, { "insns", "cycles", "ipc", "no_such_stat" }, 8);
+        for (int i = 1; i <= 3; i++) {
+            cycles += 100;
+            insns += 50 * i;
+            sampler.sample(cycles);
+        }
+        REQUIRE(sampler.get_num_samples() == 3);
+
+        char temp_file_name[21];
+        FILE* temp_file = open_temp_file(temp_file_name);
+        sampler.dump_csv(temp_file);
+        rewind(temp_file);
+        char line[128];
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "cycle,insns,cycles,ipc\n");
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "100,50,100,0.5\n");
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "200,100,100,1\n");
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "300,150,100,1.5\n");
+        cleanup_temp_file(temp_file, temp_file_name);
+
+        // Dumping doesn't disturb the live values.
+        CHECK(insns == 300);
+        CHECK(cycles == 300);
+    }
+
+    SECTION("Decimation when the buffer fills up") {
+        StatsSampler sampler(&sdb, { "cycles" }, 4);
+        for (int i = 1; i <= 10; i++) {
+            cycles += 10;
+            sampler.sample(cycles);
+        }
+        // 10..40 fill the buffer; 20, 40 survive and sampling goes to every 2 calls.
+        // 60, 80 fill it again; 40, 80 survive and sampling goes to every 4 calls.
+        CHECK(sampler.get_stride() == 4);
+        CHECK(sampler.get_num_samples() == 2);
+
+        char temp_file_name[21];
+        FILE* temp_file = open_temp_file(temp_file_name);
+        sampler.dump_csv(temp_file);
+        rewind(temp_file);
+        char line[128];
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "40,40\n");
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "80,40\n");
+        cleanup_temp_file(temp_file, temp_file_name);
+    }
+
+    SECTION("Counter resets") {
+        StatsSampler sampler(&sdb, { "insns" }, 8);
+        insns += 30;
+        sampler.sample(100);
+        // A new slice starts in the middle of the next interval.
+        insns += 20;
+        sampler.counters_reset();
+        insns = 0;
+        insns += 5;
+        sampler.sample(200);
+        // Less than before the reset, and still counted as progress.
+        insns += 10;
+        sampler.sample(300);
+
+        char temp_file_name[21];
+        FILE* temp_file = open_temp_file(temp_file_name);
+        sampler.dump_csv(temp_file);
+        rewind(temp_file);
+        char line[128];
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "100,30\n");
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "200,25\n");
+        REQUIRE(fgets(line, sizeof(line), temp_file));
+        CHECK(std::string(line) == "300,10\n");
+        cleanup_temp_file(temp_file, temp_file_name);
+        CHECK(insns == 15);
+    }
+}
@@ -0,0 +1,79 @@
+/* Unit tests for the timing wheel. */
+
+#include "catch.hpp"
+
+#include "timing_wheel.h"
+
+using namespace xiosim;
+
+TEST_CASE("Events fire on their cycle", "timing_wheel") {
+    timing_wheel_t wheel(16);
+
+    wheel.schedule(3);
+    wheel.schedule(5);
+    wheel.schedule(5);
+    REQUIRE_FALSE(wheel.advance(0));
+    REQUIRE_FALSE(wheel.advance(1));
+    REQUIRE_FALSE(wheel.advance(2));
+    REQUIRE(wheel.advance(3));
+    REQUIRE_FALSE(wheel.advance(4));
+    REQUIRE(wheel.advance(5));
+    REQUIRE_FALSE(wheel.advance(6));
+}
+
+TEST_CASE("Past events fire next", "timing_wheel") {
+    timing_wheel_t wheel(16);
+
+    REQUIRE_FALSE(wheel.advance(10));
+    wheel.schedule(7);
+    wheel.schedule(10);
+    REQUIRE(wheel.advance(11));
+    REQUIRE_FALSE(wheel.advance(12));
+}
+
+TEST_CASE("Skipping cycles", "timing_wheel") {
+    timing_wheel_t wheel(16);
+
+    wheel.schedule(20);
+    REQUIRE_FALSE(wheel.advance(19));
+    REQUIRE(wheel.advance(25));
+
+    /* further than the whole wheel */
+    wheel.schedule(30);
+    REQUIRE(wheel.advance(1000));
+    REQUIRE_FALSE(wheel.advance(1001));
+}
+
+TEST_CASE("Far events", "timing_wheel") {
+    timing_wheel_t wheel(16);
+
+    /* The wheel is 64 cycles; these don't fit. */
+    wheel.schedule(100);
+    wheel.schedule(300);
+    wheel.schedule(164);
+    for (tick_t cycle = 0; cycle < 400; cycle++) {
+        bool due = (cycle == 100 || cycle == 164 || cycle == 300);
+        REQUIRE(wheel.advance(cycle) == due);
+    }
+}
+
+TEST_CASE("Wrap around", "timing_wheel") {
+    timing_wheel_t wheel(16);
+
+    for (tick_t cycle = 0; cycle < 1000; cycle++) {
+        if (cycle % 7 == 0)
+            wheel.schedule(cycle + 63);
+        bool due = (cycle >= 63) && ((cycle - 63) % 7 == 0);
+        REQUIRE(wheel.advance(cycle) == due);
+    }
+}
+
+TEST_CASE("Clear", "timing_wheel") {
+    timing_wheel_t wheel(16);
+
+    wheel.schedule(5);
+    wheel.schedule(500);
+    wheel.clear();
+    for (tick_t cycle = 0; cycle < 600; cycle++)
+        REQUIRE_FALSE(wheel.advance(cycle));
+}
@@ -0,0 +1,110 @@
+/* Unit tests for the binary ztrace format and decoder. */
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "ztrace_decoder.h"
+#include "ztrace_format.h"
+
+using namespace xiosim::ztrace;
+
+static record_t make_record(record_kind_t kind, uint8_t flags, const char* fmt, ...) {
+    record_t r;
+    memset(&r, 0, sizeof(r));
+    r.fmt = fmt;
+    r.kind = kind;
+    r.flags = flags | RECORD_NEWLINE;
+    r.cycle = 42;
+    r.Mop_seq = 7;
+    r.uop_seq = 3;
+
+    format_info_t info;
+    parse_format(fmt, &info);
+    va_list v;
+    va_start(v, fmt);
+    pack_args(r, info, v);
+    va_end(v);
+    return r;
+}
+
+/* Write @records as one chunk, and decode it back to text. */
+static std::string round_trip(const std::vector<record_t>& records) {
+    FILE* fp = tmpfile();
+    REQUIRE(fp != nullptr);
+    write_chunk(fp, records);
+    rewind(fp);
+
+    FILE* out = tmpfile();
+    REQUIRE(out != nullptr);
+    REQUIRE(decode(fp, out) == 0);
+    rewind(out);
+    std::string text;
+    char buf[256];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), out)) > 0)
+        text.append(buf, n);
+    fclose(fp);
+    fclose(out);
+    return text;
+}
+
+static std::string chunk(const std::string& lines, int num_records) {
+    return "==============================\nBEGIN TRACE (" + std::to_string(num_records) +
+           " items)\n" + lines + "END TRACE\n==============================\n";
+}
+
+TEST_CASE("Record kinds", "ztrace") {
+    std::vector<record_t> records;
+    records.push_back(make_record(RECORD_RAW, 0, "raw %d", -5));
+    records.push_back(make_record(RECORD_MOP, 0, "f|PC:%llx", 0x401000LL));
+    records.push_back(make_record(RECORD_UOP, RECORD_SPEC, "e|%s lat=%d", "ALU", 1));
+
+    REQUIRE(round_trip(records) == chunk("raw -5\n"
+                                         "42|M:7|.|f|PC:401000\n"
+                                         "42|u:7:3|X|e|ALU lat=1\n",
+                                         3));
+}
+
+TEST_CASE("Argument kinds", "ztrace") {
+    int x;
+    char ptr[32];
+    snprintf(ptr, sizeof(ptr), "%p", (void*)&x);
+    std::vector<record_t> records;
+    records.push_back(make_record(RECORD_RAW, 0, "%*d|%-4s|%.2f|%p|100%%", 4, 12, "ab", 2.5,
+                                  (void*)&x));
+
+    REQUIRE(round_trip(records) == chunk("  12|ab  |2.50|" + std::string(ptr) + "|100%\n", 1));
+}
+
+TEST_CASE("Truncated strings", "ztrace") {
+    const std::string long_str(200, 'z');
+    std::vector<record_t> records;
+    records.push_back(make_record(RECORD_RAW, 0, "[%s] [%s] [%s]", "short", long_str.c_str(), ""));
+
+    /* The first two words hold offsets, the strings share the rest. */
+    const size_t space = sizeof(records[0].payload) - 3 * sizeof(uint64_t);
+    const std::string kept(space - strlen("short") - 2, 'z');
+    REQUIRE(round_trip(records) == chunk("[short] [" + kept + "...] []\n", 1));
+
+    /* No room left at all for the last string. */
+    records.clear();
+    records.push_back(make_record(RECORD_RAW, 0, "%s|%s", long_str.c_str(), "tail"));
+    REQUIRE(round_trip(records) ==
+            chunk(std::string(sizeof(records[0].payload) - 2 * sizeof(uint64_t) - 1, 'z') +
+                      "...|...\n",
+                  1));
+}
+
+TEST_CASE("Shared format table", "ztrace") {
+    const char* fmt = "%d";
+    std::vector<record_t> records;
+    for (int i = 0; i < 3; i++)
+        records.push_back(make_record(RECORD_RAW, 0, fmt, i));
+    records.push_back(make_record(RECORD_RAW, 0, "x=%d", 9));
+
+    REQUIRE(round_trip(records) == chunk("0\n1\n2\nx=9\n", 4));
+}
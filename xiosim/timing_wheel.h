@@ -0,0 +1,107 @@
+/* timing_wheel.h - Calendar of the cycles at which a component has work due.
+ *
+ * Something schedules a cycle when it knows work will become ready then (a
+ * request leaving a pipeline, a fill returning). The owner advances the wheel
+ * once per cycle of its own clock, and only does real work when advance()
+ * says something came due.
+ *
+ * Near-future cycles (within @horizon of the current one) are a bitmap,
+ * one bit per cycle, indexed modulo the wheel size. Anything further out
+ * waits in a min-heap until it comes within range. There are no payloads --
+ * several events on the same cycle are one bit, and a stale event just costs
+ * a spurious wakeup.
+ */
+
+#ifndef __TIMING_WHEEL_H__
+#define __TIMING_WHEEL_H__
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "host.h"
+
+namespace xiosim {
+
+class timing_wheel_t {
+  public:
+    timing_wheel_t(int horizon) {
+        size_t size = 64;
+        while (size < (size_t)horizon)
+            size <<= 1;
+        slots.resize(size / 64, 0);
+        mask = size - 1;
+    }
+
+    /* Something is due at @when. Cycles that already went by are due on
+     * the next advance(). */
+    void schedule(tick_t when) {
+        if (when < next_cycle)
+            when = next_cycle;
+        if ((uint64_t)(when - next_cycle) <= mask)
+            set(when);
+        else
+            far.push(when);
+    }
+
+    /* Move to @now (the owner's current cycle). Returns true if anything
+     * was due since the previous call. */
+    bool advance(tick_t now) {
+        if (now < next_cycle)
+            return false;
+
+        bool due = false;
+        if ((uint64_t)(now - next_cycle) >= mask) {
+            for (auto& word : slots) {
+                due |= (word != 0);
+                word = 0;
+            }
+        } else {
+            for (tick_t cycle = next_cycle; cycle <= now; cycle++)
+                due |= test_and_clear(cycle);
+        }
+        next_cycle = now + 1;
+
+        while (!far.empty() && far.top() <= now) {
+            due = true;
+            far.pop();
+        }
+        while (!far.empty() && (uint64_t)(far.top() - next_cycle) <= mask) {
+            set(far.top());
+            far.pop();
+        }
+        return due;
+    }
+
+    /* Forget everything scheduled. */
+    void clear() {
+        for (auto& word : slots)
+            word = 0;
+        far = decltype(far)();
+    }
+
+  private:
+    void set(tick_t cycle) {
+        const uint64_t slot = cycle & mask;
+        slots[slot >> 6] |= 1ULL << (slot & 63);
+    }
+
+    bool test_and_clear(tick_t cycle) {
+        const uint64_t slot = cycle & mask;
+        const uint64_t bit = 1ULL << (slot & 63);
+        uint64_t& word = slots[slot >> 6];
+        const bool res = (word & bit) != 0;
+        word &= ~bit;
+        return res;
+    }
+
+    std::vector<uint64_t> slots;
+    uint64_t mask;
+    tick_t next_cycle = 0; /* first cycle that hasn't been advanced over */
+    std::priority_queue<tick_t, std::vector<tick_t>, std::greater<tick_t>> far;
+};
+
+}  // xiosim
+
+#endif /* __TIMING_WHEEL_H__ */
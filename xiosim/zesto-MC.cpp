@@ -54,6 +54,7 @@
 
 #include <limits.h>
 
+#include "frfcfs_scheduler.h"
 #include "memory.h"
 #include "misc.h"
 #include "stats.h"
@@ -58,6 +58,7 @@
 #include "helix.h"
 #include "misc.h"
 #include "regs.h"
+#include "static_knobs.h"
 #include "stats.h"
 #include "ztrace.h"
 
@@ -88,6 +89,8 @@ core_alloc_t::~core_alloc_t()
 
 std::unique_ptr<class core_alloc_t> alloc_create(const char * alloc_opt_string, struct core_t * core)
 {
+  check_static_knobs(core->knobs);
+
 #define ZESTO_PARSE_ARGS
 #include "xiosim/ZPIPE-alloc.list.h"
 
@@ -70,9 +70,11 @@
 
 #include <cmath>
 #include <ctype.h>
+#include <new>
 
 #include "2bitc.h"
 #include "misc.h"
+#include "perceptron_kernels.h"
 #include "stats.h"
 #include "valcheck.h"
 
@@ -112,10 +114,14 @@ our_pred - what the branch predictor had predicted (some predictors
   void reg_stats(xiosim::stats::StatsDatabase* sdb, struct core_t * const core)
 #define BPRED_RESET_STATS_HEADER \
   void reset_stats(void)
-#define BPRED_GET_CACHE_HEADER \
-  class bpred_sc_t * get_cache(void)
-#define BPRED_RET_CACHE_HEADER \
-  void ret_cache(class bpred_sc_t * const scvp)
+/* @sc_type is the component's state cache class, for sizing its slot. */
+#define BPRED_GET_CACHE_HEADER(sc_type) \
+  size_t get_cache_size(void) const { return sizeof(class sc_type); } \
+  class bpred_sc_t * get_cache(void * const mem)
+#define BPRED_SAVE_HEADER \
+  void save(xiosim::checkpoint::writer_t& ckpt) const
+#define BPRED_RESTORE_HEADER \
+  void restore(xiosim::checkpoint::reader_t& ckpt)
 
 #include "xiosim/ZCOMPS-bpred.list.h"
 
@@ -234,17 +240,9 @@ void bpred_dir_t::reset_stats(void)
   spec_updates = 0;
 }
 
-class bpred_sc_t * bpred_dir_t::get_cache(void)
+class bpred_sc_t * bpred_dir_t::get_cache(void * const mem)
 {
-  class bpred_sc_t * sc = new bpred_sc_t();
-  if(!sc)
-    fatal("couldn't calloc default State Cache");
-  return sc;
-}
-
-void bpred_dir_t::ret_cache(class bpred_sc_t * const sc)
-{
-  delete(sc);
+  return new (mem) bpred_sc_t();
 }
 
 /* FUSION/META-PREDICTION
@@ -271,10 +269,13 @@ our_pred - what the meta-predictor had predicted
   void reg_stats(xiosim::stats::StatsDatabase* sdb, struct core_t * const core)
 #define FUSION_RESET_STATS_HEADER \
   void reset_stats(void)
-#define FUSION_GET_CACHE_HEADER \
-  class fusion_sc_t * get_cache(void)
-#define FUSION_RET_CACHE_HEADER \
-  void ret_cache(class fusion_sc_t * const scvp)
+#define FUSION_GET_CACHE_HEADER(sc_type) \
+  size_t get_cache_size(void) const { return sizeof(class sc_type); } \
+  class fusion_sc_t * get_cache(void * const mem)
+#define FUSION_SAVE_HEADER \
+  void save(xiosim::checkpoint::writer_t& ckpt) const
+#define FUSION_RESTORE_HEADER \
+  void restore(xiosim::checkpoint::reader_t& ckpt)
 
 #include "xiosim/ZCOMPS-fusion.list.h"
 
@@ -396,17 +397,9 @@ void fusion_t::reset_stats(void)
   spec_updates = 0;
 }
 
-class fusion_sc_t * fusion_t::get_cache(void)
-{
-  struct fusion_sc_t * sc = new fusion_sc_t();
-  if(!sc)
-    fatal("couldn't calloc default State Cache");
-  return sc;
-}
-
-void fusion_t::ret_cache(class fusion_sc_t * const sc)
+class fusion_sc_t * fusion_t::get_cache(void * const mem)
 {
-  delete(sc);
+  return new (mem) fusion_sc_t();
 }
 
 /* BRANCH TARGET PREDICTION (not including subroutine returns)
@@ -433,10 +426,13 @@ our_pred   - what the branch-predictor had predicted
   void reg_stats(xiosim::stats::StatsDatabase* sdb, struct core_t * const core)
 #define BTB_RESET_STATS_HEADER \
   void reset_stats(void)
-#define BTB_GET_CACHE_HEADER \
-  class BTB_sc_t * get_cache(void)
-#define BTB_RET_CACHE_HEADER \
-  void ret_cache(class BTB_sc_t * const scvp)
+#define BTB_GET_CACHE_HEADER(sc_type) \
+  size_t get_cache_size(void) const { return sizeof(class sc_type); } \
+  class BTB_sc_t * get_cache(void * const mem)
+#define BTB_SAVE_HEADER \
+  void save(xiosim::checkpoint::writer_t& ckpt) const
+#define BTB_RESTORE_HEADER \
+  void restore(xiosim::checkpoint::reader_t& ckpt)
 
 
 #include "xiosim/ZCOMPS-btb.list.h"
@@ -552,17 +548,9 @@ void BTB_t::reset_stats()
   num_nt = 0;
 }
 
-class BTB_sc_t * BTB_t::get_cache(void)
+class BTB_sc_t * BTB_t::get_cache(void * const mem)
 {
-  class BTB_sc_t * sc = new BTB_sc_t();
-  if(!sc)
-    fatal("couldn't calloc default State Cache");
-  return sc;
-}
-
-void BTB_t::ret_cache(class BTB_sc_t * sc)
-{
-  delete(sc);
+  return new (mem) BTB_sc_t();
 }
 
 
@@ -596,10 +584,13 @@ oPC        - oracle PC or actual return address
   void real_push(const md_addr_t PC,const md_addr_t ftPC,const md_addr_t tPC,const md_addr_t oPC)
 #define RAS_REAL_POP \
   md_addr_t real_pop(const md_addr_t PC,const md_addr_t tPC,const md_addr_t oPC)
-#define RAS_GET_STATE_HEADER \
-  class RAS_chkpt_t * get_state(void)
-#define RAS_RET_STATE_HEADER \
-  void ret_state(class RAS_chkpt_t * const cpvp)
+#define RAS_GET_STATE_HEADER(cp_type) \
+  size_t get_state_size(void) const { return sizeof(class cp_type); } \
+  class RAS_chkpt_t * get_state(void * const mem)
+#define RAS_SAVE_HEADER \
+  void save(xiosim::checkpoint::writer_t& ckpt) const
+#define RAS_RESTORE_HEADER \
+  void restore(xiosim::checkpoint::reader_t& ckpt)
 
 
 
@@ -714,15 +705,11 @@ void RAS_t::reset_stats(void)
   num_recovers = 0;
 }
 
-class RAS_chkpt_t * RAS_t::get_state(void)
+class RAS_chkpt_t * RAS_t::get_state(void * const mem)
 {
   return NULL;
 }
 
-void RAS_t::ret_state(class RAS_chkpt_t * const cpvp)
-{
-}
-
 
 
 /*====================================================*/
@@ -773,8 +760,6 @@ bpred_t::bpred_t(
   num_hits = 0;
   frozen = false;
 
-  SC_debt = 0;
-
   init_state_cache_pool(32);
 }
 
@@ -1095,6 +1080,47 @@ void bpred_t::freeze_stats(void)
     indirjmp_BTB->frozen = true;
 }
 
+/* Each component gets its own checkpoint section, identified by its type,
+   name and size, so a run that changes one component still picks up the
+   others. The state caches only hold in-flight branches, so nothing to do
+   for them at a drained pipeline. */
+void bpred_t::save(xiosim::checkpoint::writer_t& ckpt, const std::string& prefix) const
+{
+  auto save_comp = [&](const std::string& key, const auto& comp) {
+    ckpt.begin_section(prefix + "." + key,
+                       comp.type + ":" + comp.name + ":" + std::to_string(comp.bits));
+    comp.save(ckpt);
+  };
+
+  for(int i=0;i<(int)num_pred;i++)
+    save_comp("dir" + std::to_string(i), *bpreds[i]);
+  save_comp("fusion", *fusion);
+  save_comp("dirjmp_BTB", *dirjmp_BTB);
+  if(indirjmp_BTB)
+    save_comp("indirjmp_BTB", *indirjmp_BTB);
+  save_comp("RAS", *ras);
+}
+
+void bpred_t::restore(xiosim::checkpoint::reader_t& ckpt, const std::string& prefix)
+{
+  auto restore_comp = [&](const std::string& key, auto& comp) {
+    if(ckpt.begin_section(prefix + "." + key,
+                          comp.type + ":" + comp.name + ":" + std::to_string(comp.bits)))
+    {
+      comp.restore(ckpt);
+      ckpt.end_section();
+    }
+  };
+
+  for(int i=0;i<(int)num_pred;i++)
+    restore_comp("dir" + std::to_string(i), *bpreds[i]);
+  restore_comp("fusion", *fusion);
+  restore_comp("dirjmp_BTB", *dirjmp_BTB);
+  if(indirjmp_BTB)
+    restore_comp("indirjmp_BTB", *indirjmp_BTB);
+  restore_comp("RAS", *ras);
+}
+
 
 
 /*====================================================================*/
@@ -1104,14 +1130,21 @@ void bpred_t::freeze_stats(void)
    bpred_update structs in the old bpred.[ch], but each predictor
    component may furnish their own struct, so any kind of data may
    be squirreled away without changing any code outside of the
-   predictor implementation.  Since the structs aren't known ahead
-   of time, a new State Cache must be allocated each time a br/jmp
-   instruction is processed, and deallocated when the simulator is
-   done with that inst.  To avoid constantly calloc/free-ing these
-   State Caches, we maintain a pool of these State Caches, reusing
-   the structs whenever we can. */
+   predictor implementation.  Every br/jmp instruction needs one
+   from fetch until it commits or gets squashed, so rather than
+   allocating them one at a time, each State Cache is a fixed-size
+   slot with the component structs laid out inline:
+
+     [bpred_state_cache_t | preds[] | pcache[] | dir preds' sc ... |
+      fusion sc | dirjmp sc | indirjmp sc | RAS checkpoint]
+
+   Slots come from a few large chunks and are recycled through a
+   ring of free slots, so fetch never touches the heap once the
+   pool is as big as the peak number of branches in flight. */
 /*====================================================================*/
 
+#define SC_ALIGN 16
+#define SC_ROUND(x) (((x) + SC_ALIGN - 1) & ~((size_t)SC_ALIGN - 1))
 
 void
 bpred_t::init_state_cache_pool(const int start_size)
@@ -1119,120 +1152,129 @@ bpred_t::init_state_cache_pool(const int start_size)
   if(start_size <= 0)
     fatal("bpred State Cache must be initialized to 1 or more elements");
 
-  bpredSCC_size = start_size;
-  bpredSCC_head = 0;
+  /* lay out a slot */
+  const int num_comps = num_pred + 4;
+  SC_comp_offset = (size_t*) calloc(num_comps,sizeof(*SC_comp_offset));
+  if(!SC_comp_offset)
+    fatal("couldn't calloc bpred SCC layout");
 
-  bpredSCC = (class bpred_state_cache_t**) calloc(start_size,sizeof(*bpredSCC));
-  if(!bpredSCC)
-    fatal("couldn't calloc bpred SCC");
+  size_t offset = SC_ROUND(sizeof(class bpred_state_cache_t) + num_pred*sizeof(bool));
+  SC_pcache_offset = offset;
+  offset = SC_ROUND(offset + num_pred*sizeof(class bpred_sc_t*));
+  for(int i=0;i<(int)num_pred;i++)
+  {
+    SC_comp_offset[i] = offset;
+    offset = SC_ROUND(offset + bpreds[i]->get_cache_size());
+  }
+  SC_comp_offset[num_pred] = offset;
+  offset = SC_ROUND(offset + fusion->get_cache_size());
+  SC_comp_offset[num_pred+1] = offset;
+  offset = SC_ROUND(offset + dirjmp_BTB->get_cache_size());
+  SC_comp_offset[num_pred+2] = offset;
+  if(indirjmp_BTB)
+    offset = SC_ROUND(offset + indirjmp_BTB->get_cache_size());
+  SC_comp_offset[num_pred+3] = offset;
+  offset = SC_ROUND(offset + ras->get_state_size());
+  /* don't let neighboring slots share a line */
+  SC_slot_size = (offset + 63) & ~(size_t)63;
+
+  SC_num_slots = 0;
+  SC_ring = NULL;
+  SC_ring_head = 0;
+  SC_ring_num = 0;
+  grow_state_cache_pool(start_size);
 }
 
-/* Any state caches available in the free pool?  If so, return one
-   and update the pool's pointers.  If not, allocate a new one and
-   return that. */
-class bpred_state_cache_t *
-bpred_t::get_state_cache(void)
+/* Add @num_new slots to the pool (in one new chunk) and put them in
+   the free ring. */
+void
+bpred_t::grow_state_cache_pool(const int num_new)
 {
-  class bpred_state_cache_t * sc;
+  char * chunk;
+  if(posix_memalign((void**)&chunk,64,num_new*SC_slot_size))
+    fatal("couldn't allocate bpred State Cache chunk");
+  SC_chunks.push_back(chunk);
+
+  /* the ring only ever holds free slots, so it needs room for all of
+     them; it's empty when we grow, so no need to keep the old order */
+  assert(SC_ring_num == 0);
+  free(SC_ring);
+  SC_num_slots += num_new;
+  SC_ring = (class bpred_state_cache_t**) calloc(SC_num_slots,sizeof(*SC_ring));
+  if(!SC_ring)
+    fatal("couldn't calloc bpred SCC");
+  SC_ring_head = 0;
 
-  if(!bpredSCC[bpredSCC_head])
+  for(int s=0;s<num_new;s++)
   {
-    SC_debt ++;
-    sc = new bpred_state_cache_t();
-    if(!sc)
-      fatal("couldn't calloc prediction container");
-    sc->preds = (bool*) calloc(num_pred,sizeof(*sc->preds));
-    if(!sc->preds)
-      fatal("couldn't calloc prediction container");
-    sc->pcache = (class bpred_sc_t**) calloc(num_pred,sizeof(class bpred_sc_t**));
-    if(!sc->pcache)
-      fatal("couldn't calloc prediction container");
+    char * const slot = chunk + s*SC_slot_size;
+    memset(slot,0,SC_slot_size);
+    class bpred_state_cache_t * sc = new (slot) bpred_state_cache_t();
+    sc->preds = (bool*) (slot + sizeof(class bpred_state_cache_t));
+    sc->pcache = (class bpred_sc_t**) (slot + SC_pcache_offset);
     for(int i=0;i<(int)num_pred;i++)
-      sc->pcache[i] = bpreds[i]->get_cache();
-    sc->fcache = fusion->get_cache();
-    sc->dirjmp = dirjmp_BTB->get_cache();
+      sc->pcache[i] = bpreds[i]->get_cache(slot + SC_comp_offset[i]);
+    sc->fcache = fusion->get_cache(slot + SC_comp_offset[num_pred]);
+    sc->dirjmp = dirjmp_BTB->get_cache(slot + SC_comp_offset[num_pred+1]);
     if(indirjmp_BTB)
-      sc->indirjmp = indirjmp_BTB->get_cache();
-    sc->ras_checkpoint = ras->get_state();
-  }
-  else
-  {
-    sc = bpredSCC[bpredSCC_head];
-    bpredSCC[bpredSCC_head] = NULL;
-    if(bpredSCC_head > 0)
-      bpredSCC_head--;
+      sc->indirjmp = indirjmp_BTB->get_cache(slot + SC_comp_offset[num_pred+2]);
+    sc->ras_checkpoint = ras->get_state(slot + SC_comp_offset[num_pred+3]);
+    SC_ring[SC_ring_num++] = sc;
   }
+}
+
+/* Hand out the free slot that's been sitting in the ring the
+   longest.  If there's none, double the pool. */
+class bpred_state_cache_t *
+bpred_t::get_state_cache(void)
+{
+  if(!SC_ring_num)
+    grow_state_cache_pool(SC_num_slots);
+
+  class bpred_state_cache_t * sc = SC_ring[SC_ring_head];
+  SC_ring_head = modinc(SC_ring_head,SC_num_slots);
+  SC_ring_num--;
   return sc;
 }
 
 
-/* Simulator's finished using the State Cache, so return it
-   to the pool.  If returning the State Cache to the pool
-   would exceed the pool's capacity, realloc it at twice the
-   size so the number of realloc is only the log2 of the
-   peak number of State Caches simultaneously in use. */
+/* Simulator's finished using the State Cache, so put it at
+   the back of the free ring. */
 void
 bpred_t::return_state_cache(class bpred_state_cache_t * const sc)
 {
-  if(bpredSCC[bpredSCC_head] == NULL)
-  {
-    bpredSCC[bpredSCC_head] = sc;
-    return;
-  }
-
-  if(bpredSCC_head == (bpredSCC_size-1))
-  {
-    const int new_size = bpredSCC_size*2;
-    bpredSCC = (class bpred_state_cache_t**) realloc(bpredSCC,new_size*sizeof(*bpredSCC));
-    if(!bpredSCC)
-      fatal("couldn't realloc bpredSCC");
-    for(int i=bpredSCC_size;i<new_size;i++)
-      bpredSCC[i] = NULL;
-    bpredSCC_size = new_size;
-  }
-
-  bpredSCC_head ++;
-  bpredSCC[bpredSCC_head] = sc;
+  assert(SC_ring_num < SC_num_slots);
+  int tail = SC_ring_head + SC_ring_num;
+  if(tail >= SC_num_slots)
+    tail -= SC_num_slots;
+  SC_ring[tail] = sc;
+  SC_ring_num++;
 }
 
 /* At the very end of the simulation, we need to clean up.
-   This frees any State Caches still in the pool, as well
-   as the array for the pool itself. */
+   State Caches are trivially destructible, so this just frees
+   the chunks and the ring. */
 void
 bpred_t::destroy_state_cache_pool(void)
 {
-  struct bpred_state_cache_t * sc;
-
-  for(int i=0;i<bpredSCC_size;i++)
-  {
-    sc = bpredSCC[i];
-    if(sc)
-    {
-      ras->ret_state(sc->ras_checkpoint);
-      if(indirjmp_BTB)
-        indirjmp_BTB->ret_cache(sc->indirjmp);
-      dirjmp_BTB->ret_cache(sc->dirjmp);
-      fusion->ret_cache(sc->fcache);
-      for(int j=0;j<(int)num_pred;j++)
-        bpreds[j]->ret_cache(sc->pcache[j]);
-      free(sc->pcache); sc->pcache = NULL;
-      free(sc->preds); sc->preds = NULL;
-      delete(sc);
-      SC_debt --;
-    }
-    bpredSCC[i] = NULL;
-  }
-
-  /* Did we free the same number of State Caches as we
-     allocated? */
-  if(SC_debt)
-    fprintf(stderr,"warning (bpred): Leaked state caches = %d\n",SC_debt);
-
-  free(bpredSCC);
-  bpredSCC = NULL;
-  bpredSCC_size = 0;
-  bpredSCC_head = 0;
+  /* Did we get back all the State Caches we handed out? */
+  if(SC_ring_num != SC_num_slots)
+    fprintf(stderr,"warning (bpred): Leaked state caches = %d\n",SC_num_slots-SC_ring_num);
+
+  for(void * chunk : SC_chunks)
+    free(chunk);
+  SC_chunks.clear();
+  free(SC_ring);
+  SC_ring = NULL;
+  free(SC_comp_offset);
+  SC_comp_offset = NULL;
+  SC_num_slots = 0;
+  SC_ring_head = 0;
+  SC_ring_num = 0;
 }
 
+#undef SC_ROUND
+#undef SC_ALIGN
+
 #undef BPRED_STAT
 
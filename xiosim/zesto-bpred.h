@@ -57,6 +57,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+#include "checkpoint.h"
 
 #include "zesto-structs.h"
 
@@ -80,10 +83,18 @@ class bpred_t
   std::unique_ptr<class BTB_t> indirjmp_BTB; /* indirect (computed) br/jmp target predictor;
                                         if only one BTB is used for all targets, then
                                         these pointers will point to the same place. */
-  int bpredSCC_size;
-  int bpredSCC_head;
-  class bpred_state_cache_t ** bpredSCC;
-  int SC_debt;
+  /* State caches live in fixed-size slots, carved out of a few big
+     chunks, with every component's per-branch state laid out inline.
+     Free slots sit in a ring and get handed out in the order they
+     came back (i.e., program order at commit). */
+  size_t SC_slot_size;
+  size_t SC_pcache_offset;
+  size_t *SC_comp_offset;     /* dir preds, then fusion, dirjmp, indirjmp, RAS */
+  std::vector<void*> SC_chunks;
+  int SC_num_slots;
+  class bpred_state_cache_t ** SC_ring;
+  int SC_ring_head;
+  int SC_ring_num;
 
   /* stats on branch type distributions */
   counter_t num_lookups;
@@ -147,6 +158,10 @@ class bpred_t
   void reset_stats();
   void freeze_stats();
 
+  /* Checkpoint the state of all components, in sections named @prefix.* */
+  void save(xiosim::checkpoint::writer_t& ckpt, const std::string& prefix) const;
+  void restore(xiosim::checkpoint::reader_t& ckpt, const std::string& prefix);
+
   /* instead of the bpred_update structs used in the
      old bpred.[ch], each predictor can provide its
      own structs for caching away whatever state it
@@ -161,6 +176,7 @@ class bpred_t
 
   private: /* called from constructor/destructor */
   void   init_state_cache_pool(int /* initial pool size */);
+  void   grow_state_cache_pool(int /* number of new slots */);
   void   destroy_state_cache_pool(void);
 };
 
@@ -235,9 +251,16 @@ class bpred_dir_t
 
   virtual void reset_stats(void);
 
-  virtual class bpred_sc_t * get_cache(void);
+  /* Write/read the prediction tables and histories. Stateless predictors
+     don't need to. */
+  virtual void save(xiosim::checkpoint::writer_t& ckpt) const {}
+  virtual void restore(xiosim::checkpoint::reader_t& ckpt) {}
 
-  virtual void ret_cache(class bpred_sc_t * const scvp);
+  /* Construct a state cache in @mem, which holds get_cache_size() bytes.
+     State caches are never destroyed, just reused, so they must be
+     trivially destructible. */
+  virtual size_t get_cache_size(void) const { return sizeof(class bpred_sc_t); }
+  virtual class bpred_sc_t * get_cache(void * const mem);
 
   virtual int get_local_size(void) { return 0; };
   virtual int get_local_width(int lev) { return 0; };
@@ -312,9 +335,11 @@ class fusion_t
 
   virtual void reset_stats(void);
 
-  virtual class fusion_sc_t * get_cache(void);
+  virtual void save(xiosim::checkpoint::writer_t& ckpt) const {}
+  virtual void restore(xiosim::checkpoint::reader_t& ckpt) {}
 
-  virtual void ret_cache(class fusion_sc_t * const scvp);
+  virtual size_t get_cache_size(void) const { return sizeof(class fusion_sc_t); }
+  virtual class fusion_sc_t * get_cache(void * const mem);
 };
 
 class BTB_sc_t:public bpred_sc_t
@@ -382,9 +407,11 @@ class BTB_t
 
   virtual void reset_stats();
 
-  virtual class BTB_sc_t * get_cache(void);
+  virtual void save(xiosim::checkpoint::writer_t& ckpt) const {}
+  virtual void restore(xiosim::checkpoint::reader_t& ckpt) {}
 
-  virtual void ret_cache(class BTB_sc_t * const scvp);
+  virtual size_t get_cache_size(void) const { return sizeof(class BTB_sc_t); }
+  virtual class BTB_sc_t * get_cache(void * const mem);
 
   virtual int get_num_entries(void) = 0;
   virtual int get_tag_width(void) = 0;
@@ -440,9 +467,13 @@ class RAS_t
 
   virtual void reset_stats();
 
-  virtual class RAS_chkpt_t * get_state(void);
+  virtual void save(xiosim::checkpoint::writer_t& ckpt) const {}
+  virtual void restore(xiosim::checkpoint::reader_t& ckpt) {}
 
-  virtual void ret_state(class RAS_chkpt_t * const cpvp);
+  /* Construct a recovery checkpoint in @mem, which holds get_state_size()
+     bytes. Stacks without recovery state don't need one. */
+  virtual size_t get_state_size(void) const { return 0; }
+  virtual class RAS_chkpt_t * get_state(void * const mem);
 
   virtual void real_push(
       const md_addr_t PC,
@@ -465,8 +496,8 @@ class RAS_t
    predictor to the next, and so we allow each predictor to
    define any kind of state container or cache that they wish
    to.  As part of the standard predictor interface, each predictor
-   provides functions for allocating and destroying these
-   containers. */
+   reports how big its container is and constructs one in memory
+   handed to it by bpred_t. */
 class bpred_state_cache_t
 {
   friend class bpred_t;
@@ -52,6 +52,7 @@
  * Georgia Institute of Technology, Atlanta, GA 30332-0765
  */
 
+#include <algorithm>
 #include <ctype.h>
 #include <limits.h>
 #include <cmath>
@@ -74,11 +75,16 @@
 #include "zesto-exec.h"
 #include "zesto-commit.h"
 
+#include "sim.h"
+
 #define CACHE_STAT(x) {if(!cp->frozen) {x}}
 
 #define GET_BANK(x) (((x)>>cp->bank_shift) & cp->bank_mask)
 #define GET_MSHR_BANK(x) (((x)>>cp->bank_shift) & cp->MSHR_mask)
 
+/* lines per chunk of set storage with sparse_sets (1MB) */
+#define CACHE_CHUNK_LINES (1 << 16)
+
 #ifdef ZTRACE
 #ifndef CACHE_ZTRACE
 
@@ -93,6 +99,7 @@ XIOSIM_LOCK cache_lock;
 
 static void prefetch_buffer_destroy(struct cache_t* const cp);
 static void prefetch_filter_destroy(struct cache_t * const cp);
+static struct cache_line_t * cache_get_set(struct cache_t * const cp, const int index);
 
 /* Helper to parse MSRH cmd order parameter. */
 static void cache_set_MSHR_cmd_order(struct cache_t* cp, const char* const MSHR_cmd) {
@@ -160,7 +167,8 @@ std::unique_ptr<struct cache_t> cache_create(
     struct bus_t * const next_bus, /* e.g., for the DL1, this should point to the bus between DL1 and L2 */
     const float magic_hit_rate,
     bool sample_misses,
-    const char * const MSHR_cmd)
+    const char * const MSHR_cmd,
+    const bool sparse_sets)
 {
   int i;
   struct cache_t * cp = new cache_t();
@@ -223,6 +231,7 @@ std::unique_ptr<struct cache_t> cache_create(
   cp->next_bus = next_bus;
   cp->check_for_work = true;
   cp->check_for_MSHR_fill_work = true;
+  cp->events = std::make_unique<xiosim::timing_wheel_t>(latency + 1);
   cp->magic_hit_rate = magic_hit_rate;
   cp->sample_misses = sample_misses;
 
@@ -243,23 +252,14 @@ std::unique_ptr<struct cache_t> cache_create(
   if((banks & (banks-1)) != 0)
     fatal("%s banks must be power of two");
 
-  cp->blocks = new cache_line_t* [sets]();
-  cp->blocks_owners = new std::unique_ptr<struct cache_line_t[]>[sets]();
-  for(i=0;i<sets;i++)
-  {
-    /* allocate as one big block! */
-    struct cache_line_t* line = new cache_line_t[assoc]();
-    memset(line, 0, assoc * sizeof(*line));
-    cp->blocks_owners[i].reset(line);
+  if(assoc >= NO_WAY)
+    fatal("%s associativity must be less than %d", name, NO_WAY);
 
-    for(int j=0;j<assoc;j++)
-    {
-      line[j].way = j;
-      line[j].next = &line[j+1];
-    }
-    line[assoc-1].next = NULL;
-    cp->blocks[i] = line;
-  }
+  cp->blocks = new cache_set_t[sets]();
+  cp->sparse_sets = sparse_sets;
+  if(!sparse_sets)
+    for(i=0;i<sets;i++)
+      cache_get_set(cp, i);
 
   cp->heap_size = 1 << ((int) rint(ceil(log(latency+1)/log(2.0))));
 
@@ -344,7 +344,6 @@ cache_t::~cache_t() {
     free(this->pipe_num);
     free(this->pipe);
 
-    delete[] this->blocks_owners;
     delete[] this->blocks;
 
     free(this->PFF);
@@ -421,6 +420,9 @@ void cache_reg_stats(xiosim::stats::StatsDatabase* sdb,
             stat_reg_cache_formula(sdb, true, coreID, cp->name, "pf_miss_rate",
                                    "prefetch miss rate in %s", pf_misses_st / pf_lookups_st,
                                    "%12.4f");
+            stat_reg_cache_counter(sdb, true, coreID, cp->name, "pf_MSHR_hits",
+                                   "number of prefetches dropped, already in the MSHRs of %s",
+                                   &cp->stat.prefetch_MSHR_hits, 0, true, NULL);
 
             auto& pf_insertions_st = stat_reg_cache_counter(sdb, true, coreID, cp->name, "pf_insertions",
                                    "number of prefetched blocks inserted into %s",
@@ -480,6 +482,9 @@ void cache_reg_stats(xiosim::stats::StatsDatabase* sdb,
             stat_reg_cache_formula(sdb, true, coreID, cp->name, "pf_miss_rate",
                                    "prefetch miss rate in %s", pf_misses_st / pf_lookups_st,
                                    "%12.4f");
+            stat_reg_cache_counter(sdb, true, coreID, cp->name, "pf_MSHR_hits",
+                                   "number of prefetches dropped, already in the MSHRs of %s",
+                                   &cp->stat.prefetch_MSHR_hits, 0, true, NULL);
 
             auto& pf_insertions_st = stat_reg_cache_counter(sdb, true, coreID, cp->name, "pf_insertions",
                                    "number of prefetched blocks inserted into %s",
@@ -604,6 +609,9 @@ void LLC_reg_stats(xiosim::stats::StatsDatabase* sdb, struct cache_t* const cp)
                                  &cp->stat.prefetch_misses, 0, true, NULL);
         stat_reg_formula(sdb, true, "LLC.pf_miss_rate", "prefetch miss rate in LLC",
                          LLC_pf_misses_st / LLC_pf_lookups_st, "%12.4f");
+        stat_reg_counter(sdb, true, "LLC.pf_MSHR_hits",
+                         "number of prefetches dropped, already in the MSHRs of LLC",
+                         &cp->stat.prefetch_MSHR_hits, 0, true, NULL);
 
         auto& LLC_pf_insertions_st = stat_reg_counter(
                 sdb, true, "LLC.pf_insertions", "number of prefetched blocks inserted into LLC",
@@ -854,6 +862,9 @@ void prefetchers_create(struct cache_t* cp, const prefetcher_knobs_t& pf_knobs)
     cp->PFF = (cache_t::PFF_t*)calloc(pf_knobs.pff_size, sizeof(*cp->PFF));
     if (!cp->PFF)
         fatal("failed to calloc %s's prefetch FIFO", cp->name);
+    if (pf_knobs.pff_issue_width < 1)
+        fatal("%s's prefetch issue width has to be at least 1", cp->name);
+    cp->PFF_issue_width = pf_knobs.pff_issue_width;
 
     cp->prefetch_threshold = pf_knobs.pf_thresh;
     cp->prefetch_max = pf_knobs.pf_max;
@@ -867,6 +878,58 @@ void prefetchers_create(struct cache_t* cp, const prefetcher_knobs_t& pf_knobs)
     cp->PF_high_watermark = pf_knobs.high_watermark;
 }
 
+/* Give set @index its lines, if it doesn't have them yet. */
+static struct cache_line_t * cache_get_set(
+    struct cache_t * const cp,
+    const int index)
+{
+  struct cache_set_t * const set = &cp->blocks[index];
+  if(set->lines)
+    return set->lines;
+
+  if(cp->chunk_free_num < cp->assoc)
+  {
+    /* Left-overs are less than a set; not worth keeping. Without sparse_sets,
+       everything comes from a single chunk. */
+    int chunk_sets = cp->sets - cp->sets_allocated;
+    if(cp->sparse_sets)
+      chunk_sets = std::min(chunk_sets, std::max(1, CACHE_CHUNK_LINES / cp->assoc));
+    /* not value-initialized, so the host only backs pages that get used */
+    struct cache_line_t * chunk = new cache_line_t[chunk_sets * cp->assoc];
+    cp->line_chunks.emplace_back(chunk);
+    cp->chunk_free = chunk;
+    cp->chunk_free_num = chunk_sets * cp->assoc;
+  }
+
+  struct cache_line_t * const lines = cp->chunk_free;
+  cp->chunk_free += cp->assoc;
+  cp->chunk_free_num -= cp->assoc;
+  cp->sets_allocated++;
+
+  memset(lines, 0, cp->assoc * sizeof(*lines));
+  for(int j=0;j<cp->assoc;j++)
+  {
+    lines[j].way = j;
+    lines[j].next = j+1;
+  }
+  lines[cp->assoc-1].next = NO_WAY;
+  set->head = 0;
+  set->lines = lines;
+  return lines;
+}
+
+static inline struct cache_line_t * next_line(
+    struct cache_line_t * const lines,
+    const struct cache_line_t * const p)
+{
+  return (p->next == NO_WAY) ? NULL : &lines[p->next];
+}
+
+static inline struct core_t * cache_line_core(const struct cache_line_t * const line)
+{
+  return line->core_id ? cores[line->core_id - 1] : NULL;
+}
+
 /* Check to see if a given address can be found in the cache.  This is only a "peek" function
    in that it does not update any hit/miss stats, although it does update replacement state. */
 struct cache_line_t * cache_is_hit(
@@ -877,21 +940,27 @@ struct cache_line_t * cache_is_hit(
 {
   const md_paddr_t block_addr = addr >> cp->addr_shift;
   const int index = block_addr & (cp->sets-1);
-  struct cache_line_t * p = cp->blocks[index];
-  struct cache_line_t * prev = NULL;
+  struct cache_set_t * const set = &cp->blocks[index];
 
   /* Predefined hit rate for magic simulation. Doesn't properly maintain
    * replacement state, but hey, magic. */
   if(cp->magic_hit_rate != -1.0) {
     float r = random() / float(RAND_MAX);
     if (r < cp->magic_hit_rate) {
-      assert(p != NULL);
-      return p;
+      struct cache_line_t * const lines = cache_get_set(cp, index);
+      return &lines[set->head];
     }
     else
       return NULL;
   }
 
+  struct cache_line_t * const lines = set->lines;
+  if(!lines) /* never touched */
+    return NULL;
+
+  struct cache_line_t * p = &lines[set->head];
+  struct cache_line_t * prev = NULL;
+
   while(p) /* search all of the ways */
   {
     if(p->valid && (p->tag == block_addr)) /* hit */
@@ -901,7 +970,7 @@ struct cache_line_t * cache_is_hit(
         {
           case REPLACE_PLRU: /* tree-based pseudo-LRU */
           {
-            int bitmask = cp->blocks[index][0].meta;
+            int bitmask = lines[set->head].meta;
             const int way = p->way;
             for(int i=0;i<cp->log2_assoc;i++)
             {
@@ -912,7 +981,7 @@ struct cache_line_t * cache_is_hit(
               else
                 bitmask &= ~(1<<pos);
             }
-            cp->blocks[index][0].meta = bitmask;
+            lines[set->head].meta = bitmask;
           }
           XIOSIM_FALLTHROUGH;
             /* NO BREAK IN THE CASE STATEMENT HERE: Do the LRU ordering, too.
@@ -927,35 +996,35 @@ struct cache_line_t * cache_is_hit(
               if(prev) /* insert back at front of list */
               {
                 prev->next = p->next;
-                p->next = cp->blocks[index];
-                cp->blocks[index] = p;
+                p->next = set->head;
+                set->head = p->way;
               }
               break;
             }
           case REPLACE_MRU:
             {
-              if(p->next) /* only move node if not already at end of list */
+              if(p->next != NO_WAY) /* only move node if not already at end of list */
               {
                 /* remove node */
                 if(prev)
                   prev->next = p->next;
                 else
-                  cp->blocks[index] = p->next;
+                  set->head = p->next;
 
                 /* go to end of list */
-                prev = p->next;
-                while(prev->next)
-                  prev = prev->next;
+                prev = &lines[p->next];
+                while(prev->next != NO_WAY)
+                  prev = &lines[prev->next];
 
                 /* stick ourselves there */
-                prev->next = p;
-                p->next = NULL;
+                prev->next = p->way;
+                p->next = NO_WAY;
               }
               break;
             }
           case REPLACE_CLOCK:
           {
-            cp->blocks[index][0].meta |= 1ULL<<p->way; /* set referenced bit */
+            set->clock_refs |= 1ULL<<p->way; /* set referenced bit */
             break;
           }
           default:
@@ -972,7 +1041,7 @@ struct cache_line_t * cache_is_hit(
       return p;
     }
     prev = p;
-    p = p->next;
+    p = next_line(lines, p);
   }
 
   /* miss */
@@ -981,21 +1050,25 @@ struct cache_line_t * cache_is_hit(
 
 /* Check to see if a given address can be found in the cache.  This is a *true* "peek"
    function; the replacement state is not touched. */
-static struct cache_line_t * cache_peek(
+struct cache_line_t * cache_peek(
     const struct cache_t * const cp,
     const md_paddr_t addr)
 {
   const md_paddr_t block_addr = addr >> cp->addr_shift;
   const int index = block_addr & (cp->sets-1);
-  struct cache_line_t * p = cp->blocks[index];
+  const struct cache_set_t * const set = &cp->blocks[index];
+  struct cache_line_t * const lines = set->lines;
+  if(!lines) /* never touched */
+    return NULL;
 
+  struct cache_line_t * p = &lines[set->head];
   while(p) /* search all of the ways */
   {
     if(p->valid && (p->tag == block_addr)) /* hit */
     {
       return p;
     }
-    p = p->next;
+    p = next_line(lines, p);
   }
 
   /* miss */
@@ -1015,7 +1088,9 @@ void cache_insert_block(
   /* assumes block not already present */
   const md_paddr_t block_addr = addr >> cp->addr_shift;
   const int index = block_addr & (cp->sets-1);
-  struct cache_line_t * p = cp->blocks[index];
+  struct cache_set_t * const set = &cp->blocks[index];
+  struct cache_line_t * const lines = cache_get_set(cp, index);
+  struct cache_line_t * p = &lines[set->head];
   struct cache_line_t *prev = NULL;
 
   /* there had better be an invalid line now - cache_get_evictee should
@@ -1025,13 +1100,16 @@ void cache_insert_block(
     if(!p->valid)
       break;
     prev = p;
-    p = p->next;
+    p = next_line(lines, p);
   }
 
   cache_assert(p,(void)0);
+  if(block_addr >> 48)
+    fatal("%s: block address 0x%" PRIx64" doesn't fit in a tag", cp->name, block_addr);
   p->tag = block_addr;
-  p->core = core;
+  p->core_id = core ? core->id + 1 : 0;
   p->valid = true;
+  p->coh.v = 0;
   if(cmd == CACHE_WRITE || cmd == CACHE_WRITEBACK)
     p->dirty = true;
   else
@@ -1048,7 +1126,7 @@ void cache_insert_block(
     {
       case REPLACE_PLRU: /* tree-based pseudo-LRU */
       {
-        int bitmask = cp->blocks[index][0].meta;
+        int bitmask = lines[set->head].meta;
         const int way = p->way;
         for(int i=0;i<cp->log2_assoc;i++)
         {
@@ -1059,7 +1137,7 @@ void cache_insert_block(
           else
             bitmask &= ~(1<<pos);
         }
-        cp->blocks[index][0].meta = bitmask;
+        lines[set->head].meta = bitmask;
       }
       XIOSIM_FALLTHROUGH;
       /* same comment about case statement fall-through as in cache_is_hit() */
@@ -1069,27 +1147,27 @@ void cache_insert_block(
         if(prev) /* put to front of list */
         {
           prev->next = p->next;
-          p->next = cp->blocks[index];
-          cp->blocks[index] = p;
+          p->next = set->head;
+          set->head = p->way;
         }
         break;
       case REPLACE_MRU:
-        if(p->next) /* only move node if not already at end of list */
+        if(p->next != NO_WAY) /* only move node if not already at end of list */
         {
           /* remove node */
           if(prev)
             prev->next = p->next;
           else
-            cp->blocks[index] = p->next;
+            set->head = p->next;
 
           /* go to end of list */
-          prev = p->next;
-          while(prev->next)
-            prev = prev->next;
+          prev = &lines[p->next];
+          while(prev->next != NO_WAY)
+            prev = &lines[prev->next];
 
           /* stick ourselves there */
-          prev->next = p;
-          p->next = NULL;
+          prev->next = p->way;
+          p->next = NO_WAY;
         }
         break;
       case REPLACE_CLOCK:
@@ -1112,7 +1190,9 @@ struct cache_line_t * cache_get_evictee(
 {
   int block_addr = addr >> cp->addr_shift;
   int index = block_addr & (cp->sets-1);
-  struct cache_line_t * p = cp->blocks[index];
+  struct cache_set_t * const set = &cp->blocks[index];
+  struct cache_line_t * const lines = cache_get_set(cp, index);
+  struct cache_line_t * p = &lines[set->head];
 
   switch(cp->replacement_policy)
   {
@@ -1122,10 +1202,10 @@ struct cache_line_t * cache_get_evictee(
     {
       while(p)
       {
-        if(!p->next || !p->valid) /* take any invalid line, else take the last one (LRU) */
+        if((p->next == NO_WAY) || !p->valid) /* take any invalid line, else take the last one (LRU) */
           return p;
 
-        p = p->next;
+        p = next_line(lines, p);
       }
       break;
     }
@@ -1137,16 +1217,16 @@ struct cache_line_t * cache_get_evictee(
         if(!p->valid) /* take any invalid line */
           return p;
 
-        p = p->next;
+        p = next_line(lines, p);
       }
 
       if(!p) /* no invalid line, pick at random */
       {
         const int pos = random() % cp->assoc;
-        p = cp->blocks[index];
+        p = &lines[set->head];
 
         for(int i=0;i<pos;i++)
-          p = p->next;
+          p = next_line(lines, p);
 
         return p;
       }
@@ -1160,23 +1240,23 @@ struct cache_line_t * cache_get_evictee(
       {
         if(!p->valid) /* take any invalid line */
           return p;
-        p = p->next;
+        p = next_line(lines, p);
       }
 
       if((cp->assoc > 1) && !p) /* no invalid line, pick at random from non-MRU */
       {
         const int pos = random() % (cp->assoc-1);
-        p = cp->blocks[index];
-        p = p->next; /* skip MRU */
+        p = &lines[set->head];
+        p = next_line(lines, p); /* skip MRU */
 
         for(int i=0;i<pos;i++)
-          p = p->next;
+          p = next_line(lines, p);
       }
       return p;
     }
     case REPLACE_PLRU:
     {
-      int bitmask = cp->blocks[index][0].meta;
+      int bitmask = lines[set->head].meta;
       int i;
       int node = 1;
 
@@ -1184,7 +1264,7 @@ struct cache_line_t * cache_get_evictee(
       {
         if(!p->valid) /* take any invalid line */
           return p;
-        p = p->next;
+        p = next_line(lines, p);
       }
 
       for(i=0;i<cp->log2_assoc;i++)
@@ -1196,12 +1276,12 @@ struct cache_line_t * cache_get_evictee(
 
       const int way = node & ~(1<<cp->log2_assoc);
 
-      p = cp->blocks[index];
+      p = &lines[set->head];
       for(i=0;i<cp->assoc;i++)
       {
         if(p->way==way)
           break;
-        p = p->next;
+        p = next_line(lines, p);
       }
 
       return p;
@@ -1212,24 +1292,24 @@ struct cache_line_t * cache_get_evictee(
 
       while(1)
       {
-        uint64_t way = cp->blocks[index][1].meta;
-        struct cache_line_t * p = &cp->blocks[index][way];
+        const int way = set->clock_hand;
+        struct cache_line_t * p = &lines[way];
 
         /* increment clock */
-        cp->blocks[index][1].meta = modinc(way,cp->assoc); //(way+1) % cp->assoc;
+        set->clock_hand = modinc(way,cp->assoc); //(way+1) % cp->assoc;
 
         if(!p->valid) /* take any invalid line */
         {
-          cp->blocks[index][0].meta &= ~(1ULL<<p->way); /* make sure referenced bit is clear */
+          set->clock_refs &= ~(1ULL<<p->way); /* make sure referenced bit is clear */
           return p;
         }
-        else if(!((cp->blocks[index][0].meta >> p->way) & 1)) /* not referenced */
+        else if(!((set->clock_refs >> p->way) & 1)) /* not referenced */
         {
           return p;
         }
         else
         {
-          cp->blocks[index][0].meta &= ~(1ULL<<p->way); /* clear referenced bit */
+          set->clock_refs &= ~(1ULL<<p->way); /* clear referenced bit */
         }
 
         just_in_case++;
@@ -1410,6 +1490,7 @@ void cache_enqueue(
 
   cp->check_for_work = true;
   cp->check_for_pipe_work = true;
+  cp->events->schedule(cache_get_cycle(cp)+cp->latency);
 
 }
 
@@ -1419,6 +1500,35 @@ void dummy_callback(void * p)
      in a write-back cache */
 }
 
+/* Will a miss for @cmd fill the line into the cache? */
+static inline bool MSHR_fills(
+    const struct cache_t * const cp,
+    const enum cache_command cmd)
+{
+  return (cmd == CACHE_READ) || (cmd == CACHE_PREFETCH) || (cp->allocate_policy == WRITE_ALLOC);
+}
+
+/* Returns true if a miss that fills @paddr's line is already in the MSHRs.
+   A line only ever goes to one (small) MSHR bank, so we just scan it. */
+static inline bool MSHR_line_pending(
+    const struct cache_t * const cp,
+    const md_paddr_t paddr)
+{
+  const int bank = GET_MSHR_BANK(paddr);
+  if(!cp->MSHR_fill_num[bank])
+    return false;
+
+  const md_paddr_t line = paddr >> cp->addr_shift;
+  for(int i=0;i<cp->MSHR_size;i++)
+  {
+    const struct cache_action_t * const MSHR = &cp->MSHR[bank][i];
+    if(MSHR->cb && (MSHR->type == MSHR_MISS) && MSHR_fills(cp, MSHR->cmd) &&
+       ((MSHR->paddr >> cp->addr_shift) == line))
+      return true;
+  }
+  return false;
+}
+
 /* Returns true if at least one MSHR entry is free/available. */
 static inline int MSHR_available(
     const struct cache_t * const cp,
@@ -1543,7 +1653,7 @@ static void MSHR_WB_insert(
   cp->MSHR_WB_num[new_bank]++;
   cache_assert(cp->MSHR_WB_num[new_bank] <= cp->MSHR_WB_size, (void)NULL);
 
-  MSHR->core = cache_block->core;
+  MSHR->core = cache_line_core(cache_block);
   MSHR->op = NULL;
   MSHR->PC = 0;
   MSHR->paddr = new_addr;
@@ -1621,6 +1731,7 @@ void fill_arrived(
   cp->check_for_work = true;
   cp->check_for_MSHR_fill_work = true;
   cp->check_for_MSHR_WB_work = true;
+  cp->events->schedule(cache_get_cycle(cp) + delay);
 
   if(MSHR->cb != NULL) /* original request was squashed */
     MSHR->when_returned = cache_get_cycle(cp) + delay;
@@ -1788,6 +1899,7 @@ static inline void cache_fill(
   cache_assert(cp->fill_num[bank] <= cp->latency,(void)0);
   cp->check_for_work = true;
   cp->check_for_fill_work = true;
+  cp->events->schedule(cache_get_cycle(cp)+cp->latency);
 }
 
 /* update hit/miss stats for a request about to leave the pipeline. */
@@ -2050,7 +2162,14 @@ static void cache_process_fills(struct cache_t * const cp, int start_point)
         fill_work_found = true;
         if(cf->valid && cf->pipe_exit_time <= cache_get_cycle(cp))
         {
-          if(!cache_peek(cp,cf->paddr)) /* make sure hasn't been filled in the meantime */
+          struct cache_line_t * present = cache_peek(cp,cf->paddr);
+          if(present) /* filled in the meantime, or an upgrade of a line we already have */
+          {
+            if(cf->cmd == CACHE_WRITE || cf->cmd == CACHE_WRITEBACK)
+              present->dirty = true;
+            present->coh.v = 0;
+          }
+          else
           {
             struct cache_line_t * p = cache_get_evictee(cp,cf->paddr,cf->core);
             md_paddr_t new_addr = p->tag << cp->addr_shift;
@@ -2143,7 +2262,7 @@ static void cache_process_pipe(struct cache_t * const cp, int start_point)
             /* Check cache array and ask controller for an OK after hit there */
             struct cache_line_t * line = cache_is_hit(cp,ca->cmd,ca->paddr,ca->core);
 
-            controller_array_response_t res = cp->controller->check_array(line);
+            controller_array_response_t res = cp->controller->check_array(line, ca->cmd);
             if(res == ARRAY_MISS)
               line = NULL;
 
@@ -2160,7 +2279,7 @@ static void cache_process_pipe(struct cache_t * const cp, int start_point)
               if(needs_WB)
               {
                 struct cache_line_t tmp_line;
-                tmp_line.core = ca->core;
+                tmp_line.core_id = ca->core ? ca->core->id + 1 : 0;
                 tmp_line.tag = ca->paddr >> cp->addr_shift;
                 tmp_line.valid = true;
                 tmp_line.dirty = false;
@@ -2296,6 +2415,13 @@ static void cache_process_pipe(struct cache_t * const cp, int start_point)
                   if(memory::page_round_down(pf_addr)) { /* don't prefetch from zeroth page */
                     int j;
 
+                    /* already on its way from the next level */
+                    if(MSHR_line_pending(cp, pf_addr))
+                    {
+                      CACHE_STAT(cp->stat.prefetch_MSHR_hits++;)
+                      continue;
+                    }
+
                     /* search PFF to see if pf_addr already requested */
                     int already_requested = false;
                     int index = cp->PFF_head;;
@@ -2573,6 +2699,80 @@ static void cache_process_MSHR(struct cache_t * const cp, int start_point)
   CACHE_STAT(cp->stat.MSHR_full_cycles += (total_occ == max_size);)
 }
 
+/* Is there anything the next cycle can act on right away?  That is, work
+   that's already due but didn't get done this cycle (one request per bank
+   and cycle, blocked on a bus or an MSHR), or is waiting on something other
+   than time (MSHR requests not sent yet, writebacks). */
+static bool cache_has_ready_work(const struct cache_t * const cp)
+{
+  const tick_t now = cache_get_cycle(cp);
+  for(int b=0;b<cp->banks;b++)
+  {
+    if(cp->pipe_num[b] && (!cp->pipe[b][1].cb || cp->pipe[b][1].pipe_exit_time <= now))
+      return true;
+    if(cp->fill_num[b] && cp->fill_pipe[b][1].pipe_exit_time <= now)
+      return true;
+  }
+  for(int b=0;b<cp->MSHR_banks;b++)
+  {
+    if(cp->MSHR_unprocessed_num[b])
+      return true;
+    if(!cp->MSHR_num[b] && !cp->MSHR_WB_num[b])
+      continue;
+    for(int i=0;i<cp->MSHR_size;i++)
+    {
+      const struct cache_action_t * MSHR = &cp->MSHR[b][i];
+      if(!MSHR->cb)
+        continue;
+      if((MSHR->type == MSHR_WRITEBACK) && (MSHR->when_started == TICK_T_MAX))
+        return true;
+      if(MSHR->when_returned <= now)
+        return true;
+    }
+  }
+  return false;
+}
+
+/* A cycle with nothing due.  The full cycle would only have moved the bank
+   arbitration along, sampled MSHR occupancy and cleared the work flags of
+   empty structures -- do just that, from the occupancy counters. */
+static void cache_process_idle(struct cache_t * const cp)
+{
+  cp->start_point = modinc(cp->start_point,cp->banks);
+
+  int pipe_num = 0, fill_num = 0;
+  for(int b=0;b<cp->banks;b++)
+  {
+    pipe_num += cp->pipe_num[b];
+    fill_num += cp->fill_num[b];
+  }
+  int MSHR_num = 0, MSHR_WB_num = 0, MSHR_fill_num = 0;
+  for(int b=0;b<cp->MSHR_banks;b++)
+  {
+    MSHR_num += cp->MSHR_num[b];
+    MSHR_WB_num += cp->MSHR_WB_num[b];
+    MSHR_fill_num += cp->MSHR_fill_num[b];
+  }
+
+  /* an empty writeback buffer keeps its flag as long as the bus is busy */
+  if(cp->check_for_MSHR_WB_work && !MSHR_WB_num)
+    cp->check_for_MSHR_WB_work = !cp->controller->can_schedule_upstream();
+  cp->check_for_MSHR_fill_work = cp->check_for_MSHR_fill_work && MSHR_fill_num;
+  cp->check_for_fill_work = cp->check_for_fill_work && fill_num;
+  cp->check_for_pipe_work = cp->check_for_pipe_work && pipe_num;
+  cp->check_for_MSHR_work = cp->check_for_MSHR_work && MSHR_num;
+
+  int total_occ = MSHR_num + MSHR_WB_num;
+  CACHE_STAT(cp->stat.MSHR_occupancy += total_occ;)
+  CACHE_STAT(cp->stat.MSHR_full_cycles += (total_occ == cp->MSHR_banks * cp->MSHR_size);)
+
+  cp->check_for_work = cp->check_for_MSHR_WB_work ||
+                        cp->check_for_MSHR_fill_work ||
+                        cp->check_for_fill_work ||
+                        cp->check_for_pipe_work ||
+                        cp->check_for_MSHR_work;
+}
+
 /* simulate one cycle of the cache */
 void cache_process(struct cache_t * const cp)
 {
@@ -2580,6 +2780,13 @@ void cache_process(struct cache_t * const cp)
   if (cp != uncore->LLC.get())
     cp->sim_cycle++;
 
+  if (!cp->events->advance(cache_get_cycle(cp)))
+  {
+    if (cp->check_for_work)
+      cache_process_idle(cp);
+    return;
+  }
+
   if (!cp->check_for_work)
     return;
 
@@ -2598,34 +2805,49 @@ void cache_process(struct cache_t * const cp)
                         cp->check_for_fill_work ||
                         cp->check_for_pipe_work ||
                         cp->check_for_MSHR_work;
+
+  if (cp->check_for_work && cache_has_ready_work(cp))
+    cp->events->schedule(cache_get_cycle(cp)+1);
 }
 
-/* Attempt to enqueue a prefetch request, based on the predicted
+/* Attempt to enqueue prefetch requests, based on the predicted
    prefetch addresses in the prefetch FIFO (PFF) */
 static void cache_prefetch(struct cache_t * const cp)
 {
   /* if the PF controller says the bus hasn't been too busy */
   if(!cp->PF_sample_interval || (cp->PF_state == PF_OK))
   {
-    /* check prefetch FIFO for new prefetch requests - max one per cycle */
-    if(cp->PFF && cp->PFF_num)
+    /* check prefetch FIFO for new prefetch requests - max PFF_issue_width
+       per cycle, in order */
+    int issued = 0;
+    while(cp->PFF && cp->PFF_num && (issued < cp->PFF_issue_width))
     {
       md_paddr_t pf_addr = cp->PFF[cp->PFF_head].addr;
       struct core_t * core = cp->PFF[cp->PFF_head].core; // tracks originating/owner core
       const int bank = GET_MSHR_BANK(pf_addr);
 
-      if((cp->MSHR_num[bank] < cp->prefetch_threshold) /* if MSHR is too full, don't add more requests */
-         && (cp->MSHR_num_pf[bank] < cp->prefetch_max))
+      /* a miss for the line showed up while this waited in the PFF; drop it
+         without using up an issue slot */
+      if(MSHR_line_pending(cp, pf_addr))
+      {
+        CACHE_STAT(cp->stat.prefetch_MSHR_hits++;)
+      }
+      else if((cp->MSHR_num[bank] < cp->prefetch_threshold) /* if MSHR is too full, don't add more requests */
+         && (cp->MSHR_num_pf[bank] < cp->prefetch_max)
+         && cache_enqueuable(cp, memory::DO_NOT_TRANSLATE, pf_addr))
       {
         md_addr_t pf_PC = cp->PFF[cp->PFF_head].PC;
-        if(cache_enqueuable(cp, memory::DO_NOT_TRANSLATE, pf_addr))
-        {
-          cache_enqueue(core, cp, NULL, CACHE_PREFETCH, memory::DO_NOT_TRANSLATE, pf_PC, pf_addr, (seq_t)-1, bank, NO_MSHR, NULL, dummy_callback, NULL, NULL, NULL);
-          cp->PFF_head = modinc(cp->PFF_head,cp->PFF_size); //(cp->PFF_head+1) % cp->PFF_size;
-          cp->PFF_num --;
-          cache_assert(cp->PFF_num >= 0,(void)0);
-        }
+        cache_enqueue(core, cp, NULL, CACHE_PREFETCH, memory::DO_NOT_TRANSLATE, pf_PC, pf_addr, (seq_t)-1, bank, NO_MSHR, NULL, dummy_callback, NULL, NULL, NULL);
+        issued++;
       }
+      else
+      {
+        break;
+      }
+
+      cp->PFF_head = modinc(cp->PFF_head,cp->PFF_size); //(cp->PFF_head+1) % cp->PFF_size;
+      cp->PFF_num --;
+      cache_assert(cp->PFF_num >= 0,(void)0);
     }
   }
 }
@@ -2692,6 +2914,193 @@ void cache_freeze_stats(struct core_t* const core) {
         core->memory.DTLB2->frozen = true;
 }
 
+/* line flags, as stored in a checkpoint */
+#define CKPT_LINE_VALID         0x01
+#define CKPT_LINE_DIRTY         0x02
+#define CKPT_LINE_PREFETCHED    0x04
+#define CKPT_LINE_PREFETCH_USED 0x08
+
+static std::string cache_ckpt_identity(const struct cache_t * const cp)
+{
+  return std::to_string(cp->sets) + ":" + std::to_string(cp->assoc) + ":" +
+         std::to_string(cp->linesize) + ":" + std::to_string(cp->replacement_policy);
+}
+
+static std::string prefetch_ckpt_identity(const class prefetch_t * const pf)
+{
+  return std::string(pf->get_type()) + ":" + std::to_string(pf->get_bits());
+}
+
+void cache_save(
+    const struct cache_t * const cp,
+    xiosim::checkpoint::writer_t& ckpt,
+    const std::string& key)
+{
+  ckpt.begin_section(key, cache_ckpt_identity(cp));
+  for(int i=0;i<cp->sets;i++)
+  {
+    const struct cache_set_t * const set = &cp->blocks[i];
+    struct cache_line_t * const lines = set->lines;
+    if(!lines) /* never touched; same as a fresh set */
+    {
+      for(int j=0;j<cp->assoc;j++)
+        ckpt.put<int32_t>(j);
+      for(int j=0;j<cp->assoc;j++)
+      {
+        ckpt.put<uint8_t>(0);
+        ckpt.put<uint64_t>(0);
+      }
+      continue;
+    }
+
+    /* recency order first, then the lines themselves, in way order */
+    for(struct cache_line_t * p = &lines[set->head]; p; p = next_line(lines, p))
+      ckpt.put<int32_t>(p->way);
+
+    for(int j=0;j<cp->assoc;j++)
+    {
+      const struct cache_line_t * const line = &lines[j];
+      uint8_t flags = 0;
+      if(line->valid) flags |= CKPT_LINE_VALID;
+      if(line->dirty) flags |= CKPT_LINE_DIRTY;
+      if(line->prefetched) flags |= CKPT_LINE_PREFETCHED;
+      if(line->prefetch_used) flags |= CKPT_LINE_PREFETCH_USED;
+      ckpt.put(flags);
+      /* clock state used to be kept in the meta fields of ways 0 and 1 */
+      uint64_t meta = line->meta;
+      if(cp->replacement_policy == REPLACE_CLOCK && j < 2)
+        meta = (j == 0) ? set->clock_refs : set->clock_hand;
+      ckpt.put<uint64_t>(meta);
+      if(line->valid)
+      {
+        ckpt.put<md_paddr_t>(line->tag);
+        ckpt.put<uint64_t>(line->coh.v);
+        ckpt.put<int32_t>((int32_t)line->core_id - 1);
+      }
+    }
+  }
+
+  /* Outstanding misses. Writebacks are dropped -- the next level gets
+     checkpointed on its own. */
+  uint32_t num_misses = 0;
+  for(int b=0;b<cp->MSHR_banks;b++)
+    for(int i=0;i<cp->MSHR_size;i++)
+      if(cp->MSHR[b][i].cb && cp->MSHR[b][i].type == MSHR_MISS)
+        num_misses++;
+  ckpt.put(num_misses);
+  for(int b=0;b<cp->MSHR_banks;b++)
+    for(int i=0;i<cp->MSHR_size;i++)
+    {
+      const struct cache_action_t * const MSHR = &cp->MSHR[b][i];
+      if(MSHR->cb && MSHR->type == MSHR_MISS)
+      {
+        ckpt.put(MSHR->paddr);
+        ckpt.put<int32_t>(MSHR->cmd);
+        ckpt.put<int32_t>(MSHR->core ? MSHR->core->id : -1);
+      }
+    }
+
+  for(int i=0;i<cp->num_prefetchers;i++)
+  {
+    ckpt.begin_section(key + ".pf" + std::to_string(i), prefetch_ckpt_identity(cp->prefetcher[i].get()));
+    cp->prefetcher[i]->save(ckpt);
+  }
+}
+
+void cache_restore(
+    struct cache_t * const cp,
+    xiosim::checkpoint::reader_t& ckpt,
+    const std::string& key)
+{
+  if(ckpt.begin_section(key, cache_ckpt_identity(cp)))
+  {
+    std::vector<int32_t> order(cp->assoc);
+    std::vector<struct cache_line_t> set_lines(cp->assoc);
+    for(int i=0;i<cp->sets;i++)
+    {
+      /* Read into a scratch set first; sets that were never touched stay
+         unallocated with sparse_sets. */
+      struct cache_set_t set;
+      memset(&set, 0, sizeof(set));
+      struct cache_line_t * const lines = set_lines.data();
+      memset(lines, 0, cp->assoc * sizeof(*lines));
+      bool fresh = true;
+
+      ckpt.get_array(order.data(), cp->assoc);
+      for(int j=0;j<cp->assoc;j++)
+      {
+        if(order[j] < 0 || order[j] >= cp->assoc)
+          fatal("bad way %d in checkpoint of %s", order[j], cp->name);
+        lines[order[j]].next = (j == cp->assoc-1) ? NO_WAY : order[j+1];
+        fresh = fresh && (order[j] == j);
+      }
+      set.head = order[0];
+
+      for(int j=0;j<cp->assoc;j++)
+      {
+        struct cache_line_t * const line = &lines[j];
+        line->way = j;
+        const uint8_t flags = ckpt.get<uint8_t>();
+        line->valid = flags & CKPT_LINE_VALID;
+        line->dirty = flags & CKPT_LINE_DIRTY;
+        line->prefetched = flags & CKPT_LINE_PREFETCHED;
+        line->prefetch_used = flags & CKPT_LINE_PREFETCH_USED;
+        line->victim = false;
+        const uint64_t meta = ckpt.get<uint64_t>();
+        if(cp->replacement_policy == REPLACE_CLOCK && j == 0)
+          set.clock_refs = meta;
+        else if(cp->replacement_policy == REPLACE_CLOCK && j == 1)
+          set.clock_hand = meta;
+        else
+          line->meta = meta;
+        fresh = fresh && !flags && !meta;
+        line->core_id = 0;
+        if(line->valid)
+        {
+          line->tag = ckpt.get<md_paddr_t>();
+          line->coh.v = ckpt.get<uint64_t>();
+          const int32_t core_id = ckpt.get<int32_t>();
+          if(core_id >= 0 && core_id < system_knobs.num_cores)
+            line->core_id = core_id + 1;
+        }
+      }
+
+      if(fresh && !cp->blocks[i].lines)
+        continue;
+      set.lines = cache_get_set(cp, i);
+      memcpy(set.lines, lines, cp->assoc * sizeof(*lines));
+      cp->blocks[i] = set;
+    }
+
+    /* Complete whatever was in flight at checkpoint time. */
+    const uint32_t num_misses = ckpt.get<uint32_t>();
+    for(uint32_t i=0;i<num_misses;i++)
+    {
+      const md_paddr_t paddr = ckpt.get<md_paddr_t>();
+      const enum cache_command cmd = (enum cache_command) ckpt.get<int32_t>();
+      const int32_t core_id = ckpt.get<int32_t>();
+      struct core_t * const core = (core_id >= 0 && core_id < system_knobs.num_cores) ? cores[core_id] : NULL;
+      if(cache_peek(cp, paddr))
+        continue;
+      struct cache_line_t * const evictee = cache_get_evictee(cp, paddr, core);
+      evictee->valid = false;
+      evictee->prefetched = false;
+      evictee->prefetch_used = false;
+      cache_insert_block(cp, cmd, paddr, core);
+    }
+    ckpt.end_section();
+  }
+
+  for(int i=0;i<cp->num_prefetchers;i++)
+  {
+    if(ckpt.begin_section(key + ".pf" + std::to_string(i), prefetch_ckpt_identity(cp->prefetcher[i].get())))
+    {
+      cp->prefetcher[i]->restore(ckpt);
+      ckpt.end_section();
+    }
+  }
+}
+
 tick_t cache_get_cycle(const struct cache_t * const cp)
 {
   if(cp == uncore->LLC.get())
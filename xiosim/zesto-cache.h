@@ -56,11 +56,14 @@
  */
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "checkpoint.h"
 #include "knobs.h"
 #include "synchronization.h"
 #include "stats.h"
+#include "timing_wheel.h"
 
 /* used when passing an MSHR index into the cache functions, but for
    whatever reason there's no corresponding MSHR entry */
@@ -81,25 +84,37 @@ enum read_only_t { CACHE_READWRITE, CACHE_READONLY };
 enum PF_state_t { PF_REFRAIN, PF_OK };
 
 struct line_coherence_data_t {
-  uint64_t v;
+  uint8_t v;
 };
 
 struct action_coherence_data_t {
   uint64_t v;
 };
 
+/* end of a set's recency list */
+#define NO_WAY 0xff
+
+/* Kept to 16 bytes, so big caches don't take up too much host memory. */
 struct cache_line_t {
-  md_paddr_t tag;
-  struct core_t * core; /* originating core */
-  int way; /* which physical column/way am I in? */
-  uint64_t meta; /* additional field for replacment policy meta data */
+  md_paddr_t tag : 48;
+  md_paddr_t core_id : 16; /* originating core's id + 1; 0 = none */
+  uint32_t meta; /* additional field for replacment policy meta data */
   struct line_coherence_data_t coh; /* additional fields needed by coherence protocol */
-  bool valid;
-  bool dirty;
-  bool victim;
-  bool prefetched;
-  bool prefetch_used;
-  struct cache_line_t * next;
+  uint8_t way; /* which physical column/way am I in? */
+  uint8_t next; /* next way in recency order, NO_WAY at the end */
+  bool valid : 1;
+  bool dirty : 1;
+  bool victim : 1;
+  bool prefetched : 1;
+  bool prefetch_used : 1;
+};
+static_assert(sizeof(struct cache_line_t) == 16, "cache_line_t should stay compact");
+
+struct cache_set_t {
+  struct cache_line_t * lines; /* assoc lines, in way order; NULL until first touched */
+  uint64_t clock_refs; /* REPLACE_CLOCK: referenced bit per way */
+  uint8_t head; /* MRU way, first in recency order */
+  uint8_t clock_hand; /* REPLACE_CLOCK: next way to consider */
 };
 
 enum mshr_entry_type_t { MSHR_MISS, MSHR_WRITEBACK };
@@ -174,11 +189,15 @@ struct cache_t {
   int linesize;
   int addr_shift; /* to mask out the block offset */
 
-  struct cache_line_t ** blocks;
-  /* blocks are allocated as one big chunk of memory per set, and the various block[i]
-   * pointers are overwritten to keep track of MRU. Just keep a pointer to free the
-   * big chunk. */
-  std::unique_ptr<struct cache_line_t[]>* blocks_owners;
+  struct cache_set_t * blocks;
+  /* Lines get carved out of big chunks, a set at a time. With sparse_sets, a set
+   * only gets its lines the first time a block is inserted there, so huge caches
+   * only cost host memory for the sets a workload actually touches. */
+  bool sparse_sets;
+  std::vector<std::unique_ptr<struct cache_line_t[]>> line_chunks;
+  struct cache_line_t * chunk_free; /* next unused line in the last chunk */
+  int chunk_free_num;
+  int sets_allocated;
 
   enum repl_policy_t replacement_policy;
   enum alloc_policy_t allocate_policy;
@@ -220,6 +239,7 @@ struct cache_t {
   int PFF_num;
   int PFF_head;
   int PFF_tail;
+  int PFF_issue_width; /* max prefetches sent from the PFF per cycle */
   struct PFF_t {
     md_addr_t PC;
     md_paddr_t addr;
@@ -256,6 +276,9 @@ struct cache_t {
   bool check_for_pipe_work;
   bool check_for_MSHR_work;
   bool check_for_MSHR_WB_work;
+  /* cycles (of this cache's clock) when some pipe/fill/MSHR entry becomes due;
+     cache_process() skips the work in between */
+  std::unique_ptr<xiosim::timing_wheel_t> events;
 
   /* coherency controllers */
   std::unique_ptr<struct cache_controller_t> controller;
@@ -275,6 +298,7 @@ struct cache_t {
     counter_t prefetch_misses;
     counter_t prefetch_insertions;
     counter_t prefetch_useful_insertions;
+    counter_t prefetch_MSHR_hits; /* prefetches dropped, line already in the MSHRs */
     counter_t MSHR_occupancy; /* total occupancy */
     counter_t MSHR_full_cycles; /* number of cycles when full */
     counter_t WBB_insertions; /* total writebacks */
@@ -313,7 +337,8 @@ std::unique_ptr<struct cache_t> cache_create(
     struct bus_t * const bus_next,
     const float magic_hit_rate,
     bool sample_misses,
-    const char * const MSHR_cmd);
+    const char * const MSHR_cmd,
+    const bool sparse_sets = false);
 
 void cache_reg_stats(
     xiosim::stats::StatsDatabase* sdb,
@@ -356,6 +381,11 @@ struct cache_line_t * cache_get_evictee(
     const md_paddr_t addr,
     struct core_t * const core);
 
+/* Find @addr's line without updating replacement state or stats. */
+struct cache_line_t * cache_peek(
+    const struct cache_t * const cp,
+    const md_paddr_t addr);
+
 int cache_enqueuable(
     const struct cache_t * const cp,
     const int asid,
@@ -392,6 +422,19 @@ void prefetch_LLC(struct uncore_t * const uncore);
 
 void cache_freeze_stats(struct core_t * const core);
 
+/* Checkpoint the tag arrays, replacement state and prefetcher tables in
+   sections named @key.*. Misses still in the MSHRs are saved too, and get
+   filled into the arrays on restore. */
+void cache_save(
+    const struct cache_t * const cp,
+    xiosim::checkpoint::writer_t& ckpt,
+    const std::string& key);
+
+void cache_restore(
+    struct cache_t * const cp,
+    xiosim::checkpoint::reader_t& ckpt,
+    const std::string& key);
+
 inline bool cache_single_line_access(struct cache_t * const cp, const md_addr_t addr, const size_t size)
 {
     return (((addr+size-1) >> cp->addr_shift) == (addr >> cp->addr_shift));
@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <map>
+#include <vector>
 
+#include "coherence_directory.h"
 #include "memory.h"
 #include "misc.h"
 #include "stats.h"
@@ -3,6 +3,8 @@
 
 #include <memory>
 
+#include "zesto-cache.h"
+
 enum controller_response_t { MSHR_CHECK_ARRAY, MSHR_STALL };
 enum controller_array_response_t { ARRAY_HIT, ARRAY_MISS };
 
@@ -13,7 +15,8 @@ class cache_controller_t {
     struct cache_t * const cache);
   virtual ~cache_controller_t() {}
 
-  virtual controller_array_response_t check_array(struct cache_line_t * line) = 0;
+  /* @cmd is the access looking up @line (NULL on a tag miss). */
+  virtual controller_array_response_t check_array(struct cache_line_t * line, const enum cache_command cmd) = 0;
   virtual controller_response_t check_MSHR(struct cache_action_t * MSHR_item) = 0;
 
   virtual bool can_schedule_upstream() = 0;
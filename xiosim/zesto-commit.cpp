@@ -56,6 +56,7 @@
 
 #include "misc.h"
 #include "regs.h"
+#include "static_knobs.h"
 #include "stats.h"
 #include "synchronization.h"
 #include "ztrace.h"
@@ -87,6 +88,8 @@ core_commit_t::~core_commit_t()
 
 std::unique_ptr<class core_commit_t> commit_create(const char * commit_opt_string, struct core_t * core)
 {
+  check_static_knobs(core->knobs);
+
 #define ZESTO_PARSE_ARGS
 #include "xiosim/ZPIPE-commit.list.h"
 
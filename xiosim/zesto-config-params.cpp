@@ -12,6 +12,8 @@ cfg_opt_t dvfs_cfg[]{ CFG_STR("config", "none", CFGF_NONE), CFG_INT("interval",
                       CFG_END() };
 
 cfg_opt_t scheduler_cfg[]{ CFG_INT("scheduler_tick", 0, CFGF_NONE),
+                           CFG_BOOL("load_balance", cfg_false, CFGF_NONE),
+                           CFG_BOOL("migration_cache_affinity", cfg_false, CFGF_NONE),
                            CFG_STR("allocator", "gang", CFGF_NONE),
                            CFG_STR("allocator_opt_target", "throughput", CFGF_NONE),
                            CFG_STR("speedup_model", "linear", CFGF_NONE), CFG_END() };
@@ -21,6 +23,13 @@ cfg_opt_t profiling_cfg[]{ CFG_STR("file_prefix", "", CFGF_NONE),
                            CFG_STR_LIST("stop", "{}", CFGF_NONE),
                            CFG_END() };
 
+cfg_opt_t sampling_cfg[]{ CFG_INT("interval", 0, CFGF_NONE),
+                          CFG_INT("max_samples", 100000, CFGF_NONE),
+                          CFG_STR_LIST("stats", "{}", CFGF_NONE),
+                          CFG_STR("file", "samples.csv", CFGF_NONE),
+                          CFG_STR("format", "csv", CFGF_NONE),
+                          CFG_END() };
+
 cfg_opt_t ignore_cfg[]{ CFG_STR_LIST("funcs", "{}", CFGF_NONE),
                         CFG_STR_LIST("pcs", "{}", CFGF_NONE),
                         CFG_END() };
@@ -31,15 +40,24 @@ cfg_opt_t system_cfg[]{ CFG_BOOL("assert_spin", cfg_false, CFGF_NONE),
                         CFG_INT("num_cores", 1, CFGF_NONE),
                         CFG_INT("heartbeat_interval", 0, CFGF_NONE),
                         CFG_STR("ztrace_file_prefix", "ztrace", CFGF_NONE),
+                        CFG_STR("brtrace_file_prefix", "", CFGF_NONE),
                         CFG_BOOL("simulate_power", cfg_false, CFGF_NONE),
                         CFG_INT("cache_miss_sample_parameter", 0, CFGF_NONE),
                         CFG_INT("power_rtp_interval", 0, CFGF_NONE),
                         CFG_STR("power_rtp_file", "", CFGF_NONE),
+                        CFG_STR("power_model", "mcpat", CFGF_NONE),
+                        CFG_INT("power_check_interval", 0, CFGF_NONE),
+                        CFG_STR("power_cache_dir", "", CFGF_NONE),
                         CFG_STR("output_redir", "sim.out", CFGF_NONE),
+                        CFG_STR("huge_pages", "none", CFGF_NONE),
+                        CFG_STR("structured_stats", "none", CFGF_NONE),
+                        CFG_STR("checkpoint_save", "", CFGF_NONE),
+                        CFG_STR("checkpoint_restore", "", CFGF_NONE),
                         CFG_SEC("profiling_cfg", profiling_cfg, CFGF_NONE),
                         CFG_SEC("ignore_cfg", ignore_cfg, CFGF_NONE),
                         CFG_SEC("dvfs_cfg", dvfs_cfg, CFGF_NONE),
                         CFG_SEC("scheduler_cfg", scheduler_cfg, CFGF_NONE),
+                        CFG_SEC("sampling_cfg", sampling_cfg, CFGF_NONE),
                         CFG_END() };
 
 /********************************************/
@@ -48,6 +66,7 @@ cfg_opt_t system_cfg[]{ CFG_BOOL("assert_spin", cfg_false, CFGF_NONE),
 cfg_opt_t iprefetch_cfg[]{ CFG_STR_LIST("config", "none", CFGF_NONE),
                            CFG_BOOL("on_miss_only", cfg_true, CFGF_NONE),
                            CFG_INT("fifosize", 8, CFGF_NONE),
+                           CFG_INT("issue_width", 1, CFGF_NONE),
                            CFG_INT("buffer", 0, CFGF_NONE),
                            CFG_INT("filter", 0, CFGF_NONE),
                            CFG_INT("filter_reset", 65536, CFGF_NONE),
@@ -77,6 +96,7 @@ cfg_opt_t icache_cfg[]{ CFG_STR("config", "IL1:64:8:64:4:16:3:L:8", CFGF_NONE),
 cfg_opt_t dprefetch_cfg[]{ CFG_STR_LIST("config", "nextline", CFGF_NONE),
                            CFG_BOOL("on_miss_only", cfg_false, CFGF_NONE),
                            CFG_INT("fifosize", 8, CFGF_NONE),
+                           CFG_INT("issue_width", 1, CFGF_NONE),
                            CFG_INT("buffer", 0, CFGF_NONE),
                            CFG_INT("filter", 0, CFGF_NONE),
                            CFG_INT("filter_reset", 65536, CFGF_NONE),
@@ -110,6 +130,7 @@ cfg_opt_t dcache_cfg[]{ CFG_STR("config", "DL1:64:8:64:8:64:2:L:W:T:8:C", CFGF_N
 cfg_opt_t l2prefetch_cfg[]{ CFG_STR_LIST("config", "nextline", CFGF_NONE),
                             CFG_BOOL("on_miss_only", cfg_true, CFGF_NONE),
                             CFG_INT("fifosize", 8, CFGF_NONE),
+                            CFG_INT("issue_width", 1, CFGF_NONE),
                             CFG_INT("buffer", 0, CFGF_NONE),
                             CFG_INT("filter", 0, CFGF_NONE),
                             CFG_INT("filter_reset", 65536, CFGF_NONE),
@@ -135,6 +156,7 @@ cfg_opt_t l2cache_cfg[]{ CFG_STR("config", "DL2:512:8:64:8:64:9:L:W:T:8:C", CFGF
 cfg_opt_t llcprefetch_cfg[]{ CFG_STR_LIST("config", "none", CFGF_NONE),
                              CFG_BOOL("on_miss_only", cfg_false, CFGF_NONE),
                              CFG_INT("fifosize", 16, CFGF_NONE),
+                             CFG_INT("issue_width", 1, CFGF_NONE),
                              CFG_INT("buffer", 0, CFGF_NONE),
                              CFG_INT("filter", 0, CFGF_NONE),
                              CFG_INT("filter_reset", 65536, CFGF_NONE),
@@ -150,6 +172,7 @@ cfg_opt_t llccache_cfg[]{ CFG_STR("config", "LLC:2048:16:64:16:64:12:L:W:B:8:1:8
                           CFG_STR("mshr_cmd", "RPWB", CFGF_NODEFAULT),
                           CFG_FLOAT("magic_hit_rate", -1.0, CFGF_NONE),
                           CFG_BOOL("sample_misses", cfg_false, CFGF_NONE),
+                          CFG_BOOL("sparse_sets", cfg_false, CFGF_NONE),
                           CFG_FLOAT("clock", 800.0, CFGF_NONE),
                           CFG_SEC("llcprefetch_cfg", llcprefetch_cfg, CFGF_TITLE),
                           CFG_END() };
@@ -5,6 +5,7 @@
  */
 
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -51,6 +52,7 @@ extern cfg_opt_t dvfs_cfg[];
 extern cfg_opt_t scheduler_cfg[];
 extern cfg_opt_t profiling_cfg[];
 extern cfg_opt_t ignore_cfg[];
+extern cfg_opt_t sampling_cfg[];
 extern cfg_opt_t uncore_cfg[];
 extern cfg_opt_t top_level_cfg[];
 
@@ -151,6 +153,7 @@ static void store_execution_unit_options(cfg_t* exec_opt,
 static void store_prefetcher_options(cfg_t* pf_opt, prefetcher_knobs_t* pf_knobs) {
     store_str_list(pf_opt, "config", pf_knobs->pf_opt_str, &pf_knobs->num_pf, MAX_PREFETCHERS);
     pf_knobs->pff_size = cfg_getint(pf_opt, "fifosize");
+    pf_knobs->pff_issue_width = cfg_getint(pf_opt, "issue_width");
     pf_knobs->pf_thresh = cfg_getint(pf_opt, "threshold");
     pf_knobs->pf_max = cfg_getint(pf_opt, "max_outstanding_requests");
     pf_knobs->pf_buffer_size = cfg_getint(pf_opt, "buffer");
@@ -309,6 +312,7 @@ static void store_uncore_options(cfg_t* uncore_opt, uncore_knobs_t* knobs) {
     knobs->LLC_controller_str = cfg_getstr(llccache_opt, "coherency_controller");
     knobs->LLC_magic_hit_rate = cfg_getfloat(llccache_opt, "magic_hit_rate");
     knobs->LLC_sample_misses = cfg_getbool(llccache_opt, "sample_misses");
+    knobs->LLC_sparse_sets = cfg_getbool(llccache_opt, "sparse_sets");
 
     store_prefetcher_options(llcprefetch_opt, &knobs->LLC_pf);
 
@@ -329,11 +333,24 @@ static void store_system_options(cfg_t* system_opt, system_knobs_t* knobs) {
         fatal("-cores must be between 1 and %d (inclusive)", MAX_CORES);
     knobs->heartbeat_frequency = cfg_getint(system_opt, "heartbeat_interval");
     knobs->ztrace_filename = cfg_getstr(system_opt, "ztrace_file_prefix");
+    knobs->brtrace_filename = cfg_getstr(system_opt, "brtrace_file_prefix");
     knobs->sim_simout = cfg_getstr(system_opt, "output_redir");
+    knobs->huge_pages = cfg_getstr(system_opt, "huge_pages");
+    knobs->structured_stats = cfg_getstr(system_opt, "structured_stats");
+    if (strcmp(knobs->structured_stats, "none") && strcmp(knobs->structured_stats, "json") &&
+        strcmp(knobs->structured_stats, "binary"))
+        fatal("structured_stats must be \"none\", \"json\" or \"binary\"");
+    knobs->checkpoint_save = cfg_getstr(system_opt, "checkpoint_save");
+    knobs->checkpoint_restore = cfg_getstr(system_opt, "checkpoint_restore");
 
     knobs->power.compute = cfg_getbool(system_opt, "simulate_power");
     knobs->power.rtp_interval = cfg_getint(system_opt, "power_rtp_interval");
     knobs->power.rtp_filename = cfg_getstr(system_opt, "power_rtp_file");
+    knobs->power.model = cfg_getstr(system_opt, "power_model");
+    if (strcmp(knobs->power.model, "mcpat") && strcmp(knobs->power.model, "linear"))
+        fatal("power_model must be \"mcpat\" or \"linear\"");
+    knobs->power.check_interval = cfg_getint(system_opt, "power_check_interval");
+    knobs->power.cache_dir = cfg_getstr(system_opt, "power_cache_dir");
 
     knobs->cache_miss_sample_parameter = cfg_getint(system_opt, "cache_miss_sample_parameter");
 
@@ -355,9 +372,20 @@ static void store_system_options(cfg_t* system_opt, system_knobs_t* knobs) {
 
     cfg_t* scheduler_opt = cfg_getsec(system_opt, "scheduler_cfg");
     knobs->scheduler_tick = cfg_getint(scheduler_opt, "scheduler_tick");
+    knobs->load_balance = cfg_getbool(scheduler_opt, "load_balance");
+    knobs->migration_cache_affinity = cfg_getbool(scheduler_opt, "migration_cache_affinity");
     knobs->allocator = cfg_getstr(scheduler_opt, "allocator");
     knobs->allocator_opt_target = cfg_getstr(scheduler_opt, "allocator_opt_target");
     knobs->speedup_model = cfg_getstr(scheduler_opt, "speedup_model");
+
+    cfg_t* sampling_opt = cfg_getsec(system_opt, "sampling_cfg");
+    knobs->sampling.interval = cfg_getint(sampling_opt, "interval");
+    knobs->sampling.max_samples = cfg_getint(sampling_opt, "max_samples");
+    knobs->sampling.stats = store_str_list(sampling_opt, "stats");
+    knobs->sampling.filename = cfg_getstr(sampling_opt, "file");
+    knobs->sampling.format = cfg_getstr(sampling_opt, "format");
+    if (strcmp(knobs->sampling.format, "csv") && strcmp(knobs->sampling.format, "binary"))
+        fatal("sampling_cfg.format must be \"csv\" or \"binary\"");
 }
 
 void read_config_file(std::string cfg_file, core_knobs_t* core_knobs, uncore_knobs_t* uncore_knobs,
@@ -161,6 +161,15 @@ void core_t::reg_common_stats(xiosim::stats::StatsDatabase* sdb) {
                               "total number of effective uops committed", &stat.commit_eff_uops, 0,
                               TRUE, NULL);
     }
+    stat_reg_core_counter(sdb, true, id, "idle_cycles",
+                          "cycles (at default frequency) spent without a thread to run",
+                          &stat.idle_cycles, 0, TRUE, NULL);
+    stat_reg_core_counter(sdb, true, id, "sched_migrations_in",
+                          "threads migrated to this core by the load balancer",
+                          &stat.sched_migrations_in, 0, TRUE, NULL);
+    stat_reg_core_counter(sdb, true, id, "sched_migrations_out",
+                          "threads migrated away from this core by the load balancer",
+                          &stat.sched_migrations_out, 0, TRUE, NULL);
     auto sim_elapsed_time_st = stat_find_stat<double>(sdb, "sim_time");
     stat_reg_core_formula(sdb, true, id, "effective_frequency",
                           "effective frequency in MHz (XXX: assumes core was always active)",
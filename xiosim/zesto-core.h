@@ -260,6 +260,11 @@ class core_t {
     counter_t handshakes_dropped;
     counter_t handshakes_buffered;
     counter_t handshake_nops_produced;
+
+    /* scheduler */
+    counter_t idle_cycles;          /* cycles with no thread to run (default freq) */
+    counter_t sched_migrations_in;  /* threads the load balancer moved here */
+    counter_t sched_migrations_out; /* threads the load balancer moved away */
   } stat;
 
   /*************/
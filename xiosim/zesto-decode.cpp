@@ -56,6 +56,7 @@
 #include <cstddef>
 
 #include "misc.h"
+#include "static_knobs.h"
 #include "stats.h"
 #include "ztrace.h"
 
@@ -86,6 +87,8 @@ core_decode_t::~core_decode_t()
 
 std::unique_ptr<class core_decode_t> decode_create(const char * decode_opt_string, struct core_t * core)
 {
+  check_static_knobs(core->knobs);
+
 #define ZESTO_PARSE_ARGS
 #include "xiosim/ZPIPE-decode.list.h"
 
@@ -120,6 +120,10 @@ void dram_t::reg_stats(xiosim::stats::StatsDatabase* sdb)
   void refresh(void)
 #define DRAM_REG_STATS_HEADER \
   void reg_stats(xiosim::stats::StatsDatabase* sdb)
+#define DRAM_SAVE_HEADER \
+  void save(xiosim::checkpoint::writer_t& ckpt) const
+#define DRAM_RESTORE_HEADER \
+  void restore(xiosim::checkpoint::reader_t& ckpt)
 
 
 /* include all of the DRAM definitions */
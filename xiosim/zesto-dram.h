@@ -58,6 +58,7 @@
 #include <assert.h>
 #include <memory>
 
+#include "checkpoint.h"
 #include "knobs.h"
 #include "zesto-cache.h"
 
@@ -82,6 +83,11 @@ class dram_t
   virtual unsigned int access(const enum cache_command cmd, const md_paddr_t baddr, const int bsize) = 0;
   virtual void refresh(void);
   virtual void reg_stats(xiosim::stats::StatsDatabase* sdb);
+
+  /* Write/read the state that outlives a single access (open rows, etc.).
+     Timing is not part of it -- a restored DRAM starts idle. */
+  virtual void save(xiosim::checkpoint::writer_t& ckpt) const { }
+  virtual void restore(xiosim::checkpoint::reader_t& ckpt) { }
 };
 
 #ifdef DEBUG
@@ -4,6 +4,7 @@
 #include "zesto-structs.h"
 #include "zesto-core.h"
 #include "zesto-dvfs.h"
+#include "zesto-power.h"
 
 using namespace std;
 
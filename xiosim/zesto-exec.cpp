@@ -60,6 +60,7 @@
 #include "memory.h"
 #include "misc.h"
 #include "regs.h"
+#include "static_knobs.h"
 #include "stats.h"
 #include "synchronization.h"
 #include "uop_cracker.h"
@@ -118,6 +119,8 @@ extern int min_coreID;
 
 std::unique_ptr<class core_exec_t> exec_create(const char * exec_opt_string, struct core_t * core)
 {
+  check_static_knobs(core->knobs);
+
 #define ZESTO_PARSE_ARGS
 #include "xiosim/ZPIPE-exec.list.h"
 
@@ -56,6 +56,7 @@
 
 #include "misc.h"
 #include "memory.h"
+#include "static_knobs.h"
 #include "stats.h"
 #include "synchronization.h"
 #include "ztrace.h"
@@ -129,6 +130,8 @@ void core_fetch_t::create_caches() {
 
 std::unique_ptr<class core_fetch_t> fetch_create(const char * fetch_opt_string, struct core_t * core)
 {
+  check_static_knobs(core->knobs);
+
 #define ZESTO_PARSE_ARGS
 #include "xiosim/ZPIPE-fetch.list.h"
 
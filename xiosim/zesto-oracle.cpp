@@ -62,6 +62,7 @@
 #include <sstream>
 
 
+#include "brtrace_format.h"
 #include "host.h"
 #include "misc.h"
 #include "memory.h"
@@ -109,11 +110,24 @@ core_oracle_t::core_oracle_t(struct core_t* const arg_core)
     , MopQ_spec_num(0)
     , drain_pipeline(false)
     , shadow_MopQ(get_MopQ_size(arg_core->knobs))
+    , brtrace_fp(NULL)
+    , brtrace_insts(0)
     , iclass_histogram(XED_ICLASS_LAST, 0)
     , iform_histogram(XED_IFORM_LAST, 0)
     , consumed(true) {
     core = arg_core;
 
+    if (system_knobs.brtrace_filename && strcmp(system_knobs.brtrace_filename, "")) {
+        char buff[512];
+        snprintf(buff, 512, "%s.%d", system_knobs.brtrace_filename, core->id);
+        brtrace_fp = fopen(buff, "wb");
+        if (!brtrace_fp)
+            fatal("failed to open brtrace file %s", buff);
+        xiosim::brtrace::header_t header = { xiosim::brtrace::MAGIC,
+                                             xiosim::brtrace::FORMAT_VERSION };
+        fwrite(&header, sizeof(header), 1, brtrace_fp);
+    }
+
     int res = posix_memalign((void**)&MopQ, 16, MopQ_size * sizeof(*MopQ));
     if (!MopQ || res != 0)
         fatal("failed to calloc MopQ");
@@ -132,6 +146,9 @@ core_oracle_t::~core_oracle_t() {
         MopQ[i].clear();
     }
     free(MopQ);
+
+    if (brtrace_fp)
+        fclose(brtrace_fp);
 }
 
 /* register oracle-related stats in the stat-database (sdb) */
@@ -346,6 +363,7 @@ struct Mop_t* core_oracle_t::exec(const md_addr_t requested_PC) {
 
     Mop->fetch.PC = requested_PC;
     Mop->fetch.ftPC = handshake.npc;
+    Mop->fetch.page_shift = xiosim::memory::page_shift(handshake.asid, requested_PC);
     Mop->oracle.taken_branch = handshake.flags.brtaken;
     Mop->oracle.NextPC = oracle_NPC;
 
@@ -423,8 +441,8 @@ struct Mop_t* core_oracle_t::exec(const md_addr_t requested_PC) {
             uop->decode.mem_size = mem_access.second;
 
             zesto_assert(uop->oracle.virt_addr != 0 || uop->Mop->oracle.spec_mode, NULL);
-            uop->oracle.phys_addr =
-                    xiosim::memory::v2p_translate(core->asid, uop->oracle.virt_addr);
+            uop->oracle.phys_addr = xiosim::memory::v2p_translate(
+                    core->asid, uop->oracle.virt_addr, &uop->oracle.page_shift);
         }
 
         flow_index += 1;  // MD_INC_FLOW;
@@ -586,6 +604,9 @@ void core_oracle_t::commit(const struct Mop_t* const commit_Mop) {
         consumed = true;
     }
 
+    if (brtrace_fp)
+        brtrace_commit(Mop);
+
     Mop->valid = false;
 
     MopQ_head = modinc(MopQ_head, MopQ_size);  //(MopQ_head + 1) % MopQ_size;
@@ -596,6 +617,31 @@ void core_oracle_t::commit(const struct Mop_t* const commit_Mop) {
     shadow_MopQ.pop();
 }
 
+/* Log a committed Mop to the branch trace if fetch would have asked the
+   branch predictor about it. */
+void core_oracle_t::brtrace_commit(const struct Mop_t* const Mop) {
+    using namespace xiosim::brtrace;
+
+    brtrace_insts++;
+    if (!Mop->decode.is_ctrl && !Mop->decode.has_rep)
+        return;
+
+    const inst_flags_t& opflags = Mop->decode.opflags;
+    record_t rec;
+    rec.PC = Mop->fetch.PC;
+    rec.fallthru_PC = Mop->fetch.PC + Mop->fetch.len;
+    rec.target_PC = Mop->decode.targetPC;
+    rec.next_PC = Mop->oracle.NextPC;
+    rec.insts = brtrace_insts;
+    rec.flags = (opflags.CTRL ? FLAG_CTRL : 0) | (opflags.UNCOND ? FLAG_UNCOND : 0) |
+                (opflags.COND ? FLAG_COND : 0) | (opflags.INDIR ? FLAG_INDIR : 0) |
+                (opflags.CALL ? FLAG_CALL : 0) | (opflags.RETN ? FLAG_RETN : 0);
+    rec.pad = 0;
+    if (fwrite(&rec, sizeof(rec), 1, brtrace_fp) != 1)
+        fatal("failed to write brtrace record");
+    brtrace_insts = 0;
+}
+
 /* Undo the effects of the single Mop.  This function only affects the ISA-level
    state.  Bookkeeping for the MopQ and other core-level structures has to be
    dealt with separately. */
@@ -56,6 +56,7 @@
  *
  */
 
+#include <cstdio>
 #include <list>
 #include <map>
 #include <string>
@@ -149,6 +150,11 @@ class core_oracle_t {
 
   shadow_MopQ_t shadow_MopQ;
 
+  /* Committed branch trace for offline predictor sweeps (brtrace_format.h) */
+  FILE * brtrace_fp;
+  uint32_t brtrace_insts; /* committed since the last traced branch */
+  void brtrace_commit(const struct Mop_t * const Mop);
+
   struct core_t * core;
   /* dependency tracking used by oracle */
   std::unordered_map<xed_reg_enum_t, std::list<struct uop_t *>, std::hash<unsigned long> > dep_map;
@@ -0,0 +1,81 @@
+/* zesto-pipeline.h - Per-cycle pipeline stage sequencing */
+
+#ifndef ZESTO_PIPELINE_INCLUDED
+#define ZESTO_PIPELINE_INCLUDED
+
+#include <strings.h>
+
+#include "misc.h"
+
+#include "zesto-core.h"
+#include "zesto-fetch.h"
+#include "zesto-decode.h"
+#include "zesto-alloc.h"
+#include "zesto-exec.h"
+#include "zesto-commit.h"
+
+/* Pipeline models, as selected by core_knobs.model. Each one uses a different
+ * subset of the stage interfaces every cycle (the rest are "Compatibility" no-ops). */
+enum class pipeline_model_t { DPM, IO_DPM, STM, NONE };
+
+inline pipeline_model_t pipeline_model_parse(const char* model_str) {
+    if (!strcasecmp(model_str, "DPM"))
+        return pipeline_model_t::DPM;
+    if (!strcasecmp(model_str, "IO-DPM"))
+        return pipeline_model_t::IO_DPM;
+    if (!strcasecmp(model_str, "STM"))
+        return pipeline_model_t::STM;
+    if (!strcasecmp(model_str, "none"))
+        return pipeline_model_t::NONE;
+    fatal("unknown pipeline model \"%s\"", model_str);
+}
+
+/* Steps all pipeline stages of a core for one cycle, in reverse pipeline order.
+ * The stage sequence is fixed at compile time for each model, so we only dispatch
+ * to stage functions that do work for that model. Stage objects are still created
+ * through their *_create() factories and keep their virtual interfaces for
+ * everything else (recovery, stats, cross-stage queries). */
+template <pipeline_model_t model>
+struct core_pipeline_t {
+    static constexpr bool in_order = (model == pipeline_model_t::IO_DPM) ||
+                                     (model == pipeline_model_t::NONE);
+    static constexpr bool has_frontend = (model != pipeline_model_t::NONE);
+
+    static inline void step(core_t* core) {
+        if (in_order)
+            core->commit->IO_step();
+
+        /* all memory processed here */
+        core->exec->LDST_exec();
+
+        if (!in_order)
+            core->commit->step();
+
+        if (model == pipeline_model_t::IO_DPM) {
+            core->commit->pre_commit_step();
+            core->exec->step();
+        }
+
+        if (!in_order)
+            core->exec->ALU_exec();
+
+        if (has_frontend)
+            core->exec->LDQ_schedule();
+
+        if (!in_order)
+            core->exec->RS_schedule();
+
+        if (has_frontend) {
+            core->alloc->step();
+            core->decode->step();
+            core->fetch->post_fetch();
+        }
+    }
+
+    static inline void pre_fetch(core_t* core) {
+        if (has_frontend)
+            core->fetch->pre_fetch();
+    }
+};
+
+#endif /* ZESTO_PIPELINE_INCLUDED */
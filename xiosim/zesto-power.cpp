@@ -1,4 +1,7 @@
 #include <cstddef>
+#include <cstring>
+#include <pthread.h>
+#include <vector>
 
 #include "misc.h"
 #include "sim.h"
@@ -12,6 +15,7 @@
 #include "zesto-bpred.h"
 #include "zesto-uncore.h"
 #include "zesto-cache.h"
+#include "power_linear.h"
 
 #include "third_party/mcpat/XML_Parse.h"
 #include "third_party/mcpat/mcpat.h"
@@ -26,6 +30,46 @@ double *cores_leakage;
 
 FILE *rtp_file = NULL;
 
+/* Runtime power runs McPAT on a separate thread, so the simulated cores don't
+ * wait for it at every power_rtp_interval. The master core translates the
+ * counter deltas into one of two snapshot buffers and moves on; the power
+ * thread copies the snapshot into McPAT's input and computes. If both buffers
+ * are still in flight, the master waits -- every interval still gets a trace
+ * line, in order. */
+struct rtp_snapshot_t {
+  enum { FREE, PENDING, BUSY } state;
+  tick_t cycle;
+  root_system sys;          // McPAT input, with this interval's stats.
+  std::vector<double> vdd;  // Average per-core Vdd over the interval.
+  /* With the linear model, the power thread only cross-checks these. */
+  bool check;
+  std::vector<double> linear_rtp;
+  double linear_uncore_rtp;
+};
+
+static const int RTP_BUFFERS = 2;
+static rtp_snapshot_t *rtp_snapshots = NULL;
+static int rtp_next_submit = 0;  // Buffers are filled and drained round-robin.
+static int rtp_next_compute = 0;
+static bool rtp_stop = false;
+static pthread_t rtp_thread;
+static pthread_mutex_t rtp_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rtp_cond = PTHREAD_COND_INITIALIZER;
+
+/* Latest completed estimates, guarded by rtp_mutex. */
+static std::vector<power_estimate_t> rtp_estimates;
+
+static void * rtp_power_thread(void *);
+static void drain_rtp_power(void);
+
+/* power_model = "linear": per-event energies fit to McPAT at init. */
+static linear_power_model_t *linear_model = NULL;
+static root_system *linear_input = NULL;
+static int rtp_intervals = 0;
+static int num_checks = 0;          // Cross-check results, guarded by rtp_mutex.
+static double sum_check_error = 0.0;
+static double max_check_error = 0.0;
+
 bool private_l2 = false;
 
 double core_power_t::default_vdd;
@@ -172,7 +216,7 @@ void init_power(void)
   if (cores_leakage == NULL)
     fatal("couldn't allocate memory");
 
-  mcpat_initialize(XML, &cerr, cores_leakage, &uncore_leakage, 5);
+  mcpat_initialize(XML, &cerr, cores_leakage, &uncore_leakage, 5, system_knobs.power.cache_dir);
 
   cores_rtp = (double*)calloc(system_knobs.num_cores, sizeof(*cores_rtp));
   if (cores_rtp == NULL)
@@ -193,10 +237,66 @@ void init_power(void)
       cores[i]->vf_controller->vdd = g_tp.peri_global.Vdd;
       cores[i]->vf_controller->vf_controller_t::change_vf();
     }
+
+  rtp_estimates.assign(system_knobs.num_cores, power_estimate_t());
+  for (int i=0; i<system_knobs.num_cores; i++)
+    rtp_estimates[i].leakage_power = cores_leakage[i];
+
+  if (!strcmp(system_knobs.power.model, "linear"))
+  {
+    /* McPAT reads its input from XML->sys; restore it after calibration. */
+    linear_input = new root_system;
+    memcpy(linear_input, &XML->sys, sizeof(XML->sys));
+    linear_model = new linear_power_model_t(system_knobs.num_cores, private_l2);
+    linear_model->calibrate(*linear_input,
+        [](const root_system& sys, double* core_rtp, double* uncore_dyn) {
+          memcpy(&XML->sys, &sys, sizeof(sys));
+          mcpat_compute_energy(false, core_rtp, uncore_dyn);
+        });
+    memcpy(&XML->sys, linear_input, sizeof(XML->sys));
+  }
+
+  /* The power thread runs McPAT for every interval, or only for the
+   * cross-checks of the linear model. */
+  if (system_knobs.power.rtp_interval > 0 &&
+      (linear_model == NULL || system_knobs.power.check_interval > 0))
+  {
+    /* Snapshots start out as the full McPAT input (params included);
+     * every interval only overwrites the stats. */
+    rtp_snapshots = new rtp_snapshot_t[RTP_BUFFERS];
+    for (int i=0; i<RTP_BUFFERS; i++) {
+      rtp_snapshots[i].state = rtp_snapshot_t::FREE;
+      memcpy(&rtp_snapshots[i].sys, &XML->sys, sizeof(XML->sys));
+      rtp_snapshots[i].vdd.resize(system_knobs.num_cores);
+    }
+    rtp_stop = false;
+    if (pthread_create(&rtp_thread, NULL, rtp_power_thread, NULL))
+      fatal("couldn't start the runtime power thread");
+  }
 }
 
 void deinit_power(void)
 {
+  if (rtp_snapshots) {
+    pthread_mutex_lock(&rtp_mutex);
+    rtp_stop = true;
+    pthread_cond_broadcast(&rtp_cond);
+    pthread_mutex_unlock(&rtp_mutex);
+    pthread_join(rtp_thread, NULL);
+    delete[] rtp_snapshots;
+    rtp_snapshots = NULL;
+  }
+
+  if (linear_model) {
+    if (num_checks)
+      fprintf(stderr, "power: linear model vs. McPAT over %d intervals: mean error %.2f%%, max %.2f%%\n",
+              num_checks, 100.0 * sum_check_error / num_checks, 100.0 * max_check_error);
+    delete linear_model;
+    linear_model = NULL;
+    delete linear_input;
+    linear_input = NULL;
+  }
+
   free(cores_rtp);
   if (rtp_file)
     fclose(rtp_file);
@@ -236,28 +336,182 @@ void translate_uncore_stats(xiosim::stats::StatsDatabase* sdb, root_system* stat
   stats->total_cycles = curr_stat->get_final_val();
 }
 
+static void translate_all_stats(xiosim::stats::StatsDatabase* sdb, root_system* sys)
+{
+  translate_uncore_stats(sdb, sys);
+  for(int i=0; i<system_knobs.num_cores; i++)
+    cores[i]->power->translate_stats(sdb, &sys->core[i], &sys->L2[i]);
+}
+
+/* Scale McPAT's (default Vdd) results with the actual voltages, publish them,
+ * and append them to the power trace. */
+static void publish_power(tick_t cycle, const std::vector<double>& vdd,
+                          const double *core_rtp, double uncore_dyn)
+{
+  pthread_mutex_lock(&rtp_mutex);
+  for(int i=0; i<system_knobs.num_cores; i++) {
+    double scale = vdd[i] / core_power_t::default_vdd;
+    cores[i]->power->rt_power = core_rtp[i] * scale * scale;
+    cores[i]->power->leakage_power = cores_leakage[i] * scale;
+    rtp_estimates[i].cycle = cycle;
+    rtp_estimates[i].rt_power = cores[i]->power->rt_power;
+    rtp_estimates[i].leakage_power = cores[i]->power->leakage_power;
+  }
+  pthread_mutex_unlock(&rtp_mutex);
+
+  if (rtp_file)
+  {
+    for(int i=0; i<system_knobs.num_cores; i++)
+      fprintf(rtp_file, "%.4f %.4f ", cores[i]->power->rt_power, cores[i]->power->leakage_power);
+    fprintf(rtp_file, "%.4f %.4f\n", uncore_dyn, uncore_leakage);
+  }
+}
+
+static std::vector<double> average_vdds(void)
+{
+  std::vector<double> vdd(system_knobs.num_cores);
+  for(int i=0; i<system_knobs.num_cores; i++)
+    vdd[i] = cores[i]->vf_controller->get_average_vdd();
+  return vdd;
+}
+
 void compute_power(xiosim::stats::StatsDatabase* sdb, bool print_power)
 {
+  /* McPAT state belongs to the power thread until it's done. */
+  drain_rtp_power();
+
   /* Get necessary simualtor stats */
-  translate_uncore_stats(sdb, &XML->sys);
-  for(int i=0; i<system_knobs.num_cores; i++)
-    cores[i]->power->translate_stats(sdb, &XML->sys.core[i], &XML->sys.L2[i]);
+  translate_all_stats(sdb, &XML->sys);
 
   /* Invoke mcpat */
   mcpat_compute_energy(print_power, cores_rtp, &uncore_rtp);
 
   /* Print power trace */
   if (rtp_file)
-  {
-    for(int i=0; i<system_knobs.num_cores; i++) {
-      /* Scale trace with voltage changes */
-      double vdd = cores[i]->vf_controller->get_average_vdd();
-      cores[i]->power->rt_power = cores_rtp[i] * (vdd * vdd) / (core_power_t::default_vdd * core_power_t::default_vdd);
-      cores[i]->power->leakage_power = cores_leakage[i] * vdd / core_power_t::default_vdd;
-      fprintf(rtp_file, "%.4f %.4f ", cores[i]->power->rt_power, cores[i]->power->leakage_power);
+    publish_power(uncore->sim_cycle, average_vdds(), cores_rtp, uncore_rtp);
+}
+
+/* Wait for the next snapshot buffer to free up. */
+static rtp_snapshot_t * acquire_snapshot(void)
+{
+  rtp_snapshot_t *snapshot = &rtp_snapshots[rtp_next_submit];
+  pthread_mutex_lock(&rtp_mutex);
+  while (snapshot->state != rtp_snapshot_t::FREE)
+    pthread_cond_wait(&rtp_cond, &rtp_mutex);
+  pthread_mutex_unlock(&rtp_mutex);
+  return snapshot;
+}
+
+static void submit_snapshot(rtp_snapshot_t *snapshot)
+{
+  pthread_mutex_lock(&rtp_mutex);
+  snapshot->state = rtp_snapshot_t::PENDING;
+  pthread_cond_broadcast(&rtp_cond);
+  pthread_mutex_unlock(&rtp_mutex);
+  rtp_next_submit = (rtp_next_submit + 1) % RTP_BUFFERS;
+}
+
+void compute_power_async(xiosim::stats::StatsDatabase* sdb)
+{
+  if (linear_model) {
+    translate_all_stats(sdb, linear_input);
+    std::vector<double> vdd = average_vdds();
+    std::vector<double> core_rtp(system_knobs.num_cores);
+    double uncore_dyn;
+    linear_model->estimate(*linear_input, core_rtp.data(), &uncore_dyn);
+    publish_power(uncore->sim_cycle, vdd, core_rtp.data(), uncore_dyn);
+
+    rtp_intervals++;
+    int check_interval = system_knobs.power.check_interval;
+    if (check_interval > 0 && rtp_intervals % check_interval == 0) {
+      rtp_snapshot_t *snapshot = acquire_snapshot();
+      memcpy(&snapshot->sys, linear_input, sizeof(*linear_input));
+      snapshot->cycle = uncore->sim_cycle;
+      snapshot->check = true;
+      snapshot->linear_rtp = core_rtp;
+      snapshot->linear_uncore_rtp = uncore_dyn;
+      submit_snapshot(snapshot);
     }
-    fprintf(rtp_file, "%.4f %.4f\n", uncore_rtp, uncore_leakage);
+    return;
   }
+
+  rtp_snapshot_t *snapshot = acquire_snapshot();
+  /* Only the stats translation (and Vdd averaging) is on the critical path. */
+  translate_all_stats(sdb, &snapshot->sys);
+  snapshot->vdd = average_vdds();
+  snapshot->cycle = uncore->sim_cycle;
+  snapshot->check = false;
+  submit_snapshot(snapshot);
+}
+
+/* Compare a linear estimate with McPAT's, on total dynamic power. */
+static void record_check(const rtp_snapshot_t *snapshot, const double *core_rtp, double uncore_dyn)
+{
+  double linear = snapshot->linear_uncore_rtp;
+  double mcpat = uncore_dyn;
+  for (int i=0; i<system_knobs.num_cores; i++) {
+    linear += snapshot->linear_rtp[i];
+    mcpat += core_rtp[i];
+  }
+  if (mcpat == 0.0)
+    return;
+  double error = fabs(linear - mcpat) / mcpat;
+
+  pthread_mutex_lock(&rtp_mutex);
+  num_checks++;
+  sum_check_error += error;
+  max_check_error = std::max(max_check_error, error);
+  pthread_mutex_unlock(&rtp_mutex);
+}
+
+power_estimate_t get_power_estimate(int coreID)
+{
+  if (rtp_estimates.empty())  // Not simulating power.
+    return power_estimate_t();
+  pthread_mutex_lock(&rtp_mutex);
+  power_estimate_t res = rtp_estimates[coreID];
+  pthread_mutex_unlock(&rtp_mutex);
+  return res;
+}
+
+static void * rtp_power_thread(void *)
+{
+  pthread_mutex_lock(&rtp_mutex);
+  while (true) {
+    rtp_snapshot_t *snapshot = &rtp_snapshots[rtp_next_compute];
+    while (snapshot->state != rtp_snapshot_t::PENDING && !rtp_stop)
+      pthread_cond_wait(&rtp_cond, &rtp_mutex);
+    if (snapshot->state != rtp_snapshot_t::PENDING)
+      break;
+    snapshot->state = rtp_snapshot_t::BUSY;
+    pthread_mutex_unlock(&rtp_mutex);
+
+    memcpy(&XML->sys, &snapshot->sys, sizeof(XML->sys));
+    mcpat_compute_energy(false, cores_rtp, &uncore_rtp);
+    if (snapshot->check)
+      record_check(snapshot, cores_rtp, uncore_rtp);
+    else
+      publish_power(snapshot->cycle, snapshot->vdd, cores_rtp, uncore_rtp);
+
+    pthread_mutex_lock(&rtp_mutex);
+    snapshot->state = rtp_snapshot_t::FREE;
+    rtp_next_compute = (rtp_next_compute + 1) % RTP_BUFFERS;
+    pthread_cond_broadcast(&rtp_cond);
+  }
+  pthread_mutex_unlock(&rtp_mutex);
+  return NULL;
+}
+
+/* Wait until the power thread has computed everything submitted so far. */
+static void drain_rtp_power(void)
+{
+  if (rtp_snapshots == NULL)
+    return;
+  pthread_mutex_lock(&rtp_mutex);
+  for (int i=0; i<RTP_BUFFERS; i++)
+    while (rtp_snapshots[i].state != rtp_snapshot_t::FREE)
+      pthread_cond_wait(&rtp_cond, &rtp_mutex);
+  pthread_mutex_unlock(&rtp_mutex);
 }
 
 void core_power_t::translate_params(system_core *core_params, system_L2 *L2_params)
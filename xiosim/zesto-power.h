@@ -10,6 +10,19 @@ struct system_L2;
 void init_power(void);
 void deinit_power(void);
 void compute_power(xiosim::stats::StatsDatabase* sdb, bool print_power);
+/* Runtime power: translate the saved deltas in @sdb right away, and leave
+ * McPAT to the power thread. Results show up in get_power_estimate(). */
+void compute_power_async(xiosim::stats::StatsDatabase* sdb);
+
+/* Latest completed runtime power estimate for a core (Vdd-scaled, in W). */
+struct power_estimate_t {
+  tick_t cycle;          // Uncore cycle at the end of the estimated interval.
+  double rt_power;
+  double leakage_power;
+
+  power_estimate_t() : cycle(0), rt_power(0.0), leakage_power(0.0) {}
+};
+power_estimate_t get_power_estimate(int coreID);
 
 class core_power_t {
 
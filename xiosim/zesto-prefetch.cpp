@@ -56,6 +56,7 @@
 #include <iostream>
 
 #include "2bitc.h"
+#include "assoc_table.h"
 #include "memory.h"
 #include "misc.h"
 #include "stats.h"
@@ -122,6 +123,10 @@ paddr           - physical address load is reading from
   md_paddr_t lookup(const md_addr_t PC, const md_paddr_t paddr)
 #define PREFETCH_REG_STATS_HEADER \
   void reg_stats(xiosim::stats::StatsDatabase* sdb, const struct core_t * const core)
+#define PREFETCH_SAVE_HEADER \
+  void save(xiosim::checkpoint::writer_t& ckpt) const
+#define PREFETCH_RESTORE_HEADER \
+  void restore(xiosim::checkpoint::reader_t& ckpt)
 
 
 
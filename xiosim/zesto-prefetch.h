@@ -57,6 +57,7 @@
 
 #include <memory>
 
+#include "checkpoint.h"
 #include "zesto-structs.h"
 #include "zesto-cache.h"
 
@@ -76,6 +77,13 @@ class prefetch_t
   virtual md_paddr_t lookup (const md_addr_t,const md_paddr_t) = 0;
   virtual md_paddr_t latest_lookup (const md_addr_t, const md_paddr_t) { return 0; }
   virtual void reg_stats (xiosim::stats::StatsDatabase* sdb, const struct core_t * const);
+
+  /* Write/read the prefetcher's tables. Stateless prefetchers don't need to. */
+  virtual void save(xiosim::checkpoint::writer_t& ckpt) const { }
+  virtual void restore(xiosim::checkpoint::reader_t& ckpt) { }
+
+  const char * get_type(void) const { return type; }
+  int get_bits(void) const { return bits; }
 };
 
 /* Create a new prefetcher */
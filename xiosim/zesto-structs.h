@@ -156,6 +156,7 @@ struct alignas(16) uop_t
     int mem_op_index; /* which memory operand of the Mop is this */
     md_addr_t virt_addr;
     md_paddr_t phys_addr;
+    md_addr_t page_shift; /* of the page mapping virt_addr */
 
     /* register dependence pointers */
     struct uop_t * idep_uop[MAX_IDEPS];
@@ -297,6 +298,7 @@ struct alignas(16) Mop_t
     md_addr_t PC;
     md_addr_t pred_NPC;
     md_addr_t ftPC;
+    md_addr_t page_shift; /* of the page mapping PC */
     uint8_t code[x86::MAX_ILEN]; /* instruction bytes */
     size_t len; /* instruction length */
     bool first_byte_requested;
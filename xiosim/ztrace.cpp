@@ -1,4 +1,6 @@
+#include <atomic>
 #include <cstdarg>
+#include <vector>
 
 #include "core_const.h"
 #include "decode.h"
@@ -8,14 +10,27 @@
 #include "zesto-structs.h"
 
 #include "ztrace.h"
+#include "ztrace_format.h"
 
 #ifdef ZTRACE
 
-#define MAX_TRACEBUFF_ITEMS 300000
-static char tracebuff[MAX_CORES + 1][MAX_TRACEBUFF_ITEMS][255];
-static int tracebuff_head[MAX_CORES + 1];
-static int tracebuff_tail[MAX_CORES + 1];
-static int tracebuff_occupancy[MAX_CORES + 1];
+using namespace xiosim::ztrace;
+
+/* Ring size per core, in records. Power of 2. */
+const size_t RING_SIZE = 1 << 18;
+
+/* One lock-free ring per core and one for the uncore. Cores only write to
+ * their own ring; the uncore ring can get writers from any thread, so slots
+ * are claimed with an atomic increment everywhere.
+ * A slot's record is only complete once its sequence number says so: a writer
+ * clears it, fills the record, then publishes position+1. A flush stops at the
+ * first slot that isn't published, and drops records that got overwritten
+ * while it was copying them. */
+static record_t* rings[MAX_CORES + 1];
+static std::atomic<uint64_t>* ring_seq[MAX_CORES + 1];
+static std::atomic<uint64_t> ring_tail[MAX_CORES + 1];
+/* Position of the first record that hasn't been flushed yet. */
+static uint64_t ring_flushed[MAX_CORES + 1];
 
 static FILE* ztrace_fp[MAX_CORES + 1];
 
@@ -25,16 +40,91 @@ void ztrace_init(void) {
 
         for (int i = 0; i < system_knobs.num_cores; i++) {
             snprintf(buff, 512, "%s.%d", system_knobs.ztrace_filename, i);
-            ztrace_fp[i] = fopen(buff, "w");
+            ztrace_fp[i] = fopen(buff, "wb");
             if (!ztrace_fp[i])
                 fatal("failed to open ztrace file %s", buff);
         }
 
         snprintf(buff, 512, "%s.uncore", system_knobs.ztrace_filename);
-        ztrace_fp[system_knobs.num_cores] = fopen(buff, "w");
+        ztrace_fp[system_knobs.num_cores] = fopen(buff, "wb");
         if (!ztrace_fp[system_knobs.num_cores])
             fatal("failed to open ztrace file %s", buff);
+
+        for (int i = 0; i < system_knobs.num_cores + 1; i++) {
+            rings[i] = (record_t*)calloc(RING_SIZE, sizeof(record_t));
+            ring_seq[i] = new std::atomic<uint64_t>[RING_SIZE];
+            if (!rings[i])
+                fatal("couldn't calloc ztrace ring");
+            for (size_t j = 0; j < RING_SIZE; j++)
+                ring_seq[i][j].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/* Argument kinds of a format string, parsed once per call site. */
+struct format_cache_entry_t {
+    const char* fmt;
+    format_info_t info;
+};
+const size_t FORMAT_CACHE_SIZE = 256;
+static thread_local format_cache_entry_t format_cache[FORMAT_CACHE_SIZE];
+
+static const format_info_t& get_format(const char* fmt) {
+    size_t index = (reinterpret_cast<uintptr_t>(fmt) >> 3) & (FORMAT_CACHE_SIZE - 1);
+    format_cache_entry_t& entry = format_cache[index];
+    if (entry.fmt != fmt) {
+        entry.fmt = fmt;
+        parse_format(fmt, &entry.info);
+    }
+    return entry.info;
+}
+
+/* Append an event to the ring of @coreID. Only the raw arguments get copied;
+ * the text is rendered offline by ztrace_decode. */
+static void record(const int coreID,
+                   const record_kind_t kind,
+                   const struct Mop_t* Mop,
+                   const struct uop_t* uop,
+                   const uint8_t flags,
+                   const char* fmt,
+                   va_list v) {
+    int trace_id = (coreID == INVALID_CORE) ? system_knobs.num_cores : coreID;
+    assert(trace_id >= 0 && trace_id <= system_knobs.num_cores);
+    if (rings[trace_id] == NULL)
+        return;
+
+    uint64_t slot = ring_tail[trace_id].fetch_add(1, std::memory_order_relaxed);
+    record_t& r = rings[trace_id][slot & (RING_SIZE - 1)];
+    ring_seq[trace_id][slot & (RING_SIZE - 1)].store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    r.fmt = fmt;
+    r.core = trace_id;
+    r.kind = kind;
+    r.flags = flags;
+    r.stage = (fmt[0] && fmt[1] == '|') ? fmt[0] : 0;
+    r.cycle = -1;
+    r.Mop_seq = -1;
+    r.uop_seq = -1;
+    r.PC = 0;
+    if (uop) {
+        r.cycle = uop->core->sim_cycle;
+        r.Mop_seq = uop->decode.Mop_seq;
+        r.uop_seq = uop->decode.uop_seq;
+        Mop = uop->Mop;
+    }
+    if (Mop) {
+        r.cycle = Mop->core->sim_cycle;
+        if (!uop)
+            r.Mop_seq = Mop->oracle.seq;
+        r.PC = Mop->fetch.PC;
+        if (Mop->oracle.spec_mode)
+            r.flags |= RECORD_SPEC;
     }
+
+    pack_args(r, get_format(fmt), v);
+
+    ring_seq[trace_id][slot & (RING_SIZE - 1)].store(slot + 1, std::memory_order_release);
 }
 
 void trace(const int coreID, const char* fmt, ...) {
@@ -42,73 +132,77 @@ void trace(const int coreID, const char* fmt, ...) {
     va_start(v, fmt);
 
     vtrace(coreID, fmt, v);
+    va_end(v);
 }
 
 void vtrace(const int coreID, const char* fmt, va_list v) {
-    int trace_id = (coreID == INVALID_CORE) ? system_knobs.num_cores : coreID;
-    assert(trace_id >= 0 && trace_id <= system_knobs.num_cores);
+    record(coreID, RECORD_RAW, NULL, NULL, 0, fmt, v);
+}
 
-    vsprintf(tracebuff[trace_id][tracebuff_tail[trace_id]], fmt, v);
+/* Write the published records of @trace_id since the last flush as one chunk. */
+static void flush_ring(int trace_id, FILE* fp) {
+    uint64_t tail = ring_tail[trace_id].load(std::memory_order_acquire);
+    uint64_t head = ring_flushed[trace_id];
+    if (tail - head > RING_SIZE)
+        head = tail - RING_SIZE;
+
+    std::vector<record_t> records;
+    uint64_t pos;
+    for (pos = head; pos != tail; pos++) {
+        const size_t index = pos & (RING_SIZE - 1);
+        if (ring_seq[trace_id][index].load(std::memory_order_acquire) != pos + 1)
+            break; /* still being written */
+        record_t r = rings[trace_id][index];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (ring_seq[trace_id][index].load(std::memory_order_relaxed) != pos + 1)
+            continue; /* a writer lapped us while copying */
+        records.push_back(r);
+    }
+    ring_flushed[trace_id] = pos;
+    if (records.empty())
+        return;
 
-    tracebuff_tail[trace_id] = modinc(tracebuff_tail[trace_id], MAX_TRACEBUFF_ITEMS);
-    if (tracebuff_occupancy[trace_id] == MAX_TRACEBUFF_ITEMS)
-        tracebuff_head[trace_id] = modinc(tracebuff_head[trace_id], MAX_TRACEBUFF_ITEMS);
-    else
-        tracebuff_occupancy[trace_id]++;
+    write_chunk(fp, records);
+    fflush(fp);
 }
 
 void ztrace_flush(void) {
     for (int i = 0; i < system_knobs.num_cores + 1; i++) {
-        if (tracebuff_occupancy[i] == 0)
-            continue;
-
         FILE* fp = ztrace_fp[i];
-        if (fp == NULL)
+        if (fp == NULL || rings[i] == NULL)
             continue;
 
-        fprintf(fp, "==============================\n");
-        fprintf(fp, "BEGIN TRACE (%d items)\n", tracebuff_occupancy[i]);
+        flush_ring(i, fp);
+    }
+}
 
-        int j = tracebuff_head[i];
-        do {
-            fprintf(fp, "%s", tracebuff[i][j]);
-            j = modinc(j, MAX_TRACEBUFF_ITEMS);
-        } while (j != tracebuff_tail[i]);
+static void vtrace_Mop(const struct Mop_t* Mop, const uint8_t flags, const char* fmt, va_list v) {
+    record(Mop->core->id, RECORD_MOP, Mop, NULL, flags, fmt, v);
+}
 
-        fprintf(fp, "END TRACE\n");
-        fprintf(fp, "==============================\n");
-        fflush(fp);
-        tracebuff_occupancy[i] = 0;
-        tracebuff_head[i] = tracebuff_tail[i];
-    }
+static void trace_Mop(const struct Mop_t* Mop, const uint8_t flags, const char* fmt, ...) {
+    va_list v;
+    va_start(v, fmt);
+    vtrace_Mop(Mop, flags, fmt, v);
+    va_end(v);
 }
 
-void ztrace_Mop_ID(const struct Mop_t* Mop) {
-    if (Mop == NULL)
-        return;
+static void vtrace_uop(const struct uop_t* uop, const uint8_t flags, const char* fmt, va_list v) {
+    record(uop->core->id, RECORD_UOP, NULL, uop, flags, fmt, v);
+}
 
-    int coreID = Mop->core->id;
-    trace(coreID, "%" PRId64"|M:%" PRId64"|", Mop->core->sim_cycle, Mop->oracle.seq);
-    if (Mop->oracle.spec_mode)
-        trace(coreID, "X|");
-    else
-        trace(coreID, ".|");
+static void trace_uop(const struct uop_t* uop, const uint8_t flags, const char* fmt, ...) {
+    va_list v;
+    va_start(v, fmt);
+    vtrace_uop(uop, flags, fmt, v);
+    va_end(v);
 }
 
 void ztrace_uop_ID(const struct uop_t* uop) {
     if (uop == NULL)
         return;
 
-    int coreID = uop->core->id;
-    trace(coreID,
-                 "%" PRId64"|u:%" PRId64":%" PRId64"|",
-                 uop->core->sim_cycle,
-                 uop->decode.Mop_seq,
-                 uop->decode.uop_seq);
-    if (uop->Mop && uop->Mop->oracle.spec_mode)
-        trace(coreID, "X|");
-    else
-        trace(coreID, ".|");
+    trace_uop(uop, 0, "");
 }
 
 void ztrace_uop_alloc(const struct uop_t* uop) {
@@ -145,23 +239,20 @@ void ztrace_uop_timing(const struct uop_t* uop) {
 
 /* called by oracle when Mop first executes */
 void ztrace_print(const struct Mop_t* Mop) {
-    ztrace_Mop_ID(Mop);
-
     int coreID = Mop->core->id;
 
     // core id, PC
-    trace(coreID,
-                 "DEF|PC=%" PRIxPTR":op=%s:",
-                 Mop->fetch.PC,
-                 xiosim::x86::print_Mop(Mop).c_str());
+    trace_Mop(Mop, 0,
+              "DEF|PC=%" PRIxPTR":op=%s:",
+              Mop->fetch.PC,
+              xiosim::x86::print_Mop(Mop).c_str());
     // ucode flow length
     trace(coreID, "flow-length=%d\n", (int)Mop->decode.flow_length);
 
     int count = 0;
     for (size_t i = 0; i < Mop->decode.flow_length;) {
         struct uop_t* uop = &Mop->uop[i];
-        ztrace_uop_ID(uop);
-        trace(coreID, "DEF");
+        trace_uop(uop, 0, "DEF");
         if (uop->decode.BOM && !uop->decode.EOM)
             trace(coreID, "-BOM");
         if (uop->decode.EOM && !uop->decode.BOM)
@@ -221,11 +312,8 @@ void ztrace_print(const struct Mop_t* Mop, const char* fmt, ...) {
     va_list v;
     va_start(v, fmt);
 
-    int coreID = Mop->core->id;
-
-    ztrace_Mop_ID(Mop);
-    vtrace(coreID, fmt, v);
-    trace(coreID, "\n");
+    vtrace_Mop(Mop, RECORD_NEWLINE, fmt, v);
+    va_end(v);
 }
 
 void ztrace_print(const struct uop_t* uop, const char* fmt, ...) {
@@ -235,19 +323,16 @@ void ztrace_print(const struct uop_t* uop, const char* fmt, ...) {
     va_list v;
     va_start(v, fmt);
 
-    int coreID = uop->core->id;
-
-    ztrace_uop_ID(uop);
-    vtrace(coreID, fmt, v);
-    trace(coreID, "\n");
+    vtrace_uop(uop, RECORD_NEWLINE, fmt, v);
+    va_end(v);
 }
 
 void ztrace_print(const int coreID, const char* fmt, ...) {
     va_list v;
     va_start(v, fmt);
 
-    vtrace(coreID, fmt, v);
-    trace(coreID, "\n");
+    record(coreID, RECORD_RAW, NULL, NULL, RECORD_NEWLINE, fmt, v);
+    va_end(v);
 }
 
 void ztrace_print_start(const struct uop_t* uop, const char* fmt, ...) {
@@ -257,10 +342,8 @@ void ztrace_print_start(const struct uop_t* uop, const char* fmt, ...) {
     va_list v;
     va_start(v, fmt);
 
-    int coreID = uop->core->id;
-
-    ztrace_uop_ID(uop);
-    vtrace(coreID, fmt, v);
+    vtrace_uop(uop, 0, fmt, v);
+    va_end(v);
 }
 
 void ztrace_print_cont(const int coreID, const char* fmt, ...) {
@@ -268,14 +351,15 @@ void ztrace_print_cont(const int coreID, const char* fmt, ...) {
     va_start(v, fmt);
 
     vtrace(coreID, fmt, v);
+    va_end(v);
 }
 
 void ztrace_print_finish(const int coreID, const char* fmt, ...) {
     va_list v;
     va_start(v, fmt);
 
-    vtrace(coreID, fmt, v);
-    trace(coreID, "\n");
+    record(coreID, RECORD_RAW, NULL, NULL, RECORD_NEWLINE, fmt, v);
+    va_end(v);
 }
 
 #endif
@@ -5,6 +5,9 @@
  * events. It is extremeley useful when debugging simulator bugs that happen further
  * along in the execution, when the full trace won't fit on hard drives.
  * There is one circular buffer per core and one for the uncore.
+ *
+ * Events are stored in binary (see ztrace_format.h) -- the format string and the
+ * raw arguments, but no text. Run ztrace_decode on the trace files to render them.
  */
 
 #ifdef ZTRACE
@@ -0,0 +1,24 @@
+/* Renders binary ztrace files (see ztrace_format.h) to the text trace format.
+ *
+ * Usage: ztrace_decode <ztrace file> > trace.txt
+ */
+
+#include <cstdio>
+
+#include "ztrace_decoder.h"
+
+int main(int argc, const char* argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <ztrace file>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* fp = fopen(argv[1], "rb");
+    if (!fp) {
+        fprintf(stderr, "Couldn't open %s.\n", argv[1]);
+        return 1;
+    }
+    int ret = xiosim::ztrace::decode(fp, stdout);
+    fclose(fp);
+    return ret;
+}
@@ -0,0 +1,166 @@
+/* Rendering of binary ztrace files (see ztrace_format.h) to the text trace
+ * format. */
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ztrace_decoder.h"
+#include "ztrace_format.h"
+
+namespace xiosim {
+namespace ztrace {
+
+static bool read_exactly(FILE* fp, void* buf, size_t size) {
+    return fread(buf, 1, size, fp) == size;
+}
+
+/* Format one printf argument @value (from a record payload) with @spec. */
+static void render_arg(std::string& out,
+                       const std::string& spec,
+                       const conversion_t& conv,
+                       const record_t& r,
+                       size_t& arg) {
+    char buf[512];
+    int width = 0;
+    if (conv.star_width)
+        width = (arg < r.num_args) ? (int)r.payload[arg++] : 0;
+    if (arg >= r.num_args) {
+        out += spec;
+        return;
+    }
+
+    uint64_t value = r.payload[arg++];
+    bool is_ll = spec.find("ll") != std::string::npos;
+    switch (conv.kind) {
+    case ARG_INT:
+        if (conv.star_width)
+            snprintf(buf, sizeof(buf), spec.c_str(), width, (int)value);
+        else
+            snprintf(buf, sizeof(buf), spec.c_str(), (int)value);
+        break;
+    case ARG_LONG:
+        if (conv.star_width)
+            is_ll ? snprintf(buf, sizeof(buf), spec.c_str(), width, (long long)value)
+                  : snprintf(buf, sizeof(buf), spec.c_str(), width, (long)value);
+        else
+            is_ll ? snprintf(buf, sizeof(buf), spec.c_str(), (long long)value)
+                  : snprintf(buf, sizeof(buf), spec.c_str(), (long)value);
+        break;
+    case ARG_DOUBLE: {
+        double d;
+        memcpy(&d, &value, sizeof(d));
+        if (conv.star_width)
+            snprintf(buf, sizeof(buf), spec.c_str(), width, d);
+        else
+            snprintf(buf, sizeof(buf), spec.c_str(), d);
+        break;
+    }
+    case ARG_PTR:
+        snprintf(buf, sizeof(buf), spec.c_str(), (void*)(uintptr_t)value);
+        break;
+    case ARG_STRING: {
+        const char* bytes = reinterpret_cast<const char*>(r.payload);
+        const uint64_t offset = value & ~STRING_TRUNCATED;
+        std::string str = (offset < r.payload_bytes) ? bytes + offset : "";
+        if (value & STRING_TRUNCATED)
+            str += "...";
+        if (conv.star_width)
+            snprintf(buf, sizeof(buf), spec.c_str(), width, str.c_str());
+        else
+            snprintf(buf, sizeof(buf), spec.c_str(), str.c_str());
+        break;
+    }
+    }
+    out += buf;
+}
+
+/* Append the literal text of @fmt in [@begin, @end), collapsing %%. */
+static void render_literal(std::string& out, const std::string& fmt, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        out += fmt[i];
+        if (fmt[i] == '%' && i + 1 < end && fmt[i + 1] == '%')
+            i++;
+    }
+}
+
+static std::string render(const record_t& r, const std::vector<std::string>& formats) {
+    char buf[128];
+    std::string out;
+    const char* spec_mode = (r.flags & RECORD_SPEC) ? "X|" : ".|";
+    switch (r.kind) {
+    case RECORD_MOP:
+        snprintf(buf, sizeof(buf), "%" PRId64 "|M:%" PRId64 "|%s", r.cycle, r.Mop_seq, spec_mode);
+        out += buf;
+        break;
+    case RECORD_UOP:
+        snprintf(buf, sizeof(buf), "%" PRId64 "|u:%" PRId64 ":%" PRId64 "|%s", r.cycle, r.Mop_seq,
+                 r.uop_seq, spec_mode);
+        out += buf;
+        break;
+    case RECORD_RAW:
+        break;
+    }
+
+    if (r.fmt_id >= formats.size()) {
+        out += "<bad format id>";
+    } else {
+        const std::string& fmt = formats[r.fmt_id];
+        conversion_t conv;
+        size_t pos = 0;
+        size_t arg = 0;
+        while (next_conversion(fmt.c_str(), pos, &conv)) {
+            render_literal(out, fmt, pos, conv.begin);
+            render_arg(out, fmt.substr(conv.begin, conv.length), conv, r, arg);
+            pos = conv.begin + conv.length;
+        }
+        render_literal(out, fmt, pos, fmt.size());
+    }
+
+    if (r.flags & RECORD_NEWLINE)
+        out += "\n";
+    return out;
+}
+
+int decode(FILE* fp, FILE* out) {
+    chunk_header_t header;
+    while (read_exactly(fp, &header, sizeof(header))) {
+        if (header.magic != CHUNK_MAGIC) {
+            fprintf(stderr, "Not a ztrace file, or corrupted chunk.\n");
+            return 1;
+        }
+        if (header.version != FORMAT_VERSION) {
+            fprintf(stderr, "Unsupported ztrace version %u (expected %u).\n", header.version,
+                    FORMAT_VERSION);
+            return 1;
+        }
+
+        std::vector<std::string> formats(header.num_formats);
+        for (auto& fmt : formats) {
+            uint32_t len;
+            if (!read_exactly(fp, &len, sizeof(len)))
+                return 1;
+            fmt.resize(len);
+            if (len && !read_exactly(fp, &fmt[0], len))
+                return 1;
+        }
+
+        fprintf(out, "==============================\n");
+        fprintf(out, "BEGIN TRACE (%u items)\n", header.num_records);
+        for (uint32_t i = 0; i < header.num_records; i++) {
+            record_t r;
+            if (!read_exactly(fp, &r, sizeof(r))) {
+                fprintf(stderr, "Truncated ztrace chunk.\n");
+                return 1;
+            }
+            fputs(render(r, formats).c_str(), out);
+        }
+        fprintf(out, "END TRACE\n");
+        fprintf(out, "==============================\n");
+    }
+    return 0;
+}
+
+}  // xiosim::ztrace
+}  // xiosim
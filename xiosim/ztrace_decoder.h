@@ -0,0 +1,17 @@
+/* ztrace_decoder.h - Rendering of binary ztrace files to the text trace. */
+
+#ifndef __ZTRACE_DECODER_H__
+#define __ZTRACE_DECODER_H__
+
+#include <cstdio>
+
+namespace xiosim {
+namespace ztrace {
+
+/* Render every chunk in @fp to @out. Returns non-zero on a malformed file. */
+int decode(FILE* fp, FILE* out);
+
+}  // xiosim::ztrace
+}  // xiosim
+
+#endif /* __ZTRACE_DECODER_H__ */
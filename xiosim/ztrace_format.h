@@ -0,0 +1,248 @@
+/* ztrace_format.h - Binary ztrace records and file format.
+ * Shared between the simulator, which writes the records, and ztrace_decode,
+ * which renders them to the classic text trace.
+ *
+ * A trace file is a sequence of chunks, one per ztrace_flush():
+ *   ztrace_chunk_header_t
+ *   num_formats x { uint32_t length; char fmt[length]; }
+ *   num_records x ztrace_record_t, with @fmt_id indexing the formats above.
+ *
+ * Strings that don't fit in a record's payload are cut short, and end in
+ * "..." when rendered.
+ */
+
+#ifndef __ZTRACE_FORMAT_H__
+#define __ZTRACE_FORMAT_H__
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace xiosim {
+namespace ztrace {
+
+const uint32_t CHUNK_MAGIC = 0x5a54524b; /* "ZTRK" */
+const uint32_t FORMAT_VERSION = 2;
+
+struct chunk_header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_formats;
+    uint32_t num_records;
+};
+
+/* What prefix the decoder renders before the formatted text. */
+enum record_kind_t : uint8_t {
+    RECORD_RAW, /* just the text */
+    RECORD_MOP, /* cycle|M:seq|spec| */
+    RECORD_UOP, /* cycle|u:Mop_seq:uop_seq|spec| */
+};
+
+enum record_flags_t : uint8_t {
+    RECORD_SPEC = 1 << 0,    /* Mop was on the wrong path */
+    RECORD_NEWLINE = 1 << 1, /* end of a trace line */
+};
+
+const size_t RECORD_PAYLOAD_WORDS = 10;
+
+/* One traced event. Fixed-size, so a ring of them can be written without
+ * locks and read back from any position. */
+struct record_t {
+    /* Format string -- a pointer to a string literal while in the ring,
+     * an index into the chunk's format table on disk. */
+    union {
+        const char* fmt;
+        uint64_t fmt_id;
+    };
+    int64_t cycle;
+    int64_t Mop_seq;
+    int64_t uop_seq;
+    uint64_t PC;
+    uint16_t core;
+    record_kind_t kind;
+    uint8_t flags;
+    char stage; /* pipeline stage letter (f, d, a, e, c), or 0 */
+    uint8_t num_args;
+    uint16_t payload_bytes;
+    /* Arguments, one word each. Strings are copied inline: their word holds
+     * the byte offset of the (NUL-terminated, possibly truncated) copy. */
+    uint64_t payload[RECORD_PAYLOAD_WORDS];
+};
+static_assert(sizeof(record_t) == 128, "ztrace records should stay at two cache lines");
+
+/* How to pull a printf argument out of a va_list, and how to store it. */
+enum arg_kind_t : uint8_t {
+    ARG_INT,    /* anything promoted to int */
+    ARG_LONG,   /* l, ll, j, z, t */
+    ARG_DOUBLE, /* f, e, g, a */
+    ARG_STRING, /* s */
+    ARG_PTR,    /* p */
+};
+
+const size_t MAX_ARGS = RECORD_PAYLOAD_WORDS;
+
+/* A conversion spec in a format string, like %-8" PRId64 ". */
+struct conversion_t {
+    size_t begin;  /* offset of % */
+    size_t length; /* up to and including the conversion character */
+    arg_kind_t kind;
+    bool star_width; /* width comes from an extra int argument */
+};
+
+/* Parse the next conversion spec at or after @pos in @fmt. Skips %%.
+ * Returns false at the end of the string. */
+inline bool next_conversion(const char* fmt, size_t pos, conversion_t* conv) {
+    for (;;) {
+        const char* pct = strchr(fmt + pos, '%');
+        if (pct == nullptr)
+            return false;
+        const char* c = pct + 1;
+        if (*c == '%') {
+            pos = c + 1 - fmt;
+            continue;
+        }
+
+        conv->begin = pct - fmt;
+        conv->star_width = false;
+        while (*c && strchr("-+ #0", *c))
+            c++;
+        if (*c == '*') {
+            conv->star_width = true;
+            c++;
+        }
+        while (*c >= '0' && *c <= '9')
+            c++;
+        if (*c == '.') {
+            c++;
+            while (*c >= '0' && *c <= '9')
+                c++;
+        }
+
+        bool is_long = false;
+        while (*c && strchr("hljztL", *c)) {
+            if (*c != 'h')
+                is_long = true;
+            c++;
+        }
+
+        switch (*c) {
+        case 's':
+            conv->kind = ARG_STRING;
+            break;
+        case 'p':
+            conv->kind = ARG_PTR;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            conv->kind = ARG_DOUBLE;
+            break;
+        case '\0':
+            return false;
+        default:
+            conv->kind = is_long ? ARG_LONG : ARG_INT;
+            break;
+        }
+        conv->length = c + 1 - pct;
+        return true;
+    }
+}
+
+/* Argument kinds of a format string, in order. */
+struct format_info_t {
+    uint8_t num_args;
+    arg_kind_t kinds[MAX_ARGS];
+};
+
+inline void parse_format(const char* fmt, format_info_t* info) {
+    info->num_args = 0;
+    conversion_t conv;
+    size_t pos = 0;
+    while (next_conversion(fmt, pos, &conv)) {
+        if (conv.star_width && info->num_args < MAX_ARGS)
+            info->kinds[info->num_args++] = ARG_INT;
+        if (info->num_args < MAX_ARGS)
+            info->kinds[info->num_args++] = conv.kind;
+        pos = conv.begin + conv.length;
+    }
+}
+
+/* Marks a string that got cut short. Its payload word points past the
+ * copied bytes. */
+const uint64_t STRING_TRUNCATED = 1ULL << 63;
+
+/* Copy the arguments described by @info from @v into @r's payload.
+ * Strings go after the argument words. */
+inline void pack_args(record_t& r, const format_info_t& info, va_list v) {
+    char* bytes = reinterpret_cast<char*>(r.payload);
+    size_t str_offset = info.num_args * sizeof(uint64_t);
+    for (size_t i = 0; i < info.num_args; i++) {
+        switch (info.kinds[i]) {
+        case ARG_INT:
+            r.payload[i] = (uint64_t)(int64_t)va_arg(v, int);
+            break;
+        case ARG_LONG:
+            r.payload[i] = (uint64_t)va_arg(v, long long);
+            break;
+        case ARG_DOUBLE: {
+            double d = va_arg(v, double);
+            memcpy(&r.payload[i], &d, sizeof(d));
+            break;
+        }
+        case ARG_PTR:
+            r.payload[i] = reinterpret_cast<uintptr_t>(va_arg(v, void*));
+            break;
+        case ARG_STRING: {
+            const char* str = va_arg(v, const char*);
+            if (str == NULL)
+                str = "(null)";
+            const size_t space = sizeof(r.payload) - str_offset;
+            const size_t len = space ? strnlen(str, space - 1) : 0;
+            r.payload[i] = str_offset;
+            if (space) {
+                memcpy(bytes + str_offset, str, len);
+                bytes[str_offset + len] = '\0';
+                str_offset += len + 1;
+            }
+            if (str[len])
+                r.payload[i] |= STRING_TRUNCATED;
+            break;
+        }
+        }
+    }
+    r.num_args = info.num_args;
+    r.payload_bytes = str_offset;
+}
+
+/* Write @records as one chunk. Their @fmt fields have to be the format
+ * string pointers; the chunk gets its own format table. */
+inline void write_chunk(FILE* fp, const std::vector<record_t>& records) {
+    std::unordered_map<const char*, uint32_t> format_ids;
+    std::vector<const char*> formats;
+    for (const record_t& r : records)
+        if (format_ids.insert(std::make_pair(r.fmt, (uint32_t)formats.size())).second)
+            formats.push_back(r.fmt);
+
+    chunk_header_t header;
+    header.magic = CHUNK_MAGIC;
+    header.version = FORMAT_VERSION;
+    header.num_formats = formats.size();
+    header.num_records = records.size();
+    fwrite(&header, sizeof(header), 1, fp);
+    for (const char* fmt : formats) {
+        uint32_t len = strlen(fmt);
+        fwrite(&len, sizeof(len), 1, fp);
+        fwrite(fmt, 1, len, fp);
+    }
+    for (record_t r : records) {
+        r.fmt_id = format_ids[r.fmt];
+        fwrite(&r, sizeof(r), 1, fp);
+    }
+}
+
+}  // xiosim::ztrace
+}  // xiosim
+
+#endif /* __ZTRACE_FORMAT_H__ */